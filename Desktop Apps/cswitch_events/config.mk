@@ -0,0 +1,38 @@
+############################
+# Compiler Configurations  #
+############################
+
+# This variable specifies the name of the compiler that will be used to compile the project.
+CC = gcc
+
+# SANITIZERS: Memory and undefined behaviour checks of the encoder and decoder.
+SANITIZERS = -fsanitize=address,undefined -fno-sanitize-recover=all
+
+# C_FLAGS: Compiler Flags
+# CSwitch.c is built in CSWITCH_MODE_EVENTS, the switch, protocol and
+# scheduler calls it makes are replaced by main.c.
+C_FLAGS = -g -O1 -Wall -DCSWITCH_INPUT_MODE=1 $(SANITIZERS)
+
+# This variable stores additional flags to be passed to the linker.
+LINKER_FLAGS = $(SANITIZERS)
+
+###################################
+# Compiler Inputs  Configurations #
+###################################
+
+# Directories whose *.c files are all compiled.
+SRC_DIRECTORIES =
+
+# Source files which are not located in any of the directories above.
+SRC_FILES_PATHES = main.c ../../src/APP/Switch_Control/CSwitch.c
+
+# Directories searched for header files.
+INC_DIRECTORIES = ../../src/APP/Switch_Control ../../include/HAL/SWITCH \
+                  ../../include/HAL/Control_Protocol ../../include/SERVICE
+
+# Arguments given to the check by the run target, for example
+# RUN_ARGS = -n 100000 -s 7
+RUN_ARGS =
+
+# Name of the produced executable.
+EXECUTABLE_FILE = cswitch_events
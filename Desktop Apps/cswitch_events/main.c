@@ -0,0 +1,454 @@
+/******************************************************************************/
+/**
+ * @file main.c
+ * @brief Round trip checks of the button event frames of CSwitch.c.
+ *
+ * @par Project Name
+ * CSwitch Events
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Builds CSwitch.c unchanged in CSWITCH_MODE_EVENTS with the switch driver,
+ * the control protocol and the scheduler clock replaced. The transitions
+ * are given to the change callback as CheckSwitchesStates would, every frame
+ * sent by the slave side is handed back to its receive side and the events
+ * read with CSWITCH_ReadEvent must carry the switch, the edge and the time
+ * they were given with. It checks the flush of a full batch and on the
+ * deadline, the offsets around EVENT_MAX_DELTA_MS, a link which refuses a
+ * frame, the 16-bit base crossing 0xFFFF many times and random streams.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "switch.h"
+#include "ControlProtocol.h"
+#include "schedular.h"
+#include "CSwitch.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+
+#define DEFAULT_EVENTS                  (20000UL)
+#define MAX_SENT_FRAMES                 (8U)
+#define EXPECTED_DEPTH                  (64U)
+
+/** Largest offset from the first event of a frame, EVENT_MAX_DELTA_MS of CSwitch.c */
+#define MAX_DELTA_MS                    (0x0FFFUL)
+/** The frame base travels on 16 bits */
+#define BASE_RANGE_MS                   (0x10000UL)
+/** Longest random gap, a frame base is then less than BASE_RANGE_MS after the previous one */
+#define MAX_GAP_MS                      (60000UL)
+
+#define CHECK(COND)                     Check((COND), #COND, __LINE__)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+static uint32_t Failures;
+static uint32_t RandomState;
+
+/** Scheduler clock given to CSwitch.c */
+static uint32_t Now;
+
+static SWITCH_ChangeCallBack_t ChangeCallBack;
+static Message_t * pReceive;
+static Message_t SentFrames[MAX_SENT_FRAMES];
+static uint32_t Sent;
+static bool LinkDown;
+
+static CSWITCH_InputEvent_t Expected[EXPECTED_DEPTH];
+static uint32_t ExpectedHead;
+static uint32_t ExpectedTail;
+static uint32_t Offset;     /* Time the master is expected to be off by */
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION PROTOTYPES */
+/******************************************************************************/
+static void Check(bool Condition, const char * pText, int Line);
+static uint32_t Random(void);
+static void Change(uint8_t Switch, uint32_t Status);
+static uint32_t Deliver(void);
+static uint32_t ReadAll(void);
+static void Settle(void);
+static void WalkTo(uint32_t TimeMS);
+static void TestBatch(void);
+static void TestDeadline(void);
+static void TestDelta(void);
+static void TestLinkDown(void);
+static void TestWrap(void);
+static void TestRandom(uint32_t Events);
+static void TestIdle(void);
+/******************************************************************************/
+
+/******************************************************************************/
+/* REPLACED FUNCTIONS */
+/******************************************************************************/
+SWITCH_errorStatus SWITCH_enuInit(void)
+{
+    return SWITCH_SUCCESS;
+}
+
+SWITCH_errorStatus SWITCH_enuGetStatus(uint8_t switchName, uint32_t * switchStatus)
+{
+    (void)switchName;
+    *switchStatus = SWITCH_STATUS_NOT_PRESSED;
+    return SWITCH_SUCCESS;
+}
+
+SWITCH_errorStatus SWITCH_enuSetChangeCallBack(SWITCH_ChangeCallBack_t CallBack)
+{
+    ChangeCallBack = CallBack;
+    return SWITCH_SUCCESS;
+}
+
+PROTOCOL_ErrorStatus_t Protocol_Init(void)
+{
+    return PROTOCOL_OK;
+}
+
+PROTOCOL_ErrorStatus_t Protocol_SendAsync(Message_t * msg)
+{
+    PROTOCOL_ErrorStatus_t RET_ErrorStatus = PROTOCOL_OK;
+    if (LinkDown || Sent == MAX_SENT_FRAMES)
+    {
+        RET_ErrorStatus = PROTOCOL_QUEUE_FULL;
+    }
+    else
+    {
+        SentFrames[Sent] = *msg;
+        Sent++;
+    }
+    return RET_ErrorStatus;
+}
+
+PROTOCOL_ErrorStatus_t Protocol_ReceiveAsync(Message_t * msg)
+{
+    pReceive = msg;
+    return PROTOCOL_OK;
+}
+
+uint32_t schedular_GetTimeMS(void)
+{
+    return Now;
+}
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+static void Check(bool Condition, const char * pText, int Line)
+{
+    if (!Condition)
+    {
+        printf("FAIL line %d: %s\n", Line, pText);
+        Failures++;
+    }
+}
+
+/* xorshift32, the same seed gives the same events */
+static uint32_t Random(void)
+{
+    RandomState ^= RandomState << 13;
+    RandomState ^= RandomState >> 17;
+    RandomState ^= RandomState << 5;
+    return RandomState;
+}
+
+/** A debounced transition at Now, as CheckSwitchesStates reports it. */
+static void Change(uint8_t Switch, uint32_t Status)
+{
+    CSWITCH_InputEvent_t * pEvent = &Expected[ExpectedHead % EXPECTED_DEPTH];
+    pEvent->Switch = Switch;
+    pEvent->Edge   = (Status == SWITCH_STATUS_PRESSED) ? CSWITCH_EDGE_PRESSED : CSWITCH_EDGE_RELEASED;
+    pEvent->TimeMS = Now;
+    ExpectedHead++;
+    ChangeCallBack(Switch, Status);
+}
+
+/** Hands the frames sent so far to the master, returns their count. */
+static uint32_t Deliver(void)
+{
+    uint32_t Frames = Sent;
+    for (uint32_t Frame = 0; Frame < Frames; Frame++)
+    {
+        pReceive->MessageType = SentFrames[Frame].MessageType;
+        pReceive->len = SentFrames[Frame].len;
+        memcpy(pReceive->pMessage, SentFrames[Frame].pMessage, NUMBER_OF_DATA);
+        pReceive->CallBack();
+    }
+    Sent = 0;
+    return Frames;
+}
+
+/** Reads the events of the master and checks them, returns their count. */
+static uint32_t ReadAll(void)
+{
+    CSWITCH_InputEvent_t Event;
+    uint32_t Events = 0;
+    while (CSWITCH_ReadEvent(&Event) == CSWITCH_OK)
+    {
+        CHECK(ExpectedTail != ExpectedHead);
+        if (ExpectedTail != ExpectedHead)
+        {
+            const CSWITCH_InputEvent_t * pExpected = &Expected[ExpectedTail % EXPECTED_DEPTH];
+            CHECK(Event.Switch == pExpected->Switch);
+            CHECK(Event.Edge == pExpected->Edge);
+            CHECK(Event.TimeMS == pExpected->TimeMS - Offset);
+            ExpectedTail++;
+        }
+        Events++;
+    }
+    return Events;
+}
+
+/** Lets the deadline send what is left and empties the master. */
+static void Settle(void)
+{
+    Now += CSWITCH_BATCH_DEADLINE_MS;
+    CSWIRCH_SendUpdate();
+    (void)Deliver();
+    (void)ReadAll();
+    CHECK(ExpectedTail == ExpectedHead);
+    ExpectedTail = ExpectedHead;
+}
+
+/** Sends a frame every MAX_GAP_MS so the master follows the clock up to TimeMS. */
+static void WalkTo(uint32_t TimeMS)
+{
+    while (TimeMS - Now > MAX_GAP_MS)
+    {
+        Now += MAX_GAP_MS;
+        Change(UP_SWITCH, SWITCH_STATUS_NOT_PRESSED);
+        Settle();
+    }
+    Now = TimeMS;
+}
+
+/** The third event fills the frame, it leaves without waiting the deadline. */
+static void TestBatch(void)
+{
+    Now = 1000;
+    Change(UP_SWITCH, SWITCH_STATUS_PRESSED);
+    Now += 3;
+    Change(DOWN_SWITCH, SWITCH_STATUS_PRESSED);
+    CHECK(Sent == 0U);
+    Now += 7;
+    Change(UP_SWITCH, SWITCH_STATUS_NOT_PRESSED);
+    CHECK(Sent == 1U && SentFrames[0].MessageType == DATA && SentFrames[0].len == NUMBER_OF_DATA);
+    CHECK(Deliver() == 1U);
+    CHECK(ReadAll() == 3U);
+    Settle();
+}
+
+/** A lone event waits CSWITCH_BATCH_DEADLINE_MS and keeps its own time. */
+static void TestDeadline(void)
+{
+    CSWITCH_InputEvent_t Event;
+    Now += 1000;
+    Change(LEFT_SWITCH, SWITCH_STATUS_PRESSED);
+    Now += CSWITCH_BATCH_DEADLINE_MS - 1U;
+    CSWIRCH_SendUpdate();
+    CHECK(Sent == 0U);
+    Now += 1;
+    CSWIRCH_SendUpdate();
+    CHECK(Sent == 1U && SentFrames[0].len == 4U);
+    CHECK(Deliver() == 1U);
+    CHECK(ReadAll() == 1U);
+    CHECK(CSWITCH_ReadEvent(&Event) == CSWITCH_NO_EVENT);
+    CHECK(CSWITCH_ReadEvent(NULL) == CSWITCH_NULL_PTR_PASSES);
+    Settle();
+}
+
+/** MAX_DELTA_MS after the first event still fits its frame, one more does not. */
+static void TestDelta(void)
+{
+    Now += 1000;
+    Change(RIGHT_SWITCH, SWITCH_STATUS_PRESSED);
+    Now += MAX_DELTA_MS;
+    Change(RIGHT_SWITCH, SWITCH_STATUS_NOT_PRESSED);
+    CHECK(Sent == 0U);
+    CSWIRCH_SendUpdate();
+    CHECK(Sent == 1U && SentFrames[0].len == 6U);
+    CHECK(Deliver() == 1U);
+    CHECK(ReadAll() == 2U);
+
+    Now += 1000;
+    Change(RIGHT_SWITCH, SWITCH_STATUS_PRESSED);
+    Now += MAX_DELTA_MS + 1U;
+    Change(RIGHT_SWITCH, SWITCH_STATUS_NOT_PRESSED);
+    CHECK(Sent == 1U && SentFrames[0].len == 4U);
+    CHECK(Deliver() == 1U);
+    CSWIRCH_SendUpdate();
+    CHECK(Sent == 0U);
+    Now += CSWITCH_BATCH_DEADLINE_MS;
+    CSWIRCH_SendUpdate();
+    CHECK(Deliver() == 1U);
+    CHECK(ReadAll() == 2U);
+    Settle();
+}
+
+/** A refused frame is kept and sent again by the updates, what did not fit is lost. */
+static void TestLinkDown(void)
+{
+    Now += 1000;
+    LinkDown = true;
+    Change(UP_SWITCH, SWITCH_STATUS_PRESSED);
+    Now += 5;
+    Change(UP_SWITCH, SWITCH_STATUS_NOT_PRESSED);
+    Now += 5;
+    Change(DOWN_SWITCH, SWITCH_STATUS_PRESSED);
+    Now += 5;
+    ChangeCallBack(DOWN_SWITCH, SWITCH_STATUS_NOT_PRESSED);
+    Now += CSWITCH_BATCH_DEADLINE_MS;
+    CSWIRCH_SendUpdate();
+    CHECK(Sent == 0U);
+    LinkDown = false;
+    Now += CSWITCH_UPDATE_PERIOD_MS;
+    CSWIRCH_SendUpdate();
+    CHECK(Sent == 1U && SentFrames[0].len == NUMBER_OF_DATA);
+    CHECK(Deliver() == 1U);
+    CHECK(ReadAll() == 3U);
+    Settle();
+}
+
+/** The base crosses 0xFFFF inside a frame, between frames and many times over. */
+static void TestWrap(void)
+{
+    WalkTo(3U * BASE_RANGE_MS - 4U);
+    Change(UP_SWITCH, SWITCH_STATUS_PRESSED);
+    Now += 9;
+    Change(UP_SWITCH, SWITCH_STATUS_NOT_PRESSED);
+    Settle();
+
+    WalkTo(4U * BASE_RANGE_MS - 2U);
+    Change(DOWN_SWITCH, SWITCH_STATUS_PRESSED);
+    Settle();
+    Now = 4U * BASE_RANGE_MS + 1U;
+    Change(DOWN_SWITCH, SWITCH_STATUS_NOT_PRESSED);
+    Settle();
+
+    for (uint32_t Frame = 0; Frame < 100U; Frame++)
+    {
+        Now += MAX_GAP_MS;
+        Change((uint8_t)(Frame % _SWITCHES_NUM), SWITCH_STATUS_PRESSED);
+        Now += MAX_DELTA_MS;
+        Change((uint8_t)(Frame % _SWITCHES_NUM), SWITCH_STATUS_NOT_PRESSED);
+        Settle();
+    }
+}
+
+/** Random gaps, close together, around the deadline, around MAX_DELTA_MS and long. */
+static void TestRandom(uint32_t Events)
+{
+    uint32_t Read = 0;
+    for (uint32_t Event = 0; Event < Events; Event++)
+    {
+        switch (Random() % 4U)
+        {
+        case 0:
+            Now += Random() % 8U;
+            break;
+        case 1:
+            Now += CSWITCH_BATCH_DEADLINE_MS - 8U + Random() % 16U;
+            break;
+        case 2:
+            Now += MAX_DELTA_MS - 8U + Random() % 16U;
+            break;
+        default:
+            Now += Random() % MAX_GAP_MS;
+            break;
+        }
+        CSWIRCH_SendUpdate();
+        Change((uint8_t)(Random() % _SWITCHES_NUM),
+               (Random() & 1U) ? SWITCH_STATUS_PRESSED : SWITCH_STATUS_NOT_PRESSED);
+        (void)Deliver();
+        Read += ReadAll();
+    }
+    Now += CSWITCH_BATCH_DEADLINE_MS;
+    CSWIRCH_SendUpdate();
+    (void)Deliver();
+    Read += ReadAll();
+    CHECK(Read == Events);
+    Settle();
+}
+
+/** A frame more than BASE_RANGE_MS after the previous one lands a base range early. */
+static void TestIdle(void)
+{
+    Now += BASE_RANGE_MS + 1000U;
+    Offset = BASE_RANGE_MS;
+    Change(UP_SWITCH, SWITCH_STATUS_PRESSED);
+    Settle();
+    Now += 1000U;
+    Change(UP_SWITCH, SWITCH_STATUS_NOT_PRESSED);
+    Settle();
+    Offset = 0;
+}
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+int main(int argc, char ** argv)
+{
+    uint32_t Events = DEFAULT_EVENTS;
+    uint32_t Seed = 1;
+    int Option;
+
+    while ((Option = getopt(argc, argv, "n:s:")) != -1)
+    {
+        switch (Option)
+        {
+        case 'n':
+            Events = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            Seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n events] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+    RandomState = (Seed != 0U) ? Seed : 1U;
+
+    CSWITCH_Init();
+    CHECK(ChangeCallBack != NULL && pReceive != NULL);
+    if (ChangeCallBack == NULL || pReceive == NULL)
+    {
+        printf("FAIL, CSWITCH_Init did not register its callbacks\n");
+        return 1;
+    }
+
+    TestBatch();
+    TestDeadline();
+    TestDelta();
+    TestLinkDown();
+    TestWrap();
+    TestRandom(Events);
+    TestIdle();
+
+    printf("%s, %lu failed checks\n", (Failures == 0U) ? "PASS" : "FAIL", (unsigned long)Failures);
+    return (Failures == 0U) ? 0 : 1;
+}
+
+/******************************************************************************/
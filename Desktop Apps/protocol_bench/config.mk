@@ -0,0 +1,38 @@
+############################
+# Compiler Configurations  #
+############################
+
+# This variable specifies the name of the compiler that will be used to compile the project.
+CC = gcc
+
+# C_FLAGS: Compiler Flags
+# The protocol sources are built exactly as they are on target, add
+# -fsanitize=address,undefined here to check them for memory errors.
+C_FLAGS = -g -O2 -Wall
+
+# This variable stores additional flags to be passed to the linker.
+LINKER_FLAGS =
+
+###################################
+# Compiler Inputs  Configurations #
+###################################
+
+# Directories whose *.c files are all compiled.
+# endpoints/ compiles ../../src/HAL/Control_Protocol/ControlProtocol.c once per
+# endpoint, so the protocol sources must not be listed here.
+SRC_DIRECTORIES = endpoints transport
+
+# Source files which are not located in any of the directories above, the
+# channels configuration is shared by both endpoints.
+SRC_FILES_PATHES = main.c ../../src/HAL/Control_Protocol/ControlProtocol_CFG.c
+
+# Directories searched for header files, the firmware protocol sources are
+# included from here.
+INC_DIRECTORIES = endpoints transport ../../include/HAL/Control_Protocol ../../src/HAL/Control_Protocol
+
+# Arguments given to the benchmark by the run target, for example
+# RUN_ARGS = -n 1000 -b 115200
+RUN_ARGS =
+
+# Name of the produced executable.
+EXECUTABLE_FILE = protocol_bench
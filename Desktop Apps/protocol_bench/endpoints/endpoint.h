@@ -0,0 +1,87 @@
+/*******************************************************************************/
+/**
+ * @file endpoint.h
+ * @brief Two instances of the control protocol in one process.
+ *
+ * @par Project Name
+ * Control Protocol Bench
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * ControlProtocol.c keeps its state in file scope variables, so the bench
+ * compiles it twice, once per endpoint, with its public symbols renamed
+ * (see endpoint_rename.h). Each copy is bound to one end of the loopback
+ * transport and reached through an Endpoint_t table.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ ******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef ENDPOINT_H_
+#define ENDPOINT_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include "ControlProtocol.h"
+#include "protocol_buffer.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC TYPES */
+/******************************************************************************/
+
+/** Entry points of one protocol instance. */
+typedef struct
+{
+    PROTOCOL_ErrorStatus_t (*Init)(void);
+    PROTOCOL_ErrorStatus_t (*SendAsync)(Message_t * msg);
+    PROTOCOL_ErrorStatus_t (*ReceiveAsync)(Message_t * msg);
+    PROTOCOL_ErrorStatus_t (*Read)(uint8_t Channel, Message_t * msg);
+    void                   (*Runnable)(void);
+    PROTOCOL_ErrorStatus_t (*GetBufferStats)(Protocol_BufferStats_t * pStats);
+} Endpoint_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC CONSTANT DECLARATIONS */
+/******************************************************************************/
+
+/** Instance bound to LOOPBACK_END_A. */
+extern const Endpoint_t EndpointA;
+
+/** Instance bound to LOOPBACK_END_B. */
+extern const Endpoint_t EndpointB;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* ENDPOINT_H_ */
+/******************************************************************************/
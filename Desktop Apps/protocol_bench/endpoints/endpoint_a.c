@@ -0,0 +1,74 @@
+/******************************************************************************/
+/**
+ * @file endpoint_a.c
+ * @brief Control protocol instance bound to LOOPBACK_END_A.
+ *
+ * @par Project Name
+ * Control Protocol Bench
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Compiles the firmware ControlProtocol.c unchanged with its symbols
+ * prefixed by EndpointA and implements its transport contract
+ * (protocol_physical__layer.h) on top of the loopback link.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#define ENDPOINT_PREFIX EndpointA
+#include "endpoint_rename.h"
+#include "ControlProtocol.c"
+#include "protocol_buffer.c"
+#include "endpoint.h"
+#include "loopback.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC CONSTANT DEFINITIONS */
+/******************************************************************************/
+const Endpoint_t EndpointA =
+{
+    .Init         = Protocol_Init,
+    .SendAsync    = Protocol_SendAsync,
+    .ReceiveAsync = Protocol_ReceiveAsync,
+    .Read         = Protocol_Read,
+    .Runnable     = Protocol_Runnable,
+    .GetBufferStats = Protocol_GetBufferStats
+};
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+void HardWare_Init(void (*CallBack)(void), void (*TransmitCallBack)(void))
+{
+    Loopback_Attach(LOOPBACK_END_A, CallBack, TransmitCallBack);
+}
+
+void HardWare_Send(char * data, uint8_t len)
+{
+    Loopback_Send(LOOPBACK_END_A, data, len);
+}
+
+void HardWare_Receive(char * data, uint8_t len)
+{
+    Loopback_Receive(LOOPBACK_END_A, data, len);
+}
+
+/** Callbacks only run from Loopback_Step, nothing to mask on the host. */
+void HardWare_Lock(void)
+{
+}
+
+void HardWare_Unlock(void)
+{
+}
+/******************************************************************************/
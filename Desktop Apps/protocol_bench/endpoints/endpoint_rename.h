@@ -0,0 +1,77 @@
+/*******************************************************************************/
+/**
+ * @file endpoint_rename.h
+ * @brief Renames the external symbols of ControlProtocol.c.
+ *
+ * @par Project Name
+ * Control Protocol Bench
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Define ENDPOINT_PREFIX then include this file before ControlProtocol.c.
+ * Every symbol the protocol exports or imports gets the prefix, so two
+ * copies of the protocol and of the transport can be linked together. The
+ * channels configuration (ControlProtocol_CFG.c) is built once and shared.
+ * Add new public protocol symbols here when they are introduced.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ ******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef ENDPOINT_RENAME_H_
+#define ENDPOINT_RENAME_H_
+/******************************************************************************/
+
+#ifndef ENDPOINT_PREFIX
+#error "ENDPOINT_PREFIX must be defined before including endpoint_rename.h"
+#endif
+
+/******************************************************************************/
+/* PRIVATE MACROS */
+/******************************************************************************/
+
+#define ENDPOINT_CONCAT_(PREFIX, NAME)  PREFIX##_##NAME
+#define ENDPOINT_CONCAT(PREFIX, NAME)   ENDPOINT_CONCAT_(PREFIX, NAME)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PROTOCOL SYMBOLS */
+/******************************************************************************/
+#define Protocol_Init               ENDPOINT_CONCAT(ENDPOINT_PREFIX, Protocol_Init)
+#define Protocol_SendAsync          ENDPOINT_CONCAT(ENDPOINT_PREFIX, Protocol_SendAsync)
+#define Protocol_ReceiveAsync       ENDPOINT_CONCAT(ENDPOINT_PREFIX, Protocol_ReceiveAsync)
+#define Protocol_Read               ENDPOINT_CONCAT(ENDPOINT_PREFIX, Protocol_Read)
+#define Protocol_Runnable           ENDPOINT_CONCAT(ENDPOINT_PREFIX, Protocol_Runnable)
+#define Protocol_SendBuffer         ENDPOINT_CONCAT(ENDPOINT_PREFIX, Protocol_SendBuffer)
+#define Protocol_ReadBuffer         ENDPOINT_CONCAT(ENDPOINT_PREFIX, Protocol_ReadBuffer)
+#define Protocol_BufferInit         ENDPOINT_CONCAT(ENDPOINT_PREFIX, Protocol_BufferInit)
+#define Protocol_BufferAlloc        ENDPOINT_CONCAT(ENDPOINT_PREFIX, Protocol_BufferAlloc)
+#define Protocol_BufferRetain       ENDPOINT_CONCAT(ENDPOINT_PREFIX, Protocol_BufferRetain)
+#define Protocol_BufferRelease      ENDPOINT_CONCAT(ENDPOINT_PREFIX, Protocol_BufferRelease)
+#define Protocol_BufferFreeCount    ENDPOINT_CONCAT(ENDPOINT_PREFIX, Protocol_BufferFreeCount)
+#define Protocol_GetBufferStats     ENDPOINT_CONCAT(ENDPOINT_PREFIX, Protocol_GetBufferStats)
+#define ProtocolReceiveCallBack     ENDPOINT_CONCAT(ENDPOINT_PREFIX, ProtocolReceiveCallBack)
+/******************************************************************************/
+
+/******************************************************************************/
+/* TRANSPORT SYMBOLS */
+/******************************************************************************/
+#define HardWare_Init               ENDPOINT_CONCAT(ENDPOINT_PREFIX, HardWare_Init)
+#define HardWare_Send               ENDPOINT_CONCAT(ENDPOINT_PREFIX, HardWare_Send)
+#define HardWare_Receive            ENDPOINT_CONCAT(ENDPOINT_PREFIX, HardWare_Receive)
+#define HardWare_Lock               ENDPOINT_CONCAT(ENDPOINT_PREFIX, HardWare_Lock)
+#define HardWare_Unlock             ENDPOINT_CONCAT(ENDPOINT_PREFIX, HardWare_Unlock)
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* ENDPOINT_RENAME_H_ */
+/******************************************************************************/
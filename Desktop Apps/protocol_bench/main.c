@@ -0,0 +1,459 @@
+/******************************************************************************/
+/**
+ * @file main.c
+ * @brief Throughput and latency benchmark of the control protocol.
+ *
+ * @par Project Name
+ * Control Protocol Bench
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Endpoint A sends numbered messages to endpoint B over the loopback link,
+ * one at a time on the control channel, for every framing/ARQ configuration
+ * and fault profile. The bulk configurations keep the diagnostics channel
+ * saturated at the same time while B reads it slowly. Reports the payload
+ * throughput, the retransmissions and the percentiles of the one way
+ * delivery latency of the control messages, in virtual link time.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "endpoint.h"
+#include "loopback.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+
+#define DEFAULT_MESSAGES                (500U)
+#define MAX_MESSAGES                    (100000U)
+#define DEFAULT_BAUDRATE                (9600U)
+
+/** Time after which a message is counted as lost. */
+#define GIVE_UP_US                      (1000000ULL)
+
+/** Time given at the end of a run to the queued bulk messages. */
+#define DRAIN_US                        (10000000ULL)
+
+/** B reads one diagnostics message every this many runnable periods. */
+#define BULK_READ_PERIODS               (5U)
+
+#define US_PER_MS                       (1000ULL)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE ENUMS */
+/******************************************************************************/
+
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE TYPES */
+/******************************************************************************/
+
+typedef struct
+{
+    const char * Name;
+    uint8_t      PayloadLen;
+    bool         isBulkLoad;
+} BenchConfig_t;
+
+typedef struct
+{
+    const char * Name;
+    uint32_t     LatencyUs;
+    uint32_t     JitterUs;
+    uint32_t     LossPpm;
+    uint32_t     BitFlipPpm;
+} FaultProfile_t;
+
+typedef struct
+{
+    uint32_t Delivered;
+    uint32_t Lost;
+    uint32_t Duplicated;
+    uint32_t Corrupted;
+    uint32_t Retransmits;
+    uint32_t BulkSent;
+    uint32_t BulkAcked;
+    uint32_t BulkRead;
+    uint8_t  PoolPeak;      /**< Highest number of buffers used by an endpoint */
+    uint32_t PoolExhausted; /**< Frames refused by both endpoints for lack of buffer */
+    uint64_t ElapsedUs;
+    uint64_t PayloadBytes;
+} BenchResult_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE CONSTANT DEFINITIONS */
+/******************************************************************************/
+
+static const BenchConfig_t Configs[] =
+{
+    { "1B",           1, false },
+    { "8B",           8, false },
+    { "8B +bulk",     8, true  },
+};
+
+static const FaultProfile_t Profiles[] =
+{
+    { "clean",        0,    0,    0,    0 },
+    { "latency",   5000, 2000,    0,    0 },
+    { "loss",         0,    0, 1000,    0 },
+    { "bitflip",      0,    0,    0, 1000 },
+};
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+static Message_t TxMsg;
+static Message_t RxMsg;
+static Message_t BulkMsg;
+static volatile bool isAcked;
+static bool     isDelivered;
+static uint64_t SentAtUs;
+static uint32_t LatenciesUs[MAX_MESSAGES];
+static uint32_t LatenciesNum;
+static BenchResult_t Result;
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION PROTOTYPES */
+/******************************************************************************/
+static void OnAcked(void);
+static void OnReceived(void);
+static void OnBulkAcked(void);
+static void TopUpBulk(void);
+static void Tick(const BenchConfig_t * pConfig, uint32_t TickNum);
+static int  CompareU32(const void * pLeft, const void * pRight);
+static uint32_t Percentile(uint8_t Percent);
+static bool RunOne(Loopback_Backend_t Backend, uint32_t BaudRate, uint32_t Seed,
+                   uint32_t Messages, const BenchConfig_t * pConfig,
+                   const FaultProfile_t * pProfile);
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+static void OnAcked(void)
+{
+    isAcked = true;
+}
+
+static void OnReceived(void)
+{
+    if(RxMsg.len == TxMsg.len &&
+       memcmp(RxMsg.pMessage, TxMsg.pMessage, TxMsg.len) == 0)
+    {
+        if(isDelivered)
+        {
+            Result.Duplicated++;
+        }
+        else
+        {
+            isDelivered = true;
+            Result.Delivered++;
+            Result.PayloadBytes += TxMsg.len;
+            LatenciesUs[LatenciesNum++] = (uint32_t)(Loopback_Now() - SentAtUs);
+        }
+    }
+    else
+    {
+        Result.Corrupted++;
+    }
+    EndpointB.ReceiveAsync(&RxMsg);
+}
+
+static void OnBulkAcked(void)
+{
+    Result.BulkAcked++;
+}
+
+/** Keeps the diagnostics queue of A full. */
+static void TopUpBulk(void)
+{
+    while(EndpointA.SendAsync(&BulkMsg) == PROTOCOL_OK)
+    {
+        Result.BulkSent++;
+    }
+}
+
+/** Work done every PROTOCOL_RUNNABLE_PERIOD_MS of virtual time. */
+static void Tick(const BenchConfig_t * pConfig, uint32_t TickNum)
+{
+    Message_t Diagnostics;
+    EndpointA.Runnable();
+    EndpointB.Runnable();
+    if(pConfig->isBulkLoad && (TickNum % BULK_READ_PERIODS) == 0 &&
+       EndpointB.Read(PROTOCOL_CHANNEL_DIAGNOSTICS, &Diagnostics) == PROTOCOL_OK)
+    {
+        Result.BulkRead++;
+        Result.PayloadBytes += Diagnostics.len;
+    }
+    else
+    {
+        /* No thing */
+    }
+}
+
+static int CompareU32(const void * pLeft, const void * pRight)
+{
+    uint32_t Left  = *(const uint32_t *)pLeft;
+    uint32_t Right = *(const uint32_t *)pRight;
+    return (Left > Right) - (Left < Right);
+}
+
+/** Nearest rank percentile, LatenciesUs must be sorted. */
+static uint32_t Percentile(uint8_t Percent)
+{
+    uint32_t RET_Value = 0;
+    if(LatenciesNum != 0)
+    {
+        uint32_t Rank = (Percent * LatenciesNum + 99U) / 100U;
+        RET_Value = LatenciesUs[(Rank == 0) ? 0 : Rank - 1];
+    }
+    else
+    {
+        /* No thing */
+    }
+    return RET_Value;
+}
+
+/** Runs one configuration, returns false when the link stalled. */
+static bool RunOne(Loopback_Backend_t Backend, uint32_t BaudRate, uint32_t Seed,
+                   uint32_t Messages, const BenchConfig_t * pConfig,
+                   const FaultProfile_t * pProfile)
+{
+    Loopback_Faults_t Faults =
+    {
+        .BaudRate   = BaudRate,
+        .LatencyUs  = pProfile->LatencyUs,
+        .JitterUs   = pProfile->JitterUs,
+        .LossPpm    = pProfile->LossPpm,
+        .BitFlipPpm = pProfile->BitFlipPpm,
+        .Seed       = Seed
+    };
+    Loopback_Stats_t Stats;
+    Protocol_BufferStats_t PoolA;
+    Protocol_BufferStats_t PoolB;
+    uint64_t NextTickUs = PROTOCOL_RUNNABLE_PERIOD_MS * US_PER_MS;
+    uint64_t DrainEndUs;
+    uint32_t TickNum    = 0;
+    bool     isStalled;
+
+    memset(&Result, 0, sizeof(Result));
+    LatenciesNum = 0;
+    if(Loopback_Open(Backend, &Faults) != LOOPBACK_OK)
+    {
+        fprintf(stderr, "cannot open the %s loopback\n",
+                (Backend == LOOPBACK_BACKEND_PTY) ? "pty" : "pipe");
+        exit(EXIT_FAILURE);
+    }
+    else
+    {
+        /* No thing */
+    }
+    EndpointA.Init();
+    EndpointB.Init();
+    RxMsg.Channel  = PROTOCOL_CHANNEL_CONTROL;
+    RxMsg.CallBack = OnReceived;
+    EndpointB.ReceiveAsync(&RxMsg);
+    BulkMsg.Channel     = PROTOCOL_CHANNEL_DIAGNOSTICS;
+    BulkMsg.MessageType = DATA;
+    BulkMsg.len         = NUMBER_OF_DATA;
+    BulkMsg.CallBack    = OnBulkAcked;
+    memset(BulkMsg.pMessage, 0x5A, sizeof(BulkMsg.pMessage));
+
+    for(uint32_t Seq = 0; Seq < Messages; Seq++)
+    {
+        uint64_t GiveUpUs;
+
+        TxMsg.Channel     = PROTOCOL_CHANNEL_CONTROL;
+        TxMsg.MessageType = COMMAND;
+        TxMsg.len         = pConfig->PayloadLen;
+        TxMsg.CallBack    = OnAcked;
+        for(uint8_t Idx = 0; Idx < pConfig->PayloadLen; Idx++)
+        {
+            TxMsg.pMessage[Idx] = (char)((Seq >> (8U * (Idx % 4U))) + Idx);
+        }
+        isAcked     = false;
+        isDelivered = false;
+        SentAtUs    = Loopback_Now();
+        GiveUpUs    = SentAtUs + GIVE_UP_US;
+        EndpointA.SendAsync(&TxMsg);
+
+        while(!isAcked && Loopback_Now() < GiveUpUs)
+        {
+            if(pConfig->isBulkLoad)
+            {
+                TopUpBulk();
+            }
+            else
+            {
+                /* No thing */
+            }
+            if(!Loopback_Step((NextTickUs < GiveUpUs) ? NextTickUs : GiveUpUs) &&
+               Loopback_Now() >= NextTickUs)
+            {
+                Tick(pConfig, TickNum++);
+                NextTickUs += PROTOCOL_RUNNABLE_PERIOD_MS * US_PER_MS;
+            }
+            else
+            {
+                /* No thing */
+            }
+        }
+        if(!isDelivered)
+        {
+            Result.Lost++;
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+
+    /** Let the queued bulk messages drain */
+    DrainEndUs = Loopback_Now() + DRAIN_US;
+    while(Result.BulkAcked < Result.BulkSent && Loopback_Now() < DrainEndUs)
+    {
+        if(!Loopback_Step(NextTickUs))
+        {
+            Tick(pConfig, TickNum++);
+            NextTickUs += PROTOCOL_RUNNABLE_PERIOD_MS * US_PER_MS;
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    Result.ElapsedUs = Loopback_Now();
+    /** Let the last ACK arrive before closing the link */
+    while(Loopback_Step(Loopback_Now() + GIVE_UP_US))
+    {
+    }
+    Loopback_GetStats(LOOPBACK_END_A, &Stats);
+    EndpointA.GetBufferStats(&PoolA);
+    EndpointB.GetBufferStats(&PoolB);
+    Result.PoolPeak = (PoolA.PeakInUse > PoolB.PeakInUse) ? PoolA.PeakInUse : PoolB.PeakInUse;
+    Result.PoolExhausted = PoolA.Exhausted + PoolB.Exhausted;
+    /**
+     * Every message must get through and every frame is sent at least once,
+     * fewer frames than messages means the link stopped sending.
+     */
+    isStalled = (Result.Lost != 0 || Result.BulkAcked < Result.BulkSent ||
+                 Stats.SendCalls < Messages + Result.BulkSent);
+    /** Frames sent on top of one per message */
+    Result.Retransmits = isStalled ? 0 : Stats.SendCalls - Messages - Result.BulkSent;
+    Loopback_Close();
+
+    qsort(LatenciesUs, LatenciesNum, sizeof(LatenciesUs[0]), CompareU32);
+    printf("%-12s %-9s %-6s %9u %5u %5u %7u %5u %9u %6u/%-4u %11.1f %7.1f %7.1f %7.1f %7.1f\n",
+           pConfig->Name, pProfile->Name, isStalled ? "STALL" : "ok",
+           Result.Delivered, Result.Lost, Result.Duplicated, Result.Corrupted,
+           Result.Retransmits, Result.BulkRead, Result.PoolPeak, Result.PoolExhausted,
+           (Result.ElapsedUs != 0)
+               ? (double)Result.PayloadBytes * 1e6 / (double)Result.ElapsedUs : 0.0,
+           Percentile(50) / 1000.0, Percentile(90) / 1000.0,
+           Percentile(99) / 1000.0, Percentile(100) / 1000.0);
+    return !isStalled;
+}
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+int main(int argc, char * argv[])
+{
+    Loopback_Backend_t Backend = LOOPBACK_BACKEND_PIPE;
+    uint32_t Messages = DEFAULT_MESSAGES;
+    uint32_t BaudRate = DEFAULT_BAUDRATE;
+    uint32_t Seed     = 1;
+    uint32_t Stalled  = 0;
+    int Option;
+
+    while((Option = getopt(argc, argv, "t:n:b:s:")) != -1)
+    {
+        if(Option == 't' && strcmp(optarg, "pty") == 0)
+        {
+            Backend = LOOPBACK_BACKEND_PTY;
+        }
+        else if(Option == 't' && strcmp(optarg, "pipe") == 0)
+        {
+            Backend = LOOPBACK_BACKEND_PIPE;
+        }
+        else if(Option == 'n')
+        {
+            Messages = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else if(Option == 'b')
+        {
+            BaudRate = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else if(Option == 's')
+        {
+            Seed = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-t pipe|pty] [-n messages] "
+                            "[-b baudrate] [-s seed]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if(Messages == 0 || Messages > MAX_MESSAGES || BaudRate == 0)
+    {
+        fprintf(stderr, "messages must be 1..%u and baudrate not 0\n",
+                MAX_MESSAGES);
+        return EXIT_FAILURE;
+    }
+    else
+    {
+        /* No thing */
+    }
+
+    printf("backend %s, %u baud, %u messages per run\n\n",
+           (Backend == LOOPBACK_BACKEND_PTY) ? "pty" : "pipe", BaudRate, Messages);
+    printf("%-12s %-9s %-6s %9s %5s %5s %7s %5s %9s %11s %11s %7s %7s %7s %7s\n",
+           "config", "faults", "link", "delivered", "lost", "dup", "corrupt", "retx",
+           "bulk read", "pool pk/ex", "payload B/s", "p50 ms", "p90 ms", "p99 ms", "max ms");
+    for(size_t Config = 0; Config < sizeof(Configs) / sizeof(Configs[0]); Config++)
+    {
+        for(size_t Profile = 0; Profile < sizeof(Profiles) / sizeof(Profiles[0]); Profile++)
+        {
+            if(!RunOne(Backend, BaudRate, Seed, Messages, &Configs[Config], &Profiles[Profile]))
+            {
+                Stalled++;
+            }
+            else
+            {
+                /* No thing */
+            }
+        }
+    }
+    printf("\n%s, %u stalled runs\n", (Stalled == 0) ? "PASS" : "FAIL", Stalled);
+    return (Stalled == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/******************************************************************************/
@@ -0,0 +1,436 @@
+/******************************************************************************/
+/**
+ * @file loopback.c
+ * @brief Linux loopback transport for the control protocol.
+ *
+ * @par Project Name
+ * Control Protocol Bench
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Every byte handed to Loopback_Send gets an arrival time from the fault
+ * model and waits in a per direction queue. Loopback_Step moves the virtual
+ * clock to the next arrival, pushes the byte through the pipe or the
+ * pseudo-terminal and fills the receive buffer armed by the other end.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+#include "loopback.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+
+/** Bytes that can travel on one direction at the same time. */
+#define LINK_QUEUE_SIZE                 (4096U)
+
+/** Bits per byte on the wire, 8N1. */
+#define BITS_PER_BYTE                   (10U)
+
+/** Time given to the kernel to move bytes through the pseudo-terminal. */
+#define READ_TIMEOUT_MS                 (1000)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE TYPES */
+/******************************************************************************/
+
+typedef struct
+{
+    uint64_t ArrivalUs;
+    uint8_t  Byte;
+    bool     isLost;
+    bool     isLastOfSend;
+} LinkByte_t;
+
+/** One direction of the link, named after the end sending on it. */
+typedef struct
+{
+    LinkByte_t Queue[LINK_QUEUE_SIZE];
+    uint16_t   Head;
+    uint16_t   Count;
+    uint64_t   LineFreeUs;
+    uint64_t   LastArrivalUs;
+    int        WriteFd;
+    int        ReadFd;
+    uint32_t   InKernel;
+    Loopback_Stats_t Stats;
+} Direction_t;
+
+typedef struct
+{
+    void   (*CallBack)(void);
+    void   (*TransmitCallBack)(void);
+    char *   pData;
+    uint8_t  Len;
+    uint8_t  Received;
+} EndPoint_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+static Direction_t Directions[_LOOPBACK_ENDS_NUM];
+static EndPoint_t  EndPoints[_LOOPBACK_ENDS_NUM];
+static Loopback_Faults_t Faults;
+static uint64_t NowUs;
+static uint32_t RandomState;
+static int      OpenedFds[4];
+static uint8_t  OpenedFdsNum;
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION PROTOTYPES */
+/******************************************************************************/
+static uint32_t Random(void);
+static bool     Chance(uint32_t Ppm);
+static Loopback_ErrorStatus_t OpenPipes(void);
+static Loopback_ErrorStatus_t OpenPty(void);
+static void     Deliver(Loopback_End_t Receiver);
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+/** xorshift32, good enough for fault injection and reproducible. */
+static uint32_t Random(void)
+{
+    RandomState ^= RandomState << 13;
+    RandomState ^= RandomState >> 17;
+    RandomState ^= RandomState << 5;
+    return RandomState;
+}
+
+static bool Chance(uint32_t Ppm)
+{
+    return (Ppm != 0) && ((Random() % LOOPBACK_PPM) < Ppm);
+}
+
+static Loopback_ErrorStatus_t OpenPipes(void)
+{
+    Loopback_ErrorStatus_t RET_ErrorStatus = LOOPBACK_OK;
+    int AtoB[2];
+    int BtoA[2];
+    if(pipe(AtoB) != 0)
+    {
+        RET_ErrorStatus = LOOPBACK_ERROR;
+    }
+    else if(pipe(BtoA) != 0)
+    {
+        close(AtoB[0]);
+        close(AtoB[1]);
+        RET_ErrorStatus = LOOPBACK_ERROR;
+    }
+    else
+    {
+        Directions[LOOPBACK_END_A].WriteFd = AtoB[1];
+        Directions[LOOPBACK_END_A].ReadFd  = AtoB[0];
+        Directions[LOOPBACK_END_B].WriteFd = BtoA[1];
+        Directions[LOOPBACK_END_B].ReadFd  = BtoA[0];
+        OpenedFds[0] = AtoB[0];
+        OpenedFds[1] = AtoB[1];
+        OpenedFds[2] = BtoA[0];
+        OpenedFds[3] = BtoA[1];
+        OpenedFdsNum = 4;
+    }
+    return RET_ErrorStatus;
+}
+
+/**
+ * End A owns the master side and end B the slave side, the same way a host
+ * tool and a board sit on both sides of a USB serial adapter.
+ */
+static Loopback_ErrorStatus_t OpenPty(void)
+{
+    Loopback_ErrorStatus_t RET_ErrorStatus = LOOPBACK_ERROR;
+    struct termios Settings;
+    int Master = posix_openpt(O_RDWR | O_NOCTTY);
+    int Slave  = -1;
+    if(Master >= 0 && grantpt(Master) == 0 && unlockpt(Master) == 0)
+    {
+        Slave = open(ptsname(Master), O_RDWR | O_NOCTTY);
+    }
+    else
+    {
+        /* No thing */
+    }
+    if(Slave >= 0 && tcgetattr(Slave, &Settings) == 0)
+    {
+        /** Raw mode, the frames carry 0xFF and control characters */
+        cfmakeraw(&Settings);
+        if(tcsetattr(Slave, TCSANOW, &Settings) == 0)
+        {
+            Directions[LOOPBACK_END_A].WriteFd = Master;
+            Directions[LOOPBACK_END_A].ReadFd  = Slave;
+            Directions[LOOPBACK_END_B].WriteFd = Slave;
+            Directions[LOOPBACK_END_B].ReadFd  = Master;
+            OpenedFds[0] = Master;
+            OpenedFds[1] = Slave;
+            OpenedFdsNum = 2;
+            RET_ErrorStatus = LOOPBACK_OK;
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    else
+    {
+        /* No thing */
+    }
+    if(RET_ErrorStatus != LOOPBACK_OK)
+    {
+        if(Slave >= 0) close(Slave);
+        if(Master >= 0) close(Master);
+    }
+    else
+    {
+        /* No thing */
+    }
+    return RET_ErrorStatus;
+}
+
+/** Reads what the kernel holds for the receiver into its armed buffer. */
+static void Deliver(Loopback_End_t Receiver)
+{
+    Direction_t * pDirection = &Directions[!Receiver];
+    EndPoint_t  * pEnd       = &EndPoints[Receiver];
+    struct pollfd Poll = { .fd = pDirection->ReadFd, .events = POLLIN };
+    while(pDirection->InKernel > 0 && pEnd->pData != NULL)
+    {
+        ssize_t Read = -1;
+        if(poll(&Poll, 1, READ_TIMEOUT_MS) > 0)
+        {
+            Read = read(pDirection->ReadFd, pEnd->pData + pEnd->Received,
+                        pEnd->Len - pEnd->Received);
+        }
+        else
+        {
+            /* No thing */
+        }
+        if(Read <= 0)
+        {
+            break;
+        }
+        else
+        {
+            pDirection->InKernel -= (uint32_t)Read;
+            pEnd->Received += (uint8_t)Read;
+        }
+        if(pEnd->Received == pEnd->Len)
+        {
+            /** Disarm before the callback, it usually arms the next read */
+            pEnd->pData = NULL;
+            if(pEnd->CallBack != NULL)
+            {
+                pEnd->CallBack();
+            }
+            else
+            {
+                /* No thing */
+            }
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+}
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+Loopback_ErrorStatus_t Loopback_Open(Loopback_Backend_t Backend,
+                                     const Loopback_Faults_t * pFaults)
+{
+    Loopback_ErrorStatus_t RET_ErrorStatus = LOOPBACK_OK;
+    if(pFaults == NULL || pFaults->BaudRate == 0)
+    {
+        RET_ErrorStatus = LOOPBACK_ERROR;
+    }
+    else
+    {
+        memset(Directions, 0, sizeof(Directions));
+        memset(EndPoints, 0, sizeof(EndPoints));
+        Faults      = *pFaults;
+        NowUs       = 0;
+        RandomState = (pFaults->Seed != 0) ? pFaults->Seed : 0x2545F491UL;
+        RET_ErrorStatus = (Backend == LOOPBACK_BACKEND_PTY) ? OpenPty()
+                                                            : OpenPipes();
+    }
+    return RET_ErrorStatus;
+}
+
+void Loopback_Close(void)
+{
+    for(uint8_t Fd = 0; Fd < OpenedFdsNum; Fd++)
+    {
+        close(OpenedFds[Fd]);
+    }
+    OpenedFdsNum = 0;
+}
+
+void Loopback_Attach(Loopback_End_t End, void (*CallBack)(void),
+                     void (*TransmitCallBack)(void))
+{
+    EndPoints[End].CallBack         = CallBack;
+    EndPoints[End].TransmitCallBack = TransmitCallBack;
+}
+
+void Loopback_Send(Loopback_End_t End, const char * pData, uint8_t Len)
+{
+    Direction_t * pDirection = &Directions[End];
+    uint64_t ByteTimeUs = (BITS_PER_BYTE * 1000000ULL) / Faults.BaudRate;
+    pDirection->Stats.SendCalls++;
+    for(uint8_t Idx = 0; Idx < Len && pDirection->Count < LINK_QUEUE_SIZE; Idx++)
+    {
+        LinkByte_t * pByte = &pDirection->Queue[
+            (pDirection->Head + pDirection->Count) % LINK_QUEUE_SIZE];
+        uint64_t Start = (pDirection->LineFreeUs > NowUs) ? pDirection->LineFreeUs
+                                                          : NowUs;
+        pDirection->LineFreeUs = Start + ByteTimeUs;
+        pByte->ArrivalUs = pDirection->LineFreeUs + Faults.LatencyUs;
+        if(Faults.JitterUs != 0)
+        {
+            pByte->ArrivalUs += Random() % Faults.JitterUs;
+        }
+        else
+        {
+            /* No thing */
+        }
+        if(pByte->ArrivalUs < pDirection->LastArrivalUs)
+        {
+            pByte->ArrivalUs = pDirection->LastArrivalUs;
+        }
+        else
+        {
+            /* No thing */
+        }
+        pDirection->LastArrivalUs = pByte->ArrivalUs;
+        pByte->Byte   = (uint8_t)pData[Idx];
+        pByte->isLastOfSend = (Idx == Len - 1U);
+        pByte->isLost = Chance(Faults.LossPpm);
+        if(pByte->isLost)
+        {
+            pDirection->Stats.BytesLost++;
+        }
+        else if(Chance(Faults.BitFlipPpm))
+        {
+            pByte->Byte ^= (uint8_t)(1U << (Random() % 8U));
+            pDirection->Stats.BytesFlipped++;
+        }
+        else
+        {
+            /* No thing */
+        }
+        pDirection->Stats.BytesSent++;
+        pDirection->Count++;
+    }
+}
+
+void Loopback_Receive(Loopback_End_t End, char * pData, uint8_t Len)
+{
+    EndPoints[End].pData    = pData;
+    EndPoints[End].Len      = Len;
+    EndPoints[End].Received = 0;
+}
+
+bool Loopback_Step(uint64_t UntilUs)
+{
+    bool isDelivered = false;
+    Direction_t * pNext = NULL;
+    for(uint8_t End = 0; End < _LOOPBACK_ENDS_NUM; End++)
+    {
+        Direction_t * pDirection = &Directions[End];
+        if(pDirection->Count != 0 &&
+           (pNext == NULL ||
+            pDirection->Queue[pDirection->Head].ArrivalUs <
+            pNext->Queue[pNext->Head].ArrivalUs))
+        {
+            pNext = pDirection;
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    if(pNext != NULL && pNext->Queue[pNext->Head].ArrivalUs <= UntilUs)
+    {
+        LinkByte_t * pByte = &pNext->Queue[pNext->Head];
+        Loopback_End_t Sender = (pNext == &Directions[LOOPBACK_END_A]) ? LOOPBACK_END_A
+                                                                       : LOOPBACK_END_B;
+        NowUs = pByte->ArrivalUs;
+        pNext->Head = (pNext->Head + 1) % LINK_QUEUE_SIZE;
+        pNext->Count--;
+        if(!pByte->isLost && write(pNext->WriteFd, &pByte->Byte, 1) == 1)
+        {
+            pNext->InKernel++;
+        }
+        else
+        {
+            /* No thing */
+        }
+        Deliver(!Sender);
+        if(pByte->isLastOfSend && EndPoints[Sender].TransmitCallBack != NULL)
+        {
+            EndPoints[Sender].TransmitCallBack();
+        }
+        else
+        {
+            /* No thing */
+        }
+        isDelivered = true;
+    }
+    else if(UntilUs > NowUs)
+    {
+        NowUs = UntilUs;
+    }
+    else
+    {
+        /* No thing */
+    }
+    return isDelivered;
+}
+
+uint64_t Loopback_Now(void)
+{
+    return NowUs;
+}
+
+void Loopback_GetStats(Loopback_End_t End, Loopback_Stats_t * pStats)
+{
+    if(pStats != NULL)
+    {
+        *pStats = Directions[End].Stats;
+    }
+    else
+    {
+        /* No thing */
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,171 @@
+/*******************************************************************************/
+/**
+ * @file loopback.h
+ * @brief Linux loopback transport for the control protocol.
+ *
+ * @par Project Name
+ * Control Protocol Bench
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Connects two protocol endpoints living in the same process through either
+ * two pipes or a pseudo-terminal pair. Every byte goes through a fault model
+ * (byte loss, bit flips, latency and the serialisation time of the UART)
+ * driven by a virtual clock, so runs are repeatable and do not depend on the
+ * speed of the host.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ ******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef LOOPBACK_H_
+#define LOOPBACK_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC DEFINES */
+/******************************************************************************/
+
+/** Probability scale used by the fault model (parts per million). */
+#define LOOPBACK_PPM                    (1000000UL)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC ENUMS */
+/******************************************************************************/
+
+typedef enum
+{
+    LOOPBACK_OK,
+    LOOPBACK_ERROR
+} Loopback_ErrorStatus_t;
+
+/** Operating system object carrying the bytes between the endpoints. */
+typedef enum
+{
+    LOOPBACK_BACKEND_PIPE,      /**< One pipe per direction */
+    LOOPBACK_BACKEND_PTY        /**< Pseudo-terminal master/slave pair */
+} Loopback_Backend_t;
+
+/**
+ * @note _LOOPBACK_ENDS_NUM must stay the last element.
+ */
+typedef enum
+{
+    LOOPBACK_END_A,
+    LOOPBACK_END_B,
+    _LOOPBACK_ENDS_NUM
+} Loopback_End_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC TYPES */
+/******************************************************************************/
+
+/** Fault model applied to both directions of the link. */
+typedef struct
+{
+    uint32_t BaudRate;      /**< Line rate, 10 bits per byte (8N1) */
+    uint32_t LatencyUs;     /**< Fixed one way latency added to every byte */
+    uint32_t JitterUs;      /**< Random extra latency, bytes never reorder */
+    uint32_t LossPpm;       /**< Probability of losing a byte */
+    uint32_t BitFlipPpm;    /**< Probability of flipping one bit of a byte */
+    uint32_t Seed;          /**< Seed of the fault generator */
+} Loopback_Faults_t;
+
+/** Counters kept for the bytes sent by one end. */
+typedef struct
+{
+    uint32_t SendCalls;     /**< Number of HardWare_Send calls */
+    uint32_t BytesSent;     /**< Bytes handed to the link */
+    uint32_t BytesLost;     /**< Bytes removed by the fault model */
+    uint32_t BytesFlipped;  /**< Bytes corrupted by the fault model */
+} Loopback_Stats_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION PROTOTYPES */
+/******************************************************************************/
+
+/** @brief Opens the link, resets the virtual clock and the counters.
+ *  @param[in] Backend Pipes or pseudo-terminal.
+ *  @param[in] pFaults Fault model, must not be NULL.
+ *  @return Error Status
+ */
+Loopback_ErrorStatus_t Loopback_Open(Loopback_Backend_t Backend,
+                                     const Loopback_Faults_t * pFaults);
+
+/** @brief Closes the file descriptors opened by Loopback_Open. */
+void Loopback_Close(void);
+
+/** @brief Registers the receive and transmit complete callbacks of one end. */
+void Loopback_Attach(Loopback_End_t End, void (*CallBack)(void),
+                     void (*TransmitCallBack)(void));
+
+/** @brief Queues bytes from one end towards the other one. */
+void Loopback_Send(Loopback_End_t End, const char * pData, uint8_t Len);
+
+/** @brief Arms the reception of Len bytes on one end. */
+void Loopback_Receive(Loopback_End_t End, char * pData, uint8_t Len);
+
+/**
+ * @brief Delivers the next byte travelling on the link.
+ *
+ * The virtual clock jumps to the arrival time of the next byte, the byte is
+ * written to the operating system object and read back by the receiving
+ * end. Receive callbacks, and the transmit callback once the last byte of a
+ * send went through, run from here the same way the DMA interrupts run them
+ * on target.
+ *
+ * @param[in] UntilUs Virtual time not to go past.
+ * @return true if a byte was delivered, false if the link is idle up to
+ *         UntilUs, in which case the clock is moved to UntilUs.
+ */
+bool Loopback_Step(uint64_t UntilUs);
+
+/** @brief Returns the virtual time in microseconds. */
+uint64_t Loopback_Now(void);
+
+/** @brief Returns the counters of the bytes sent by one end. */
+void Loopback_GetStats(Loopback_End_t End, Loopback_Stats_t * pStats);
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* LOOPBACK_H_ */
+/******************************************************************************/
@@ -0,0 +1,39 @@
+############################
+# Compiler Configurations  #
+############################
+
+# This variable specifies the name of the compiler that will be used to compile the project.
+CC = gcc
+
+# SANITIZERS: Memory and undefined behaviour checks of the protocol sources.
+# They slow the callbacks down, build with SANITIZERS= to measure their time.
+SANITIZERS = -fsanitize=address,undefined -fno-sanitize-recover=all
+
+# C_FLAGS: Compiler Flags
+C_FLAGS = -g -O2 -Wall $(SANITIZERS)
+
+# This variable stores additional flags to be passed to the linker.
+LINKER_FLAGS = $(SANITIZERS)
+
+###################################
+# Compiler Inputs  Configurations #
+###################################
+
+# Directories whose *.c files are all compiled.
+# target/ compiles ../../src/HAL/Control_Protocol/ControlProtocol.c and
+# protocol_buffer.c itself, so the protocol sources must not be listed here.
+SRC_DIRECTORIES = target
+
+# Source files which are not located in any of the directories above.
+SRC_FILES_PATHES = main.c ../../src/HAL/Control_Protocol/ControlProtocol_CFG.c
+
+# Directories searched for header files, the firmware protocol sources are
+# included from here.
+INC_DIRECTORIES = target ../../include/HAL/Control_Protocol ../../src/HAL/Control_Protocol
+
+# Arguments given to the fuzzer by the run target, for example
+# RUN_ARGS = -n 1000000 -s 7
+RUN_ARGS =
+
+# Name of the produced executable.
+EXECUTABLE_FILE = protocol_fuzz
@@ -0,0 +1,400 @@
+/******************************************************************************/
+/**
+ * @file main.c
+ * @brief Fuzzer and worst case timing of the control protocol receive path.
+ *
+ * @par Project Name
+ * Control Protocol Fuzzer
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Feeds byte streams to ProtocolReceiveCallBack: random bytes, random
+ * segments and valid frames damaged by byte loss, bit flips, inserted and
+ * repeated bytes. After every input the internal state of the protocol is
+ * checked, then valid frames must still be received, which proves the
+ * receiver found its way back to the frame boundaries. Prints the callback
+ * time per kind of segment at the end.
+ *
+ * Inputs given on the command line are replayed instead, a failing input
+ * is saved so it can be replayed after a fix.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ControlProtocol.h"
+#include "fuzz_target.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+
+#define MAX_FRAMES_PER_INPUT            (8U)
+#define MAX_INPUT_SIZE                  (MAX_FRAMES_PER_INPUT * FUZZ_FRAME_SIZE + 16U)
+#define MAX_MUTATIONS                   (4U)
+#define DEFAULT_ITERATIONS              (200000UL)
+/** The protocol restarts from Protocol_Init once every this many inputs */
+#define RESET_PERIOD                    (64U)
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TIMER_UNIT                      "TSC ticks"
+#else
+#define TIMER_UNIT                      "ns"
+#endif
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+static uint8_t  Input[MAX_INPUT_SIZE];
+static uint32_t RandomState;
+
+static const uint8_t CanaryPayload[NUMBER_OF_DATA] = { 'R', 'E', 'S', 'Y', 'N', 'C', 0, 1 };
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION PROTOTYPES */
+/******************************************************************************/
+static uint32_t Random(void);
+static size_t AddFrame(uint8_t * pInput);
+static size_t Mutate(uint8_t * pInput, size_t Size);
+static size_t Generate(uint8_t * pInput);
+static bool RunOne(const uint8_t * pInput, size_t Size, const char ** pWhy);
+static void SaveInput(const uint8_t * pInput, size_t Size, uint32_t Seed, uint32_t Iteration);
+static bool ReplayFile(const char * pPath);
+static void PrintTiming(void);
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+/** xorshift32, the same sequence for a given seed on every host. */
+static uint32_t Random(void)
+{
+    RandomState ^= RandomState << 13;
+    RandomState ^= RandomState >> 17;
+    RandomState ^= RandomState << 5;
+    return RandomState;
+}
+
+/** Appends a data, ACK, NACK or CREDIT frame with random fields. */
+static size_t AddFrame(uint8_t * pInput)
+{
+    static const uint8_t ControlLens[] = { 253U, 254U, 255U };
+    uint8_t Payload[NUMBER_OF_DATA];
+    uint8_t Len;
+    for(uint8_t Data = 0 ; Data < NUMBER_OF_DATA ; Data++)
+    {
+        Payload[Data] = (uint8_t)Random();
+    }
+    if(Random() % 4U == 0)
+    {
+        Len = ControlLens[Random() % sizeof(ControlLens)];
+        for(uint8_t Channel = 0 ; Channel < NUMBER_OF_DATA ; Channel++)
+        {
+            Payload[Channel] %= (PROTOCOL_MAX_QUEUE_DEPTH + 2U);
+        }
+    }
+    else
+    {
+        Len = (uint8_t)(Random() % (NUMBER_OF_DATA + 3U));
+    }
+    /** Mostly existing channels, sometimes any value of the type segment */
+    uint8_t Type = (Random() % 8U == 0)
+                 ? (uint8_t)Random()
+                 : (uint8_t)(((Random() % _PROTOCOL_CHANNELS_NUM) << 4) |
+                             ((Random() & 1U) << 3) | (Random() & 1U));
+    FuzzTarget_BuildFrame(pInput, Type, Len, Payload);
+    return FUZZ_FRAME_SIZE;
+}
+
+/** Damages a stream the way a noisy UART does, plus a few harsher cases. */
+static size_t Mutate(uint8_t * pInput, size_t Size)
+{
+    size_t At = (Size != 0) ? Random() % Size : 0;
+    switch(Random() % 5U)
+    {
+    case 0:     /** bit flip */
+        if(Size != 0)
+        {
+            pInput[At] ^= (uint8_t)(1U << (Random() % 8U));
+        }
+        break;
+    case 1:     /** lost byte */
+        if(Size != 0)
+        {
+            memmove(&pInput[At], &pInput[At + 1U], Size - At - 1U);
+            Size--;
+        }
+        break;
+    case 2:     /** extra byte */
+        if(Size < MAX_INPUT_SIZE)
+        {
+            memmove(&pInput[At + 1U], &pInput[At], Size - At);
+            pInput[At] = (uint8_t)Random();
+            Size++;
+        }
+        break;
+    case 3:     /** repeated segment */
+        if(Size >= 2U && Size + 2U <= MAX_INPUT_SIZE)
+        {
+            At &= ~(size_t)1U;
+            At = (At + 2U <= Size) ? At : Size - 2U;
+            memmove(&pInput[At + 2U], &pInput[At], Size - At);
+            Size += 2U;
+        }
+        break;
+    default:    /** cut */
+        Size = At;
+        break;
+    }
+    return Size;
+}
+
+static size_t Generate(uint8_t * pInput)
+{
+    size_t Size = 0;
+    switch(Random() % 3U)
+    {
+    case 0:     /** random bytes */
+        Size = 1U + Random() % MAX_INPUT_SIZE;
+        for(size_t Byte = 0 ; Byte < Size ; Byte++)
+        {
+            pInput[Byte] = (uint8_t)Random();
+        }
+        break;
+    case 1:     /** random segments, orders near the frame ones */
+        Size = 2U * (1U + Random() % (MAX_INPUT_SIZE / 2U));
+        for(size_t Byte = 0 ; Byte < Size ; Byte += 2U)
+        {
+            pInput[Byte]      = (uint8_t)(Random() % 16U);
+            pInput[Byte + 1U] = (Random() % 4U == 0) ? 0xffU : (uint8_t)Random();
+        }
+        break;
+    default:    /** frames, damaged */
+        for(uint32_t Frames = 1U + Random() % MAX_FRAMES_PER_INPUT ; Frames != 0 ; Frames--)
+        {
+            Size += AddFrame(&pInput[Size]);
+        }
+        for(uint32_t Mutations = Random() % (MAX_MUTATIONS + 1U) ; Mutations != 0 ; Mutations--)
+        {
+            Size = Mutate(pInput, Size);
+        }
+        break;
+    }
+    return Size;
+}
+
+/**
+ * Feeds one input and checks the protocol, then reads everything back and
+ * feeds valid frames with the sequence bits 0, 1, 0. The end of the input
+ * can take the first one with it, whatever the receiver expects one of the
+ * other two must come out intact.
+ */
+static bool RunOne(const uint8_t * pInput, size_t Size, const char ** pWhy)
+{
+    uint8_t Canary[3U * FUZZ_FRAME_SIZE];
+    char    Last[NUMBER_OF_DATA];
+    bool    isOk = false;
+    FuzzTarget_Feed(pInput, Size);
+    if(FuzzTarget_Check(pWhy))
+    {
+        (void)FuzzTarget_Drain(NULL);
+        for(uint8_t Frame = 0 ; Frame < 3U ; Frame++)
+        {
+            FuzzTarget_BuildFrame(&Canary[Frame * FUZZ_FRAME_SIZE],
+                                  (uint8_t)((PROTOCOL_CHANNEL_CONTROL << 4) | ((Frame & 1U) << 3)),
+                                  NUMBER_OF_DATA, CanaryPayload);
+        }
+        FuzzTarget_Feed(Canary, sizeof(Canary));
+        if(!FuzzTarget_Check(pWhy))
+        {
+            /* No thing */
+        }
+        else if(FuzzTarget_Drain(Last) == 0 ||
+                memcmp(Last, CanaryPayload, NUMBER_OF_DATA) != 0)
+        {
+            *pWhy = "valid frames lost after the input, the receiver did not resynchronise";
+        }
+        else
+        {
+            isOk = true;
+        }
+    }
+    else
+    {
+        /* No thing */
+    }
+    return isOk;
+}
+
+static void SaveInput(const uint8_t * pInput, size_t Size, uint32_t Seed, uint32_t Iteration)
+{
+    char Path[64];
+    snprintf(Path, sizeof(Path), "crash-%u-%u.bin", Seed, Iteration);
+    FILE * pFile = fopen(Path, "wb");
+    if(pFile != NULL)
+    {
+        fwrite(pInput, 1, Size, pFile);
+        fclose(pFile);
+        fprintf(stderr, "input saved to %s\n", Path);
+    }
+    else
+    {
+        fprintf(stderr, "cannot save the input to %s\n", Path);
+    }
+}
+
+static bool ReplayFile(const char * pPath)
+{
+    static uint8_t Replay[64U * 1024U];
+    const char * pWhy = NULL;
+    bool isOk = false;
+    FILE * pFile = fopen(pPath, "rb");
+    if(pFile == NULL)
+    {
+        fprintf(stderr, "cannot open %s\n", pPath);
+    }
+    else
+    {
+        size_t Size = fread(Replay, 1, sizeof(Replay), pFile);
+        fclose(pFile);
+        FuzzTarget_Reset();
+        isOk = RunOne(Replay, Size, &pWhy);
+        printf("%s: %zu bytes, %s\n", pPath, Size, isOk ? "ok" : pWhy);
+    }
+    return isOk;
+}
+
+static void PrintTiming(void)
+{
+    const FuzzTarget_Stats_t * pStats = FuzzTarget_GetStats();
+    printf("\n%llu bytes fed, %llu messages received, %llu frames sent back\n",
+           (unsigned long long)pStats->Bytes, (unsigned long long)pStats->Messages,
+           (unsigned long long)pStats->Frames);
+    printf("%-8s %12s %10s %10s %10s   (%s per callback)\n",
+           "segment", "callbacks", "mean", "p99.9", "worst", TIMER_UNIT);
+    for(uint8_t Kind = 0 ; Kind < _FUZZ_SEGMENT_KINDS_NUM ; Kind++)
+    {
+        const FuzzTarget_Timing_t * pTiming = &pStats->Timing[Kind];
+        printf("%-8s %12llu %10.1f %10llu %10llu\n",
+               FuzzTarget_KindName((FuzzTarget_SegmentKind_t)Kind),
+               (unsigned long long)pTiming->Calls,
+               (pTiming->Calls != 0) ? (double)pTiming->TotalTicks / (double)pTiming->Calls : 0.0,
+               (unsigned long long)FuzzTarget_Percentile(pTiming, 999U),
+               (unsigned long long)pTiming->WorstTicks);
+    }
+}
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+#ifdef FUZZ_LIBFUZZER
+
+/** Entry point of libFuzzer, see README.md. */
+int LLVMFuzzerTestOneInput(const uint8_t * pData, size_t Size)
+{
+    static bool isInitialised = false;
+    const char * pWhy = NULL;
+    if(!isInitialised)
+    {
+        FuzzTarget_Init();
+        isInitialised = true;
+    }
+    else
+    {
+        FuzzTarget_Reset();
+    }
+    if(!RunOne(pData, Size, &pWhy))
+    {
+        fprintf(stderr, "%s\n", pWhy);
+        abort();
+    }
+    return 0;
+}
+
+#else
+
+int main(int argc, char * argv[])
+{
+    uint32_t Iterations = DEFAULT_ITERATIONS;
+    uint32_t Seed = 1;
+    int Option;
+    int RET_Status = EXIT_SUCCESS;
+
+    while((Option = getopt(argc, argv, "n:s:")) != -1)
+    {
+        if(Option == 'n')
+        {
+            Iterations = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else if(Option == 's')
+        {
+            Seed = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-n iterations] [-s seed] [input files...]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    FuzzTarget_Init();
+    if(optind < argc)
+    {
+        for(int File = optind ; File < argc ; File++)
+        {
+            RET_Status = ReplayFile(argv[File]) ? RET_Status : EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        RandomState = (Seed != 0) ? Seed : 1U;
+        printf("fuzzing %u inputs, seed %u\n", Iterations, Seed);
+        for(uint32_t Iteration = 0 ; Iteration < Iterations ; Iteration++)
+        {
+            const char * pWhy = NULL;
+            size_t Size = Generate(Input);
+            if(Iteration % RESET_PERIOD == 0)
+            {
+                FuzzTarget_Reset();
+            }
+            else
+            {
+                /* No thing */
+            }
+            if(!RunOne(Input, Size, &pWhy))
+            {
+                fprintf(stderr, "input %u: %s\n", Iteration, pWhy);
+                SaveInput(Input, Size, Seed, Iteration);
+                RET_Status = EXIT_FAILURE;
+                break;
+            }
+            else
+            {
+                /* No thing */
+            }
+        }
+    }
+    PrintTiming();
+    return RET_Status;
+}
+
+#endif /* FUZZ_LIBFUZZER */
+
+/******************************************************************************/
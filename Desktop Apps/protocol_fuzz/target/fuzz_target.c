@@ -0,0 +1,392 @@
+/******************************************************************************/
+/**
+ * @file fuzz_target.c
+ * @brief Receive path of the control protocol driven byte by byte.
+ *
+ * @par Project Name
+ * Control Protocol Fuzzer
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Includes the firmware ControlProtocol.c and protocol_buffer.c so their
+ * private state can be checked, and implements the transport contract
+ * (protocol_physical__layer.h) on top of memory. The receive callback is
+ * timed with the time stamp counter of the host.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include "ControlProtocol.c"
+#include "protocol_buffer.c"
+#include "fuzz_target.h"
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE MACROS */
+/******************************************************************************/
+
+#define IS_IN_SEGMENT(DATA, LEN)                                             \
+    ((DATA) >= (char*)&SegmentReceived && (LEN) != 0 &&                       \
+     (DATA) + (LEN) <= (char*)&SegmentReceived + sizeof(SegmentReceived))
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+static void (*RxCallBack)(void);
+static void (*TxCallBack)(void);
+
+/** Reception armed by HardWare_Receive */
+static char *  pArmed;
+static uint8_t ArmedLen;
+static uint8_t ArmedFill;
+
+static bool isTxPending;
+/** First transport misuse seen since the last reset */
+static const char * pTransportError;
+
+static uint64_t TimerOverhead;
+static FuzzTarget_Stats_t Stats;
+
+static const char * const KindNames[_FUZZ_SEGMENT_KINDS_NUM] =
+{
+    [FUZZ_SEGMENT_START]   = "start",
+    [FUZZ_SEGMENT_BODY]    = "body",
+    [FUZZ_SEGMENT_END]     = "end",
+    [FUZZ_SEGMENT_DROPPED] = "dropped",
+};
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION PROTOTYPES */
+/******************************************************************************/
+static inline uint64_t ReadTimer(void);
+static FuzzTarget_SegmentKind_t Classify(void);
+static void CompleteTransmit(void);
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+static inline uint64_t ReadTimer(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    return __rdtsc();
+#else
+    struct timespec Now;
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (uint64_t)Now.tv_sec * 1000000000ULL + (uint64_t)Now.tv_nsec;
+#endif
+}
+
+/** Same decision as ProtocolReceiveCallBack, taken before it runs. */
+static FuzzTarget_SegmentKind_t Classify(void)
+{
+    FuzzTarget_SegmentKind_t Kind = FUZZ_SEGMENT_BODY;
+    if(SegmentReceived.order == START_FRAME_SEG && SegmentReceived.data == 0xff)
+    {
+        Kind = FUZZ_SEGMENT_START;
+    }
+    else if(!receivedMsg.isStartSent || SegmentReceived.order != receivedMsg.NextOrder)
+    {
+        Kind = FUZZ_SEGMENT_DROPPED;
+    }
+    else if(SegmentReceived.order == END_FRAME_SEG)
+    {
+        Kind = FUZZ_SEGMENT_END;
+    }
+    else
+    {
+        /* No thing */
+    }
+    return Kind;
+}
+
+/** Frames sent by the protocol leave the wire at once. */
+static void CompleteTransmit(void)
+{
+    while(isTxPending)
+    {
+        isTxPending = false;
+        TxCallBack();
+    }
+}
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+void HardWare_Init(void (*CallBack)(void), void (*TransmitCallBack)(void))
+{
+    RxCallBack = CallBack;
+    TxCallBack = TransmitCallBack;
+}
+
+void HardWare_Send(char * data, uint8_t len)
+{
+    if(isTxPending)
+    {
+        pTransportError = "HardWare_Send called while a frame is being sent";
+    }
+    else if(len != FRAME_SIZE ||
+            (data != (char*)&messageToSend && data != (char*)&controlFrame))
+    {
+        pTransportError = "HardWare_Send called with a wrong buffer";
+    }
+    else
+    {
+        isTxPending = true;
+        Stats.Frames++;
+    }
+}
+
+void HardWare_Receive(char * data, uint8_t len)
+{
+    if(IS_IN_SEGMENT(data, len))
+    {
+        pArmed    = data;
+        ArmedLen  = len;
+        ArmedFill = 0;
+    }
+    else
+    {
+        pTransportError = "HardWare_Receive armed outside SegmentReceived";
+        pArmed = NULL;
+    }
+}
+
+/** Callbacks run from FuzzTarget_Feed only, nothing to mask. */
+void HardWare_Lock(void)
+{
+}
+
+void HardWare_Unlock(void)
+{
+}
+
+void FuzzTarget_Init(void)
+{
+    TimerOverhead = UINT64_MAX;
+    for(uint32_t Try = 0 ; Try < 1000 ; Try++)
+    {
+        uint64_t Start = ReadTimer();
+        uint64_t Ticks = ReadTimer() - Start;
+        TimerOverhead = (Ticks < TimerOverhead) ? Ticks : TimerOverhead;
+    }
+    memset(&Stats, 0, sizeof(Stats));
+    FuzzTarget_Reset();
+}
+
+void FuzzTarget_Reset(void)
+{
+    pArmed = NULL;
+    isTxPending = false;
+    pTransportError = NULL;
+    Protocol_Init();
+}
+
+void FuzzTarget_Feed(const uint8_t * pData, size_t Size)
+{
+    for(size_t Byte = 0 ; Byte < Size && pTransportError == NULL ; Byte++)
+    {
+        Stats.Bytes++;
+        if(pArmed == NULL)
+        {
+            pTransportError = "no reception armed, bytes are lost";
+        }
+        else
+        {
+            pArmed[ArmedFill++] = (char)pData[Byte];
+            if(ArmedFill == ArmedLen)
+            {
+                FuzzTarget_SegmentKind_t Kind = Classify();
+                FuzzTarget_Timing_t * pTiming = &Stats.Timing[Kind];
+                pArmed = NULL;
+                uint64_t Start = ReadTimer();
+                RxCallBack();
+                uint64_t Ticks = ReadTimer() - Start;
+                Ticks = (Ticks > TimerOverhead) ? Ticks - TimerOverhead : 0;
+                pTiming->Calls++;
+                pTiming->TotalTicks += Ticks;
+                pTiming->WorstTicks = (Ticks > pTiming->WorstTicks) ? Ticks : pTiming->WorstTicks;
+                pTiming->Histogram[(Ticks / FUZZ_TIMING_BUCKET_TICKS < FUZZ_TIMING_BUCKETS)
+                                   ? Ticks / FUZZ_TIMING_BUCKET_TICKS
+                                   : FUZZ_TIMING_BUCKETS - 1U]++;
+                CompleteTransmit();
+            }
+            else
+            {
+                /* No thing */
+            }
+        }
+    }
+}
+
+bool FuzzTarget_Check(const char ** pWhy)
+{
+    const char * pError = pTransportError;
+    uint32_t Owned = (pRxBuffer != NULL) ? 1U : 0U;
+    for(uint8_t Channel = 0 ; Channel < _PROTOCOL_CHANNELS_NUM && pError == NULL ; Channel++)
+    {
+        const MsgQueue_t * pQueues[2] = { &RxQueues[Channel], &TxQueues[Channel] };
+        if(RxQueues[Channel].Count > ProtocolChannels[Channel].RxQueueDepth ||
+           TxQueues[Channel].Count > ProtocolChannels[Channel].TxQueueDepth)
+        {
+            pError = "queue count above the configured depth";
+        }
+        else if(TxCredits[Channel] > ProtocolChannels[Channel].RxQueueDepth ||
+                (RxSequence[Channel] > 1U && RxSequence[Channel] != SEQUENCE_ANY))
+        {
+            pError = "credits or sequence out of range";
+        }
+        else
+        {
+            /* No thing */
+        }
+        for(uint8_t Queue = 0 ; Queue < 2 && pError == NULL ; Queue++)
+        {
+            const MsgQueue_t * pQueue = pQueues[Queue];
+            Owned += pQueue->Count;
+            if(pQueue->Head >= PROTOCOL_MAX_QUEUE_DEPTH)
+            {
+                pError = "queue head out of range";
+            }
+            else
+            {
+                /* No thing */
+            }
+            for(uint8_t Slot = 0 ; Slot < pQueue->Count && pError == NULL ; Slot++)
+            {
+                const Protocol_Buffer_t * pBuffer =
+                    pQueue->Slot[(pQueue->Head + Slot) % PROTOCOL_MAX_QUEUE_DEPTH];
+                if(!IS_POOL_BUFFER(pBuffer) || pBuffer->RefCount == 0)
+                {
+                    pError = "queued buffer not allocated from the pool";
+                }
+                else if(pBuffer->Msg.len > NUMBER_OF_DATA || pBuffer->Msg.Channel != Channel)
+                {
+                    pError = "queued message with a wrong length or channel";
+                }
+                else
+                {
+                    /* No thing */
+                }
+            }
+        }
+    }
+    if(pError != NULL)
+    {
+        /* No thing */
+    }
+    else if(PROTOCOL_BUFFER_POOL_SIZE - FreeCount != Owned)
+    {
+        pError = "buffers leaked or released twice";
+    }
+    else if(receivedMsg.NextOrder > END_FRAME_SEG)
+    {
+        pError = "next segment order out of the frame";
+    }
+    else if(pRxPayload != RxScratch &&
+            (pRxBuffer == NULL || pRxPayload != pRxBuffer->Msg.pMessage))
+    {
+        pError = "payload written outside the receive buffer";
+    }
+    else if(pArmed == NULL)
+    {
+        pError = "no reception armed after the callback";
+    }
+    else
+    {
+        /* No thing */
+    }
+    if(pWhy != NULL)
+    {
+        *pWhy = pError;
+    }
+    return (pError == NULL);
+}
+
+uint32_t FuzzTarget_Drain(char * pLast)
+{
+    uint32_t Messages = 0;
+    Message_t Msg;
+    for(uint8_t Channel = 0 ; Channel < _PROTOCOL_CHANNELS_NUM ; Channel++)
+    {
+        while(Protocol_Read(Channel, &Msg) == PROTOCOL_OK)
+        {
+            Messages++;
+            if(pLast != NULL)
+            {
+                memcpy(pLast, Msg.pMessage, NUMBER_OF_DATA);
+            }
+        }
+    }
+    CompleteTransmit();
+    Stats.Messages += Messages;
+    return Messages;
+}
+
+void FuzzTarget_BuildFrame(uint8_t * pFrame, uint8_t Type, uint8_t Len,
+                           const uint8_t * pPayload)
+{
+    uint8_t CheckSum = 0;
+    for(uint8_t Segment = 0 ; Segment < FRAME_SIZE_IN_SEGMENTS ; Segment++)
+    {
+        pFrame[2U * Segment] = Segment;
+    }
+    pFrame[2U * START_FRAME_SEG + 1U] = 0xff;
+    pFrame[2U * DATA_TYPE_SEG + 1U]   = Type;
+    pFrame[2U * DATA_LEN_SEG + 1U]    = Len;
+    for(uint8_t Data = 0 ; Data < NUMBER_OF_DATA ; Data++)
+    {
+        pFrame[2U * (FIRST_DATA_SEG + Data) + 1U] = pPayload[Data];
+        CheckSum += pPayload[Data];
+    }
+    pFrame[2U * CHECKSUM_SEG + 1U]  = CheckSum;
+    pFrame[2U * END_FRAME_SEG + 1U] = 0xff;
+}
+
+const FuzzTarget_Stats_t * FuzzTarget_GetStats(void)
+{
+    return &Stats;
+}
+
+uint64_t FuzzTarget_Percentile(const FuzzTarget_Timing_t * pTiming, uint16_t PerMille)
+{
+    uint64_t Wanted = (pTiming->Calls * PerMille + 999U) / 1000U;
+    uint64_t Seen = 0;
+    uint32_t Bucket = 0;
+    for( ; Bucket < FUZZ_TIMING_BUCKETS - 1U ; Bucket++)
+    {
+        Seen += pTiming->Histogram[Bucket];
+        if(Seen >= Wanted)
+        {
+            break;
+        }
+    }
+    return (uint64_t)(Bucket + 1U) * FUZZ_TIMING_BUCKET_TICKS;
+}
+
+const char * FuzzTarget_KindName(FuzzTarget_SegmentKind_t Kind)
+{
+    return (Kind < _FUZZ_SEGMENT_KINDS_NUM) ? KindNames[Kind] : "?";
+}
+
+/******************************************************************************/
@@ -0,0 +1,179 @@
+/*******************************************************************************/
+/**
+ * @file fuzz_target.h
+ * @brief Receive path of the control protocol driven byte by byte.
+ *
+ * @par Project Name
+ * Control Protocol Fuzzer
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Wraps the firmware ControlProtocol.c behind a transport which takes its
+ * bytes from memory. Every callback of the receive path is timed and the
+ * internal state of the protocol is checked against its invariants.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ ******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef FUZZ_TARGET_H_
+#define FUZZ_TARGET_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC DEFINES */
+/******************************************************************************/
+
+/** Bytes of one frame on the wire. */
+#define FUZZ_FRAME_SIZE                 (26U)
+
+/** Callback times are counted in buckets of this many timer ticks */
+#define FUZZ_TIMING_BUCKET_TICKS        (8U)
+#define FUZZ_TIMING_BUCKETS             (1024U)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC ENUMS */
+/******************************************************************************/
+
+/**
+ * @brief What the receive callback did with a segment.
+ * @note _FUZZ_SEGMENT_KINDS_NUM must stay the last element.
+ */
+typedef enum
+{
+    FUZZ_SEGMENT_START,     /**< Start of a frame */
+    FUZZ_SEGMENT_BODY,      /**< Type, length, payload or checksum */
+    FUZZ_SEGMENT_END,       /**< End of a frame, the frame is processed */
+    FUZZ_SEGMENT_DROPPED,   /**< Outside a frame or out of order */
+    _FUZZ_SEGMENT_KINDS_NUM
+} FuzzTarget_SegmentKind_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC TYPES */
+/******************************************************************************/
+
+/** Time spent in the receive callback for one kind of segment. */
+typedef struct
+{
+    uint64_t Calls;
+    uint64_t TotalTicks;
+    uint64_t WorstTicks;
+    /** Calls per time bucket, the last one also counts the longer calls */
+    uint64_t Histogram[FUZZ_TIMING_BUCKETS];
+} FuzzTarget_Timing_t;
+
+/** Counters kept since FuzzTarget_Init. */
+typedef struct
+{
+    FuzzTarget_Timing_t Timing[_FUZZ_SEGMENT_KINDS_NUM];
+    uint64_t Bytes;         /**< Bytes fed */
+    uint64_t Frames;        /**< Frames sent back (ACK, NACK, CREDIT) */
+    uint64_t Messages;      /**< Messages read back by FuzzTarget_Drain */
+} FuzzTarget_Stats_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION PROTOTYPES */
+/******************************************************************************/
+
+/** @brief Calibrates the timer and clears the counters. */
+void FuzzTarget_Init(void);
+
+/** @brief Starts the protocol again from Protocol_Init. */
+void FuzzTarget_Reset(void);
+
+/**
+ * @brief Delivers bytes to the receive path.
+ *
+ * The bytes fill the buffer armed by HardWare_Receive, the receive callback
+ * runs each time it is full, exactly as the DMA interrupt runs it on target.
+ * Frames sent by the protocol complete before the next byte.
+ */
+void FuzzTarget_Feed(const uint8_t * pData, size_t Size);
+
+/**
+ * @brief Checks the internal state of the protocol.
+ * @param[out] pWhy Set to the broken invariant, may be NULL.
+ * @return true when every invariant holds.
+ */
+bool FuzzTarget_Check(const char ** pWhy);
+
+/**
+ * @brief Reads every message waiting on every channel.
+ * @param[out] pLast Copy of the last payload read, NUMBER_OF_DATA bytes,
+ *                   may be NULL.
+ * @return Number of messages read.
+ */
+uint32_t FuzzTarget_Drain(char * pLast);
+
+/**
+ * @brief Builds a frame as the protocol puts it on the wire.
+ * @param[out] pFrame   FUZZ_FRAME_SIZE bytes.
+ * @param[in]  Type     Type segment, channel, sequence bit and message type.
+ * @param[in]  Len      Length segment, above NUMBER_OF_DATA for control frames.
+ * @param[in]  pPayload NUMBER_OF_DATA bytes.
+ */
+void FuzzTarget_BuildFrame(uint8_t * pFrame, uint8_t Type, uint8_t Len,
+                           const uint8_t * pPayload);
+
+/** @brief Returns the counters kept since FuzzTarget_Init. */
+const FuzzTarget_Stats_t * FuzzTarget_GetStats(void);
+
+/**
+ * @brief Time under which a share of the calls of one kind returned.
+ *
+ * Unlike the worst time it does not move with the interrupts and the
+ * preemption of the host.
+ *
+ * @param[in] pTiming  Timing of one segment kind.
+ * @param[in] PerMille Share of the calls, 999 for the 99.9th percentile.
+ * @return Upper bound of the bucket, in timer ticks.
+ */
+uint64_t FuzzTarget_Percentile(const FuzzTarget_Timing_t * pTiming, uint16_t PerMille);
+
+/** @brief Returns the name of a segment kind. */
+const char * FuzzTarget_KindName(FuzzTarget_SegmentKind_t Kind);
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* FUZZ_TARGET_H_ */
+/******************************************************************************/
@@ -0,0 +1,427 @@
+/******************************************************************************/
+/**
+ * @file checks.c
+ * @brief Checks of the dispatch order and of the pool of the scheduler.
+ *
+ * @par Project Name
+ * Scheduler Bench
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Runs the scheduler of sizes/sched_check.c, every callback logs which
+ * runnable ran at which tick. The log must show the ready runnable of the
+ * highest priority running first, the runnables of the same priority
+ * keeping the order of the table, and after an overrun the releases missed
+ * by the high priority runnables served before the lower ones.
+ *
+ * The pool check then adds, removes, suspends, resumes and changes the
+ * period of random runnables while the ticks run, checking the state of
+ * the scheduler after each call and the period between two runs.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+
+/* The pool calls of the scheduler built by sched_check.c */
+#define schedular_AddRunnable           schedular_AddRunnable_40
+#define schedular_RemoveRunnable        schedular_RemoveRunnable_40
+#define schedular_SuspendRunnable       schedular_SuspendRunnable_40
+#define schedular_ResumeRunnable        schedular_ResumeRunnable_40
+#define schedular_SetPeriod             schedular_SetPeriod_40
+#include "schedular.h"
+#define MAX_RUNNABLES                   CHECK_RUNNABLES
+#include "schedular_CFG.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+
+/** Ticks of the dispatch order check. */
+#define ORDER_TICKS                     (200U)
+
+/** The runnable of every tick overruns at this call ... */
+#define ORDER_OVERRUN_CALL              (10U)
+
+/** ... by this many ticks, more than the period of the switches. */
+#define ORDER_OVERRUN_TICKS             (7U)
+
+#define ORDER_LOG_SIZE                  (ORDER_TICKS * 8U)
+
+/** One call to the pool every this many ticks on average. */
+#define POOL_CALL_TICKS                 (50)
+
+#define POOL_PRIORITIES                 (5)
+
+/** Periods drawn below this many ticks, or below POOL_LONG_PERIOD. */
+#define POOL_SHORT_PERIOD               (20)
+
+/** Far beyond one turn of the wheel, to go through its far level. */
+#define POOL_LONG_PERIOD                (9000)
+
+#define POOL_MAX_DELAY                  (30)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE TYPES */
+/******************************************************************************/
+
+typedef struct
+{
+    uint32_t Runnable;
+    uint32_t Tick;
+} CheckRun_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+
+/** Priorities of the table of sched_check.c, -1 for the free slots. */
+static const int32_t OrderPriority[] = { 2, 0, 1, 1, -1, 0 };
+
+static CheckRun_t OrderLog[ORDER_LOG_SIZE];
+static uint32_t OrderLogLength;
+
+/** First entry of the log not compared with the previous one. */
+static uint32_t OrderBatchStart;
+
+/** Entry of the log which follows the overrun. */
+static uint32_t OrderOverrunEntry;
+
+static uint32_t OrderCalls[CHECK_RUNNABLES];
+
+/** Handle of the runnable calling Check_Runnable_<n>, valid when added. */
+static uint32_t PoolHandle[CHECK_RUNNABLES];
+static uint8_t PoolAdded[CHECK_RUNNABLES];
+
+/** Tick of the last run, 0 when the period is not checked from it. */
+static uint32_t PoolLastRun[CHECK_RUNNABLES];
+
+static uint64_t PoolRuns;
+static uint32_t PoolCalls;
+
+/** Rules broken by the runs. */
+static uint32_t CheckFailed;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+static void CheckFail(const char * pRule, uint32_t Runnable)
+{
+    if(CheckFailed < 10U)
+    {
+        printf("check failed at tick %lu, runnable %lu: %s\n",
+               (unsigned long)Bench_WheelTime_40(), (unsigned long)Runnable, pRule);
+    }
+    else
+    {
+        /* No thing */
+    }
+    CheckFailed++;
+}
+
+/** Logs a run of the dispatch order check and plays the overrun. */
+static void OrderRun(uint32_t Runnable)
+{
+    if(Bench_IsHigherReady_40(Runnable))
+    {
+        CheckFail("a runnable of a higher priority is ready", Runnable);
+    }
+    else
+    {
+        /* No thing */
+    }
+    if(OrderLogLength < ORDER_LOG_SIZE)
+    {
+        OrderLog[OrderLogLength].Runnable = Runnable;
+        OrderLog[OrderLogLength].Tick = Bench_WheelTime_40();
+        OrderLogLength++;
+    }
+    else
+    {
+        /* No thing */
+    }
+    OrderCalls[Runnable]++;
+    if((Runnable == 0) && (OrderCalls[Runnable] == ORDER_OVERRUN_CALL))
+    {
+        for(uint32_t Tick = 0 ; Tick < ORDER_OVERRUN_TICKS ; Tick++)
+        {
+            Bench_Interrupt_40();
+        }
+        /** The runs which follow were released after this one */
+        OrderBatchStart = OrderLogLength;
+        OrderOverrunEntry = OrderLogLength;
+    }
+    else
+    {
+        /* No thing */
+    }
+}
+
+static void PoolCall(void);
+
+/** Checks the period between two runs of a runnable of the pool. */
+static void PoolRun(uint32_t Callback)
+{
+    uint32_t Now = Bench_WheelTime_40();
+    uint32_t Handle = PoolHandle[Callback];
+
+    if(!PoolAdded[Callback])
+    {
+        CheckFail("a removed runnable ran", Callback);
+    }
+    else if((PoolLastRun[Callback] != 0) &&
+            ((Now - PoolLastRun[Callback]) != Bench_PeriodTicks_40(Handle)))
+    {
+        CheckFail("run out of its period", Handle);
+    }
+    else
+    {
+        /* No thing */
+    }
+    PoolLastRun[Callback] = Now;
+    PoolRuns++;
+    /** The pool is also called by runnables, others may be ready then */
+    if((rand() % POOL_CALL_TICKS) == 0)
+    {
+        PoolCall();
+    }
+    else
+    {
+        /* No thing */
+    }
+}
+
+/** Calls the pool with a random runnable, the way a runnable would. */
+static void PoolCall(void)
+{
+    uint32_t Callback = (uint32_t)rand() % CHECK_RUNNABLES;
+    uint32_t Handle = PoolHandle[Callback];
+    uint32_t Call = (uint32_t)rand() % 4U;
+    Schedular_ErrorStatus_t Status = SCHEDULAR_OK;
+    Schedular_runnable_t Runnable =
+    {
+        .name = "pool",
+        .CallBack = Check_Callbacks[Callback]
+    };
+
+    /** The next run follows the call, not the previous period */
+    PoolLastRun[Callback] = 0;
+    if(!PoolAdded[Callback])
+    {
+        Runnable.priority = (uint32_t)rand() % POOL_PRIORITIES;
+        Runnable.periodicityMS = (1U + ((uint32_t)rand() %
+            ((rand() % 2) ? POOL_SHORT_PERIOD : POOL_LONG_PERIOD))) * TICK_TIME;
+        Runnable.DelayMS = ((uint32_t)rand() % POOL_MAX_DELAY) * TICK_TIME;
+        Status = schedular_AddRunnable(&Runnable, &PoolHandle[Callback]);
+        PoolAdded[Callback] = (Status == SCHEDULAR_OK);
+    }
+    else if(Call == 0)
+    {
+        Status = schedular_RemoveRunnable(Handle);
+        PoolAdded[Callback] = 0;
+        if(schedular_RemoveRunnable(Handle) != SCHEDULAR_NOT_OK)
+        {
+            CheckFail("removed twice", Handle);
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    else if(Call == 1)
+    {
+        Status = schedular_SuspendRunnable(Handle);
+    }
+    else if(Call == 2)
+    {
+        Status = schedular_ResumeRunnable(Handle);
+    }
+    else
+    {
+        Status = schedular_SetPeriod(Handle,
+            (1U + ((uint32_t)rand() % POOL_LONG_PERIOD)) * TICK_TIME);
+    }
+    if(Status != SCHEDULAR_OK)
+    {
+        CheckFail("pool call refused", Callback);
+    }
+    else if((Bench_CheckState_40() != 0) && (CheckFailed == 0))
+    {
+        CheckFail("scheduler state broken", Callback);
+    }
+    else
+    {
+        /* No thing */
+    }
+    PoolCalls++;
+}
+
+static void (*CheckRun)(uint32_t Runnable) = OrderRun;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+#define CHECK_DEFINE(n)                                                        \
+    void Check_Runnable_##n(void)                                              \
+    {                                                                          \
+        CheckRun(n);                                                           \
+    }
+CHECK_CALLBACKS(CHECK_DEFINE)
+
+#define CHECK_ADDRESS(n)                Check_Runnable_##n,
+void (* const Check_Callbacks[CHECK_RUNNABLES])(void) =
+{
+    CHECK_CALLBACKS(CHECK_ADDRESS)
+};
+
+uint32_t Check_DispatchOrder(void)
+{
+    const CheckRun_t * pPrev;
+    const CheckRun_t * pRun;
+    uint32_t OverrunRuns = 0;
+
+    CheckFailed = 0;
+    CheckRun = OrderRun;
+    OrderLogLength = 0;
+    OrderOverrunEntry = 0;
+    for(uint32_t Runnable = 0 ; Runnable < CHECK_RUNNABLES ; Runnable++)
+    {
+        OrderCalls[Runnable] = 0;
+    }
+
+    Bench_Init_40();
+    for(uint32_t Tick = 0 ; Tick < ORDER_TICKS ; Tick++)
+    {
+        OrderBatchStart = OrderLogLength;
+        Bench_Tick_40();
+        /** Released by the same tick, they run by priority then table order */
+        for(uint32_t Entry = OrderBatchStart + 1U ; Entry < OrderLogLength ; Entry++)
+        {
+            pPrev = &OrderLog[Entry - 1U];
+            pRun = &OrderLog[Entry];
+            if((OrderPriority[pPrev->Runnable] > OrderPriority[pRun->Runnable]) ||
+               ((OrderPriority[pPrev->Runnable] == OrderPriority[pRun->Runnable]) &&
+                (pPrev->Runnable >= pRun->Runnable)))
+            {
+                CheckFail("out of the priority and table order", pRun->Runnable);
+            }
+            else
+            {
+                /* No thing */
+            }
+        }
+        if((Bench_CheckState_40() != 0) && (CheckFailed == 0))
+        {
+            CheckFail("scheduler state broken", 0);
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+
+    /** The switches missed releases during the overrun, they run first */
+    if((OrderOverrunEntry == 0) || (OrderOverrunEntry >= OrderLogLength) ||
+       (OrderPriority[OrderLog[OrderOverrunEntry].Runnable] != 0))
+    {
+        CheckFail("a lower priority ran first after the overrun", 0);
+    }
+    else
+    {
+        /** The releases missed by the overrunning runnable are merged */
+        for(uint32_t Entry = OrderOverrunEntry ;
+            (Entry < OrderLogLength) &&
+            (OrderLog[Entry].Tick == OrderLog[OrderOverrunEntry].Tick) ; Entry++)
+        {
+            OverrunRuns += (OrderLog[Entry].Runnable == 0);
+        }
+        if(OverrunRuns != 1U)
+        {
+            CheckFail("missed releases of one runnable not merged", 0);
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    /** Released at every tick, the overrun ones once */
+    if(OrderCalls[0] != (ORDER_TICKS + 1U))
+    {
+        CheckFail("calls differ from the period", 0);
+    }
+    else
+    {
+        /* No thing */
+    }
+    printf("dispatch order: %lu runs, %lu failed checks\n",
+           (unsigned long)OrderLogLength, (unsigned long)CheckFailed);
+    return CheckFailed;
+}
+
+uint32_t Check_Pool(uint32_t Seed, uint32_t Ticks)
+{
+    Schedular_runnable_t Empty = { 0 };
+    uint32_t Handle;
+
+    CheckFailed = 0;
+    CheckRun = PoolRun;
+    PoolRuns = 0;
+    PoolCalls = 0;
+    srand(Seed);
+
+    /** The pool starts empty, the table runnables are removed */
+    Bench_Init_40();
+    for(Handle = 0 ; Handle < CHECK_RUNNABLES ; Handle++)
+    {
+        (void)schedular_RemoveRunnable(Handle);
+        PoolAdded[Handle] = 0;
+    }
+    if(schedular_AddRunnable(&Empty, &Handle) != SCHEDULAR_NULL_PTR_PASSED)
+    {
+        CheckFail("runnable without callback added", 0);
+    }
+    else
+    {
+        /* No thing */
+    }
+
+    for(uint32_t Tick = 0 ; Tick < Ticks ; Tick++)
+    {
+        Bench_Tick_40();
+        if((rand() % POOL_CALL_TICKS) == 0)
+        {
+            PoolCall();
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    printf("pool: seed %lu, %lu calls, %llu runs, %lu failed checks\n",
+           (unsigned long)Seed, (unsigned long)PoolCalls,
+           (unsigned long long)PoolRuns, (unsigned long)CheckFailed);
+    return CheckFailed;
+}
+
+/******************************************************************************/
@@ -0,0 +1,36 @@
+############################
+# Compiler Configurations  #
+############################
+
+# This variable specifies the name of the compiler that will be used to compile the project.
+CC = gcc
+
+# C_FLAGS: Compiler Flags
+# The scheduler is built with the optimisation it gets on target.
+C_FLAGS = -g -O2 -Wall
+
+# This variable stores additional flags to be passed to the linker.
+LINKER_FLAGS =
+
+###################################
+# Compiler Inputs  Configurations #
+###################################
+
+# Directories whose *.c files are all compiled.
+# sizes/ compiles ../../src/SERVICE/schedular.c once per table size, so the
+# scheduler sources must not be listed here.
+SRC_DIRECTORIES = sizes
+
+# Source files which are not located in any of the directories above.
+SRC_FILES_PATHES = main.c checks.c
+
+# Directories searched for header files. config/ comes first, its
+# schedular_CFG.h replaces the one of the firmware.
+INC_DIRECTORIES = config sizes ../../include/SERVICE ../../include/stm32f4-hal ../../src/SERVICE
+
+# Arguments given to the benchmark by the run target, for example
+# RUN_ARGS = -t 2000000
+RUN_ARGS =
+
+# Name of the produced executable.
+EXECUTABLE_FILE = schedular_bench
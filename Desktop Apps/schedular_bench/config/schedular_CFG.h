@@ -0,0 +1,46 @@
+/******************************************************************************/
+/**
+ * @file schedular_CFG.h
+ * @brief Scheduler configuration of the bench.
+ *
+ * @par Project Name
+ * Scheduler Bench
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Replaces include/SERVICE/schedular_CFG.h. MAX_RUNNABLES is given by the
+ * file of sizes/ which includes the scheduler, the rest follows the
+ * firmware configuration.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+#ifndef SCHEDULAR_BENCH_CFG_H_
+#define SCHEDULAR_BENCH_CFG_H_
+
+#define      SYS_CLK                 16000000
+
+#define      TICK_TIME               1
+
+#ifndef MAX_RUNNABLES
+#error "MAX_RUNNABLES is defined by the file of sizes/"
+#endif
+
+#define      SCHEDULAR_WHEEL_BITS    6
+
+/** The host has no SysTick to stretch, the bench plays every tick. */
+#define      SCHEDULAR_TICKLESS_IDLE 0
+
+/** The host has no cycle counter, the bench times the ticks itself. */
+#define      SCHEDULAR_ENABLE_STATS  0
+
+#define      PRIORITY_0              0
+
+#define      PRIORITY_1              1
+
+#endif /* SCHEDULAR_BENCH_CFG_H_ */
@@ -0,0 +1,265 @@
+/******************************************************************************/
+/**
+ * @file main.c
+ * @brief Tick cost of the scheduler against the size of its table.
+ *
+ * @par Project Name
+ * Scheduler Bench
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Runs the scheduler of src/SERVICE/schedular.c with tables of 2, 16, 64
+ * and 256 runnables, one of them due every BENCH_PERIOD_FACTOR ticks in
+ * all of them. Reports the time of one tick, release and dispatch included,
+ * next to the table scan the scheduler used before the timer wheel, and
+ * checks every runnable ran as many times as its period gives. The checks
+ * of checks.c run first.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "bench.h"
+#include "stm32f4xx_systick.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+
+#define DEFAULT_TICKS                   (1000000UL)
+
+/** Ticks of the random calls to the pool. */
+#define POOL_TICKS                      (200000UL)
+
+#define DEFAULT_SEED                    (1UL)
+
+#define MAX_SIZE                        (256U)
+
+#define NS_PER_S                        (1000000000ULL)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE TYPES */
+/******************************************************************************/
+
+typedef struct
+{
+    uint32_t Runnables;
+    void (*Init)(void);
+    void (*Tick)(void);
+} BenchSize_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+
+static const BenchSize_t Sizes[] =
+{
+    {   2, Bench_Init_2,   Bench_Tick_2   },
+    {  16, Bench_Init_16,  Bench_Tick_16  },
+    {  64, Bench_Init_64,  Bench_Tick_64  },
+    { 256, Bench_Init_256, Bench_Tick_256 },
+};
+
+static volatile uint64_t Calls;
+
+/** Remaining time of each runnable in the table scan model. */
+static uint32_t ScanRemaining[MAX_SIZE];
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+static uint64_t NowNs(void)
+{
+    struct timespec Now;
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return ((uint64_t)Now.tv_sec * NS_PER_S) + (uint64_t)Now.tv_nsec;
+}
+
+/** Calls the runnables of a table of Runnables must make in Ticks ticks. */
+static uint64_t ExpectedCalls(uint32_t Runnables, uint32_t Ticks)
+{
+    uint64_t Expected = 0;
+    uint32_t Period = BENCH_PERIOD_FACTOR * Runnables;
+    uint32_t First;
+
+    for(uint32_t Runnable = 0; Runnable < Runnables; Runnable++)
+    {
+        First = (BENCH_PERIOD_FACTOR * Runnable) + 1;
+        if(First <= Ticks)
+        {
+            Expected += ((Ticks - First) / Period) + 1;
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    return Expected;
+}
+
+/**
+ * Scheduler before the timer wheel: every tick decrements the remaining
+ * time of every runnable and runs the ones at zero.
+ */
+static void ScanInit(uint32_t Runnables)
+{
+    for(uint32_t Runnable = 0; Runnable < Runnables; Runnable++)
+    {
+        ScanRemaining[Runnable] = BENCH_PERIOD_FACTOR * Runnable;
+    }
+}
+
+static void ScanTick(uint32_t Runnables)
+{
+    for(uint32_t Runnable = 0; Runnable < Runnables; Runnable++)
+    {
+        if(ScanRemaining[Runnable] == 0)
+        {
+            Bench_Runnable();
+            ScanRemaining[Runnable] = BENCH_PERIOD_FACTOR * Runnables;
+        }
+        else
+        {
+            /* No thing */
+        }
+        ScanRemaining[Runnable]--;
+    }
+}
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+void Bench_Runnable(void)
+{
+    Calls++;
+}
+
+/** The scheduler configures SysTick, the bench plays the ticks itself. */
+SysTick_ErrorStatus_t SysTick_Config(SysTick_CFG_t * SysTickCFG)
+{
+    (void)SysTickCFG;
+    return SYSTICK_OK;
+}
+
+SysTick_ErrorStatus_t SysTick_SetTimeMS(uint32_t Time)
+{
+    (void)Time;
+    return SYSTICK_OK;
+}
+
+SysTick_ErrorStatus_t SysTick_Start(void)
+{
+    return SYSTICK_OK;
+}
+
+SysTick_ErrorStatus_t SysTick_SetCallback(SysTickCB_t pCallBackFunction)
+{
+    (void)pCallBackFunction;
+    return SYSTICK_OK;
+}
+
+int main(int argc, char * argv[])
+{
+    uint32_t Ticks = DEFAULT_TICKS;
+    uint32_t Seed = DEFAULT_SEED;
+    uint32_t Failed = 0;
+    uint64_t Start;
+    uint64_t WheelNs;
+    uint64_t ScanNs;
+    uint64_t WheelCalls;
+    uint64_t Expected;
+    int Option;
+
+    while((Option = getopt(argc, argv, "t:s:")) != -1)
+    {
+        if(Option == 't')
+        {
+            Ticks = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else if(Option == 's')
+        {
+            Seed = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-t ticks] [-s seed]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if(Ticks == 0)
+    {
+        fprintf(stderr, "ticks must not be 0\n");
+        return EXIT_FAILURE;
+    }
+    else
+    {
+        /* No thing */
+    }
+
+    Failed += Check_DispatchOrder();
+    Failed += Check_Pool(Seed, POOL_TICKS);
+
+    printf("\n%lu ticks per size, one runnable due every %u ticks\n\n",
+           (unsigned long)Ticks, BENCH_PERIOD_FACTOR);
+    printf("%9s %10s %10s %13s %12s\n",
+           "runnables", "calls", "expected", "wheel ns/tick", "scan ns/tick");
+    for(size_t Size = 0; Size < sizeof(Sizes) / sizeof(Sizes[0]); Size++)
+    {
+        Calls = 0;
+        Sizes[Size].Init();
+        Start = NowNs();
+        for(uint32_t Tick = 0; Tick < Ticks; Tick++)
+        {
+            Sizes[Size].Tick();
+        }
+        WheelNs = NowNs() - Start;
+        WheelCalls = Calls;
+
+        ScanInit(Sizes[Size].Runnables);
+        Start = NowNs();
+        for(uint32_t Tick = 0; Tick < Ticks; Tick++)
+        {
+            ScanTick(Sizes[Size].Runnables);
+        }
+        ScanNs = NowNs() - Start;
+
+        Expected = ExpectedCalls(Sizes[Size].Runnables, Ticks);
+        if(WheelCalls != Expected)
+        {
+            Failed++;
+        }
+        else
+        {
+            /* No thing */
+        }
+        printf("%9u %10llu %10llu %13.1f %12.1f\n", Sizes[Size].Runnables,
+               (unsigned long long)WheelCalls, (unsigned long long)Expected,
+               (double)WheelNs / Ticks, (double)ScanNs / Ticks);
+    }
+    printf("\n%s\n", (Failed == 0) ? "PASS" : "FAIL");
+    return (Failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/******************************************************************************/
@@ -0,0 +1,83 @@
+/******************************************************************************/
+/**
+ * @file bench.h
+ * @brief Interface between the bench and the scheduler of each table size.
+ *
+ * @par Project Name
+ * Scheduler Bench
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+/** One runnable is due every this many ticks, whatever the table size. */
+#define BENCH_PERIOD_FACTOR             4
+
+/** The runnables cycle over this many priorities. */
+#define BENCH_PRIORITIES                4
+
+/** @brief Callback of every runnable, counts the calls. */
+void Bench_Runnable(void);
+
+/** Capacity of the pool of the scheduler built for the checks. */
+#define CHECK_RUNNABLES                 40
+
+/** Callbacks of the checks, Check_Runnable_<n> reports the runnable n. */
+#define CHECK_CALLBACKS(X)                                                     \
+    X(0)  X(1)  X(2)  X(3)  X(4)  X(5)  X(6)  X(7)  X(8)  X(9)                 \
+    X(10) X(11) X(12) X(13) X(14) X(15) X(16) X(17) X(18) X(19)                \
+    X(20) X(21) X(22) X(23) X(24) X(25) X(26) X(27) X(28) X(29)                \
+    X(30) X(31) X(32) X(33) X(34) X(35) X(36) X(37) X(38) X(39)
+#define CHECK_DECLARE(n)                void Check_Runnable_##n(void);
+CHECK_CALLBACKS(CHECK_DECLARE)
+extern void (* const Check_Callbacks[CHECK_RUNNABLES])(void);
+
+void Bench_Init_2(void);
+void Bench_Tick_2(void);
+void Bench_Init_16(void);
+void Bench_Tick_16(void);
+void Bench_Init_64(void);
+void Bench_Tick_64(void);
+void Bench_Init_256(void);
+void Bench_Tick_256(void);
+
+/* Scheduler of the checks, a pool of CHECK_RUNNABLES, see sched_check.c */
+void Bench_Init_40(void);
+void Bench_Tick_40(void);
+/** @brief Plays the SysTick interrupt only, a runnable calls it to overrun. */
+void Bench_Interrupt_40(void);
+/** @brief Whether a runnable of a higher rank than Handle is ready. */
+uint32_t Bench_IsHigherReady_40(uint32_t Handle);
+/** @brief Checks the wheel links, the priority order and the ready bits.
+ *  @return Number of broken rules. */
+uint32_t Bench_CheckState_40(void);
+/** @brief Ticks served by the wheel. */
+uint32_t Bench_WheelTime_40(void);
+/** @brief Period of a runnable of the pool, in ticks. */
+uint32_t Bench_PeriodTicks_40(uint32_t Handle);
+
+/**
+ * @brief Checks the dispatch order, see checks.c.
+ * @return Number of failed checks.
+ */
+uint32_t Check_DispatchOrder(void);
+
+/**
+ * @brief Calls the pool at random while the ticks run, see checks.c.
+ * @param Seed  Seed of the random calls, a failure replays with the same.
+ * @param Ticks Ticks to run.
+ * @return Number of failed checks.
+ */
+uint32_t Check_Pool(uint32_t Seed, uint32_t Ticks);
+
+#endif /* BENCH_H_ */
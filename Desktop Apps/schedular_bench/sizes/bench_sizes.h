@@ -0,0 +1,91 @@
+/******************************************************************************/
+/**
+ * @file bench_sizes.h
+ * @brief Scheduler of one table size, with its symbols renamed.
+ *
+ * @par Project Name
+ * Scheduler Bench
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Each file of sizes/ defines MAX_RUNNABLES and BENCH_TABLE, then includes
+ * this header which compiles ../../src/SERVICE/schedular.c unchanged with
+ * the public symbols suffixed by the size. It adds Bench_Init_<size> and
+ * Bench_Tick_<size>, the latter plays one SysTick interrupt and the main
+ * loop until every released runnable ran.
+ *
+ * Runnable i of a table of N runs every BENCH_PERIOD_FACTOR * N ticks,
+ * starting at tick BENCH_PERIOD_FACTOR * i + 1, so whatever the size one
+ * runnable is due every BENCH_PERIOD_FACTOR ticks.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+#ifndef BENCH_SIZES_H_
+#define BENCH_SIZES_H_
+
+#include "bench.h"
+
+#define BENCH_GLUE(NAME, SIZE)          NAME##_##SIZE
+#define BENCH_NAME(NAME, SIZE)          BENCH_GLUE(NAME, SIZE)
+
+#define schedular_init                  BENCH_NAME(schedular_init, MAX_RUNNABLES)
+#define schedular_start                 BENCH_NAME(schedular_start, MAX_RUNNABLES)
+#define schedular_GetTimeMS             BENCH_NAME(schedular_GetTimeMS, MAX_RUNNABLES)
+#define schedular_AddRunnable           BENCH_NAME(schedular_AddRunnable, MAX_RUNNABLES)
+#define schedular_RemoveRunnable        BENCH_NAME(schedular_RemoveRunnable, MAX_RUNNABLES)
+#define schedular_SuspendRunnable       BENCH_NAME(schedular_SuspendRunnable, MAX_RUNNABLES)
+#define schedular_ResumeRunnable        BENCH_NAME(schedular_ResumeRunnable, MAX_RUNNABLES)
+#define schedular_SetPeriod             BENCH_NAME(schedular_SetPeriod, MAX_RUNNABLES)
+#define schedular_GetStats              BENCH_NAME(schedular_GetStats, MAX_RUNNABLES)
+#define schedular_GetPeakPendingTicks   BENCH_NAME(schedular_GetPeakPendingTicks, MAX_RUNNABLES)
+#define schedular_ResetStats            BENCH_NAME(schedular_ResetStats, MAX_RUNNABLES)
+#define schedular_ExportStats           BENCH_NAME(schedular_ExportStats, MAX_RUNNABLES)
+#define AllRunnablesSystemList          BENCH_NAME(AllRunnablesSystemList, MAX_RUNNABLES)
+
+/** Entry i of the table */
+#define BENCH_ENTRY(i)                                                         \
+    [(i)] =                                                                    \
+    {                                                                          \
+        .name          = "bench",                                              \
+        .periodicityMS = BENCH_PERIOD_FACTOR * MAX_RUNNABLES * TICK_TIME,      \
+        .priority      = (i) % BENCH_PRIORITIES,                               \
+        .CallBack      = Bench_Runnable,                                       \
+        .DelayMS       = BENCH_PERIOD_FACTOR * (i) * TICK_TIME                 \
+    },
+#define BENCH_ENTRIES_2(i)              BENCH_ENTRY(i) BENCH_ENTRY((i) + 1)
+#define BENCH_ENTRIES_4(i)              BENCH_ENTRIES_2(i) BENCH_ENTRIES_2((i) + 2)
+#define BENCH_ENTRIES_8(i)              BENCH_ENTRIES_4(i) BENCH_ENTRIES_4((i) + 4)
+#define BENCH_ENTRIES_16(i)             BENCH_ENTRIES_8(i) BENCH_ENTRIES_8((i) + 8)
+#define BENCH_ENTRIES_32(i)             BENCH_ENTRIES_16(i) BENCH_ENTRIES_16((i) + 16)
+#define BENCH_ENTRIES_64(i)             BENCH_ENTRIES_32(i) BENCH_ENTRIES_32((i) + 32)
+#define BENCH_ENTRIES_128(i)            BENCH_ENTRIES_64(i) BENCH_ENTRIES_64((i) + 64)
+#define BENCH_ENTRIES_256(i)            BENCH_ENTRIES_128(i) BENCH_ENTRIES_128((i) + 128)
+
+#include "schedular.c"
+
+const Schedular_runnable_t AllRunnablesSystemList[MAX_RUNNABLES] =
+{
+    BENCH_TABLE
+};
+
+void BENCH_NAME(Bench_Init, MAX_RUNNABLES)(void)
+{
+    schedular_init();
+}
+
+void BENCH_NAME(Bench_Tick, MAX_RUNNABLES)(void)
+{
+    TickCB();
+    while(IS_TICK_PENDING() || (ReadyCount != 0))
+    {
+        Schedular();
+    }
+}
+
+#endif /* BENCH_SIZES_H_ */
@@ -0,0 +1,4 @@
+/** @brief Scheduler with a table of 16 runnables, see bench_sizes.h. */
+#define MAX_RUNNABLES                   16
+#define BENCH_TABLE                     BENCH_ENTRIES_16(0)
+#include "bench_sizes.h"
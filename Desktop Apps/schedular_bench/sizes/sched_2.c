@@ -0,0 +1,4 @@
+/** @brief Scheduler with a table of 2 runnables, see bench_sizes.h. */
+#define MAX_RUNNABLES                   2
+#define BENCH_TABLE                     BENCH_ENTRIES_2(0)
+#include "bench_sizes.h"
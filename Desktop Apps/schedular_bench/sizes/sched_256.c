@@ -0,0 +1,4 @@
+/** @brief Scheduler with a table of 256 runnables, see bench_sizes.h. */
+#define MAX_RUNNABLES                   256
+#define BENCH_TABLE                     BENCH_ENTRIES_256(0)
+#include "bench_sizes.h"
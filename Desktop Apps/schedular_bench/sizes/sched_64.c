@@ -0,0 +1,4 @@
+/** @brief Scheduler with a table of 64 runnables, see bench_sizes.h. */
+#define MAX_RUNNABLES                   64
+#define BENCH_TABLE                     BENCH_ENTRIES_64(0)
+#include "bench_sizes.h"
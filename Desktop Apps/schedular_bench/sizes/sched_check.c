@@ -0,0 +1,127 @@
+/**
+ * @brief Scheduler of the checks, see bench_sizes.h and checks.c.
+ *
+ * A pool of CHECK_RUNNABLES where the table fills the first slots only, the
+ * others are free. Runnables 2 and 3 share a priority to check they keep
+ * the table order, 0 is the low priority one which overruns.
+ */
+#define MAX_RUNNABLES                   40
+#define CHECK_ENTRY(i, Priority, Period, Delay)                                \
+    [(i)] =                                                                    \
+    {                                                                          \
+        .name          = "check",                                              \
+        .periodicityMS = (Period) * TICK_TIME,                                 \
+        .priority      = (Priority),                                           \
+        .CallBack      = Check_Runnable_##i,                                   \
+        .DelayMS       = (Delay) * TICK_TIME                                   \
+    },
+#define BENCH_TABLE                                                            \
+    CHECK_ENTRY(0, 2, 1, 0)                                                    \
+    CHECK_ENTRY(1, 0, 5, 0)                                                    \
+    CHECK_ENTRY(2, 1, 2, 0)                                                    \
+    CHECK_ENTRY(3, 1, 2, 0)                                                    \
+    CHECK_ENTRY(5, 0, 10, 3)
+#include "bench_sizes.h"
+
+#if MAX_RUNNABLES != CHECK_RUNNABLES
+#error "sched_check.c must be built with CHECK_RUNNABLES"
+#endif
+
+void Bench_Interrupt_40(void)
+{
+    TickCB();
+}
+
+uint32_t Bench_IsHigherReady_40(uint32_t Handle)
+{
+    uint32_t Found = 0;
+    for(uint32_t Rank = 0 ; Rank < RunnableRank[Handle] ; Rank++)
+    {
+        if(IS_RUNNABLE_READY(Rank))
+        {
+            Found = 1;
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    return Found;
+}
+
+uint32_t Bench_CheckState_40(void)
+{
+    uint32_t Broken = 0;
+    uint32_t Used = 0;
+    uint32_t Active = 0;
+    uint32_t Ready = 0;
+    uint32_t Linked = 0;
+    uint16_t Prev;
+    uint16_t Runnable;
+
+    for(uint32_t Slot = 0 ; Slot < MAX_RUNNABLES ; Slot++)
+    {
+        Used += (RunnableStates[Slot] != RUNNABLE_FREE);
+        Active += (RunnableStates[Slot] == RUNNABLE_ACTIVE);
+        /** A free slot is never called */
+        Broken += ((RunnableStates[Slot] == RUNNABLE_FREE) && (Runnables[Slot].CallBack != NULL));
+        /** Only the active runnables are in the wheel */
+        Broken += ((RunnableStates[Slot] != RUNNABLE_ACTIVE) && (RunnableTimers[Slot].pHead != NULL));
+    }
+    Broken += (Used != RunnablesCount);
+
+    for(uint32_t Rank = 0 ; Rank < RunnablesCount ; Rank++)
+    {
+        Runnable = RunnablesByPriority[Rank];
+        Broken += (RunnableRank[Runnable] != Rank);
+        Broken += (RunnableStates[Runnable] == RUNNABLE_FREE);
+        if(Rank > 0)
+        {
+            Broken += (Runnables[RunnablesByPriority[Rank - 1]].priority >
+                       Runnables[Runnable].priority);
+        }
+        if(IS_RUNNABLE_READY(Rank))
+        {
+            Ready++;
+            /** A suspended runnable loses its release */
+            Broken += (RunnableStates[Runnable] != RUNNABLE_ACTIVE);
+        }
+    }
+    for(uint32_t Rank = RunnablesCount ; Rank < (READY_WORDS * 32U) ; Rank++)
+    {
+        Broken += IS_RUNNABLE_READY(Rank);
+    }
+    Broken += (Ready != ReadyCount);
+
+    for(uint32_t Level = 0 ; Level < WHEEL_LEVELS ; Level++)
+    {
+        for(uint32_t Slot = 0 ; Slot < WHEEL_SLOTS ; Slot++)
+        {
+            Prev = NO_RUNNABLE;
+            for(Runnable = WheelSlots[Level][Slot] ;
+                (Runnable != NO_RUNNABLE) && (Linked <= MAX_RUNNABLES) ;
+                Runnable = RunnableTimers[Runnable].Next)
+            {
+                Broken += (RunnableTimers[Runnable].Prev != Prev);
+                Broken += (RunnableTimers[Runnable].pHead != &WheelSlots[Level][Slot]);
+                Broken += (RunnableStates[Runnable] != RUNNABLE_ACTIVE);
+                /** Every runnable in the wheel is due later */
+                Broken += ((int32_t)(RunnableTimers[Runnable].Expiry - WheelTime) <= 0);
+                Prev = Runnable;
+                Linked++;
+            }
+        }
+    }
+    Broken += (Linked != Active);
+    return Broken;
+}
+
+uint32_t Bench_WheelTime_40(void)
+{
+    return WheelTime;
+}
+
+uint32_t Bench_PeriodTicks_40(uint32_t Handle)
+{
+    return RUNNABLE_PERIOD_TICKS(Handle);
+}
@@ -0,0 +1,40 @@
+############################
+# Compiler Configurations  #
+############################
+
+# This variable specifies the name of the compiler that will be used to compile the project.
+CC = gcc
+
+# SANITIZERS: Memory and undefined behaviour checks of the driver.
+SANITIZERS = -fsanitize=address,undefined -fno-sanitize-recover=all
+
+# C_FLAGS: Compiler Flags
+# sim/spi_sim.h is included first in every file so SPI1 to SPI4 point at the
+# simulated registers instead of the peripheral addresses. _GNU_SOURCE gives
+# sim/spi_sim.c the registers of the signal context.
+C_FLAGS = -g -O1 -Wall -D_GNU_SOURCE -include sim/spi_sim.h $(SANITIZERS)
+
+# This variable stores additional flags to be passed to the linker.
+LINKER_FLAGS = $(SANITIZERS)
+
+###################################
+# Compiler Inputs  Configurations #
+###################################
+
+# Directories whose *.c files are all compiled.
+SRC_DIRECTORIES = sim
+
+# Source files which are not located in any of the directories above.
+SRC_FILES_PATHES = main.c ../../src/stm32f4-hal/stm32f4xx_spi.c \
+                   ../../src/SERVICE/spi_bus.c ../../src/SERVICE/spi_bus_CFG.c \
+                   ../../src/SERVICE/spi_slave.c
+
+# Directories searched for header files.
+INC_DIRECTORIES = sim ../../include/stm32f4-hal ../../include/SERVICE
+
+# Arguments given to the simulator by the run target, for example
+# RUN_ARGS = -n 5000 -s 7
+RUN_ARGS =
+
+# Name of the produced executable.
+EXECUTABLE_FILE = spi_sim
@@ -0,0 +1,1013 @@
+/******************************************************************************/
+/**
+ * @file main.c
+ * @brief Checks of the interrupt driven SPI driver on simulated registers.
+ *
+ * @par Project Name
+ * SPI Simulator
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Builds stm32f4xx_spi.c unchanged against sim/spi_sim.c and checks that:
+ * queued jobs run back to back from the interrupt with their chip selects at
+ * the right bytes, a callback can queue more jobs, async zero-copy transfers
+ * complete and hand the bus over to the queue, bad jobs are refused, the
+ * DMA transfers of the four SPIs run at once on their own streams, the bus
+ * manager switches the format of SPI1 only between devices and moves the
+ * chip selects with it, the register map slave answers a master from its
+ * DMA rings, and three SPIs can run random job streams at the same time
+ * without losing or changing a byte. SPI_TransmitReceive is run with the
+ * shift register moved on by every register access, which checks its two
+ * frames in flight and its recovery from an overrun and a mode fault.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "spi_sim.h"
+#include "stm32f4xx_spi.h"
+#include "stm32f4xx_gpio.h"
+#include "spi_bus.h"
+#include "spi_slave.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+
+#define DEFAULT_JOBS                    (20000UL)
+#define JOBS_IN_FLIGHT                  (8U)
+#define MAX_JOB_SIZE                    (64U)
+#define MAX_STEPS                       (100000000UL)
+
+#define POLLED_FRAMES                   (64U)
+/** Accesses of the driver per frame: SCK slower than the loop, then faster */
+#define POLLED_SLOW_SCK                 (8U)
+#define POLLED_FAST_SCK                 (1U)
+#define POLLED_TIMEOUT                  (1000U)
+/** Accesses an interrupt keeps the driver away, longer than the frames in flight */
+#define POLLED_STALL                    (3U * POLLED_SLOW_SCK)
+
+#define BUS_MAX_FRAMES                  (32U)
+#define SLAVE_MAX_FRAMES                (8U)
+#define CR1_FORMAT                      (0x08BBUL)  /* CPOL, CPHA, BR, LSBFIRST, DFF */
+
+#define CHECK(COND)                     Check((COND), #COND, __LINE__)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE TYPES */
+/******************************************************************************/
+
+/** A job of the random stream and its buffers. */
+typedef struct
+{
+    SPI_Job_t Job;
+    SPI_Handle_t * hspi;
+    uint8_t Index;
+    uint8_t Tx[MAX_JOB_SIZE];
+    uint8_t Rx[MAX_JOB_SIZE];
+} StreamJob_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+static uint32_t Failures;
+static uint32_t RandomState;
+
+static SPI_Handle_t Handles[SPISIM_INSTANCES];
+
+static SPI_Job_t * Order[8];
+static uint32_t OrderCount;
+static SPI_Job_t LateJob;
+static uint8_t LateTx[2] = { 0xA5, 0x5A };
+static uint8_t LateRx[2];
+
+static volatile bool AsyncDone;
+static volatile uint32_t DMADone[SPISIM_INSTANCES];
+static volatile uint32_t DMAErrors;
+static uint8_t Counter;
+static uint8_t RecordedMosi[16];
+static uint32_t Recorded;
+
+static uint32_t BusFormats[BUS_MAX_FRAMES];
+static uint32_t BusFrames;
+static SpiBus_Transfer_t BusAgain;
+static uint32_t BusCallBacks;
+static uint8_t SlaveWritten[2];   /* Address and size of the last write */
+static uint8_t SlaveRead[2];      /* Address and size of the last read */
+static uint32_t SlaveCallBacks;
+static StreamJob_t Streams[SPISIM_INSTANCES][JOBS_IN_FLIGHT];
+static uint32_t JobsLeft[SPISIM_INSTANCES];
+static uint32_t JobsDone[SPISIM_INSTANCES];
+static uint32_t BytesQueued[SPISIM_INSTANCES];
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION PROTOTYPES */
+/******************************************************************************/
+static void Check(bool Condition, const char * pText, int Line);
+static uint32_t Random(void);
+static void InitMaster(uint8_t Index, void * Instance);
+static void FillJob(SPI_Job_t * pJob, const uint8_t * pTx, uint8_t * pRx, uint16_t Size,
+                    uint8_t CSPin, uint8_t CSAction, SPI_JobCallBack_t CallBack);
+static bool IsCSEvent(const SpiSim_CSEvent_t * pEvent, uint8_t Pin, bool Low, uint32_t Bytes);
+static void RecordOrder(SPI_Job_t * pJob);
+static void SubmitLate(SPI_Job_t * pJob);
+static void AsyncCallBack(void);
+static uint16_t CounterDevice(uint8_t Index, uint16_t Mosi);
+static uint16_t XorDevice(uint8_t Index, uint16_t Mosi);
+static uint16_t RecordDevice(uint8_t Index, uint16_t Mosi);
+static void StreamNext(StreamJob_t * pStream);
+static void StreamCallBack(SPI_Job_t * pJob);
+static void TestChain(void);
+static void TestAsync(void);
+static void TestRefused(void);
+static bool IsXored(uint8_t Index, const uint8_t * pTx, const uint8_t * pRx, uint16_t Size);
+static void TestPolled(void);
+static void DMADone1(void);
+static void DMADone2(void);
+static void DMADone3(void);
+static void DMADone4(void);
+static void DMAError(void);
+static void TestDMA(void);
+static uint16_t FormatDevice(uint8_t Index, uint16_t Mosi);
+static void BusCallBack(SpiBus_Transfer_t * pTransfer);
+static void TestBus(void);
+static void SlaveWrite(uint8_t Address, const uint8_t * pData, uint16_t Size);
+static void SlaveReadDone(uint8_t Address, uint16_t Size);
+static void SlaveTransaction(const uint8_t * pMosi, uint8_t * pMiso, uint8_t Size);
+static void TestSlave(void);
+static void TestStreams(uint32_t Jobs);
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+static void Check(bool Condition, const char * pText, int Line)
+{
+    if (!Condition)
+    {
+        printf("FAIL line %d: %s\n", Line, pText);
+        Failures++;
+    }
+}
+
+/* xorshift32, the same seed gives the same jobs */
+static uint32_t Random(void)
+{
+    RandomState ^= RandomState << 13;
+    RandomState ^= RandomState >> 17;
+    RandomState ^= RandomState << 5;
+    return RandomState;
+}
+
+static void InitMaster(uint8_t Index, void * Instance)
+{
+    SPI_Handle_t * hspi = &Handles[Index];
+    memset(hspi, 0, sizeof(*hspi));
+    hspi->Instance               = Instance;
+    hspi->Init.Mode              = SPI_MODE_MASTER;
+    hspi->Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_2;
+    hspi->Init.ByteOrder         = SPI_BYTEORDER_MSB;
+    hspi->Init.NSS               = SPI_NSS_SOFT;
+    hspi->Init.DataSize          = SPI_DATASIZE_8BIT;
+    hspi->Init.CLKPolarity       = SPI_POLARITY_HIGH;
+    hspi->Init.CLKPhase          = SPI_PHASE_SECOND_EDGE;
+    hspi->Init.CRCCalculation    = SPI_CRCCALCULATION_DISABLE;
+    hspi->Init.CRCPolynomial     = 10;
+    CHECK(SPI_Init(hspi) == SPI_OK);
+}
+
+static void FillJob(SPI_Job_t * pJob, const uint8_t * pTx, uint8_t * pRx, uint16_t Size,
+                    uint8_t CSPin, uint8_t CSAction, SPI_JobCallBack_t CallBack)
+{
+    memset(pJob, 0, sizeof(*pJob));
+    pJob->pTxData  = pTx;
+    pJob->pRxData  = pRx;
+    pJob->Size     = Size;
+    pJob->CSPort   = GPIO_PORTA;
+    pJob->CSPin    = CSPin;
+    pJob->CSAction = CSAction;
+    pJob->CallBack = CallBack;
+}
+
+static bool IsCSEvent(const SpiSim_CSEvent_t * pEvent, uint8_t Pin, bool Low, uint32_t Bytes)
+{
+    return (pEvent->Port == GPIO_PORTA) && (pEvent->Pin == Pin) &&
+           (pEvent->Low == Low) && (pEvent->Bytes == Bytes);
+}
+
+static void RecordOrder(SPI_Job_t * pJob)
+{
+    if (OrderCount < sizeof(Order) / sizeof(Order[0]))
+    {
+        Order[OrderCount] = pJob;
+    }
+    OrderCount++;
+}
+
+/* Queues one more job from the interrupt, behind the ones already queued */
+static void SubmitLate(SPI_Job_t * pJob)
+{
+    RecordOrder(pJob);
+    FillJob(&LateJob, LateTx, LateRx, sizeof(LateTx), 2, SPI_CS_FRAME, RecordOrder);
+    CHECK(SPI_SubmitJob(&Handles[0], &LateJob) == SPI_OK);
+}
+
+static void AsyncCallBack(void)
+{
+    AsyncDone = true;
+}
+
+static uint16_t CounterDevice(uint8_t Index, uint16_t Mosi)
+{
+    (void)Index;
+    (void)Mosi;
+    return Counter++;
+}
+
+static uint16_t XorDevice(uint8_t Index, uint16_t Mosi)
+{
+    return (uint8_t)(Mosi ^ (0x11U * (Index + 1U)));
+}
+
+static uint16_t RecordDevice(uint8_t Index, uint16_t Mosi)
+{
+    (void)Index;
+    if (Recorded < sizeof(RecordedMosi))
+    {
+        RecordedMosi[Recorded] = (uint8_t)Mosi;
+    }
+    Recorded++;
+    return 0;
+}
+
+/* Gives the job random content and queues it again */
+static void StreamNext(StreamJob_t * pStream)
+{
+    uint16_t Size = (uint16_t)(1U + Random() % MAX_JOB_SIZE);
+    uint32_t Shape = Random();
+    for (uint16_t Byte = 0; Byte < Size; Byte++)
+    {
+        pStream->Tx[Byte] = (uint8_t)Random();
+    }
+    memset(pStream->Rx, 0, sizeof(pStream->Rx));
+    FillJob(&pStream->Job,
+            ((Shape & 1U) != 0U) ? pStream->Tx : NULL,
+            ((Shape & 2U) != 0U) ? pStream->Rx : NULL,
+            Size, (uint8_t)(pStream->Index * 4U + (Shape >> 2) % 4U),
+            (uint8_t)((Shape >> 4) % (SPI_CS_FRAME + 1U)), StreamCallBack);
+    pStream->Job.pContext = pStream;
+    JobsLeft[pStream->Index]--;
+    BytesQueued[pStream->Index] += Size;
+    CHECK(SPI_SubmitJob(pStream->hspi, &pStream->Job) == SPI_OK);
+}
+
+static void StreamCallBack(SPI_Job_t * pJob)
+{
+    StreamJob_t * pStream = pJob->pContext;
+    CHECK(pJob->pNext == NULL);
+    if (pJob->pRxData != NULL)
+    {
+        for (uint16_t Byte = 0; Byte < pJob->Size; Byte++)
+        {
+            uint8_t Sent = (pJob->pTxData != NULL) ? pJob->pTxData[Byte] : 0xFFU;
+            if (pJob->pRxData[Byte] != (uint8_t)XorDevice(pStream->Index, Sent))
+            {
+                CHECK(pJob->pRxData[Byte] == (uint8_t)XorDevice(pStream->Index, Sent));
+                break;
+            }
+        }
+    }
+    JobsDone[pStream->Index]++;
+    if (JobsLeft[pStream->Index] != 0U)
+    {
+        StreamNext(pStream);
+    }
+}
+
+/* Three jobs queued at once and one more from a callback, all in one run */
+static void TestChain(void)
+{
+    static const uint8_t TxA[4] = { 0x9F, 0x01, 0x02, 0x03 };
+    static const uint8_t TxB[3] = { 0x10, 0x20, 0x30 };
+    uint8_t RxA[4] = { 0 };
+    uint8_t RxC[5] = { 0 };
+    SPI_Job_t A, B, C;
+    uint32_t Count;
+
+    SpiSim_Reset();
+    InitMaster(0, SPI1);
+    OrderCount = 0;
+    FillJob(&A, TxA, RxA, sizeof(TxA), 0, SPI_CS_SELECT, SubmitLate);
+    FillJob(&B, TxB, NULL, sizeof(TxB), 0, SPI_CS_RELEASE, RecordOrder);
+    FillJob(&C, NULL, RxC, sizeof(RxC), 1, SPI_CS_FRAME, RecordOrder);
+    CHECK(SPI_SubmitJob(&Handles[0], &A) == SPI_OK);
+    CHECK(SPI_SubmitJob(&Handles[0], &B) == SPI_OK);
+    CHECK(SPI_SubmitJob(&Handles[0], &C) == SPI_OK);
+
+    /* Everything completes without coming back to the caller */
+    CHECK(SpiSim_Run(MAX_STEPS) == 14U);
+    CHECK(OrderCount == 4U);
+    CHECK(Order[0] == &A && Order[1] == &B && Order[2] == &C && Order[3] == &LateJob);
+    CHECK(memcmp(RxA, TxA, sizeof(TxA)) == 0);
+    CHECK(RxC[0] == 0xFF && RxC[4] == 0xFF);
+    CHECK(memcmp(LateRx, LateTx, sizeof(LateTx)) == 0);
+    CHECK(Handles[0].pJobHead == NULL && Handles[0].pJobTail == NULL);
+    CHECK(!Handles[0].isJobRunning);
+
+    const SpiSim_CSEvent_t * pLog = SpiSim_GetCSLog(&Count);
+    CHECK(Count == 6U);
+    if (Count == 6U)
+    {
+        CHECK(IsCSEvent(&pLog[0], 0, true, 0));
+        CHECK(IsCSEvent(&pLog[1], 0, false, 7));
+        CHECK(IsCSEvent(&pLog[2], 1, true, 7));
+        CHECK(IsCSEvent(&pLog[3], 1, false, 12));
+        CHECK(IsCSEvent(&pLog[4], 2, true, 12));
+        CHECK(IsCSEvent(&pLog[5], 2, false, 14));
+    }
+    CHECK(SpiSim_GetOverruns(0) == 0U);
+}
+
+/* Async zero-copy transfers complete, a job queued meanwhile runs after */
+static void TestAsync(void)
+{
+    uint8_t Tx[6] = { 1, 2, 3, 4, 5, 6 };
+    uint8_t Rx[4] = { 0 };
+    uint8_t JobTx[3] = { 0x31, 0x32, 0x33 };
+    uint8_t JobRx[3] = { 0 };
+    SPI_Job_t Job;
+    uint32_t Count;
+
+    SpiSim_Reset();
+    InitMaster(1, SPI2);
+    AsyncDone = false;
+    OrderCount = 0;
+    CHECK(SPI_TransmitAsyncZeroCopy(&Handles[1], Tx, sizeof(Tx), AsyncCallBack) == SPI_OK);
+    FillJob(&Job, JobTx, JobRx, sizeof(JobTx), 3, SPI_CS_FRAME, RecordOrder);
+    CHECK(SPI_SubmitJob(&Handles[1], &Job) == SPI_OK);
+    CHECK(SpiSim_GetCSLog(&Count) != NULL && Count == 0U);
+    SpiSim_Run(MAX_STEPS);
+    CHECK(AsyncDone);
+    CHECK(Handles[1].State == SPI_STATE_IDLE);
+    CHECK(OrderCount == 1U);
+    /* The byte left by the transmit only transfer is not taken as the job's */
+    CHECK(memcmp(JobRx, JobTx, sizeof(JobTx)) == 0);
+    CHECK(SpiSim_GetBytes(1) == sizeof(Tx) + sizeof(JobTx));
+
+    AsyncDone = false;
+    Counter = 0x40;
+    SpiSim_SetDevice(1, CounterDevice);
+    CHECK(SPI_ReceiveAsyncZeroCopy(&Handles[1], Rx, sizeof(Rx), AsyncCallBack) == SPI_OK);
+    SpiSim_Run(MAX_STEPS);
+    CHECK(AsyncDone);
+    CHECK(Handles[1].State == SPI_STATE_IDLE);
+    CHECK(Rx[0] == 0x40 && Rx[1] == 0x41 && Rx[2] == 0x42 && Rx[3] == 0x43);
+}
+
+static void TestRefused(void)
+{
+    uint8_t Data[2] = { 0 };
+    SPI_Job_t Job;
+    SPI_Job_t Other;
+
+    SpiSim_Reset();
+    InitMaster(2, SPI3);
+    FillJob(&Job, Data, Data, 0, 0, SPI_CS_NONE, NULL);
+    CHECK(SPI_SubmitJob(&Handles[2], &Job) == SPI_ERROR);
+    FillJob(&Job, Data, Data, sizeof(Data), 0, SPI_CS_FRAME, NULL);
+    Job.CSPort = NULL;
+    CHECK(SPI_SubmitJob(&Handles[2], &Job) == SPI_ERROR);
+    Job.CSPort = GPIO_PORTA;
+    Job.CSAction = SPI_CS_FRAME + 1U;
+    CHECK(SPI_SubmitJob(&Handles[2], &Job) == SPI_ERROR);
+    CHECK(SPI_SubmitJob(&Handles[2], NULL) == SPI_ERROR);
+    CHECK(SPI_SubmitJob(NULL, &Job) == SPI_ERROR);
+
+    /* A running job keeps the bus from the zero-copy calls */
+    FillJob(&Job, Data, Data, sizeof(Data), 0, SPI_CS_NONE, NULL);
+    CHECK(SPI_SubmitJob(&Handles[2], &Job) == SPI_OK);
+    CHECK(SPI_TransmitAsyncZeroCopy(&Handles[2], Data, sizeof(Data), AsyncCallBack) == SPI_ERROR);
+    CHECK(SPI_ReceiveAsyncZeroCopy(&Handles[2], Data, sizeof(Data), AsyncCallBack) == SPI_ERROR);
+    SpiSim_Run(MAX_STEPS);
+    CHECK(!Handles[2].isJobRunning);
+
+    Handles[2].Init.DataSize = SPI_DATASIZE_16BIT;
+    CHECK(SPI_Init(&Handles[2]) == SPI_OK);
+    FillJob(&Other, Data, Data, sizeof(Data), 0, SPI_CS_NONE, NULL);
+    CHECK(SPI_SubmitJob(&Handles[2], &Other) == SPI_ERROR);
+    Handles[2].Init.DataSize = SPI_DATASIZE_8BIT;
+    Handles[2].Init.Mode = SPI_MODE_SLAVE;
+    CHECK(SPI_Init(&Handles[2]) == SPI_OK);
+    CHECK(SPI_SubmitJob(&Handles[2], &Other) == SPI_ERROR);
+}
+
+static bool IsXored(uint8_t Index, const uint8_t * pTx, const uint8_t * pRx, uint16_t Size)
+{
+    bool Same = true;
+    for (uint16_t Byte = 0; Byte < Size; Byte++)
+    {
+        Same = Same && (pRx[Byte] == (uint8_t)XorDevice(Index, pTx[Byte]));
+    }
+    return Same;
+}
+
+/* SPI_TransmitReceive while each register access of the driver moves SCK on */
+static void TestPolled(void)
+{
+    uint8_t Tx[POLLED_FRAMES];
+    uint8_t Rx[POLLED_FRAMES];
+    uint8_t Again[POLLED_FRAMES];
+    uint16_t Tx16[4] = { 0x1234, 0xBEEF, 0x0001, 0x8001 };
+    uint16_t Rx16[4] = { 0 };
+    SpiSim_Polled_t Polled;
+    SPI_ErrorStatus First;
+    SPI_ErrorStatus Second;
+    bool isTrapped;
+
+    SpiSim_Reset();
+    InitMaster(0, SPI1);
+    SpiSim_SetDevice(0, XorDevice);
+    for (uint16_t Byte = 0; Byte < sizeof(Tx); Byte++)
+    {
+        Tx[Byte] = (uint8_t)Random();
+    }
+    /* A host which cannot trap the accesses fails, it must not pass without these checks */
+    isTrapped = SpiSim_StartPolled(0, POLLED_SLOW_SCK);
+    CHECK(isTrapped);
+    if (!isTrapped)
+    {
+        printf("SPI_TransmitReceive not checked, this host cannot trap register accesses\n");
+        return;
+    }
+
+    /* Back to back calls: SCK only stops after the last frame of each, SPE stays set */
+    First = SPI_TransmitReceive(&Handles[0], Tx, Rx, sizeof(Tx), POLLED_TIMEOUT);
+    Second = SPI_TransmitReceive(&Handles[0], Tx, Again, sizeof(Tx), POLLED_TIMEOUT);
+    SpiSim_StopPolled(&Polled);
+    CHECK(First == SPI_OK && Second == SPI_OK);
+    CHECK(Polled.Frames == 2U * POLLED_FRAMES);
+    CHECK(Polled.Gaps == 2U);
+    CHECK(Polled.Disables == 0U);
+    CHECK(IsXored(0, Tx, Rx, sizeof(Tx)) && IsXored(0, Tx, Again, sizeof(Tx)));
+    CHECK((SpiSim_Registers[0][0] & 0x44U) == 0x44U);
+    CHECK(SpiSim_GetOverruns(0) == 0U);
+
+    /* NULL sends 0xFF, NULL receive drops the frames */
+    SpiSim_SetDevice(0, RecordDevice);
+    Recorded = 0;
+    memset(Rx, 0x55, sizeof(Rx));
+    SpiSim_StartPolled(0, POLLED_SLOW_SCK);
+    First = SPI_TransmitReceive(&Handles[0], NULL, Rx, 4, POLLED_TIMEOUT);
+    Second = SPI_TransmitReceive(&Handles[0], Tx, NULL, 4, POLLED_TIMEOUT);
+    SpiSim_StopPolled(&Polled);
+    CHECK(First == SPI_OK && Second == SPI_OK);
+    CHECK(Recorded == 8U && Polled.Frames == 8U);
+    CHECK(RecordedMosi[0] == 0xFF && RecordedMosi[3] == 0xFF);
+    CHECK(RecordedMosi[4] == Tx[0] && RecordedMosi[7] == Tx[3]);
+    CHECK(Rx[0] == 0x00 && Rx[3] == 0x00 && Rx[4] == 0x55);
+
+    /* SCK faster than the loop reads: the overrun is reported and cleared */
+    SpiSim_SetDevice(0, XorDevice);
+    SpiSim_StartPolled(0, POLLED_FAST_SCK);
+    First = SPI_TransmitReceive(&Handles[0], Tx, Rx, sizeof(Tx), POLLED_TIMEOUT);
+    SpiSim_StopPolled(&Polled);
+    CHECK(First == SPI_ERROR);
+    CHECK(SpiSim_GetOverruns(0) != 0U);
+    CHECK((SpiSim_Registers[0][2] & 0xC1U) == 0U);
+    /* No frame of the failed call is left for the next one */
+    memset(Rx, 0, sizeof(Rx));
+    SpiSim_StartPolled(0, POLLED_SLOW_SCK);
+    First = SPI_TransmitReceive(&Handles[0], Tx, Rx, sizeof(Tx), POLLED_TIMEOUT);
+    SpiSim_StopPolled(&Polled);
+    CHECK(First == SPI_OK && Polled.Frames == POLLED_FRAMES);
+    CHECK(IsXored(0, Tx, Rx, sizeof(Tx)));
+
+    /* An interrupt during the call overruns, with two frames in flight at most none is left */
+    SpiSim_StartPolled(0, POLLED_SLOW_SCK);
+    SpiSim_Stall(5, POLLED_STALL);
+    First = SPI_TransmitReceive(&Handles[0], Tx, Rx, sizeof(Tx), POLLED_TIMEOUT);
+    SpiSim_StopPolled(&Polled);
+    CHECK(First == SPI_ERROR);
+    CHECK((SpiSim_Registers[0][2] & 0xC1U) == 0U);
+    memset(Rx, 0, sizeof(Rx));
+    SpiSim_StartPolled(0, POLLED_SLOW_SCK);
+    First = SPI_TransmitReceive(&Handles[0], Tx, Rx, sizeof(Tx), POLLED_TIMEOUT);
+    SpiSim_StopPolled(&Polled);
+    CHECK(First == SPI_OK && Polled.Frames == POLLED_FRAMES);
+    CHECK(IsXored(0, Tx, Rx, sizeof(Tx)));
+
+    /* A mode fault clears MSTR and SPE, the driver sets MSTR back */
+    SpiSim_StartPolled(0, POLLED_SLOW_SCK);
+    SpiSim_ModeFault(5);
+    First = SPI_TransmitReceive(&Handles[0], Tx, Rx, sizeof(Tx), POLLED_TIMEOUT);
+    SpiSim_StopPolled(&Polled);
+    CHECK(First == SPI_ERROR);
+    CHECK(Polled.Frames == 5U);
+    CHECK((SpiSim_Registers[0][0] & 0x4U) != 0U);
+    CHECK((SpiSim_Registers[0][2] & 0x20U) == 0U);
+    memset(Rx, 0, sizeof(Rx));
+    SpiSim_StartPolled(0, POLLED_SLOW_SCK);
+    First = SPI_TransmitReceive(&Handles[0], Tx, Rx, sizeof(Tx), POLLED_TIMEOUT);
+    SpiSim_StopPolled(&Polled);
+    CHECK(First == SPI_OK && Polled.Frames == POLLED_FRAMES);
+    CHECK(IsXored(0, Tx, Rx, sizeof(Tx)));
+    CHECK((SpiSim_Registers[0][0] & 0x44U) == 0x44U);
+
+    /* 16-bit frames move as half words, NULL sends 0xFFFF */
+    Handles[0].Init.DataSize = SPI_DATASIZE_16BIT;
+    CHECK(SPI_Init(&Handles[0]) == SPI_OK);
+    SpiSim_SetDevice(0, NULL);
+    SpiSim_StartPolled(0, POLLED_SLOW_SCK);
+    First = SPI_TransmitReceive(&Handles[0], (uint8_t *)Tx16, (uint8_t *)Rx16, 4, POLLED_TIMEOUT);
+    SpiSim_StopPolled(&Polled);
+    CHECK(First == SPI_OK && Polled.Gaps == 1U);
+    CHECK(memcmp(Tx16, Rx16, sizeof(Tx16)) == 0);
+    SpiSim_StartPolled(0, POLLED_SLOW_SCK);
+    First = SPI_TransmitReceive(&Handles[0], NULL, (uint8_t *)Rx16, 4, POLLED_TIMEOUT);
+    SpiSim_StopPolled(&Polled);
+    CHECK(First == SPI_OK);
+    CHECK(Rx16[0] == 0xFFFFU && Rx16[3] == 0xFFFFU);
+}
+
+static void DMADone1(void)
+{
+    DMADone[0]++;
+}
+
+static void DMADone2(void)
+{
+    DMADone[1]++;
+}
+
+static void DMADone3(void)
+{
+    DMADone[2]++;
+}
+
+static void DMADone4(void)
+{
+    DMADone[3]++;
+}
+
+static void DMAError(void)
+{
+    DMAErrors++;
+}
+
+/* Full duplex on the four SPIs at once, then each direction alone */
+static void TestDMA(void)
+{
+    static CallBack_t const DoneCallBacks[SPISIM_INSTANCES] = { DMADone1, DMADone2, DMADone3, DMADone4 };
+    void * const Instances[SPISIM_INSTANCES] = { SPI1, SPI2, SPI3, SPI4 };
+    static uint8_t Tx[SPISIM_INSTANCES][300];
+    static uint8_t Rx[SPISIM_INSTANCES][300];
+    uint16_t Tx16[5] = { 0x1234, 0xBEEF, 0x0001, 0xFF00, 0x8001 };
+    uint16_t Rx16[5] = { 0 };
+    uint8_t Small[4] = { 0 };
+    SPI_Job_t Job;
+    uint8_t JobTx[3] = { 0x71, 0x72, 0x73 };
+    uint8_t JobRx[3] = { 0 };
+
+    SpiSim_Reset();
+    memset((void *)DMADone, 0, sizeof(DMADone));
+    DMAErrors = 0;
+    for (uint8_t Index = 0; Index < SPISIM_INSTANCES; Index++)
+    {
+        InitMaster(Index, Instances[Index]);
+        Handles[Index].errorCallBack = DMAError;
+        SpiSim_SetDevice(Index, XorDevice);
+        for (uint16_t Byte = 0; Byte < sizeof(Tx[Index]); Byte++)
+        {
+            Tx[Index][Byte] = (uint8_t)Random();
+        }
+        CHECK(SPI_TransmitReceiveDMA(&Handles[Index], Tx[Index], Rx[Index],
+                                     (uint16_t)(100U * (Index % 3U) + 50U), DoneCallBacks[Index]) == SPI_OK);
+    }
+    CHECK(SPI_TransmitReceiveDMA(&Handles[0], Tx[0], Rx[0], 1, DMADone1) == SPI_BUSY);
+    CHECK(SPI_TransmitAsyncZeroCopy(&Handles[0], Tx[0], 1, AsyncCallBack) == SPI_ERROR);
+    SpiSim_Run(MAX_STEPS);
+    for (uint8_t Index = 0; Index < SPISIM_INSTANCES; Index++)
+    {
+        uint16_t Size = (uint16_t)(100U * (Index % 3U) + 50U);
+        CHECK(DMADone[Index] == 1U);
+        CHECK(Handles[Index].State == SPI_STATE_IDLE);
+        CHECK(SpiSim_GetBytes(Index) == Size);
+        CHECK(SpiSim_GetOverruns(Index) == 0U);
+        for (uint16_t Byte = 0; Byte < Size; Byte++)
+        {
+            if (Rx[Index][Byte] != (uint8_t)XorDevice(Index, Tx[Index][Byte]))
+            {
+                CHECK(Rx[Index][Byte] == (uint8_t)XorDevice(Index, Tx[Index][Byte]));
+                break;
+            }
+        }
+        CHECK((SpiSim_Registers[Index][1] & 0x3U) == 0U);
+    }
+
+    /* Transmit only drains every received frame, then a queued job runs */
+    CHECK(SPI_TransmitDMA(&Handles[1], Tx[1], 10, DMADone2) == SPI_OK);
+    FillJob(&Job, JobTx, JobRx, sizeof(JobTx), 5, SPI_CS_FRAME, RecordOrder);
+    OrderCount = 0;
+    CHECK(SPI_SubmitJob(&Handles[1], &Job) == SPI_OK);
+    SpiSim_Run(MAX_STEPS);
+    CHECK(DMADone[1] == 2U);
+    CHECK(OrderCount == 1U);
+    CHECK(JobRx[0] == (uint8_t)XorDevice(1, JobTx[0]) && JobRx[2] == (uint8_t)XorDevice(1, JobTx[2]));
+    CHECK(SpiSim_GetOverruns(1) == 0U);
+
+    /* Receive only sends 0xFF */
+    Counter = 0x20;
+    SpiSim_SetDevice(2, CounterDevice);
+    CHECK(SPI_ReceiveDMA(&Handles[2], Small, sizeof(Small), DMADone3) == SPI_OK);
+    SpiSim_Run(MAX_STEPS);
+    CHECK(DMADone[2] == 2U);
+    CHECK(Small[0] == 0x20 && Small[3] == 0x23);
+
+    /* 16-bit frames move as half words */
+    Handles[3].Init.DataSize = SPI_DATASIZE_16BIT;
+    CHECK(SPI_Init(&Handles[3]) == SPI_OK);
+    SpiSim_SetDevice(3, NULL);
+    CHECK(SPI_TransmitReceiveDMA(&Handles[3], (uint8_t *)Tx16, (uint8_t *)Rx16, 5, DMADone4) == SPI_OK);
+    SpiSim_Run(MAX_STEPS);
+    CHECK(DMADone[3] == 2U);
+    CHECK(memcmp(Tx16, Rx16, sizeof(Tx16)) == 0);
+
+    /* A stream error ends the transfer once, without the done callback */
+    CHECK(SPI_TransmitDMA(&Handles[0], Tx[0], 20, DMADone1) == SPI_OK);
+    SpiSim_FailDMA(0);
+    SpiSim_Run(MAX_STEPS);
+    CHECK(DMAErrors == 1U);
+    CHECK(DMADone[0] == 1U);
+    CHECK(Handles[0].State == SPI_STATE_IDLE);
+    /* Both streams were stopped, the next transfer starts */
+    CHECK(SPI_TransmitReceiveDMA(&Handles[0], Tx[0], Rx[0], 8, DMADone1) == SPI_OK);
+    SpiSim_Run(MAX_STEPS);
+    CHECK(DMADone[0] == 2U);
+    CHECK(Rx[0][7] == (uint8_t)XorDevice(0, Tx[0][7]));
+
+    /* Pieces kept apart go out as one transfer, one callback at the end */
+    {
+        uint8_t Header[2] = { 0xC0, 0x03 };
+        uint8_t Crc[1] = { 0x5D };
+        const DMA_Segment_t Pieces[3] = { { Header, 2 }, { Tx[2], 3 }, { Crc, 1 } };
+        const DMA_Segment_t Empty[2] = { { Header, 2 }, { Crc, 0 } };
+        uint32_t Bytes = SpiSim_GetBytes(2);
+        SpiSim_SetDevice(2, RecordDevice);
+        Recorded = 0;
+        CHECK(SPI_TransmitChainDMA(&Handles[2], Pieces, 3, DMADone3) == SPI_OK);
+        CHECK(SPI_TransmitChainDMA(&Handles[2], Pieces, 3, DMADone3) == SPI_BUSY);
+        SpiSim_Run(MAX_STEPS);
+        CHECK(DMADone[2] == 3U);
+        CHECK(SpiSim_GetBytes(2) == Bytes + 6U);
+        CHECK(Recorded == 6U);
+        CHECK(RecordedMosi[0] == 0xC0 && RecordedMosi[1] == 0x03 && RecordedMosi[2] == Tx[2][0] &&
+              RecordedMosi[4] == Tx[2][2] && RecordedMosi[5] == 0x5D);
+        CHECK(SpiSim_GetOverruns(2) == 0U);
+        CHECK(SPI_TransmitChainDMA(&Handles[2], Empty, 2, DMADone3) == SPI_ERROR);
+        CHECK(SPI_TransmitChainDMA(&Handles[2], Pieces, 0, DMADone3) == SPI_ERROR);
+    }
+
+    CHECK(SPI_TransmitDMA(&Handles[1], NULL, 4, DMADone2) == SPI_ERROR);
+    CHECK(SPI_TransmitReceiveDMA(&Handles[1], Tx[1], NULL, 4, DMADone2) == SPI_ERROR);
+    CHECK(SPI_ReceiveDMA(&Handles[1], Small, 0, DMADone2) == SPI_ERROR);
+}
+
+/* Records the format SPI1 had for every frame */
+static uint16_t FormatDevice(uint8_t Index, uint16_t Mosi)
+{
+    if (BusFrames < BUS_MAX_FRAMES)
+    {
+        BusFormats[BusFrames] = SpiSim_Registers[Index][0] & CR1_FORMAT;
+    }
+    BusFrames++;
+    return (uint16_t)(Mosi ^ 0x5A5AU);
+}
+
+static void BusCallBack(SpiBus_Transfer_t * pTransfer)
+{
+    CHECK(pTransfer->pNext == NULL);
+    BusCallBacks++;
+    /* Queued a second time from its own callback */
+    if (pTransfer == &BusAgain && pTransfer->pContext == NULL)
+    {
+        pTransfer->pContext = pTransfer;
+        CHECK(SpiBus_Submit(pTransfer) == SPI_BUS_OK);
+    }
+}
+
+/* The TFT, the flash and the sensor of spi_bus_CFG.c share SPI1 */
+static void TestBus(void)
+{
+    static const struct { uint8_t Device; uint16_t Frames; } Expected[] =
+    {
+        { SPI_BUS_TFT, 7 }, { SPI_BUS_FLASH, 2 }, { SPI_BUS_SENSOR, 2 }, { SPI_BUS_TFT, 6 }
+    };
+    uint8_t TftTx[4] = { 0x11, 0x22, 0x33, 0x44 };
+    uint8_t TftRx[4] = { 0 };
+    uint8_t Command[3] = { 0x2A, 0x00, 0x7F };
+    uint8_t FlashRx[2] = { 0 };
+    uint16_t SensorTx[2] = { 0x8001, 0x1234 };
+    uint16_t SensorRx[2] = { 0 };
+    SpiBus_Transfer_t Transfers[5];
+    SpiBus_Stats_t Stats;
+    const SpiSim_CSEvent_t * pLog;
+    uint32_t Count;
+    uint32_t Frame = 0;
+
+    SpiSim_Reset();
+    SpiSim_SetDevice(0, FormatDevice);
+    BusFrames = 0;
+    BusCallBacks = 0;
+    CHECK(SpiBus_Init() == SPI_BUS_OK);
+    pLog = SpiSim_GetCSLog(&Count);
+    CHECK(Count == _SPI_BUS_DEVICES_NUM && !pLog[0].Low && !pLog[2].Low);
+
+    memset(Transfers, 0, sizeof(Transfers));
+    Transfers[0] = (SpiBus_Transfer_t){ .Device = SPI_BUS_TFT, .pTxData = TftTx, .pRxData = TftRx, .Size = 4 };
+    Transfers[1] = (SpiBus_Transfer_t){ .Device = SPI_BUS_TFT, .pTxData = Command, .Size = 3 };
+    Transfers[2] = (SpiBus_Transfer_t){ .Device = SPI_BUS_FLASH, .pRxData = FlashRx, .Size = 2 };
+    Transfers[3] = (SpiBus_Transfer_t){ .Device = SPI_BUS_SENSOR, .pTxData = (uint8_t *)SensorTx,
+                                        .pRxData = (uint8_t *)SensorRx, .Size = 2 };
+    Transfers[4] = (SpiBus_Transfer_t){ .Device = SPI_BUS_TFT, .pTxData = Command, .Size = 2,
+                                        .KeepSelected = true };
+    BusAgain = (SpiBus_Transfer_t){ .Device = SPI_BUS_TFT, .pTxData = TftTx, .Size = 2,
+                                    .CallBack = BusCallBack };
+    for (uint8_t Transfer = 0; Transfer < 5U; Transfer++)
+    {
+        Transfers[Transfer].CallBack = BusCallBack;
+        CHECK(SpiBus_Submit(&Transfers[Transfer]) == SPI_BUS_OK);
+    }
+    CHECK(SpiBus_Submit(&BusAgain) == SPI_BUS_OK);
+    CHECK(Transfers[0].Status == SPI_BUS_PENDING);
+    SpiSim_Run(MAX_STEPS);
+
+    for (uint8_t Transfer = 0; Transfer < 5U; Transfer++)
+    {
+        CHECK(Transfers[Transfer].Status == SPI_BUS_DONE);
+    }
+    CHECK(BusAgain.Status == SPI_BUS_DONE);
+    CHECK(BusCallBacks == 7U);
+    CHECK(TftRx[0] == (0x11 ^ 0x5A) && TftRx[3] == (0x44 ^ 0x5A));
+    CHECK(FlashRx[0] == (0xFF ^ 0x5A) && FlashRx[1] == (0xFF ^ 0x5A));
+    CHECK(SensorRx[0] == (0x8001 ^ 0x5A5A) && SensorRx[1] == (0x1234 ^ 0x5A5A));
+    CHECK(SpiSim_GetOverruns(0) == 0U);
+
+    /* Every frame ran with the format of its device */
+    CHECK(BusFrames == 17U);
+    for (uint8_t Run = 0; Run < sizeof(Expected) / sizeof(Expected[0]); Run++)
+    {
+        const SpiBus_Device_t * pDevice = &SpiBusDevices[Expected[Run].Device];
+        uint32_t Format = pDevice->CLKPolarity | pDevice->CLKPhase | pDevice->BaudRatePrescaler | pDevice->DataSize;
+        for (uint16_t Index = 0; Index < Expected[Run].Frames; Index++, Frame++)
+        {
+            if (BusFormats[Frame] != Format)
+            {
+                CHECK(BusFormats[Frame] == Format);
+                break;
+            }
+        }
+    }
+    CHECK(SpiBus_GetStats(SPI_BUS_FLASH, &Stats) == SPI_BUS_OK);
+    CHECK(Stats.Transfers == 7U && Stats.Reconfigurations == 3U && Stats.Errors == 0U);
+    CHECK(Stats.Pending == 0U && Stats.PeakPending == 6U);
+
+    /* Each device is selected around its frames only, the kept TFT select
+       lasts over the next TFT transfer */
+    pLog = SpiSim_GetCSLog(&Count);
+    CHECK(Count == _SPI_BUS_DEVICES_NUM + 12U);
+    if (Count == _SPI_BUS_DEVICES_NUM + 12U)
+    {
+        const SpiSim_CSEvent_t * pBus = &pLog[_SPI_BUS_DEVICES_NUM];
+        CHECK(IsCSEvent(&pBus[0], GPIO_PIN0, true, 0) && IsCSEvent(&pBus[1], GPIO_PIN0, false, 4));
+        CHECK(IsCSEvent(&pBus[2], GPIO_PIN0, true, 4) && IsCSEvent(&pBus[3], GPIO_PIN0, false, 7));
+        CHECK(IsCSEvent(&pBus[4], GPIO_PIN4, true, 7) && IsCSEvent(&pBus[5], GPIO_PIN4, false, 9));
+        CHECK(pBus[6].Port == GPIO_PORTB && pBus[6].Low && pBus[6].Bytes == 9U);
+        CHECK(pBus[7].Port == GPIO_PORTB && !pBus[7].Low && pBus[7].Bytes == 11U);
+        CHECK(IsCSEvent(&pBus[8], GPIO_PIN0, true, 11) && IsCSEvent(&pBus[9], GPIO_PIN0, false, 15));
+        CHECK(IsCSEvent(&pBus[10], GPIO_PIN0, true, 15) && IsCSEvent(&pBus[11], GPIO_PIN0, false, 17));
+    }
+
+    /* A failed transfer releases its chip select */
+    Transfers[0].Size = 8;
+    CHECK(SpiBus_Submit(&Transfers[0]) == SPI_BUS_OK);
+    SpiSim_FailDMA(0);
+    SpiSim_Run(MAX_STEPS);
+    CHECK(Transfers[0].Status == SPI_BUS_FAILED);
+    pLog = SpiSim_GetCSLog(&Count);
+    CHECK(!pLog[Count - 1U].Low);
+    CHECK(SpiBus_GetStats(SPI_BUS_TFT, &Stats) == SPI_BUS_OK);
+    CHECK(Stats.Errors == 1U && Stats.Transfers == 7U && Stats.Pending == 0U);
+
+    Transfers[1].Size = 0;
+    CHECK(SpiBus_Submit(&Transfers[1]) == SPI_BUS_ERROR);
+    Transfers[1].Size = 1;
+    Transfers[1].pTxData = NULL;
+    CHECK(SpiBus_Submit(&Transfers[1]) == SPI_BUS_ERROR);
+    Transfers[1].pTxData = Command;
+    Transfers[1].Device = _SPI_BUS_DEVICES_NUM;
+    CHECK(SpiBus_Submit(&Transfers[1]) == SPI_BUS_ERROR);
+    CHECK(SpiBus_Submit(NULL) == SPI_BUS_ERROR);
+    CHECK(SpiBus_GetStats(SPI_BUS_TFT, NULL) == SPI_BUS_ERROR);
+}
+
+static void SlaveWrite(uint8_t Address, const uint8_t * pData, uint16_t Size)
+{
+    (void)pData;
+    SlaveWritten[0] = Address;
+    SlaveWritten[1] = (uint8_t)Size;
+    SlaveCallBacks++;
+}
+
+static void SlaveReadDone(uint8_t Address, uint16_t Size)
+{
+    SlaveRead[0] = Address;
+    SlaveRead[1] = (uint8_t)Size;
+    SlaveCallBacks++;
+}
+
+/* The master selects SPI1, clocks the frames and releases NSS on PA4 */
+static void SlaveTransaction(const uint8_t * pMosi, uint8_t * pMiso, uint8_t Size)
+{
+    for (uint8_t Frame = 0; Frame < Size; Frame++)
+    {
+        pMiso[Frame] = (uint8_t)SpiSim_SlaveExchange(0, pMosi[Frame]);
+    }
+    SpiSim_Edge(GPIO_PIN4);
+}
+
+/* A master writes and reads the register map of spi_slave.c */
+static void TestSlave(void)
+{
+    static const uint8_t Values[4] = { 0x11, 0x22, 0x33, 0x44 };
+    static const uint8_t Write[4] = { 0x02, 0xA1, 0xA2, 0xA3 };
+    static const uint8_t Read[5] = { SPI_SLAVE_READ | 8U, 0, 0, 0, 0 };
+    static const uint8_t WriteLocked[2] = { 0x0C, 0xB1 };
+    static const uint8_t WriteEnd[5] = { SPI_SLAVE_MAP_SIZE - 2U, 1, 2, 3, 4 };
+    static const uint8_t ReadEnd[5] = { SPI_SLAVE_READ | (SPI_SLAVE_MAP_SIZE - 2U), 0, 0, 0, 0 };
+    uint8_t Miso[SLAVE_MAX_FRAMES];
+    uint8_t Registers[4];
+    SpiSlave_Stats_t Stats;
+
+    SpiSim_Reset();
+    SlaveCallBacks = 0;
+    CHECK(SpiSlave_Init(SlaveWrite, SlaveReadDone) == SPI_SLAVE_OK);
+    CHECK(SpiSlave_SetRegisters(8, Values, sizeof(Values)) == SPI_SLAVE_OK);
+
+    SlaveTransaction(Write, Miso, sizeof(Write));
+    CHECK(SlaveCallBacks == 1U && SlaveWritten[0] == 2U && SlaveWritten[1] == 3U);
+    CHECK(SpiSlave_GetRegisters(2, Registers, 3) == SPI_SLAVE_OK);
+    CHECK(memcmp(Registers, &Write[1], 3) == 0);
+
+    /* The first read selects register 8 and still answers from register 0 */
+    SlaveTransaction(Read, Miso, sizeof(Read));
+    CHECK(Miso[1] == 0x00U && Miso[2] == 0x00U && Miso[3] == 0xA1U && Miso[4] == 0xA2U);
+    CHECK(SlaveCallBacks == 1U);
+    for (uint8_t Poll = 0; Poll < 3U; Poll++)
+    {
+        SlaveTransaction(Read, Miso, sizeof(Read));
+        CHECK(memcmp(&Miso[1], Values, sizeof(Values)) == 0);
+        CHECK(SlaveCallBacks == 2U + Poll && SlaveRead[0] == 8U && SlaveRead[1] == 4U);
+    }
+
+    /* NSS rises while the service holds its lock, the edge is served on unlock */
+    for (uint8_t Frame = 0; Frame < sizeof(WriteLocked); Frame++)
+    {
+        (void)SpiSim_SlaveExchange(0, WriteLocked[Frame]);
+    }
+    SpiSim_EdgeOnLock(GPIO_PIN4);
+    CHECK(SpiSlave_GetStats(&Stats) == SPI_SLAVE_OK);
+    CHECK(SlaveCallBacks == 5U && SlaveWritten[0] == 0x0CU && SlaveWritten[1] == 1U);
+    SlaveTransaction(Read, Miso, sizeof(Read));
+    CHECK(memcmp(&Miso[1], Values, sizeof(Values)) == 0);
+    CHECK(SlaveCallBacks == 6U && SlaveRead[0] == 8U && SlaveRead[1] == 4U);
+
+    /* Bytes past the map are dropped, reads stop at its end */
+    SlaveTransaction(WriteEnd, Miso, sizeof(WriteEnd));
+    CHECK(SlaveWritten[0] == SPI_SLAVE_MAP_SIZE - 2U && SlaveWritten[1] == 2U);
+    SlaveTransaction(ReadEnd, Miso, sizeof(ReadEnd));
+    SlaveTransaction(ReadEnd, Miso, sizeof(ReadEnd));
+    CHECK(Miso[1] == 1U && Miso[2] == 2U);
+    CHECK(SlaveRead[0] == SPI_SLAVE_MAP_SIZE - 2U && SlaveRead[1] == 2U);
+
+    /* Enough writes to wrap the receive ring several times */
+    for (uint32_t Loop = 0; Loop < 3U * SPI_SLAVE_RX_RING_SIZE; Loop++)
+    {
+        uint8_t Frames[4] = { 0x10, (uint8_t)Loop, (uint8_t)(Loop >> 8), (uint8_t)~Loop };
+        SlaveTransaction(Frames, Miso, 1U + (uint8_t)(Loop % 3U) + 1U);
+        CHECK(SpiSlave_GetRegisters(0x10, Registers, 1) == SPI_SLAVE_OK && Registers[0] == (uint8_t)Loop);
+    }
+
+    /* A failed stream restarts both, the read selecting register 8 again is served */
+    SpiSim_FailDMA(0);
+    SlaveTransaction(Read, Miso, sizeof(Read));
+    SlaveTransaction(Read, Miso, sizeof(Read));
+    CHECK(memcmp(&Miso[1], Values, sizeof(Values)) == 0);
+
+    CHECK(SpiSlave_GetStats(&Stats) == SPI_SLAVE_OK);
+    CHECK(Stats.Errors == 1U && Stats.Dropped == 2U && Stats.Reads == 6U);
+    CHECK(Stats.Writes == 3U + 3U * SPI_SLAVE_RX_RING_SIZE);
+    CHECK(Stats.Transactions == 12U + 3U * SPI_SLAVE_RX_RING_SIZE);
+    CHECK(SpiSim_GetOverruns(0) == 0U);
+    CHECK(SpiSlave_SetRegisters(SPI_SLAVE_MAP_SIZE - 1U, Values, 2) == SPI_SLAVE_ERROR);
+    CHECK(SpiSlave_GetRegisters(0, NULL, 1) == SPI_SLAVE_ERROR);
+}
+
+/* SPI1, SPI3 and SPI4 run random jobs, each callback queues the next one */
+static void TestStreams(uint32_t Jobs)
+{
+    static const uint8_t Indexes[3] = { 0, 2, 3 };
+    void * const Instances[SPISIM_INSTANCES] = { SPI1, SPI2, SPI3, SPI4 };
+
+    SpiSim_Reset();
+    for (uint8_t Slot = 0; Slot < sizeof(Indexes); Slot++)
+    {
+        uint8_t Index = Indexes[Slot];
+        InitMaster(Index, Instances[Index]);
+        SpiSim_SetDevice(Index, XorDevice);
+        JobsLeft[Index] = Jobs;
+        JobsDone[Index] = 0;
+        BytesQueued[Index] = 0;
+        for (uint8_t Job = 0; Job < JOBS_IN_FLIGHT && JobsLeft[Index] != 0U; Job++)
+        {
+            Streams[Index][Job].hspi = &Handles[Index];
+            Streams[Index][Job].Index = Index;
+            StreamNext(&Streams[Index][Job]);
+        }
+    }
+    SpiSim_Run(MAX_STEPS);
+
+    for (uint8_t Slot = 0; Slot < sizeof(Indexes); Slot++)
+    {
+        uint8_t Index = Indexes[Slot];
+        CHECK(JobsDone[Index] == Jobs);
+        CHECK(SpiSim_GetBytes(Index) == BytesQueued[Index]);
+        CHECK(SpiSim_GetOverruns(Index) == 0U);
+        CHECK(Handles[Index].pJobHead == NULL && !Handles[Index].isJobRunning);
+    }
+    CHECK(SpiSim_GetBytes(1) == 0U);
+    printf("streams: %lu jobs on 3 SPIs, %lu bytes\n",
+           (unsigned long)(3U * Jobs),
+           (unsigned long)(BytesQueued[0] + BytesQueued[2] + BytesQueued[3]));
+}
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+int main(int argc, char ** argv)
+{
+    uint32_t Jobs = DEFAULT_JOBS;
+    uint32_t Seed = 1;
+    int Option;
+
+    while ((Option = getopt(argc, argv, "n:s:")) != -1)
+    {
+        switch (Option)
+        {
+        case 'n':
+            Jobs = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            Seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n jobs] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+    RandomState = (Seed != 0U) ? Seed : 1U;
+
+    TestChain();
+    TestAsync();
+    TestRefused();
+    TestPolled();
+    TestDMA();
+    TestBus();
+    TestSlave();
+    TestStreams(Jobs);
+
+    printf("%s, %lu failed checks\n", (Failures == 0U) ? "PASS" : "FAIL", (unsigned long)Failures);
+    return (Failures == 0U) ? 0 : 1;
+}
+
+/******************************************************************************/
@@ -0,0 +1,866 @@
+/******************************************************************************/
+/**
+ * @file spi_sim.c
+ * @brief Simulated register blocks of SPI1 to SPI4.
+ *
+ * @par Project Name
+ * SPI Simulator
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Reads of DR cannot be seen in RAM, so DR carries a marker bit while it
+ * holds a received byte: a value written by the driver has no marker and is
+ * the next byte to send. RXNE is taken as read once the interrupt ran with
+ * RXNEIE set, the driver always reads DR there. The streams move one frame
+ * per round: the receive stream empties DR first, then the transmit stream
+ * refills it, which is the order the stream priorities give on target.
+ * A slave does not take part in the rounds, the master clocks it with
+ * SpiSim_SlaveExchange. Its transmit buffer is kept apart from DR: the
+ * transmit stream refills it as soon as it is empty, so a frame is left in
+ * it at the end of a transaction, like on target.
+ *
+ * A polled SPI keeps its page of registers without access rights: each
+ * access of the driver faults, the page is opened and the instruction single
+ * stepped, then the trap sees what it did and moves the shift register on
+ * before closing the page again. A DR which lost its marker was written and
+ * goes to the transmit buffer, DR is then put back to the received frame.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+#include "spi_sim.h"
+#include "stm32f4xx_gpio.h"
+#include "stm32f4xx_dma.h"
+#include "stm32f4xx_exti.h"
+#include "stm32f4xx_nvic.h"
+#include "stm32f4xx_rcc.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+
+/* The signal context of x86-64 has a REG_CR2 of its own */
+#undef REG_CR2
+#define REG_CR1                         (0U)
+#define REG_CR2                         (1U)
+#define REG_SR                          (2U)
+#define REG_DR                          (3U)
+
+#define CR1_MSTR                        (0x1UL << 2)
+#define CR1_SPE                         (0x1UL << 6)
+#define CR2_RXDMAEN                     (0x1UL << 0)
+#define CR2_TXDMAEN                     (0x1UL << 1)
+#define CR2_RXNEIE                      (0x1UL << 6)
+#define CR2_TXEIE                       (0x1UL << 7)
+#define SR_RXNE                         (0x1UL << 0)
+#define SR_TXE                          (0x1UL << 1)
+#define SR_MODF                         (0x1UL << 5)
+#define SR_OVR                          (0x1UL << 6)
+#define SR_BSY                          (0x1UL << 7)
+
+/** Set in DR while it holds a received byte, never written by the driver */
+#define DR_RECEIVED                     (0x10000UL)
+
+#define DMA_CONTROLLERS                 (2U)
+#define DMA_STREAMS                     (8U)
+#define EXTI_LINES                      (16U)
+
+#if defined(__x86_64__)
+/** Trap flag of RFLAGS, the next instruction raises SIGTRAP */
+#define RFLAGS_TF                       (0x100ULL)
+#define POLLED_SUPPORTED                (1)
+#else
+#define POLLED_SUPPORTED                (0)
+#endif
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE TYPES */
+/******************************************************************************/
+
+/** One simulated DMA stream. */
+typedef struct
+{
+    DMA_Handle_t * pHandle;
+    uint8_t * pMemory;
+    uint8_t * pStart;           /**< Reloaded by a circular stream */
+    volatile uint32_t * pPeripheral;
+    uint32_t Length;
+    uint32_t Remaining;
+    bool Armed;
+    bool Fail;
+} Stream_t;
+
+/** Shift register of the polled SPI. */
+typedef struct
+{
+    bool Active;
+    uint8_t Index;
+    uint32_t FrameAccesses;
+    uint32_t Word;              /**< Register of the access being stepped */
+    uint32_t CR1Before;
+    uint16_t Shift;
+    uint32_t ShiftLeft;         /**< Accesses until the frame is shifted, 0 when idle */
+    uint16_t TxBuffer;
+    bool TxFull;
+    uint16_t RxBuffer;
+    bool DRRead;                /**< DR was read, an SR read clears OVR */
+    bool SRReadModf;            /**< SR was read with MODF, a CR1 write clears it */
+    uint32_t FaultFrame;        /**< Frame raising MODF, 0 for none */
+    uint32_t StallFrame;        /**< Frame after which the driver stalls, 0 for none */
+    uint32_t StallAccesses;
+    SpiSim_Polled_t Stats;
+} Polled_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION PROTOTYPES */
+/******************************************************************************/
+extern void SPI1_IRQHandler(void);
+extern void SPI2_IRQHandler(void);
+extern void SPI3_IRQHandler(void);
+extern void SPI4_IRQHandler(void);
+
+static uint16_t Loopback(uint8_t Index, uint16_t Mosi);
+static Stream_t * FindStream(uint8_t Index, uint32_t Direction);
+static void StreamDone(Stream_t * pStream);
+static bool MoveRx(uint8_t Index);
+static void SlaveRefill(uint8_t Index);
+static bool Step(uint8_t Index);
+static void PolledShift(volatile uint32_t * pReg);
+static void PolledAccess(uint32_t Word);
+static void RaiseOnLock(uint8_t Line);
+#if POLLED_SUPPORTED
+static void PolledFault(int Signal, siginfo_t * pInfo, void * pContext);
+static void PolledTrap(int Signal, siginfo_t * pInfo, void * pContext);
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+static void (*const IRQHandlers[SPISIM_INSTANCES])(void) =
+{
+    SPI1_IRQHandler, SPI2_IRQHandler, SPI3_IRQHandler, SPI4_IRQHandler
+};
+
+static SpiSim_Device_t Devices[SPISIM_INSTANCES];
+static uint32_t Bytes[SPISIM_INSTANCES];
+static uint32_t Overruns[SPISIM_INSTANCES];
+static uint32_t TotalBytes;
+
+static SpiSim_CSEvent_t CSLog[SPISIM_CS_LOG_SIZE];
+static uint32_t CSLogCount;
+
+static Stream_t Streams[DMA_CONTROLLERS][DMA_STREAMS];
+
+static uint16_t SlaveTx[SPISIM_INSTANCES];
+static bool SlaveTxFull[SPISIM_INSTANCES];
+static EXTI_CallBack_t LineCallBacks[EXTI_LINES];
+/** Lines masked by EXTI_Disable, disabled in the NVIC, pending and to raise on lock */
+static uint32_t LinesMasked;
+static uint32_t LinesDisabled;
+static uint32_t LinesPending;
+static uint32_t LinesOnLock;
+
+static Polled_t Polled;
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC VARIABLE DEFINITIONS */
+/******************************************************************************/
+SpiSim_Page_t SpiSim_Page __attribute__((aligned(SPISIM_PAGE_SIZE)));
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+static uint16_t Loopback(uint8_t Index, uint16_t Mosi)
+{
+    (void)Index;
+    return Mosi;
+}
+
+/* Armed stream of one direction on the DR of one SPI, NULL when none */
+static Stream_t * FindStream(uint8_t Index, uint32_t Direction)
+{
+    Stream_t * pFound = NULL;
+    for (uint8_t Controller = 0; Controller < DMA_CONTROLLERS; Controller++)
+    {
+        for (uint8_t Stream = 0; Stream < DMA_STREAMS; Stream++)
+        {
+            Stream_t * pStream = &Streams[Controller][Stream];
+            if (pStream->Armed &&
+                pStream->pPeripheral == &SpiSim_Registers[Index][REG_DR] &&
+                pStream->pHandle->Initialization.Direction == Direction)
+            {
+                pFound = pStream;
+            }
+        }
+    }
+    return pFound;
+}
+
+static void StreamDone(Stream_t * pStream)
+{
+    DMA_Handle_t * pHandle = pStream->pHandle;
+    bool isChained = (pHandle->pSegments != NULL && (pHandle->Segment + 1U) < pHandle->Segments);
+    if (pHandle->Initialization.Mode == DMA_CIRCULAR)
+    {
+        pStream->pMemory   = pStream->pStart;
+        pStream->Remaining = pStream->Length;
+    }
+    else if (isChained)
+    {
+        /* The next piece starts from the interrupt, no callback */
+        pHandle->Segment  += 1U;
+        pStream->pMemory   = pHandle->pSegments[pHandle->Segment].pMemory;
+        pStream->pStart    = pStream->pMemory;
+        pStream->Length    = pHandle->pSegments[pHandle->Segment].Length;
+        pStream->Remaining = pStream->Length;
+    }
+    else
+    {
+        pStream->Armed = false;
+        pHandle->State = DMA_STATE_READY;
+    }
+    if (!isChained && pHandle->CompleteTransferCallBack != NULL)
+    {
+        pHandle->CompleteTransferCallBack();
+    }
+}
+
+/* The receive stream empties DR, returns true when it moved a frame */
+static bool MoveRx(uint8_t Index)
+{
+    volatile uint32_t * pReg = SpiSim_Registers[Index];
+    bool Active = false;
+    Stream_t * pRx = FindStream(Index, DMA_PERIPH_TO_MEMORY);
+    if (pRx != NULL && (pReg[REG_CR2] & CR2_RXDMAEN) != 0U && (pReg[REG_SR] & SR_RXNE) != 0U)
+    {
+        bool isHalfWord = (pRx->pHandle->Initialization.MemAlignment == DMA_MDATAALIGN_HALFWORD);
+        uint16_t Frame = (uint16_t)pReg[REG_DR];
+        if (isHalfWord)
+        {
+            memcpy(pRx->pMemory, &Frame, sizeof(Frame));
+        }
+        else
+        {
+            *pRx->pMemory = (uint8_t)Frame;
+        }
+        if (pRx->pHandle->Initialization.MemInc == DMA_MEMORY_INCREMENT_ENABLED)
+        {
+            pRx->pMemory += isHalfWord ? 2U : 1U;
+        }
+        pReg[REG_SR] &= ~(SR_RXNE | SR_OVR);
+        if (--pRx->Remaining == 0U)
+        {
+            StreamDone(pRx);
+        }
+        Active = true;
+    }
+    return Active;
+}
+
+/* The transmit stream of a slave fills its empty transmit buffer */
+static void SlaveRefill(uint8_t Index)
+{
+    volatile uint32_t * pReg = SpiSim_Registers[Index];
+    Stream_t * pTx = FindStream(Index, DMA_MEMORY_TO_PERIPH);
+    if (!SlaveTxFull[Index] && pTx != NULL && (pReg[REG_CR2] & CR2_TXDMAEN) != 0U)
+    {
+        if (pTx->Fail)
+        {
+            pTx->Armed = false;
+            pTx->pHandle->State = DMA_STATE_ERROR;
+            if (pTx->pHandle->ErrorTransferCallBack != NULL)
+            {
+                pTx->pHandle->ErrorTransferCallBack();
+            }
+        }
+        else
+        {
+            bool isHalfWord = (pTx->pHandle->Initialization.MemAlignment == DMA_MDATAALIGN_HALFWORD);
+            SlaveTx[Index] = *pTx->pMemory;
+            if (isHalfWord)
+            {
+                memcpy(&SlaveTx[Index], pTx->pMemory, sizeof(SlaveTx[Index]));
+            }
+            pTx->pMemory += isHalfWord ? 2U : 1U;
+            SlaveTxFull[Index] = true;
+            pReg[REG_SR] &= ~SR_TXE;
+            if (--pTx->Remaining == 0U)
+            {
+                StreamDone(pTx);
+            }
+        }
+    }
+}
+
+/* One round of one SPI, returns true when something happened */
+static bool Step(uint8_t Index)
+{
+    volatile uint32_t * pReg = SpiSim_Registers[Index];
+    bool Active = false;
+    if ((pReg[REG_CR1] & (CR1_SPE | CR1_MSTR)) == (CR1_SPE | CR1_MSTR))
+    {
+        if ((pReg[REG_DR] & DR_RECEIVED) == 0U)
+        {
+            uint16_t Miso = Devices[Index](Index, (uint16_t)pReg[REG_DR]);
+            if ((pReg[REG_SR] & SR_RXNE) != 0U)
+            {
+                pReg[REG_SR] |= SR_OVR;
+                Overruns[Index]++;
+            }
+            pReg[REG_DR] = Miso | DR_RECEIVED;
+            pReg[REG_SR] |= SR_RXNE;
+            Bytes[Index]++;
+            TotalBytes++;
+            Active = true;
+        }
+
+        Active |= MoveRx(Index);
+
+        Stream_t * pTx = FindStream(Index, DMA_MEMORY_TO_PERIPH);
+        if (pTx != NULL && (pReg[REG_CR2] & CR2_TXDMAEN) != 0U &&
+            (pReg[REG_DR] & DR_RECEIVED) != 0U && (pReg[REG_SR] & SR_RXNE) == 0U)
+        {
+            if (pTx->Fail)
+            {
+                /* A transfer error disables the stream on target */
+                pTx->Armed = false;
+                pTx->pHandle->State = DMA_STATE_ERROR;
+                if (pTx->pHandle->ErrorTransferCallBack != NULL)
+                {
+                    pTx->pHandle->ErrorTransferCallBack();
+                }
+            }
+            else
+            {
+                bool isHalfWord = (pTx->pHandle->Initialization.MemAlignment == DMA_MDATAALIGN_HALFWORD);
+                uint16_t Frame = *pTx->pMemory;
+                if (isHalfWord)
+                {
+                    memcpy(&Frame, pTx->pMemory, sizeof(Frame));
+                }
+                if (pTx->pHandle->Initialization.MemInc == DMA_MEMORY_INCREMENT_ENABLED)
+                {
+                    pTx->pMemory += isHalfWord ? 2U : 1U;
+                }
+                pReg[REG_DR] = Frame;
+                if (--pTx->Remaining == 0U)
+                {
+                    StreamDone(pTx);
+                }
+            }
+            Active = true;
+        }
+
+        bool RxEvent = ((pReg[REG_CR2] & CR2_RXNEIE) != 0U) && ((pReg[REG_SR] & SR_RXNE) != 0U);
+        bool TxEvent = ((pReg[REG_CR2] & CR2_TXEIE) != 0U) && ((pReg[REG_SR] & SR_TXE) != 0U);
+        if (RxEvent || TxEvent)
+        {
+            IRQHandlers[Index]();
+            if (RxEvent)
+            {
+                pReg[REG_SR] &= ~(SR_RXNE | SR_OVR);
+            }
+            Active = true;
+        }
+    }
+    return Active;
+}
+
+
+/* The frame in the shift register moves on by one access */
+static void PolledShift(volatile uint32_t * pReg)
+{
+    uint16_t Miso;
+    if ((pReg[REG_CR1] & (CR1_SPE | CR1_MSTR)) == (CR1_SPE | CR1_MSTR))
+    {
+        if (Polled.ShiftLeft != 0U && --Polled.ShiftLeft == 0U)
+        {
+            Miso = Devices[Polled.Index](Polled.Index, Polled.Shift);
+            if ((pReg[REG_SR] & SR_RXNE) != 0U)
+            {
+                /* DR keeps the frame not read yet, the new one is lost */
+                pReg[REG_SR] |= SR_OVR;
+                Overruns[Polled.Index]++;
+            }
+            else
+            {
+                Polled.RxBuffer = Miso;
+                pReg[REG_DR] = Miso | DR_RECEIVED;
+                pReg[REG_SR] |= SR_RXNE;
+            }
+            Bytes[Polled.Index]++;
+            TotalBytes++;
+            Polled.Stats.Frames++;
+            if (!Polled.TxFull)
+            {
+                Polled.Stats.Gaps++;
+            }
+            if (Polled.Stats.Frames == Polled.FaultFrame)
+            {
+                /* The fault disables the SPI, the frame waiting is dropped */
+                pReg[REG_SR] |= SR_MODF;
+                pReg[REG_CR1] &= ~(CR1_SPE | CR1_MSTR);
+                Polled.TxFull = false;
+                Polled.FaultFrame = 0U;
+            }
+        }
+        if (Polled.ShiftLeft == 0U && Polled.TxFull)
+        {
+            Polled.Shift = Polled.TxBuffer;
+            Polled.TxFull = false;
+            Polled.ShiftLeft = Polled.FrameAccesses;
+        }
+    }
+    pReg[REG_SR] = (Polled.TxFull) ? (pReg[REG_SR] & ~SR_TXE) : (pReg[REG_SR] | SR_TXE);
+    pReg[REG_SR] = (Polled.TxFull || Polled.ShiftLeft != 0U) ? (pReg[REG_SR] | SR_BSY) :
+                                                                (pReg[REG_SR] & ~SR_BSY);
+}
+
+/* Effect of one access of the driver, once it was made */
+static void PolledAccess(uint32_t Word)
+{
+    uint8_t Index = (uint8_t)(Word / SPISIM_REGISTERS);
+    uint32_t Reg = Word % SPISIM_REGISTERS;
+    volatile uint32_t * pReg = SpiSim_Registers[Index];
+    if (Index == Polled.Index)
+    {
+        Polled.Stats.Accesses++;
+        if (Reg == REG_DR && (pReg[REG_DR] & DR_RECEIVED) == 0U)
+        {
+            Polled.TxBuffer = (uint16_t)pReg[REG_DR];
+            Polled.TxFull = true;
+            pReg[REG_DR] = Polled.RxBuffer | DR_RECEIVED;
+        }
+        else if (Reg == REG_DR)
+        {
+            pReg[REG_SR] &= ~SR_RXNE;
+            Polled.DRRead = true;
+        }
+        else if (Reg == REG_SR)
+        {
+            if (Polled.DRRead)
+            {
+                pReg[REG_SR] &= ~SR_OVR;
+            }
+            Polled.DRRead = false;
+            Polled.SRReadModf = ((pReg[REG_SR] & SR_MODF) != 0U);
+        }
+        else if (Reg == REG_CR1)
+        {
+            if (Polled.SRReadModf)
+            {
+                pReg[REG_SR] &= ~SR_MODF;
+                Polled.SRReadModf = false;
+            }
+            if ((Polled.CR1Before & CR1_SPE) != 0U && (pReg[REG_CR1] & CR1_SPE) == 0U)
+            {
+                Polled.Stats.Disables++;
+            }
+        }
+        PolledShift(pReg);
+        if (Polled.StallFrame != 0U && Polled.Stats.Frames >= Polled.StallFrame)
+        {
+            /* An interrupt keeps the driver away, SCK runs on */
+            Polled.StallFrame = 0U;
+            for (uint32_t Access = 0; Access < Polled.StallAccesses; Access++)
+            {
+                PolledShift(pReg);
+            }
+        }
+    }
+}
+
+#if POLLED_SUPPORTED
+/* An access to the protected registers, let it run once */
+static void PolledFault(int Signal, siginfo_t * pInfo, void * pContext)
+{
+    uintptr_t Address = (uintptr_t)pInfo->si_addr;
+    uintptr_t Base = (uintptr_t)&SpiSim_Page;
+    if (!Polled.Active || Address < Base || Address >= Base + sizeof(SpiSim_Page.Registers))
+    {
+        /* A real fault, the access faults again without the handler */
+        signal(Signal, SIG_DFL);
+    }
+    else
+    {
+        mprotect(&SpiSim_Page, sizeof(SpiSim_Page), PROT_READ | PROT_WRITE);
+        Polled.Word = (uint32_t)((Address - Base) / sizeof(uint32_t));
+        Polled.CR1Before = SpiSim_Registers[Polled.Index][REG_CR1];
+        ((ucontext_t *)pContext)->uc_mcontext.gregs[REG_EFL] |= RFLAGS_TF;
+    }
+}
+
+/* The access was made, its effect is played before the next one */
+static void PolledTrap(int Signal, siginfo_t * pInfo, void * pContext)
+{
+    (void)Signal;
+    (void)pInfo;
+    ((ucontext_t *)pContext)->uc_mcontext.gregs[REG_EFL] &= ~RFLAGS_TF;
+    PolledAccess(Polled.Word);
+    mprotect(&SpiSim_Page, sizeof(SpiSim_Page), PROT_NONE);
+}
+#endif
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+void SpiSim_Reset(void)
+{
+    for (uint8_t Index = 0; Index < SPISIM_INSTANCES; Index++)
+    {
+        for (uint8_t Reg = 0; Reg < SPISIM_REGISTERS; Reg++)
+        {
+            SpiSim_Registers[Index][Reg] = 0;
+        }
+        SpiSim_Registers[Index][REG_SR] = SR_TXE;
+        SpiSim_Registers[Index][REG_DR] = DR_RECEIVED;
+        Devices[Index] = Loopback;
+        SlaveTx[Index] = 0;
+        SlaveTxFull[Index] = false;
+        Bytes[Index] = 0;
+        Overruns[Index] = 0;
+    }
+    TotalBytes = 0;
+    CSLogCount = 0;
+    memset(Streams, 0, sizeof(Streams));
+    memset(LineCallBacks, 0, sizeof(LineCallBacks));
+    LinesMasked   = 0;
+    LinesDisabled = 0;
+    LinesPending  = 0;
+    LinesOnLock   = 0;
+}
+
+void SpiSim_SetDevice(uint8_t Index, SpiSim_Device_t Device)
+{
+    Devices[Index] = (Device != NULL) ? Device : Loopback;
+}
+
+uint32_t SpiSim_Run(uint32_t MaxSteps)
+{
+    uint32_t Start = TotalBytes;
+    bool Active = true;
+    while (Active && MaxSteps != 0U)
+    {
+        Active = false;
+        for (uint8_t Index = 0; Index < SPISIM_INSTANCES; Index++)
+        {
+            Active |= Step(Index);
+        }
+        MaxSteps--;
+    }
+    return TotalBytes - Start;
+}
+
+uint16_t SpiSim_SlaveExchange(uint8_t Index, uint16_t Mosi)
+{
+    volatile uint32_t * pReg = SpiSim_Registers[Index];
+    uint16_t Miso = SlaveTx[Index];
+    if ((pReg[REG_CR1] & (CR1_SPE | CR1_MSTR)) == CR1_SPE)
+    {
+        SlaveRefill(Index);
+        /* An empty transmit buffer sends its last frame again */
+        Miso = SlaveTx[Index];
+        SlaveTxFull[Index] = false;
+        pReg[REG_SR] |= SR_TXE;
+        if ((pReg[REG_SR] & SR_RXNE) != 0U)
+        {
+            pReg[REG_SR] |= SR_OVR;
+            Overruns[Index]++;
+        }
+        pReg[REG_DR] = Mosi | DR_RECEIVED;
+        pReg[REG_SR] |= SR_RXNE;
+        Bytes[Index]++;
+        TotalBytes++;
+        MoveRx(Index);
+        SlaveRefill(Index);
+    }
+    return Miso;
+}
+
+void SpiSim_Edge(uint8_t Line)
+{
+    if (Line >= EXTI_LINES || (LinesMasked & (1UL << Line)) != 0U)
+    {
+        /* A masked line does not latch the edge */
+    }
+    else if ((LinesDisabled & (1UL << Line)) != 0U)
+    {
+        LinesPending |= 1UL << Line;
+    }
+    else if (LineCallBacks[Line] != NULL)
+    {
+        LineCallBacks[Line]();
+    }
+}
+
+void SpiSim_EdgeOnLock(uint8_t Line)
+{
+    LinesOnLock |= 1UL << Line;
+}
+
+/* The edge asked by SpiSim_EdgeOnLock, now that the line is masked */
+static void RaiseOnLock(uint8_t Line)
+{
+    if ((LinesOnLock & (1UL << Line)) != 0U)
+    {
+        LinesOnLock &= ~(1UL << Line);
+        SpiSim_Edge(Line);
+    }
+}
+
+uint32_t SpiSim_GetBytes(uint8_t Index)
+{
+    return Bytes[Index];
+}
+
+uint32_t SpiSim_GetOverruns(uint8_t Index)
+{
+    return Overruns[Index];
+}
+
+void SpiSim_FailDMA(uint8_t Index)
+{
+    Stream_t * pTx = FindStream(Index, DMA_MEMORY_TO_PERIPH);
+    if (pTx != NULL)
+    {
+        pTx->Fail = true;
+    }
+}
+
+bool SpiSim_StartPolled(uint8_t Index, uint32_t FrameAccesses)
+{
+    bool Started = false;
+#if POLLED_SUPPORTED
+    struct sigaction Action;
+    memset(&Action, 0, sizeof(Action));
+    Action.sa_flags = SA_SIGINFO;
+    sigemptyset(&Action.sa_mask);
+    Action.sa_sigaction = PolledFault;
+    sigaction(SIGSEGV, &Action, NULL);
+    Action.sa_sigaction = PolledTrap;
+    sigaction(SIGTRAP, &Action, NULL);
+
+    memset(&Polled, 0, sizeof(Polled));
+    Polled.Index = Index;
+    Polled.FrameAccesses = (FrameAccesses != 0U) ? FrameAccesses : 1U;
+    Polled.RxBuffer = (uint16_t)SpiSim_Registers[Index][REG_DR];
+    Polled.Active = true;
+    Started = (mprotect(&SpiSim_Page, sizeof(SpiSim_Page), PROT_NONE) == 0);
+    Polled.Active = Started;
+#else
+    (void)Index;
+    (void)FrameAccesses;
+#endif
+    return Started;
+}
+
+void SpiSim_StopPolled(SpiSim_Polled_t * pPolled)
+{
+    if (Polled.Active)
+    {
+        mprotect(&SpiSim_Page, sizeof(SpiSim_Page), PROT_READ | PROT_WRITE);
+        Polled.Active = false;
+        signal(SIGSEGV, SIG_DFL);
+        signal(SIGTRAP, SIG_DFL);
+    }
+    if (pPolled != NULL)
+    {
+        *pPolled = Polled.Stats;
+    }
+}
+
+void SpiSim_ModeFault(uint32_t Frames)
+{
+    Polled.FaultFrame = Polled.Stats.Frames + Frames;
+}
+
+void SpiSim_Stall(uint32_t Frames, uint32_t Accesses)
+{
+    Polled.StallFrame = Polled.Stats.Frames + Frames;
+    Polled.StallAccesses = Accesses;
+}
+
+const SpiSim_CSEvent_t * SpiSim_GetCSLog(uint32_t * pCount)
+{
+    *pCount = CSLogCount;
+    return CSLog;
+}
+
+/* Chip selects of the driver end here instead of the GPIO driver */
+GPIO_enuErrorStatus GPIO_SetPinValue(void * GPIO_Port, uint8_t GPIO_Pin, uint32_t GPIO_State)
+{
+    if (CSLogCount < SPISIM_CS_LOG_SIZE)
+    {
+        CSLog[CSLogCount].Port  = GPIO_Port;
+        CSLog[CSLogCount].Pin   = GPIO_Pin;
+        CSLog[CSLogCount].Low   = (GPIO_State == GPIO_STATE_RESET);
+        CSLog[CSLogCount].Bytes = TotalBytes;
+        CSLogCount++;
+    }
+    return GPIO_SUCCESS;
+}
+
+/* Pins, clocks and interrupt lines of the services have nothing to set up */
+GPIO_enuErrorStatus GPIO_Init(gpioPin_t * gpioPin)
+{
+    (void)gpioPin;
+    return GPIO_SUCCESS;
+}
+
+RCC_enuErrorStatus RCC_enuEnablePeripheral(uint32_t PERIPHERAL)
+{
+    (void)PERIPHERAL;
+    return RCC_FUNC_DONE;
+}
+
+/* Only the interrupts of EXTI lines 0 to 4 are modelled */
+NVIC_ErrorStatus_t NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    if (IRQn >= EXTI0_IRQn && IRQn <= EXTI4_IRQn)
+    {
+        uint8_t Line = (uint8_t)(IRQn - EXTI0_IRQn);
+        LinesDisabled &= ~(1UL << Line);
+        if ((LinesPending & (1UL << Line)) != 0U)
+        {
+            LinesPending &= ~(1UL << Line);
+            SpiSim_Edge(Line);
+        }
+    }
+    return NVIC_OK;
+}
+
+NVIC_ErrorStatus_t NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    if (IRQn >= EXTI0_IRQn && IRQn <= EXTI4_IRQn)
+    {
+        uint8_t Line = (uint8_t)(IRQn - EXTI0_IRQn);
+        LinesDisabled |= 1UL << Line;
+        RaiseOnLock(Line);
+    }
+    return NVIC_OK;
+}
+
+/* The streams of the driver end here instead of the DMA driver */
+DMA_ErrorStatus_t DMA_Init(DMA_Handle_t * pHandleDMA, uint32_t TimeOut)
+{
+    DMA_ErrorStatus_t RET_ErrorStatus = DMA_OK;
+    Stream_t * pStream = &Streams[(pHandleDMA->Instance == DMA2) ? 1U : 0U][pHandleDMA->Stream & 0xFU];
+    (void)TimeOut;
+    if (pStream->Armed)
+    {
+        /* Still enabled, DMA_Init gives up after its time out */
+        RET_ErrorStatus = DMA_TIMEOUT;
+    }
+    else
+    {
+        memset(pStream, 0, sizeof(*pStream));
+        pStream->pHandle = pHandleDMA;
+        pHandleDMA->State = DMA_STATE_READY;
+    }
+    return RET_ErrorStatus;
+}
+
+DMA_ErrorStatus_t DMA_StartInterrupt(DMA_Handle_t * pHandleDMA, void * srcAddress,
+                                     void * destAddress, uint32_t DataLength)
+{
+    Stream_t * pStream = &Streams[(pHandleDMA->Instance == DMA2) ? 1U : 0U][pHandleDMA->Stream & 0xFU];
+    bool isReceive = (pHandleDMA->Initialization.Direction == DMA_PERIPH_TO_MEMORY);
+    pStream->pHandle     = pHandleDMA;
+    pStream->pPeripheral = isReceive ? srcAddress : destAddress;
+    pStream->pMemory     = isReceive ? destAddress : srcAddress;
+    pStream->pStart      = pStream->pMemory;
+    pStream->Length      = DataLength;
+    pStream->Remaining   = DataLength;
+    pStream->Armed       = (DataLength != 0U);
+    pStream->Fail        = false;
+    pHandleDMA->State     = DMA_STATE_BUSY;
+    pHandleDMA->pSegments = NULL;
+    pHandleDMA->Segments  = 0U;
+    pHandleDMA->Segment   = 0U;
+    return DMA_OK;
+}
+
+DMA_ErrorStatus_t DMA_StartChain(DMA_Handle_t * pHandleDMA, void * pPeripheral,
+                                 const DMA_Segment_t * pSegments, uint32_t Segments)
+{
+    DMA_ErrorStatus_t RET_ErrorStatus = DMA_StartInterrupt(pHandleDMA, pSegments[0].pMemory, pPeripheral,
+                                                           pSegments[0].Length);
+    pHandleDMA->pSegments = pSegments;
+    pHandleDMA->Segments  = Segments;
+    return RET_ErrorStatus;
+}
+
+DMA_ErrorStatus_t DMA_Abort(DMA_Handle_t * pHandleDMA, uint32_t TimeOut)
+{
+    Stream_t * pStream = &Streams[(pHandleDMA->Instance == DMA2) ? 1U : 0U][pHandleDMA->Stream & 0xFU];
+    (void)TimeOut;
+    pStream->Armed = false;
+    pHandleDMA->State = DMA_STATE_READY;
+    return DMA_OK;
+}
+
+DMA_ErrorStatus_t DMA_GetCounter(DMA_Handle_t * pHandleDMA, uint32_t * pCounter)
+{
+    Stream_t * pStream = &Streams[(pHandleDMA->Instance == DMA2) ? 1U : 0U][pHandleDMA->Stream & 0xFU];
+    *pCounter = pStream->Armed ? pStream->Remaining : 0U;
+    return DMA_OK;
+}
+
+DMA_ErrorStatus_t DMA_GetProgress(DMA_Handle_t * pHandleDMA, uint32_t * pDone)
+{
+    Stream_t * pStream = &Streams[(pHandleDMA->Instance == DMA2) ? 1U : 0U][pHandleDMA->Stream & 0xFU];
+    *pDone = pStream->Length - pStream->Remaining;
+    for (uint32_t Piece = 0; pHandleDMA->pSegments != NULL && Piece < pHandleDMA->Segment; Piece++)
+    {
+        *pDone += pHandleDMA->pSegments[Piece].Length;
+    }
+    return DMA_OK;
+}
+
+/* Edges are raised by SpiSim_Edge */
+EXTI_ErrorStatus_t EXTI_Init(const EXTI_Config_t * pConfig)
+{
+    LineCallBacks[pConfig->Pin] = pConfig->CallBack;
+    LinesMasked &= ~(1UL << pConfig->Pin);
+    return EXTI_OK;
+}
+
+EXTI_ErrorStatus_t EXTI_Disable(uint8_t Line)
+{
+    LinesMasked |= 1UL << Line;
+    RaiseOnLock(Line);
+    return EXTI_OK;
+}
+
+EXTI_ErrorStatus_t EXTI_Enable(uint8_t Line)
+{
+    LinesMasked &= ~(1UL << Line);
+    return EXTI_OK;
+}
+
+/******************************************************************************/
@@ -0,0 +1,225 @@
+/*******************************************************************************/
+/**
+ * @file spi_sim.h
+ * @brief Simulated register blocks of SPI1 to SPI4.
+ *
+ * @par Project Name
+ * SPI Simulator
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Included before every source, it points SPI1 to SPI4 of stm32f4xx_spi.h
+ * at RAM. SpiSim_Run plays the peripherals: each byte written in DR is
+ * exchanged with a device model, then RXNE is raised and SPIx_IRQHandler is
+ * called while its interrupt is enabled, like the NVIC would. DMA_Init and
+ * DMA_StartInterrupt arm simulated streams which move the frames while
+ * RXDMAEN/TXDMAEN are set. Chip select changes made with GPIO_SetPinValue
+ * are logged with the byte count they happened at. A slave is clocked by
+ * SpiSim_SlaveExchange and SpiSim_Edge calls the callback given to
+ * EXTI_Init for a line. DMA_Abort, DMA_GetCounter and DMA_GetProgress work
+ * on the simulated streams, circular ones included, and a stream started by
+ * DMA_StartChain takes its next piece where the DMA interrupt would. The
+ * streams keep the state of their handle like the DMA interrupt. GPIO_Init,
+ * RCC_enuEnablePeripheral and the NVIC enable/disable calls of the services
+ * do nothing, but for the EXTI0 to EXTI4 interrupts: an edge is kept pending
+ * while its interrupt is disabled in the NVIC and dropped while its line is
+ * masked with EXTI_Disable, as on target. Between SpiSim_StartPolled and SpiSim_StopPolled every access
+ * of the driver to the registers of one SPI moves its shift register on, so
+ * the polled calls see the frames come in while they run.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ ******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef SPI_SIM_H_
+#define SPI_SIM_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC DEFINES */
+/******************************************************************************/
+
+#define SPISIM_INSTANCES                (4U)
+/** Words of one register block, CR1 to I2SPR */
+#define SPISIM_REGISTERS                (9U)
+#define SPISIM_CS_LOG_SIZE              (4096U)
+/** The registers fill one page of the host, protected while polled */
+#define SPISIM_PAGE_SIZE                (4096U)
+
+#define SpiSim_Registers                (SpiSim_Page.Registers)
+
+#define SPI1                            ((void*)SpiSim_Registers[0])
+#define SPI2                            ((void*)SpiSim_Registers[1])
+#define SPI3                            ((void*)SpiSim_Registers[2])
+#define SPI4                            ((void*)SpiSim_Registers[3])
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC TYPES */
+/******************************************************************************/
+
+/**
+ * @brief Slave on the bus of one SPI.
+ * @param Index Index of the SPI, 0 for SPI1.
+ * @param Mosi  Frame sent by the driver, 8 or 16 bits.
+ * @return Frame answered on MISO.
+ */
+typedef uint16_t (*SpiSim_Device_t)(uint8_t Index, uint16_t Mosi);
+
+/** One chip select change. */
+typedef struct
+{
+    void * Port;
+    uint8_t Pin;
+    bool Low;           /**< true when selected */
+    uint32_t Bytes;     /**< Bytes exchanged on every SPI before the change */
+} SpiSim_CSEvent_t;
+
+/** Register blocks of the four SPIs, alone in their page. */
+typedef struct
+{
+    volatile uint32_t Registers[SPISIM_INSTANCES][SPISIM_REGISTERS];
+    uint8_t Unused[SPISIM_PAGE_SIZE - (SPISIM_INSTANCES * SPISIM_REGISTERS * sizeof(uint32_t))];
+} SpiSim_Page_t;
+
+/** What the shift register of the polled SPI did. */
+typedef struct
+{
+    uint32_t Accesses;  /**< Register accesses of the driver */
+    uint32_t Frames;    /**< Frames shifted */
+    uint32_t Gaps;      /**< Frames which ended with the transmit buffer empty, SCK stopped */
+    uint32_t Disables;  /**< Times the driver cleared SPE */
+} SpiSim_Polled_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC VARIABLE DECLARATIONS */
+/******************************************************************************/
+
+extern SpiSim_Page_t SpiSim_Page;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION PROTOTYPES */
+/******************************************************************************/
+
+/** @brief Registers at their reset value, loopback devices, empty log. */
+void SpiSim_Reset(void);
+
+/** @brief Sets the device answering on one SPI, NULL for a loopback. */
+void SpiSim_SetDevice(uint8_t Index, SpiSim_Device_t Device);
+
+/**
+ * @brief Runs every SPI until none of them has work left.
+ * @param MaxSteps Bound on the rounds, a driver which never stops fails it.
+ * @return Bytes exchanged during the call.
+ */
+uint32_t SpiSim_Run(uint32_t MaxSteps);
+
+/**
+ * @brief The master clocks one frame of a slave SPI.
+ * @param Index Index of the SPI, its SPE set and MSTR clear.
+ * @param Mosi  Frame sent by the master.
+ * @return Frame of the transmit buffer of the slave.
+ */
+uint16_t SpiSim_SlaveExchange(uint8_t Index, uint16_t Mosi);
+
+/** @brief An edge on an EXTI line, its callback runs like the interrupt would. */
+void SpiSim_Edge(uint8_t Line);
+
+/**
+ * @brief An edge on an EXTI line, raised as soon as the code masks it.
+ *
+ * Gives the edge which comes in while a service holds its lock, with
+ * EXTI_Disable or NVIC_DisableIRQ. Lines 0 to 4 only.
+ */
+void SpiSim_EdgeOnLock(uint8_t Line);
+
+/** @brief Bytes exchanged on one SPI since SpiSim_Reset. */
+uint32_t SpiSim_GetBytes(uint8_t Index);
+
+/** @brief Times one SPI raised OVR since SpiSim_Reset. */
+uint32_t SpiSim_GetOverruns(uint8_t Index);
+
+/** @brief The armed transmit stream of one SPI fails at its next request. */
+void SpiSim_FailDMA(uint8_t Index);
+
+/**
+ * @brief Moves the shift register of one SPI on at every access of the driver
+ *        to its registers, until SpiSim_StopPolled.
+ *
+ * The page of the registers is protected, each access traps and is single
+ * stepped, which needs Linux on x86-64. Only the polled SPI may be used
+ * meanwhile, its DMA and interrupts are not played.
+ *
+ * @param Index         Index of the SPI, a master.
+ * @param FrameAccesses Accesses one frame takes to shift, the speed of SCK
+ *                      against the polling loop.
+ * @return false when the host cannot trap the accesses.
+ */
+bool SpiSim_StartPolled(uint8_t Index, uint32_t FrameAccesses);
+
+/**
+ * @brief Ends SpiSim_StartPolled, the registers can be read again.
+ * @param[out] pPolled What the shift register did, may be NULL.
+ */
+void SpiSim_StopPolled(SpiSim_Polled_t * pPolled);
+
+/**
+ * @brief The NSS input of the polled master goes low once Frames more frames
+ *        were shifted: MODF is raised, SPE and MSTR are cleared.
+ */
+void SpiSim_ModeFault(uint32_t Frames);
+
+/**
+ * @brief An interrupt delays the driver once Frames more frames were shifted,
+ *        the polled SPI shifts on for Accesses accesses meanwhile.
+ */
+void SpiSim_Stall(uint32_t Frames, uint32_t Accesses);
+
+/**
+ * @brief Chip select changes since SpiSim_Reset.
+ * @param[out] pCount Number of events.
+ */
+const SpiSim_CSEvent_t * SpiSim_GetCSLog(uint32_t * pCount);
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* SPI_SIM_H_ */
+/******************************************************************************/
@@ -46,6 +46,8 @@ extern "C"
 
 #define CFG_APP_MASTER                 0
 #define CFG_APP_SLAVE                  1
+#define CFG_APP_DMA_BENCH              2
+#define CFG_APP_SPI_BENCH              3
 
 
 
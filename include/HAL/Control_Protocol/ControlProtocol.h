@@ -41,6 +41,7 @@ extern "C"
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include "ControlProtocol_CFG.h"
 /******************************************************************************/
 
 /******************************************************************************/
@@ -64,7 +65,10 @@ extern "C"
 typedef enum
 {
     PROTOCOL_OK,
-    PROTOCOL_ERROR
+    PROTOCOL_ERROR,
+    PROTOCOL_QUEUE_FULL,    /**< The channel can not take more messages */
+    PROTOCOL_QUEUE_EMPTY,   /**< No message waiting on the channel */
+    PROTOCOL_NO_BUFFER      /**< The buffer pool is exhausted */
 } PROTOCOL_ErrorStatus_t;
 
 
@@ -92,14 +96,33 @@ typedef struct
     char  pMessage[NUMBER_OF_DATA]; /**< Pointer to the message data */
     uint16_t len;                   /**< Length of the message data */
     Protocol_CallBack CallBack;     /**< Callback function for message handling */
+    uint8_t Channel;                /**< Logical channel, @ref Protocol_Channel_t */
 } Message_t;
 
+/* Struct defining a pooled message buffer, see protocol_buffer.h */
+typedef struct
+{
+    Message_t Msg;          /**< Message, filled in place */
+    uint8_t   RefCount;     /**< Owned by the pool, do not change */
+} Protocol_Buffer_t;
+
+/* Struct defining the configuration of a logical channel */
+typedef struct
+{
+    uint8_t Priority;       /**< 0 is the highest, picked first between frames */
+    uint8_t TxQueueDepth;   /**< Messages waiting to be sent, up to PROTOCOL_MAX_QUEUE_DEPTH */
+    uint8_t RxQueueDepth;   /**< Messages waiting to be read, also the credits of the sender */
+} Protocol_ChannelCfg_t;
+
 /******************************************************************************/
 
 /******************************************************************************/
 /* PUBLIC CONSTANT DECLARATIONS */
 /******************************************************************************/
 
+/** Channels configuration, defined in ControlProtocol_CFG.c */
+extern const Protocol_ChannelCfg_t ProtocolChannels[_PROTOCOL_CHANNELS_NUM];
+
 /******************************************************************************/
 
 /******************************************************************************/
@@ -119,16 +142,66 @@ typedef struct
 PROTOCOL_ErrorStatus_t Protocol_Init(void);
 
 /** @brief Sends a message asynchronously 
+ *
+ *  The message is copied into a pooled buffer queued on msg->Channel, so it
+ *  can be reused as soon as the function returns. Between two frames the queued
+ *  message of the highest priority channel having credits goes first.
+ *  msg->CallBack is called once the other side acknowledged it.
+ *
  *  @param[in] msg Pointer to the message to be sent
- *  @return Error Status
+ *  @return PROTOCOL_OK, PROTOCOL_ERROR for a wrong message or
+ *          PROTOCOL_QUEUE_FULL when the channel queue is full
  */
 PROTOCOL_ErrorStatus_t Protocol_SendAsync(Message_t * msg);
 
+/** @brief Queues a pooled buffer for sending, without copying it
+ *
+ *  The protocol takes its own reference on the buffer and drops it once
+ *  the frame is acknowledged, the caller releases its reference whenever it
+ *  is done with the buffer. pBuffer->Msg.CallBack is called on the ACK.
+ *
+ *  @param[in] pBuffer Buffer taken with Protocol_BufferAlloc
+ *  @return PROTOCOL_OK, PROTOCOL_ERROR or PROTOCOL_QUEUE_FULL
+ */
+PROTOCOL_ErrorStatus_t Protocol_SendBuffer(Protocol_Buffer_t * pBuffer);
+
 /** @brief Receives a message asynchronously 
+ *
+ *  Every message arriving on msg->Channel is copied into msg and
+ *  msg->CallBack is called, until another buffer is registered.
+ *
  *  @param[in out] Frame Pointer to store the received message
  *  @return Error Status
  */
 PROTOCOL_ErrorStatus_t Protocol_ReceiveAsync(Message_t* msg);
+
+/** @brief Reads the oldest message received on a channel
+ *
+ *  For channels without a buffer registered by Protocol_ReceiveAsync.
+ *  Messages wait in the channel receive queue, the sender stops when the
+ *  queue is full and goes on once a message has been read.
+ *
+ *  @param[in]  Channel Logical channel, @ref Protocol_Channel_t
+ *  @param[out] msg     Filled with the message
+ *  @return PROTOCOL_OK, PROTOCOL_ERROR or PROTOCOL_QUEUE_EMPTY
+ */
+PROTOCOL_ErrorStatus_t Protocol_Read(uint8_t Channel, Message_t * msg);
+
+/** @brief Takes the oldest buffer received on a channel, without copying it
+ *
+ *  The frame was received in place in this buffer, the caller now owns its
+ *  reference and must give it back with Protocol_BufferRelease.
+ *
+ *  @param[in]  Channel  Logical channel, @ref Protocol_Channel_t
+ *  @param[out] ppBuffer Set to the received buffer
+ *  @return PROTOCOL_OK, PROTOCOL_ERROR or PROTOCOL_QUEUE_EMPTY
+ */
+PROTOCOL_ErrorStatus_t Protocol_ReadBuffer(uint8_t Channel, Protocol_Buffer_t ** ppBuffer);
+
+/** @brief Sends again the frames which were not acknowledged in time
+ *  @note Must be called every PROTOCOL_RUNNABLE_PERIOD_MS
+ */
+void Protocol_Runnable(void);
 /******************************************************************************/
 
 /******************************************************************************/
@@ -0,0 +1,120 @@
+/*******************************************************************************/
+/**
+ * @file ControlProtocol_CFG.h
+ * @brief Configuration of the control protocol.
+ *
+ * @par Project Name
+ * Control Protocol
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Lists the logical channels multiplexed over the physical link and sizes
+ * their queues. The priority and the queue depths of every channel are set
+ * in ControlProtocol_CFG.c. Both micro-controllers must be built with the
+ * same configuration.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ ******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef CONTROL_PROTOCOL_CFG_H_
+#define CONTROL_PROTOCOL_CFG_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC DEFINES */
+/******************************************************************************/
+
+/**
+ * @def PROTOCOL_MAX_QUEUE_DEPTH
+ * @brief Number of slots reserved for every transmit and receive queue.
+ *
+ * The depth configured for a channel in ControlProtocol_CFG.c can not be
+ * larger than this value.
+ */
+#define PROTOCOL_MAX_QUEUE_DEPTH            (4U)
+
+/**
+ * @def PROTOCOL_BUFFER_POOL_SIZE
+ * @brief Number of message buffers shared by all channels and directions.
+ *
+ * Every queued message, transmit or receive, holds one buffer until it is
+ * acknowledged or read, plus one buffer for the frame being received. When
+ * the pool is empty new frames are refused and the credits sent to the other
+ * side drop to 0.
+ */
+#define PROTOCOL_BUFFER_POOL_SIZE           (12U)
+
+/**
+ * @def PROTOCOL_RUNNABLE_PERIOD_MS
+ * @brief Period at which Protocol_Runnable is called, its entry of
+ * AllRunnablesSystemList in schedular_CFG.c uses it.
+ */
+#define PROTOCOL_RUNNABLE_PERIOD_MS         (10U)
+
+/**
+ * @def PROTOCOL_ACK_TIMEOUT_MS
+ * @brief Time to wait for the ACK of a frame before sending it again.
+ *
+ * Counted by Protocol_Runnable, not 0. A new frame waits for the ACK of the
+ * previous one, so only this timeout recovers a lost frame or a lost ACK, a
+ * NACK only comes for a frame which arrived damaged.
+ */
+#define PROTOCOL_ACK_TIMEOUT_MS             (200U)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC ENUMS */
+/******************************************************************************/
+
+/**
+ * @brief Logical channels carried by the link.
+ *
+ * @note _PROTOCOL_CHANNELS_NUM must remain the last element, at most 8
+ * channels are supported because each one gets a credit byte in the ACK
+ * frame.
+ */
+typedef enum
+{
+    PROTOCOL_CHANNEL_CONTROL,       /**< Button commands, latency critical */
+    PROTOCOL_CHANNEL_DIAGNOSTICS,   /**< Bulk diagnostics stream */
+    _PROTOCOL_CHANNELS_NUM
+} Protocol_Channel_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* CONTROL_PROTOCOL_CFG_H_ */
+/******************************************************************************/
@@ -0,0 +1,112 @@
+/*******************************************************************************/
+/**
+ * @file protocol_buffer.h
+ * @brief Message buffer pool of the control protocol.
+ *
+ * @par Project Name
+ * Control Protocol
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Fixed pool of PROTOCOL_BUFFER_POOL_SIZE buffers, sized at compile time in
+ * ControlProtocol_CFG.h, without heap. Buffers are reference counted: the
+ * protocol holds a reference while a buffer waits in a queue, and every
+ * other user takes its own with Protocol_BufferRetain. A buffer goes back
+ * to the pool when its last reference is released. Safe to call from the
+ * application and from the transport callbacks.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ ******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef PROTOCOL_BUFFER_H_
+#define PROTOCOL_BUFFER_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include "ControlProtocol.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC TYPES */
+/******************************************************************************/
+
+/* Struct defining the usage counters of the pool */
+typedef struct
+{
+    uint8_t  Size;          /**< PROTOCOL_BUFFER_POOL_SIZE */
+    uint8_t  InUse;         /**< Buffers currently allocated */
+    uint8_t  PeakInUse;     /**< Highest InUse since Protocol_Init */
+    uint32_t Exhausted;     /**< Allocations refused because the pool was empty */
+} Protocol_BufferStats_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION PROTOTYPES */
+/******************************************************************************/
+
+/** @brief Puts every buffer back in the pool and clears the counters
+ *  @note Called by Protocol_Init
+ */
+void Protocol_BufferInit(void);
+
+/** @brief Takes a buffer from the pool
+ *  @param[out] ppBuffer Set to the buffer, its reference count is 1
+ *  @return PROTOCOL_OK, PROTOCOL_ERROR or PROTOCOL_NO_BUFFER
+ */
+PROTOCOL_ErrorStatus_t Protocol_BufferAlloc(Protocol_Buffer_t ** ppBuffer);
+
+/** @brief Adds a reference to a buffer
+ *  @param[in] pBuffer Allocated buffer
+ *  @return Error Status
+ */
+PROTOCOL_ErrorStatus_t Protocol_BufferRetain(Protocol_Buffer_t * pBuffer);
+
+/** @brief Drops a reference, the buffer goes back to the pool with the last one
+ *  @param[in] pBuffer Allocated buffer
+ *  @return Error Status
+ */
+PROTOCOL_ErrorStatus_t Protocol_BufferRelease(Protocol_Buffer_t * pBuffer);
+
+/** @brief Returns the number of buffers left in the pool */
+uint8_t Protocol_BufferFreeCount(void);
+
+/** @brief Reads the usage counters of the pool
+ *  @param[out] pStats Filled with the counters
+ *  @return Error Status
+ */
+PROTOCOL_ErrorStatus_t Protocol_GetBufferStats(Protocol_BufferStats_t * pStats);
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* PROTOCOL_BUFFER_H_ */
+/******************************************************************************/
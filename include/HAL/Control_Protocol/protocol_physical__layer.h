@@ -1,16 +1,16 @@
 /*******************************************************************************/
 /**
- * @file FILE.h
- * @brief 
+ * @file protocol_physical__layer.h
+ * @brief Transport used by the control protocol.
  *
  * @par Project Name
- * 
+ * Control Protocol
  *
  * @par Code Language
  * C
  *
  * @par Description
- * 
+ * Functions every link carrying the control protocol has to provide.
  *
  * @par Author
  * Mahmoud Abou-Hawis
@@ -82,12 +82,46 @@ extern "C"
 /******************************************************************************/
 /* PUBLIC FUNCTION PROTOTYPES */
 /******************************************************************************/
-void HardWare_Init(void (*CallBack)(void));
 
+/**
+ * @brief Transport contract used by the control protocol.
+ *
+ * The protocol only talks to the link through the functions below, so
+ * any backend that implements them can carry it. The target backend binds
+ * them to USART1 with DMA2, the host loopback backend in
+ * "Desktop Apps/protocol_bench" binds them to Linux pipes or a
+ * pseudo-terminal.
+ */
+
+/** @brief Initializes the transport.
+ *  @param[in] CallBack Called (in interrupt context on target) every time a
+ *             receive started by HardWare_Receive has been filled.
+ *  @param[in] TransmitCallBack Called (in interrupt context on target) when
+ *             the buffer given to HardWare_Send has been sent.
+ */
+void HardWare_Init(void (*CallBack)(void), void (*TransmitCallBack)(void));
+
+/** @brief Starts transmitting a buffer, returns without waiting.
+ *  @param[in] data Buffer to send, must stay valid until it is sent.
+ *  @param[in] len  Number of bytes to send.
+ */
 void HardWare_Send(char * data, uint8_t len);
 
+/** @brief Arms the reception of exactly len bytes into data.
+ *  @param[out] data Buffer to fill.
+ *  @param[in]  len  Number of bytes to wait for before calling the callback.
+ */
 void HardWare_Receive(char * data, uint8_t len);
 
+/** @brief Keeps both transport callbacks from running until HardWare_Unlock.
+ *  @note Used by the protocol around the state shared with its callbacks.
+ *        Calls nest, the callbacks run again after the outermost unlock.
+ */
+void HardWare_Lock(void);
+
+/** @brief Lets the transport callbacks run again. */
+void HardWare_Unlock(void);
+
 /******************************************************************************/
 
 /******************************************************************************/
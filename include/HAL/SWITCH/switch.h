@@ -144,6 +144,17 @@ typedef struct
     uint8_t SWITCH_Connection;  /**< Type of switch connection (pull-up or pull-down) */
 } SWITCH_CFG_t;
 
+/**
+ * @brief Switch Change Callback
+ *
+ * Called by CheckSwitchesStates, in the runnable, each time the debounced
+ * status of a switch changes.
+ *
+ * @param switchName The switch which changed.
+ * @param switchStatus Its new status, SWITCH_STATUS_PRESSED or SWITCH_STATUS_NOT_PRESSED.
+ */
+typedef void (*SWITCH_ChangeCallBack_t)(uint8_t switchName, uint32_t switchStatus);
+
 
 /******************************************************************************/
 
@@ -195,6 +206,19 @@ extern SWITCH_errorStatus SWITCH_enuInit(void);
 extern SWITCH_errorStatus SWITCH_enuGetStatus(uint8_t switchName, 
                                               uint32_t *switchStatus);
 
+/**
+ * @brief Set the Switch Change Callback
+ *
+ * The callback sees every change at the period of CheckSwitchesStates, a
+ * user which reads SWITCH_enuGetStatus less often would miss the short ones
+ * and their time.
+ *
+ * @param CallBack Called on every change, NULL for none.
+ * @return SWITCH_errorStatus
+ * - SWITCH_SUCCESS: The callback was set.
+ */
+extern SWITCH_errorStatus SWITCH_enuSetChangeCallBack(SWITCH_ChangeCallBack_t CallBack);
+
 /******************************************************************************/
 
 /******************************************************************************/
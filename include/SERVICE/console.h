@@ -0,0 +1,116 @@
+/*******************************************************************************/
+/**
+ * @file console.h
+ * @brief Buffered console output on USART2.
+ *
+ * @par Project Name
+ * stm32fxx services
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Writes are copied into a RAM ring and return at once. DMA1 stream 6 sends
+ * the ring on USART2 (PA2) in contiguous chunks, each transfer complete
+ * interrupt starts the next chunk, so printing costs the caller the copy
+ * only. Made to be called from runnables.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ *******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "console_CFG.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC ENUMS */
+/******************************************************************************/
+
+typedef enum
+{
+    CONSOLE_OK,
+    CONSOLE_ERROR,
+    CONSOLE_OVERFLOW    /**< Part of the write was dropped, see CONSOLE_OVERFLOW_POLICY */
+} CONSOLE_ErrorStatus_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC TYPES */
+/******************************************************************************/
+
+/* Struct defining the counters of the console */
+typedef struct
+{
+    uint16_t Pending;       /**< Bytes in the ring, being sent or waiting */
+    uint16_t PeakPending;   /**< Highest Pending since Console_Init */
+    uint32_t Dropped;       /**< Bytes lost to the overflow policy */
+} Console_Stats_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION PROTOTYPES */
+/******************************************************************************/
+
+/** @brief Sets up PA2, USART2 and DMA1 stream 6 and empties the ring
+ *  @return Error Status
+ */
+CONSOLE_ErrorStatus_t Console_Init(void);
+
+/** @brief Copies bytes into the ring and starts the DMA if it is idle
+ *  @param[in] pData Bytes to print
+ *  @param[in] Size  Number of bytes
+ *  @return CONSOLE_OK, CONSOLE_ERROR or CONSOLE_OVERFLOW
+ */
+CONSOLE_ErrorStatus_t Console_Write(const char * pData, uint16_t Size);
+
+/** @brief Formats with vsnprintf, then writes like Console_Write
+ *  @param[in] pFormat printf format, the output is cut at CONSOLE_LINE_SIZE - 1
+ *  @return CONSOLE_OK, CONSOLE_ERROR or CONSOLE_OVERFLOW
+ */
+CONSOLE_ErrorStatus_t Console_Printf(const char * pFormat, ...);
+
+/** @brief Copies the counters of the console
+ *  @param[out] pStats Filled with the counters
+ *  @return Error Status
+ */
+CONSOLE_ErrorStatus_t Console_GetStats(Console_Stats_t * pStats);
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* CONSOLE_H_ */
+/******************************************************************************/
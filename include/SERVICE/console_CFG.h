@@ -0,0 +1,100 @@
+/*******************************************************************************/
+/**
+ * @file console_CFG.h
+ * @brief Configuration of the buffered console.
+ *
+ * @par Project Name
+ * stm32fxx services
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Sizes the console ring and selects what happens to a write which does not
+ * fit in it.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ ******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef CONSOLE_CFG_H_
+#define CONSOLE_CFG_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC DEFINES */
+/******************************************************************************/
+
+/** @defgroup CONSOLE_POLICY Console overflow policies
+  * @{
+  */
+#define CONSOLE_POLICY_DROP_NEWEST          (0U)    /**< Bytes which do not fit are lost */
+#define CONSOLE_POLICY_DROP_OLDEST          (1U)    /**< Oldest bytes not yet sent make room */
+#define CONSOLE_POLICY_BLOCK                (2U)    /**< Waits for the DMA to make room */
+/**
+  * @}
+  */
+
+/**
+ * @def CONSOLE_OVERFLOW_POLICY
+ * @brief What Console_Write does when the ring is full, @ref CONSOLE_POLICY.
+ *
+ * CONSOLE_POLICY_BLOCK must not be used from an interrupt of a priority
+ * higher than or equal to DMA1 stream 6.
+ */
+#ifndef CONSOLE_OVERFLOW_POLICY
+#define CONSOLE_OVERFLOW_POLICY             CONSOLE_POLICY_DROP_NEWEST
+#endif
+
+/**
+ * @def CONSOLE_BUFFER_SIZE
+ * @brief Bytes of the ring, one of them stays unused.
+ */
+#define CONSOLE_BUFFER_SIZE                 (512U)
+
+/**
+ * @def CONSOLE_LINE_SIZE
+ * @brief Longest output of one Console_Printf, longer outputs are truncated.
+ */
+#define CONSOLE_LINE_SIZE                   (96U)
+
+/**
+ * @def CONSOLE_BAUD_RATE
+ * @brief Baud rate of USART2.
+ */
+#define CONSOLE_BAUD_RATE                   (115200U)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* CONSOLE_CFG_H_ */
+/******************************************************************************/
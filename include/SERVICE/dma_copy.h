@@ -0,0 +1,173 @@
+/*******************************************************************************/
+/**
+ * @file dma_copy.h
+ * @brief Memory copies and fills run by DMA2.
+ *
+ * @par Project Name
+ * stm32fxx services
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * DmaCopy_Memcpy and DmaCopy_Memset queue a job and return at once; the
+ * jobs run one after the other on one stream of DMA2, the only controller
+ * which can move memory to memory, and each one calls its callback from
+ * the DMA interrupt when it is over. The stream reads and writes words in
+ * bursts of four through its FIFO. The unaligned head and the tail of a
+ * job, and jobs shorter than DMA_COPY_CPU_THRESHOLD, are done by the CPU.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ *******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef DMA_COPY_H_
+#define DMA_COPY_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "dma_copy_CFG.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC ENUMS */
+/******************************************************************************/
+
+typedef enum
+{
+    DMA_COPY_OK,
+    DMA_COPY_ERROR
+} DMA_COPY_ErrorStatus_t;
+
+typedef enum
+{
+    DMA_COPY_PENDING,   /**< Queued or running */
+    DMA_COPY_DONE,      /**< Every byte was written */
+    DMA_COPY_FAILED     /**< The stream reported an error, the destination is partly written */
+} DMA_COPY_JobStatus_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC TYPES */
+/******************************************************************************/
+
+typedef struct DmaCopy_Job_s DmaCopy_Job_t;
+
+/**
+ * @brief Called once a job is over, from the DMA interrupt or from the
+ *        submitting call for a job done by the CPU at once
+ *
+ * The job already left the queue, it may be submitted again from here.
+ */
+typedef void (*DmaCopy_CallBack_t)(DmaCopy_Job_t * pJob);
+
+/**
+ * @brief One copy or fill
+ *
+ * Owned by the service from the submitting call until its callback, it
+ * must stay in memory meanwhile. Only pContext is for the caller, the
+ * other fields are set by DmaCopy_Memcpy and DmaCopy_Memset.
+ */
+struct DmaCopy_Job_s
+{
+    uint8_t * pDest;
+    const uint8_t * pSrc;           /**< NULL for a fill */
+    uint32_t Size;                  /**< Bytes */
+    uint32_t Pattern;               /**< Fill byte in each byte, read by the stream */
+    volatile DMA_COPY_JobStatus_t Status;
+    DmaCopy_CallBack_t CallBack;    /**< May be NULL */
+    void * pContext;                /**< Free for the caller */
+    uint32_t Offset;                /**< Next byte for the stream */
+    uint32_t End;                   /**< End of the part of the stream */
+    DmaCopy_Job_t * pNext;          /**< Used by the service while queued */
+};
+
+/* Struct defining the counters of the service */
+typedef struct
+{
+    uint32_t DmaJobs;       /**< Jobs done with the stream */
+    uint32_t CpuJobs;       /**< Jobs done by the CPU only */
+    uint32_t DmaBytes;      /**< Bytes moved by the stream */
+    uint32_t Errors;        /**< Jobs failed */
+} DmaCopy_Stats_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION PROTOTYPES */
+/******************************************************************************/
+
+/** @brief Enables DMA2 and the interrupt of the stream
+ *  @return Error Status
+ */
+DMA_COPY_ErrorStatus_t DmaCopy_Init(void);
+
+/** @brief Queues a copy of Size bytes from pSrc to pDest
+ *  @param[in] pJob     Storage of the job, see @ref DmaCopy_Job_t
+ *  @param[in] pDest    Destination, must not overlap pSrc
+ *  @param[in] pSrc     Source
+ *  @param[in] Size     Bytes
+ *  @param[in] CallBack May be NULL
+ *  @return Error Status
+ *  @note May be called from a job callback.
+ */
+DMA_COPY_ErrorStatus_t DmaCopy_Memcpy(DmaCopy_Job_t * pJob, void * pDest, const void * pSrc,
+                                      uint32_t Size, DmaCopy_CallBack_t CallBack);
+
+/** @brief Queues a fill of Size bytes of pDest with Value
+ *  @param[in] pJob     Storage of the job, see @ref DmaCopy_Job_t
+ *  @param[in] pDest    Destination
+ *  @param[in] Value    Byte written
+ *  @param[in] Size     Bytes
+ *  @param[in] CallBack May be NULL
+ *  @return Error Status
+ *  @note May be called from a job callback.
+ */
+DMA_COPY_ErrorStatus_t DmaCopy_Memset(DmaCopy_Job_t * pJob, void * pDest, uint8_t Value,
+                                      uint32_t Size, DmaCopy_CallBack_t CallBack);
+
+/** @brief Tells whether jobs are queued or running
+ *  @return true while the queue is not empty
+ */
+bool DmaCopy_IsBusy(void);
+
+/** @brief Copies the counters of the service
+ *  @param[out] pStats Filled with the counters
+ *  @return Error Status
+ */
+DMA_COPY_ErrorStatus_t DmaCopy_GetStats(DmaCopy_Stats_t * pStats);
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* DMA_COPY_H_ */
+/******************************************************************************/
@@ -0,0 +1,88 @@
+/*******************************************************************************/
+/**
+ * @file dma_copy_CFG.h
+ * @brief Configuration of the DMA memory copy service.
+ *
+ * @par Project Name
+ * stm32fxx services
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Stream, priority and CPU threshold of dma_copy.h.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ ******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef DMA_COPY_CFG_H_
+#define DMA_COPY_CFG_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC DEFINES */
+/******************************************************************************/
+
+/**
+ * @def DMA_COPY_STREAM
+ * @brief Stream of DMA2 used for the copies, @ref DMA_STREAMS.
+ *
+ * Stream 6 is not used by the SPI and UART drivers.
+ */
+#define DMA_COPY_STREAM                     DMA_STREAM_6
+
+/**
+ * @def DMA_COPY_STREAM_IRQ
+ * @brief Interrupt line of DMA_COPY_STREAM.
+ */
+#define DMA_COPY_STREAM_IRQ                 DMA2_Stream6_IRQn
+
+/**
+ * @def DMA_COPY_PRIORITY
+ * @brief Priority of the copies against the peripheral streams of DMA2,
+ *        @ref DMA_Priority_level.
+ */
+#define DMA_COPY_PRIORITY                   DMA_PRIORITY_LOW
+
+/**
+ * @def DMA_COPY_CPU_THRESHOLD
+ * @brief Jobs shorter than this many bytes are done by the CPU, starting
+ *        the stream would cost more. At least 32.
+ */
+#define DMA_COPY_CPU_THRESHOLD              (64U)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* DMA_COPY_CFG_H_ */
+/******************************************************************************/
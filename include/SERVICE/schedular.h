@@ -62,12 +62,38 @@ extern "C"
 /* PUBLIC MACROS */
 /******************************************************************************/
 
+/** Version of the layout written by schedular_ExportStats. */
+#define SCHEDULAR_STATS_VERSION             (1U)
+
+/** Bytes of the header of a statistics snapshot. */
+#define SCHEDULAR_STATS_HEADER_SIZE         (9U)
+
+/** Bytes of the record of one runnable in a statistics snapshot. */
+#define SCHEDULAR_STATS_RECORD_SIZE         (30U)
+
+/** Bytes of a statistics snapshot of Runnables runnables. */
+#define SCHEDULAR_STATS_SIZE(Runnables)     \
+            (SCHEDULAR_STATS_HEADER_SIZE + ((Runnables) * SCHEDULAR_STATS_RECORD_SIZE))
+
 /******************************************************************************/
 
 /******************************************************************************/
 /* PUBLIC ENUMS */
 /******************************************************************************/
 
+/**
+ * @brief Status returned by the scheduler functions.
+ */
+typedef enum
+{
+    /** The call succeeded. */
+    SCHEDULAR_OK,
+    /** A parameter is out of range or the feature is not enabled. */
+    SCHEDULAR_NOT_OK,
+    /** A NULL pointer was passed. */
+    SCHEDULAR_NULL_PTR_PASSED
+} Schedular_ErrorStatus_t;
+
 /******************************************************************************/
 
 /******************************************************************************/
@@ -112,6 +138,25 @@ typedef struct {
     uint32_t DelayMS;
 } Schedular_runnable_t;
 
+/**
+ * @brief Execution statistics of one runnable, in core clock cycles.
+ *
+ * The latency of a run is the time from the tick which released it to its
+ * start, the jitter is the spread of that latency. A release is missed when
+ * it did not complete before the next release of the runnable.
+ */
+typedef struct
+{
+    uint32_t Calls;             /**< Runs since the last reset */
+    uint32_t MinCycles;         /**< Shortest run */
+    uint32_t AvgCycles;         /**< Average run */
+    uint32_t MaxCycles;         /**< Longest run */
+    uint32_t MinLatencyCycles;  /**< Shortest delay from release to start */
+    uint32_t MaxLatencyCycles;  /**< Longest delay from release to start */
+    uint32_t JitterCycles;      /**< MaxLatencyCycles - MinLatencyCycles */
+    uint32_t Missed;            /**< Releases which missed their deadline */
+} Schedular_stats_t;
+
 
 
 /******************************************************************************/
@@ -150,6 +195,121 @@ void schedular_init(void);
  *       (`scheduler_init`).
  */
 void schedular_start(void);
+
+/**
+ * @brief Gets the time elapsed since the scheduler started.
+ *
+ * The time advances by TICK_TIME on every tick, it is the time base used to
+ * timestamp events between runnables.
+ *
+ * @return Time in milliseconds, wraps around after about 49 days.
+ */
+uint32_t schedular_GetTimeMS(void);
+
+/**
+ * @brief Adds a runnable to a free slot of the pool.
+ *
+ * It is released first after its DelayMS, then every periodicityMS, and is
+ * dispatched after the runnables of the same or a higher priority.
+ *
+ * @param[in]  pRunnable Runnable to copy in the pool, its CallBack not NULL.
+ * @param[out] pHandle   Handle of the runnable for the other calls.
+ *
+ * @return SCHEDULAR_OK, SCHEDULAR_NULL_PTR_PASSED, or SCHEDULAR_NOT_OK when
+ *         the MAX_RUNNABLES slots are used.
+ *
+ * @note The pool functions are called after schedular_init, from runnables
+ *       or the main loop but not from interrupts. The entries of
+ *       AllRunnablesSystemList keep their index as handle.
+ */
+Schedular_ErrorStatus_t schedular_AddRunnable(const Schedular_runnable_t * pRunnable,
+                                              uint32_t * pHandle);
+
+/**
+ * @brief Removes a runnable, its slot becomes free and a pending release is lost.
+ *
+ * A runnable may remove itself from its callback.
+ *
+ * @param[in] Handle Handle of the runnable.
+ * @return SCHEDULAR_OK, or SCHEDULAR_NOT_OK when the slot is free.
+ */
+Schedular_ErrorStatus_t schedular_RemoveRunnable(uint32_t Handle);
+
+/**
+ * @brief Stops releasing a runnable until it is resumed, it keeps its slot.
+ *
+ * @param[in] Handle Handle of the runnable.
+ * @return SCHEDULAR_OK, or SCHEDULAR_NOT_OK when the slot is free.
+ */
+Schedular_ErrorStatus_t schedular_SuspendRunnable(uint32_t Handle);
+
+/**
+ * @brief Releases a suspended runnable again, after its DelayMS then at its
+ *        period. Nothing changes for a runnable which is not suspended.
+ *
+ * @param[in] Handle Handle of the runnable.
+ * @return SCHEDULAR_OK, or SCHEDULAR_NOT_OK when the slot is free.
+ */
+Schedular_ErrorStatus_t schedular_ResumeRunnable(uint32_t Handle);
+
+/**
+ * @brief Changes the period of a runnable.
+ *
+ * Its next release moves to one new period after its last release, or to
+ * the next tick when that time has passed already.
+ *
+ * @param[in] Handle   Handle of the runnable.
+ * @param[in] PeriodMS New period in milliseconds, not 0.
+ * @return SCHEDULAR_OK, or SCHEDULAR_NOT_OK when the slot is free or the
+ *         period is 0.
+ */
+Schedular_ErrorStatus_t schedular_SetPeriod(uint32_t Handle, uint32_t PeriodMS);
+
+/**
+ * @brief Reads the statistics of one runnable.
+ *
+ * @param[in]  Runnable Index of the runnable in the configuration table.
+ * @param[out] pStats   Filled with its statistics, zeros before its first run.
+ *
+ * @return SCHEDULAR_OK, SCHEDULAR_NULL_PTR_PASSED, or SCHEDULAR_NOT_OK when
+ *         the index is out of range or SCHEDULAR_ENABLE_STATS is not set.
+ */
+Schedular_ErrorStatus_t schedular_GetStats(uint32_t Runnable, Schedular_stats_t * pStats);
+
+/**
+ * @brief Largest number of ticks which waited together to be served.
+ *
+ * More than one means a tick overran, the runnables released meanwhile
+ * started late.
+ *
+ * @return The peak since the last reset, 0 when the statistics are disabled.
+ */
+uint32_t schedular_GetPeakPendingTicks(void);
+
+/**
+ * @brief Clears the statistics of every runnable and the pending peak.
+ */
+void schedular_ResetStats(void);
+
+/**
+ * @brief Writes a binary snapshot of the statistics.
+ *
+ * Every field is little endian. The snapshot starts with a 9 byte header:
+ * the version (1 byte, SCHEDULAR_STATS_VERSION), the number of runnables
+ * (2 bytes), the pending peak (2 bytes, saturated) and the cycles per tick
+ * (4 bytes). One 30 byte record follows per runnable, in table order:
+ * Calls, MinCycles, AvgCycles, MaxCycles, MinLatencyCycles,
+ * MaxLatencyCycles and Missed (4 bytes each) then the priority (2 bytes).
+ *
+ * @param[out] pBuffer  Destination of the snapshot.
+ * @param[in]  Size     Size of pBuffer, at least SCHEDULAR_STATS_SIZE(N).
+ * @param[out] pLength  Bytes written.
+ *
+ * @return SCHEDULAR_OK, SCHEDULAR_NULL_PTR_PASSED, or SCHEDULAR_NOT_OK when
+ *         pBuffer is too small or the statistics are disabled.
+ */
+Schedular_ErrorStatus_t schedular_ExportStats(uint8_t * pBuffer, uint32_t Size,
+                                              uint32_t * pLength);
 /******************************************************************************/
 
 /******************************************************************************/
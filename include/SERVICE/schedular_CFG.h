@@ -10,8 +10,40 @@
 
 /**
  * @brief Maximum number of tasks supported by the scheduler
+ *
+ * Size of the runnables pool. The entries of AllRunnablesSystemList left
+ * without callback are free slots for schedular_AddRunnable.
  */
-#define      MAX_RUNNABLES       2
+#define      MAX_RUNNABLES       3
+
+/**
+ * @brief Slots of each level of the timer wheel, as a power of two
+ *
+ * A runnable due within 2^BITS ticks waits in the near level, within
+ * 2^(2*BITS) ticks in the far level. Longer periods still work, they are
+ * visited once more per turn of the far level. Between 1 and 8.
+ */
+#define      SCHEDULAR_WHEEL_BITS    6
+
+/**
+ * @brief Tickless idle, 1 to enable it
+ *
+ * When no runnable is ready the core sleeps (WFI) with SysTick stretched up
+ * to the next release instead of spinning, which battery powered boards
+ * need. Other interrupts still wake it, the time is corrected at wakeup.
+ * Runnables should not rely on the core running between their releases.
+ */
+#define      SCHEDULAR_TICKLESS_IDLE 0
+
+/**
+ * @brief Per runnable statistics, 1 to enable them
+ *
+ * Each run is timed with the DWT cycle counter: calls, min/avg/max cycles,
+ * the latency from the ideal release to the start and the missed deadlines,
+ * read with schedular_GetStats or schedular_ExportStats. The counter stops
+ * while the core sleeps, keep it in mind with SCHEDULAR_TICKLESS_IDLE.
+ */
+#define      SCHEDULAR_ENABLE_STATS  0
 
 /**
  * @brief Highest priority level (Priority 0)
@@ -19,6 +51,11 @@
 #define      PRIORITY_0          0 
 
 /**
- * @brief Highest priority level (Priority 0)
+ * @brief Priority level 1, below PRIORITY_0
+ */
+#define      PRIORITY_1          1
+
+/**
+ * @brief Priority level 2, below PRIORITY_1
  */
-#define      PRIORITY_1          1
\ No newline at end of file
+#define      PRIORITY_2          2
\ No newline at end of file
@@ -0,0 +1,172 @@
+/*******************************************************************************/
+/**
+ * @file spi_bus.h
+ * @brief SPI buses shared by several devices.
+ *
+ * @par Project Name
+ * stm32fxx services
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Every device of spi_bus_CFG.h owns a chip select and a clock profile on
+ * one of SPI1 to SPI4. Transfers submitted for the devices of one bus run
+ * one after the other with the DMA; the format of the SPI is rewritten only
+ * when the next transfer is for another device, and each transfer complete
+ * interrupt starts the next transfer, so a queue keeps its bus busy without
+ * the caller.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ *******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef SPI_BUS_H_
+#define SPI_BUS_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "spi_bus_CFG.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC ENUMS */
+/******************************************************************************/
+
+typedef enum
+{
+    SPI_BUS_OK,
+    SPI_BUS_ERROR
+} SPI_BUS_ErrorStatus_t;
+
+typedef enum
+{
+    SPI_BUS_PENDING,    /**< Queued or on the wire */
+    SPI_BUS_DONE,       /**< Every frame was exchanged */
+    SPI_BUS_FAILED      /**< The DMA reported an error, the chip select was released */
+} SPI_BUS_TransferStatus_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC TYPES */
+/******************************************************************************/
+
+/* Struct defining one device of spi_bus_CFG.h */
+typedef struct
+{
+    void *   Instance;          /**< SPI1 to SPI4, @ref SPI_Instances */
+    void *   CSPort;            /**< GPIO port of the chip select */
+    uint8_t  CSPin;             /**< GPIO pin of the chip select, driven low to select */
+    uint32_t CLKPolarity;       /**< @ref SPI_Clock_Polarity */
+    uint32_t CLKPhase;          /**< @ref SPI_Clock_Phase */
+    uint32_t BaudRatePrescaler; /**< @ref SPI_BaudRate_Prescaler */
+    uint32_t DataSize;          /**< @ref SPI_Data_Size */
+} SpiBus_Device_t;
+
+typedef struct SpiBus_Transfer_s SpiBus_Transfer_t;
+
+/**
+ * @brief Called from the DMA interrupt once a transfer is over
+ *
+ * The transfer already left the queue, it may be submitted again from here.
+ */
+typedef void (*SpiBus_CallBack_t)(SpiBus_Transfer_t * pTransfer);
+
+/**
+ * @brief One transfer of a device
+ *
+ * Owned by the bus from SpiBus_Submit until its callback, it must stay in
+ * memory and must not be changed meanwhile.
+ */
+struct SpiBus_Transfer_s
+{
+    uint8_t Device;                 /**< @ref SpiBus_Devices_t */
+    uint8_t * pTxData;              /**< Frames sent, NULL sends 0xFF */
+    uint8_t * pRxData;              /**< Frames received, NULL drops them */
+    uint16_t Size;                  /**< Number of frames, bytes or half words after DataSize */
+    bool KeepSelected;              /**< Leaves the chip select low for the next transfer of the device */
+    volatile SPI_BUS_TransferStatus_t Status;
+    SpiBus_CallBack_t CallBack;     /**< May be NULL */
+    void * pContext;                /**< Free for the caller */
+    SpiBus_Transfer_t * pNext;      /**< Used by the bus while queued */
+};
+
+/* Struct defining the counters of one bus */
+typedef struct
+{
+    uint32_t Transfers;         /**< Transfers done */
+    uint32_t Reconfigurations;  /**< Format changes between two devices */
+    uint32_t Errors;            /**< Transfers failed */
+    uint16_t Pending;           /**< Transfers queued, the running one included */
+    uint16_t PeakPending;       /**< Highest Pending since SpiBus_Init */
+} SpiBus_Stats_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC CONSTANT DECLARATIONS */
+/******************************************************************************/
+
+extern const SpiBus_Device_t SpiBusDevices[_SPI_BUS_DEVICES_NUM];
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION PROTOTYPES */
+/******************************************************************************/
+
+/** @brief Drives every chip select high and sets up the SPIs and DMA streams
+ *         of the configured devices
+ *  @return Error Status
+ *  @note The SCK, MISO and MOSI pins are left to the application.
+ */
+SPI_BUS_ErrorStatus_t SpiBus_Init(void);
+
+/** @brief Queues a transfer on the bus of its device and starts it if the bus is idle
+ *  @param[in] pTransfer The transfer, see @ref SpiBus_Transfer_t
+ *  @return Error Status
+ *  @note May be called from a transfer callback.
+ */
+SPI_BUS_ErrorStatus_t SpiBus_Submit(SpiBus_Transfer_t * pTransfer);
+
+/** @brief Copies the counters of the bus of a device
+ *  @param[in]  Device @ref SpiBus_Devices_t
+ *  @param[out] pStats Filled with the counters
+ *  @return Error Status
+ */
+SPI_BUS_ErrorStatus_t SpiBus_GetStats(uint8_t Device, SpiBus_Stats_t * pStats);
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* SPI_BUS_H_ */
+/******************************************************************************/
@@ -0,0 +1,80 @@
+/*******************************************************************************/
+/**
+ * @file spi_bus_CFG.h
+ * @brief Configuration of the shared SPI buses.
+ *
+ * @par Project Name
+ * stm32fxx services
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Names the devices sharing the SPI buses, their chip select and clock
+ * profile are given in spi_bus_CFG.c.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ ******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef SPI_BUS_CFG_H_
+#define SPI_BUS_CFG_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC DEFINES */
+/******************************************************************************/
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC ENUMS */
+/******************************************************************************/
+
+/*
+ * Devices on the SPI buses, each one has an entry in SpiBusDevices.
+ *
+ * - _SPI_BUS_DEVICES_NUM: number of devices, not a device.
+ */
+typedef enum
+{
+  SPI_BUS_TFT,
+  SPI_BUS_FLASH,
+  SPI_BUS_SENSOR,
+  _SPI_BUS_DEVICES_NUM
+} SpiBus_Devices_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* SPI_BUS_CFG_H_ */
+/******************************************************************************/
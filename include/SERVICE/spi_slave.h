@@ -0,0 +1,163 @@
+/*******************************************************************************/
+/**
+ * @file spi_slave.h
+ * @brief Register map served by SPI1 as a slave.
+ *
+ * @par Project Name
+ * stm32fxx services
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * SPI1 runs as a slave with hardware NSS on PA4, SCK on PA5, MISO on PA6
+ * and MOSI on PA7. A transaction lasts from NSS low to NSS high. Its first
+ * byte is a command: bit 7 set reads, bits 6..0 are the address.
+ *
+ * - Write: the following bytes are stored from the address on, bytes past
+ *   the end of the map are dropped.
+ * - Read: the command selects the address which the next transactions
+ *   answer from.
+ *
+ * The receive stream fills a ring all the time and the transmit stream is
+ * armed on the map before the master selects the slave, so the CPU does not
+ * run during a transaction. The rising edge of NSS ends it: the bytes
+ * received are parsed and the transmit stream is armed again. As the
+ * answer is armed before the command is known, from its second byte on a
+ * transaction clocks out the map from the address of the last read command;
+ * the first byte of MISO is undefined. A master reads a register block by
+ * sending the same read command twice, or polls it by repeating it.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ *******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef SPI_SLAVE_H_
+#define SPI_SLAVE_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "spi_slave_CFG.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC DEFINES */
+/******************************************************************************/
+
+#define SPI_SLAVE_READ                      (0x80U)     /**< Read bit of the command */
+#define SPI_SLAVE_ADDRESS_MASK              (0x7FU)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC ENUMS */
+/******************************************************************************/
+
+typedef enum
+{
+    SPI_SLAVE_OK,
+    SPI_SLAVE_ERROR
+} SPI_SLAVE_ErrorStatus_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC TYPES */
+/******************************************************************************/
+
+/**
+ * @brief Called from the NSS interrupt after the master wrote registers
+ * @param Address First register written
+ * @param pData   The registers in the map, Size of them
+ * @param Size    Registers written, 0 when the address is past the map
+ */
+typedef void (*SpiSlave_WriteCallBack_t)(uint8_t Address, const uint8_t * pData, uint16_t Size);
+
+/**
+ * @brief Called from the NSS interrupt after the master clocked registers out
+ * @param Address First register sent
+ * @param Size    Registers sent, read-to-clear registers may be cleared here
+ */
+typedef void (*SpiSlave_ReadCallBack_t)(uint8_t Address, uint16_t Size);
+
+/* Struct defining the counters of the slave */
+typedef struct
+{
+    uint32_t Transactions;      /**< NSS rising edges with at least one byte */
+    uint32_t Writes;            /**< Write commands */
+    uint32_t Reads;             /**< Transactions which clocked registers out */
+    uint32_t Dropped;           /**< Written bytes past the end of the map */
+    uint32_t Errors;            /**< DMA errors, the streams were restarted */
+} SpiSlave_Stats_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION PROTOTYPES */
+/******************************************************************************/
+
+/** @brief Sets up the pins, SPI1, its streams and the NSS line, then waits for the master
+ *  @param[in] WriteCallBack May be NULL
+ *  @param[in] ReadCallBack  May be NULL
+ *  @return Error Status
+ *  @note The master must keep NSS high for the time of the NSS interrupt
+ *        between two transactions.
+ */
+SPI_SLAVE_ErrorStatus_t SpiSlave_Init(SpiSlave_WriteCallBack_t WriteCallBack,
+                                      SpiSlave_ReadCallBack_t ReadCallBack);
+
+/** @brief Writes registers of the map, seen by the next read of the master
+ *  @param[in] Address First register
+ *  @param[in] pData   Values
+ *  @param[in] Size    Number of registers
+ *  @return Error Status, SPI_SLAVE_ERROR when the block leaves the map
+ */
+SPI_SLAVE_ErrorStatus_t SpiSlave_SetRegisters(uint8_t Address, const uint8_t * pData, uint16_t Size);
+
+/** @brief Reads registers of the map
+ *  @param[in]  Address First register
+ *  @param[out] pData   Values
+ *  @param[in]  Size    Number of registers
+ *  @return Error Status, SPI_SLAVE_ERROR when the block leaves the map
+ */
+SPI_SLAVE_ErrorStatus_t SpiSlave_GetRegisters(uint8_t Address, uint8_t * pData, uint16_t Size);
+
+/** @brief Copies the counters of the slave
+ *  @param[out] pStats Filled with the counters
+ *  @return Error Status
+ */
+SPI_SLAVE_ErrorStatus_t SpiSlave_GetStats(SpiSlave_Stats_t * pStats);
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* SPI_SLAVE_H_ */
+/******************************************************************************/
@@ -0,0 +1,85 @@
+/*******************************************************************************/
+/**
+ * @file spi_slave_CFG.h
+ * @brief Configuration of the SPI slave register map.
+ *
+ * @par Project Name
+ * stm32fxx services
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Size of the register map, size of the receive ring and clock mode of the
+ * SPI1 slave of spi_slave.h.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ ******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef SPI_SLAVE_CFG_H_
+#define SPI_SLAVE_CFG_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC DEFINES */
+/******************************************************************************/
+
+/**
+ * @def SPI_SLAVE_MAP_SIZE
+ * @brief Registers of the map, 2 to 128 since an address has 7 bits.
+ */
+#define SPI_SLAVE_MAP_SIZE                  (64U)
+
+/**
+ * @def SPI_SLAVE_RX_RING_SIZE
+ * @brief Bytes of the receive ring, longer than the longest transaction.
+ */
+#define SPI_SLAVE_RX_RING_SIZE              (256U)
+
+/**
+ * @def SPI_SLAVE_CLK_POLARITY
+ * @brief Clock polarity of the master, @ref SPI_Clock_Polarity.
+ */
+#define SPI_SLAVE_CLK_POLARITY              SPI_POLARITY_LOW
+
+/**
+ * @def SPI_SLAVE_CLK_PHASE
+ * @brief Clock phase of the master, @ref SPI_Clock_Phase.
+ */
+#define SPI_SLAVE_CLK_PHASE                 SPI_PHASE_FIRST_EDGE
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* SPI_SLAVE_CFG_H_ */
+/******************************************************************************/
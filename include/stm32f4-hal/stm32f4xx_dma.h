@@ -196,7 +196,7 @@ extern "C"
   * @{
   */
 #define DMA_PERIPHERAL_INCREMENT_DISABLED       0x00000000U     
-#define DMA_PERIPHERAL_INCREMENT_ENABLED        DMA_SxCR_CIRC_0 
+#define DMA_PERIPHERAL_INCREMENT_ENABLED        DMA_SxCR_PINC_0 
  /**
   * @}
   */ 
@@ -303,6 +303,27 @@ extern "C"
   * @}
   */
 
+/** @defgroup DMA_Buffer DMA double buffer targets
+  * @{
+  */
+#define DMA_BUFFER_0                  (0U)           /*!< M0AR */
+#define DMA_BUFFER_1                  (1U)           /*!< M1AR */
+/**
+  * @}
+  */
+
+/** @defgroup DMA_Error_Code DMA error codes
+  * @brief    Errors of a transfer, OR-ed in DMA_Handle_t::ErrorCode
+  * @{
+  */
+#define DMA_ERROR_NONE                0x00000000U    /*!< No error                                   */
+#define DMA_ERROR_TE                  0x00000001U    /*!< Transfer error, the stream was disabled     */
+#define DMA_ERROR_FE                  0x00000002U    /*!< FIFO overrun or underrun, the stream goes on */
+#define DMA_ERROR_DME                 0x00000004U    /*!< Direct mode error, the stream goes on        */
+/**
+  * @}
+  */
+
 /******************************************************************************/
 
 /******************************************************************************/
@@ -347,6 +368,13 @@ typedef enum
 
   /** @brief DMA channel is currently busy with a transfer operation. */
   DMA_STATE_BUSY,
+
+  /** @brief The first half of the transfer is done, the stream goes on.
+   *         A circular or double buffer stream is busy again at each wrap. */
+  DMA_STATE_HALF,
+
+  /** @brief A transfer error disabled the stream, see DMA_GetError. */
+  DMA_STATE_ERROR,
 } DMA_States_t;
 
 
@@ -410,6 +438,18 @@ typedef struct
 } DMA_Init_t;
 
 
+/** @brief One piece of a chained transfer, see DMA_StartChain. */
+typedef struct
+{
+  /** @brief Memory side of the piece, source or destination. */
+  void * pMemory;
+
+  /** @brief Number of data items of the piece, 1 to 65535. */
+  uint32_t Length;
+
+} DMA_Segment_t;
+
+
 /** @brief DMA channel handle structure. */
 typedef struct 
 {
@@ -433,6 +473,21 @@ typedef struct
 
   /** @brief Callback function for transfer error. */
   void (*ErrorTransferCallBack)(void);
+
+  /** @brief Errors since the transfer started. @ref DMA_Error_Code */
+  volatile uint32_t ErrorCode;
+
+  /** @brief Data items of the transfer, or of each buffer in double buffer mode. */
+  uint32_t Length;
+
+  /** @brief Pieces of the chain on the stream, NULL for other transfers. */
+  const DMA_Segment_t * pSegments;
+
+  /** @brief Number of pieces of pSegments. */
+  uint32_t Segments;
+
+  /** @brief Piece the stream works on. */
+  volatile uint32_t Segment;
   
 } DMA_Handle_t;
 
@@ -472,10 +527,33 @@ typedef struct
  *   - DMA_BUSY: The DMA channel is currently busy.
  *
  * @note This function must be called before using any other DMA functions on the specified channel.
+ * @note Bursts need FIFO mode and a compatible threshold, see DMA_ConfigFifo;
+ *       direct mode takes single transfers only and no memory to memory.
  */
 extern DMA_ErrorStatus_t DMA_Init(DMA_Handle_t * pHandleDMA , uint32_t TimeOut);
 
 
+/**
+ * @brief Switches an idle stream to FIFO mode with the given threshold and bursts.
+ *
+ * The combination is checked like DMA_Init does: a burst must fit in the 16
+ * bytes of the FIFO, and a memory burst (beats times MemAlignment) must be a
+ * divisor of the threshold, so words in bursts of 4 need the full threshold
+ * while bytes in bursts of 4 work with every threshold. The stream takes the
+ * new setting at once, without a DMA_Init.
+ *
+ * @param[in] pHandleDMA  Pointer to a DMA handle initialized by DMA_Init.
+ * @param[in] Threshold   @ref DMA_FIFO_threshold_level.
+ * @param[in] MemBurst    @ref DMA_Memory_burst.
+ * @param[in] PeriphBurst @ref DMA_Peripheral_burst.
+ *
+ * @return DMA_OK, DMA_BUSY while the stream runs, or DMA_ERROR for a
+ *         forbidden combination, which leaves the stream unchanged.
+ */
+extern DMA_ErrorStatus_t DMA_ConfigFifo(DMA_Handle_t * pHandleDMA, uint32_t Threshold,
+                                        uint32_t MemBurst, uint32_t PeriphBurst);
+
+
 /**
  * @brief Starts a DMA transfer.
  *
@@ -541,8 +619,11 @@ extern DMA_ErrorStatus_t DMA_UnRegisterCallBack(DMA_Handle_t *pHandleDMA,
  * @brief Gets the current state of a DMA channel.
  *
  * This function retrieves the current state of the DMA channel 
- * represented by the provided handle. The specific details of the 
- * returned state information may vary depending on the DMA controller implementation.
+ * represented by the provided handle. The stream interrupt keeps it: ready
+ * again at the transfer complete of a normal transfer, before the complete
+ * callback, half at the half transfer and error at a transfer error. A
+ * stream whose interrupt is disabled in the NVIC stays busy until the next
+ * DMA_Init or DMA_Abort.
  *
  * @param[in] pHandleDMA Pointer to a DMA handle structure (`DMA_Handle_t`).
  *
@@ -555,6 +636,146 @@ extern DMA_ErrorStatus_t DMA_UnRegisterCallBack(DMA_Handle_t *pHandleDMA,
  */
 extern DMA_ErrorStatus_t DMA_GetState(DMA_Handle_t *pHandleDMA, DMA_States_t * state);
 
+/**
+ * @brief Reads the number of data items the stream still has to transfer (NDTR).
+ *
+ * In circular mode the counter is reloaded at every transfer complete, so it
+ * tells which part of the buffer the DMA is writing.
+ *
+ * @param[in]  pHandleDMA Pointer to an initialized DMA handle.
+ * @param[out] pCounter   Filled with the data items left.
+ *
+ * @return DMA_OK, or DMA_ERROR for a NULL parameter.
+ */
+extern DMA_ErrorStatus_t DMA_GetCounter(DMA_Handle_t *pHandleDMA, uint32_t * pCounter);
+
+
+/**
+ * @brief Reads the number of data items the stream already transferred.
+ *
+ * Taken from NDTR, so it counts the items which landed up to the read,
+ * between interrupts too. A circular stream gives the position in its
+ * buffer, a double buffer stream the position in the current buffer
+ * (DMA_GetCurrentTarget) and a chain the items of all its pieces so far.
+ * An aborted transfer keeps the items it moved.
+ *
+ * @param[in]  pHandleDMA Pointer to a started DMA handle.
+ * @param[out] pDone      Filled with the data items transferred.
+ *
+ * @return DMA_OK, or DMA_ERROR for a NULL parameter.
+ */
+extern DMA_ErrorStatus_t DMA_GetProgress(DMA_Handle_t *pHandleDMA, uint32_t * pDone);
+
+
+/**
+ * @brief Stops a stream before the end of its transfer.
+ *
+ * The interrupts of the stream are disabled with it, so no callback runs
+ * for the stopped transfer, and its flags are cleared once EN reads 0.
+ *
+ * @param[in] pHandleDMA Pointer to an initialized DMA handle.
+ * @param[in] TimeOut    Polls of EN before giving up.
+ *
+ * @return DMA_OK when the stream stopped, DMA_TIMEOUT, or DMA_ERROR for an
+ *         invalid handle.
+ */
+extern DMA_ErrorStatus_t DMA_Abort(DMA_Handle_t *pHandleDMA, uint32_t TimeOut);
+
+
+/**
+ * @brief Gets the errors of the current or last transfer of a stream.
+ *
+ * Every DMAx_Streamy_IRQHandler clears the flags of its stream and serves
+ * the handle given to DMA_Init for it. A transfer error calls the error
+ * callback; FIFO errors (FIFO mode) and direct mode errors (direct mode)
+ * do not stop the stream and are only recorded here.
+ *
+ * @param[in]  pHandleDMA Pointer to the DMA handle.
+ * @param[out] pError     Receives the errors, @ref DMA_Error_Code.
+ * @return DMA_OK, or DMA_ERROR for a NULL parameter.
+ */
+extern DMA_ErrorStatus_t DMA_GetError(DMA_Handle_t *pHandleDMA, uint32_t * pError);
+
+
+/**
+ * @brief Starts a double buffer transfer between a peripheral and two buffers.
+ *
+ * The stream fills or drains pBuffer0, then pBuffer1, then pBuffer0 again
+ * and so on without stopping, the complete callback is called each time
+ * it switches. It runs until DMA_Abort.
+ *
+ * @param[in] pHandleDMA  Pointer to a DMA handle initialized by DMA_Init,
+ *                        peripheral to memory or memory to peripheral.
+ * @param[in] pPeripheral Data register of the peripheral.
+ * @param[in] pBuffer0    Buffer of M0AR, used first.
+ * @param[in] pBuffer1    Buffer of M1AR.
+ * @param[in] DataLength  Number of data items of each buffer.
+ *
+ * @return DMA_OK when started, DMA_BUSY when the stream runs, DMA_ERROR otherwise.
+ */
+extern DMA_ErrorStatus_t DMA_StartDoubleBuffer(DMA_Handle_t * pHandleDMA, void * pPeripheral,
+                                               void * pBuffer0, void * pBuffer1, uint32_t DataLength);
+
+
+/**
+ * @brief Gets the buffer the stream works on.
+ *
+ * In the complete callback the stream already moved to the other buffer,
+ * so the one not returned here is the one just filled or drained.
+ *
+ * @param[in]  pHandleDMA Pointer to the DMA handle.
+ * @param[out] pTarget    DMA_BUFFER_0 or DMA_BUFFER_1, @ref DMA_Buffer.
+ * @return DMA_OK, or DMA_ERROR for a NULL parameter.
+ */
+extern DMA_ErrorStatus_t DMA_GetCurrentTarget(DMA_Handle_t * pHandleDMA, uint8_t * pTarget);
+
+
+/**
+ * @brief Replaces one buffer of a double buffer transfer.
+ *
+ * Called from the complete callback for the buffer the stream just left,
+ * the stream takes the new buffer when it switches next time.
+ *
+ * @param[in] pHandleDMA Pointer to the DMA handle.
+ * @param[in] Target     DMA_BUFFER_0 or DMA_BUFFER_1, @ref DMA_Buffer.
+ * @param[in] pBuffer    The new buffer, of the length given at the start.
+ * @return DMA_OK, DMA_BUSY when the stream works on Target, DMA_ERROR otherwise.
+ */
+extern DMA_ErrorStatus_t DMA_SetBuffer(DMA_Handle_t * pHandleDMA, uint8_t Target, void * pBuffer);
+
+
+/**
+ * @brief Starts a transfer between a peripheral and a chain of buffers.
+ *
+ * The stream moves the pieces one after the other, as if they were one
+ * buffer: the transfer complete interrupt of a piece points the stream at
+ * the next one and enables it again before anything else, and the complete
+ * callback is called once, at the end of the last piece. The half callback
+ * is not used. A transfer error stops the chain and calls the error
+ * callback, DMA_GetChainPosition tells which piece failed.
+ *
+ * @param[in] pHandleDMA  Pointer to a DMA handle initialized by DMA_Init in
+ *                        normal mode, peripheral to memory or memory to
+ *                        peripheral.
+ * @param[in] pPeripheral Data register of the peripheral.
+ * @param[in] pSegments   The pieces, kept until the complete callback.
+ * @param[in] Segments    Number of pieces.
+ *
+ * @return DMA_OK when started, DMA_BUSY when the stream runs, DMA_ERROR otherwise.
+ */
+extern DMA_ErrorStatus_t DMA_StartChain(DMA_Handle_t * pHandleDMA, void * pPeripheral,
+                                        const DMA_Segment_t * pSegments, uint32_t Segments);
+
+
+/**
+ * @brief Gets the piece a chained transfer works on.
+ *
+ * @param[in]  pHandleDMA Pointer to the DMA handle.
+ * @param[out] pSegment   Index of the piece in the chain given to DMA_StartChain.
+ * @return DMA_OK, or DMA_ERROR for a NULL parameter or no chain.
+ */
+extern DMA_ErrorStatus_t DMA_GetChainPosition(DMA_Handle_t * pHandleDMA, uint32_t * pSegment);
+
 
 /******************************************************************************/
 
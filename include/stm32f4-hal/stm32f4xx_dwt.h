@@ -0,0 +1,94 @@
+/*******************************************************************************/
+/**
+* @file    stm32f4xx_dwt.h
+* @brief   DWT Cycle Counter Driver Header File for STM32F401CC Microcontroller
+*
+* @par Project Name
+*  stm32f4xx drivers
+*
+* @par Code Language
+* C
+*
+* @par Description
+* Runs the cycle counter of the Data Watchpoint and Trace unit of the
+* Cortex-M4. It counts core clock cycles, 32 bits wide, so it wraps after
+* about 51 s at 84 MHz; differences taken with DWT_GetElapsed stay right
+* across one wrap.
+*
+* @par Author
+* Mahmoud Abou-Hawis
+*
+*******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef __STM32F4xx_DWT_H_
+#define __STM32F4xx_DWT_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdint.h>
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC ENUMS */
+/******************************************************************************/
+
+typedef enum
+{
+  DWT_OK    = 0x00U,
+  DWT_ERROR = 0x01U
+} DWT_ErrorStatus_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION PROTOTYPES */
+/******************************************************************************/
+
+/**
+ * @brief Enables the trace unit and starts the cycle counter from 0.
+ * @return DWT_OK, or DWT_ERROR when the core has no cycle counter.
+ */
+extern DWT_ErrorStatus_t DWT_Init(void);
+
+/**
+ * @brief Reads the cycle counter.
+ * @return Core clock cycles since DWT_Init, modulo 2^32.
+ */
+extern uint32_t DWT_GetCycles(void);
+
+/**
+ * @brief Cycles since a reading of DWT_GetCycles.
+ * @param Start An earlier reading, less than one wrap old.
+ * @return Core clock cycles elapsed.
+ */
+extern uint32_t DWT_GetElapsed(uint32_t Start);
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* __STM32F4xx_DWT_H_ */
+/******************************************************************************/
@@ -0,0 +1,141 @@
+/*******************************************************************************/
+/**
+* @file    stm32f4xx_exti.h
+* @brief   EXTI Driver Header File for STM32F401CC Microcontroller
+*
+* @par Project Name
+*  stm32f4xx drivers
+*
+* @par Code Language
+* C
+*
+* @par Description
+* Routes a GPIO pin to its external interrupt line through SYSCFG, selects
+* the edges which trigger it and calls back from the EXTI interrupt. Line n
+* serves pin n of one port at a time.
+*
+* @par Author
+* Mahmoud Abou-Hawis
+*
+*******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#ifndef __STM32F4xx_EXTI_H_
+#define __STM32F4xx_EXTI_H_
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC DEFINES */
+/******************************************************************************/
+
+/** @defgroup EXTI_Trigger EXTI Trigger Edges
+  * @{
+  */
+#define EXTI_TRIGGER_RISING             (0x01U)
+#define EXTI_TRIGGER_FALLING            (0x02U)
+#define EXTI_TRIGGER_BOTH               (EXTI_TRIGGER_RISING | EXTI_TRIGGER_FALLING)
+/**
+  * @}
+  */
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC ENUMS */
+/******************************************************************************/
+
+typedef enum
+{
+  EXTI_OK    = 0x00U,
+  EXTI_ERROR = 0x01U
+} EXTI_ErrorStatus_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC TYPES */
+/******************************************************************************/
+
+/**
+ * @brief Called from the EXTI interrupt after the pending bit of the line
+ *        was cleared
+ */
+typedef void (*EXTI_CallBack_t)(void);
+
+/**
+ * @brief Configuration of one line
+ */
+typedef struct
+{
+  void * Port;                /*!< GPIO port of the pin, GPIO_PORTA to GPIO_PORTH */
+  uint8_t Pin;                /*!< GPIO_PIN0 to GPIO_PIN15, also the line number */
+  uint8_t Trigger;            /*!< @ref EXTI_Trigger */
+  EXTI_CallBack_t CallBack;   /*!< May be NULL */
+} EXTI_Config_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION PROTOTYPES */
+/******************************************************************************/
+
+/**
+ * @brief Connects a pin to its line and unmasks the line.
+ *
+ * Enables the SYSCFG clock, selects the port of the line, sets the edges,
+ * drops an edge seen before and enables the interrupt of the line in the
+ * NVIC (EXTI0 to EXTI4, EXTI9_5 or EXTI15_10). The pin itself is set up
+ * with GPIO_Init, in input or alternate function mode.
+ *
+ * @param pConfig The line, see @ref EXTI_Config_t.
+ * @return EXTI_OK, or EXTI_ERROR for an invalid configuration.
+ */
+extern EXTI_ErrorStatus_t EXTI_Init(const EXTI_Config_t * pConfig);
+
+/**
+ * @brief Masks a line, its edges are still latched in the pending register.
+ * @param Line 0 to 15.
+ * @return EXTI_OK, or EXTI_ERROR for an invalid line.
+ */
+extern EXTI_ErrorStatus_t EXTI_Disable(uint8_t Line);
+
+/**
+ * @brief Unmasks a line, an edge latched meanwhile is served at once.
+ * @param Line 0 to 15.
+ * @return EXTI_OK, or EXTI_ERROR for an invalid line.
+ */
+extern EXTI_ErrorStatus_t EXTI_Enable(uint8_t Line);
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* C++ Style GUARD */
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+/******************************************************************************/
+
+/******************************************************************************/
+/* MULTIPLE INCLUSION GUARD */
+/******************************************************************************/
+#endif /* __STM32F4xx_EXTI_H_ */
+/******************************************************************************/
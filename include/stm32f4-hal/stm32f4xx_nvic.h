@@ -404,6 +404,24 @@ extern NVIC_ErrorStatus_t NVIC_ClearPendingIRQ(IRQn_Type IRQn);
  *                          - Other values represent error conditions.
 */
 extern NVIC_ErrorStatus_t NVIC_GetActive(IRQn_Type IRQn,uint32_t * pActiveState);
+
+/**
+ * @brief Masks every interrupt of configurable priority (sets PRIMASK).
+ *
+ * A pending interrupt still wakes the core from WFI while they are masked,
+ * it is taken once NVIC_RestoreInterrupts unmasks them.
+ *
+ * @return The PRIMASK value before the call, to give to NVIC_RestoreInterrupts.
+ */
+extern uint32_t NVIC_DisableInterrupts(void);
+
+/**
+ * @brief Restores the interrupt mask saved by NVIC_DisableInterrupts.
+ *
+ * @param[in] PriMask The value returned by the matching NVIC_DisableInterrupts,
+ *                    nested sections only unmask at the outermost one.
+ */
+extern void NVIC_RestoreInterrupts(uint32_t PriMask);
 /******************************************************************************/
 
 /******************************************************************************/
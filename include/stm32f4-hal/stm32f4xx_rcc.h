@@ -93,6 +93,15 @@ extern "C"
 
 
 
+/**
+ * @brief Buses whose clock is returned by RCC_enuGetBusClock.
+ */
+#define		RCC_BUS_SYSCLK				((uint32_t)0x00000000)
+#define		RCC_BUS_AHB					((uint32_t)0x00000001)
+#define		RCC_BUS_APB1				((uint32_t)0x00000002)
+#define		RCC_BUS_APB2				((uint32_t)0x00000003)
+
+
 /**
  * @brief Available GPIOs , which is connected on AHB1
 */
@@ -119,7 +128,7 @@ extern "C"
 #define		PERIPHERAL_TM55	 	 	    ((uint32_t)0x00000008)
 #define 	PERIPHERAL_WWDG	     		((uint32_t)0x00000080)
 #define		PERIPHERAL_SPI2 			((uint32_t)0x00004000)
-#define		PERIPHERAL_SPI3 			((uint32_t)0x00004000)
+#define		PERIPHERAL_SPI3 			((uint32_t)0x00008000)
 #define		PERIPHERAL_USART2   		((uint32_t)0x00020000)
 #define		PERIPHERAL_I2C1 			((uint32_t)0x00200000)
 #define		PERIPHERAL_I2C2	 	    	((uint32_t)0x00400000)
@@ -548,6 +557,26 @@ RCC_enuErrorStatus  RCC_enuSetPrescaler(uint32_t BUS);
  */
 RCC_enuErrorStatus  RCC_enuGetPrescaler(uint32_t BUS, uint32_t * BusPrescaler);
 
+/**
+ * @brief Get the frequency a bus currently runs at
+ *
+ * The frequency is computed from the clock source, the PLL factors and the
+ * prescalers found in the RCC registers, so it follows every change made
+ * with RCC_enuSetSysClk, RCC_enuConfigPLL and RCC_enuSetPrescaler.
+ *
+ * @param[in] BUS The bus (RCC_BUS_SYSCLK, RCC_BUS_AHB, RCC_BUS_APB1 or RCC_BUS_APB2)
+ * @param[out] Frequency pointer to the bus frequency result, in Hz.
+ * @return Error status, RCC_HSE_NOT_CONFIGURED when the clock comes from the
+ *         HSE and its frequency was never given to RCC_enuConfigHSE.
+ *
+ * Example usage:
+ * @code
+ *      uint32_t PCLK2;
+ *      RCC_enuGetBusClock(RCC_BUS_APB2, &PCLK2);
+ * @endcode
+ */
+RCC_enuErrorStatus  RCC_enuGetBusClock(uint32_t BUS, uint32_t * Frequency);
+
 /**
  * @brief Enable a peripheral
  *
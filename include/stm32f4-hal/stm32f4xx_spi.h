@@ -43,6 +43,7 @@ extern "C"
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include "stm32f4xx_dma.h"
 /******************************************************************************/
 
 /******************************************************************************/
@@ -51,12 +52,15 @@ extern "C"
 
 
 /** @defgroup SPI_Instances SPI Instances
+  * @note A host build may define them first to point at simulated registers.
   * @{
   */
+#ifndef SPI1
 #define SPI1                            ((void*)0x40013000) /*!< SPI1 base address */
 #define SPI2                            ((void*)0x40003800) /*!< SPI2 base address */
 #define SPI3                            ((void*)0x40003C00) /*!< SPI3 base address */
 #define SPI4                            ((void*)0x40013400) /*!< SPI4 base address */
+#endif
 /**
   * @}
   */
@@ -149,6 +153,30 @@ extern "C"
   */
 
 
+/** @defgroup SPI_DMA_Streams SPI DMA Streams
+  * Receive and transmit streams used by the DMA functions:
+  * - SPI1: DMA2 stream 2 and stream 3, channel 3
+  * - SPI2: DMA1 stream 3 and stream 4, channel 0
+  * - SPI3: DMA1 stream 0 and stream 7, channel 0
+  * - SPI4: DMA2 stream 0, channel 4 and stream 4, channel 5
+  * @{
+  */
+/**
+  * @}
+  */
+
+/** @defgroup SPI_Chip_Select SPI Job Chip Select Actions
+  * @{
+  */
+#define SPI_CS_NONE                     (0x00U) /*!< Chip select is not touched */
+#define SPI_CS_SELECT                   (0x01U) /*!< Driven low before the first byte */
+#define SPI_CS_RELEASE                  (0x02U) /*!< Driven high after the last byte */
+#define SPI_CS_FRAME                    (SPI_CS_SELECT | SPI_CS_RELEASE)
+/**
+  * @}
+  */
+
+
 
 
 /******************************************************************************/
@@ -199,6 +227,34 @@ typedef enum
  */
 typedef void (*CallBack_t)(void);
 
+typedef struct SPI_Job_s SPI_Job_t;
+
+/**
+ * @brief Called from the SPI interrupt once a job is done
+ *
+ * The job already left the queue, it may be submitted again from here.
+ */
+typedef void (*SPI_JobCallBack_t)(SPI_Job_t * pJob);
+
+/**
+ * @brief One transaction of the queue of an SPI handle
+ *
+ * The job is owned by the driver from SPI_SubmitJob until its callback,
+ * it must stay in memory and must not be changed meanwhile.
+ */
+struct SPI_Job_s
+{
+  const uint8_t * pTxData;      /*!< Bytes sent, NULL sends 0xFF */
+  uint8_t * pRxData;            /*!< Bytes received, NULL drops them */
+  uint16_t Size;                /*!< Number of bytes, at least one */
+  void * CSPort;                /*!< GPIO port of the chip select, unused with SPI_CS_NONE */
+  uint8_t CSPin;                /*!< GPIO pin of the chip select */
+  uint8_t CSAction;             /*!< @ref SPI_Chip_Select */
+  SPI_JobCallBack_t CallBack;   /*!< May be NULL */
+  void * pContext;              /*!< Free for the caller */
+  SPI_Job_t * pNext;            /*!< Used by the driver while the job is queued */
+};
+
 /**
  * @brief SPI Initialization Configuration
  *
@@ -315,6 +371,10 @@ typedef struct
   uint32_t size;      /*!< Carry the current size of data when used Async functions*/
   CallBack_t callBack;/*!< Carry the CallBack which will executed after finish the Async functions*/
   uint8_t * Data;     /*!< Carry the data (transmit/received) in Async functions */
+  CallBack_t errorCallBack;     /*!< Called when a DMA transfer fails, may be NULL */
+  SPI_Job_t * pJobHead;         /*!< Job on the wire or next to start */
+  SPI_Job_t * pJobTail;         /*!< Last job queued */
+  volatile bool isJobRunning;   /*!< pJobHead is on the wire */
 } SPI_Handle_t;
 
 
@@ -377,6 +437,27 @@ extern SPI_ErrorStatus SPI_Transmit(SPI_Handle_t *hspi, uint8_t *pData, uint16_t
 extern SPI_ErrorStatus SPI_Receive(SPI_Handle_t *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
 
 
+/**
+ * @brief Transmits and receives data at the same time over SPI by polling.
+ *
+ * Two frames are kept in flight, one in the shift register and the next in
+ * the transmit buffer, and every received frame is read in the same loop, so
+ * SCK runs without gaps while the loop keeps up. The SPI stays enabled at
+ * the end, back to back calls do not set it up again.
+ *
+ * @param hspi Pointer to the SPI handle structure.
+ * @param pTxData Frames to transmit, bytes or half words after the data size, NULL sends 0xFF.
+ * @param pRxData Buffer of the received frames, may be pTxData, NULL drops them.
+ * @param Size Number of frames.
+ * @param Timeout Polls without progress before giving up.
+ * @return SPI_OK when every frame was exchanged, SPI_BUSY when an async
+ *         transfer or a job runs, SPI_TIMEOUT, or SPI_ERROR on an overrun or
+ *         a mode fault, which are cleared.
+ */
+extern SPI_ErrorStatus SPI_TransmitReceive(SPI_Handle_t *hspi, const uint8_t *pTxData, uint8_t *pRxData,
+                                           uint16_t Size, uint32_t Timeout);
+
+
 /**
  * @brief Transmits data over SPI asynchronously without using a buffer.
  *
@@ -403,6 +484,159 @@ extern SPI_ErrorStatus SPI_TransmitAsyncZeroCopy(SPI_Handle_t *hspi, uint8_t *pD
 extern SPI_ErrorStatus SPI_ReceiveAsyncZeroCopy(SPI_Handle_t *hspi, uint8_t *pData, uint16_t Size,CallBack_t CB);
 
 
+/**
+ * @brief Applies a new frame format to an initialized SPI.
+ *
+ * Rewrites the clock polarity, clock phase, baud rate prescaler, data size
+ * and byte order of CR1 from hspi->Init, the other settings are kept. The
+ * SPI is disabled once the last frame left the bus, then a master is enabled
+ * again so SCK idles at the new polarity before a device is selected.
+ *
+ * @param hspi Pointer to the SPI handle, hspi->Init holds the new format.
+ * @return SPI_OK when applied, SPI_BUSY when a transfer or a job runs,
+ *         SPI_ERROR for an invalid format.
+ */
+extern SPI_ErrorStatus SPI_UpdateFormat(SPI_Handle_t *hspi);
+
+
+/**
+ * @brief Queues a transaction on an SPI master.
+ *
+ * Jobs run one after the other in the SPI interrupt: every received byte
+ * stores its byte and sends the next, the end of a job releases its chip
+ * select, calls its callback and starts the next job, so a queue runs to the
+ * end without the caller. A job queued while an async zero-copy transfer
+ * runs starts when it completes. The SPIx_IRQn of the instance must be
+ * enabled in the NVIC.
+ *
+ * @param hspi Pointer to an SPI handle initialized as an 8-bit master.
+ * @param pJob The transaction, see @ref SPI_Job_t.
+ * @return SPI_OK when queued, SPI_ERROR otherwise.
+ * @note May be called from a job callback. It must not be called from an
+ *       interrupt of a higher priority than the SPI one.
+ */
+extern SPI_ErrorStatus SPI_SubmitJob(SPI_Handle_t *hspi, SPI_Job_t *pJob);
+
+
+/**
+ * @brief Transmits data over SPI with the DMA.
+ *
+ * The received frames are drained by the receive stream into a dummy, the
+ * callback runs once the last frame left the bus.
+ *
+ * @param hspi Pointer to the SPI handle structure.
+ * @param pData Frames to transmit, bytes or half words after the data size.
+ * @param Size Number of frames.
+ * @param CB Called from the DMA interrupt at the end, may be NULL.
+ * @return SPI_OK when started, SPI_BUSY when a transfer runs, SPI_ERROR otherwise.
+ * @note The DMA clock and the interrupts of the streams of the instance
+ *       must be enabled, see @ref SPI_DMA_Streams.
+ */
+extern SPI_ErrorStatus SPI_TransmitDMA(SPI_Handle_t *hspi, uint8_t *pData, uint16_t Size, CallBack_t CB);
+
+
+/**
+ * @brief Receives data over SPI with the DMA.
+ *
+ * The transmit stream sends 0xFF for every frame, so a master clocks the
+ * frames in and a slave answers with 0xFF.
+ *
+ * @param hspi Pointer to the SPI handle structure.
+ * @param pData Buffer of the received frames.
+ * @param Size Number of frames.
+ * @param CB Called from the DMA interrupt at the end, may be NULL.
+ * @return SPI_OK when started, SPI_BUSY when a transfer runs, SPI_ERROR otherwise.
+ */
+extern SPI_ErrorStatus SPI_ReceiveDMA(SPI_Handle_t *hspi, uint8_t *pData, uint16_t Size, CallBack_t CB);
+
+
+/**
+ * @brief Transmits and receives data at the same time over SPI with the DMA.
+ *
+ * @param hspi Pointer to the SPI handle structure.
+ * @param pTxData Frames to transmit.
+ * @param pRxData Buffer of the received frames, may be pTxData.
+ * @param Size Number of frames.
+ * @param CB Called from the DMA interrupt at the end, may be NULL.
+ * @return SPI_OK when started, SPI_BUSY when a transfer runs, SPI_ERROR otherwise.
+ * @note On a transfer error the DMA requests of the SPI are stopped and
+ *       hspi->errorCallBack is called instead of CB.
+ */
+extern SPI_ErrorStatus SPI_TransmitReceiveDMA(SPI_Handle_t *hspi, uint8_t *pTxData, uint8_t *pRxData,
+                                              uint16_t Size, CallBack_t CB);
+
+
+/**
+ * @brief Transmits pieces of memory as one transfer over SPI with the DMA.
+ *
+ * The transmit stream takes the pieces one after the other from its
+ * transfer complete interrupt (see DMA_StartChain), so a header, a payload
+ * and a CRC kept apart go out without being copied together. The received
+ * frames are dropped.
+ *
+ * @param hspi Pointer to the SPI handle structure.
+ * @param pSegments The pieces, Length in frames, kept until the end.
+ * @param Segments Number of pieces.
+ * @param CB Called from the DMA interrupt at the end of the last piece, may be NULL.
+ * @return SPI_OK when started, SPI_BUSY when a transfer runs, SPI_ERROR otherwise,
+ *         also for more than 65535 frames in all.
+ * @note On a transfer error the DMA requests of the SPI are stopped and
+ *       hspi->errorCallBack is called instead of CB.
+ */
+extern SPI_ErrorStatus SPI_TransmitChainDMA(SPI_Handle_t *hspi, const DMA_Segment_t *pSegments,
+                                            uint16_t Segments, CallBack_t CB);
+
+
+/**
+ * @brief Receives every frame of a slave into a ring buffer with the DMA.
+ *
+ * The receive stream runs in circular mode and never stops, the transmit
+ * stream is idle until SPI_SlaveLoadDMA gives it data. The SPI stays busy
+ * until SPI_SlaveStopDMA.
+ *
+ * @param hspi Pointer to the SPI handle, initialized as a slave.
+ * @param pRxRing Ring buffer of the received frames.
+ * @param Size Number of frames of the ring.
+ * @return SPI_OK when started, SPI_BUSY when a transfer runs, SPI_ERROR otherwise.
+ */
+extern SPI_ErrorStatus SPI_SlaveStartDMA(SPI_Handle_t *hspi, uint8_t *pRxRing, uint16_t Size);
+
+
+/**
+ * @brief Gives the transmit stream of a running slave the frames of the next transaction.
+ *
+ * pTxData[0] is the frame of the first slot. When the SPI still holds a
+ * frame in its transmit buffer, that frame goes out in the first slot and
+ * the stream starts at pTxData[1].
+ *
+ * @param hspi Pointer to the SPI handle started by SPI_SlaveStartDMA.
+ * @param pTxData Frames to send, read by the DMA while the master clocks.
+ * @param Size Number of frames, at least 2.
+ * @return SPI_OK when armed, SPI_ERROR otherwise.
+ * @note Call it while the slave is not selected.
+ */
+extern SPI_ErrorStatus SPI_SlaveLoadDMA(SPI_Handle_t *hspi, const uint8_t *pTxData, uint16_t Size);
+
+
+/**
+ * @brief Index in the ring of the next frame the slave will receive.
+ *
+ * @param hspi Pointer to the SPI handle started by SPI_SlaveStartDMA.
+ * @param pPosition Receives the index.
+ * @return SPI_OK, or SPI_ERROR when the slave does not run.
+ */
+extern SPI_ErrorStatus SPI_SlaveGetRxPosition(SPI_Handle_t *hspi, uint16_t *pPosition);
+
+
+/**
+ * @brief Stops both streams of a slave and disables the SPI.
+ *
+ * @param hspi Pointer to the SPI handle.
+ * @return SPI_OK, or SPI_ERROR when a stream did not stop.
+ */
+extern SPI_ErrorStatus SPI_SlaveStopDMA(SPI_Handle_t *hspi);
+
+
 /******************************************************************************/
 
 /******************************************************************************/
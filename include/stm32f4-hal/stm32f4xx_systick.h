@@ -255,6 +255,30 @@ extern SysTick_ErrorStatus_t SysTick_SetCallback(SysTickCB_t pCallBackFunction);
  * @endcode
  */
 extern SysTick_ErrorStatus_t SysTick_DelayMicroSeconds(uint32_t Time);
+
+/**
+ * @brief Stretches the running SysTick period over several ticks and sleeps.
+ *
+ * The counter is reloaded to end the current tick and Ticks - 1 more at once,
+ * then the core waits for an interrupt (WFI). On wakeup the counter is set to
+ * end the tick in progress at its usual time and goes back to the period of
+ * SysTick_SetTimeMS, so the tick phase is kept whatever woke the core.
+ *
+ * @param[in]  Ticks       Ticks to sleep at most, bounded by the 24-bit
+ *                         reload register, the last one ends with the usual
+ *                         SysTick interrupt.
+ * @param[out] pSleptTicks Whole ticks which ended while sleeping without
+ *                         their interrupt, the caller accounts for them.
+ *
+ * @return SYSTICK_OK, SYSTICK_NULL_PTR_PASSED, or SYSTICK_NOT_OK when Ticks
+ *         is 0 or the timer is not running.
+ *
+ * @note Call it with the interrupts masked (NVIC_DisableInterrupts), after
+ *       checking nothing is left to do. An interrupt still wakes the core and
+ *       is taken once they are unmasked. It returns at once with no tick
+ *       slept when a SysTick interrupt is already pending.
+ */
+extern SysTick_ErrorStatus_t SysTick_SleepTicks(uint32_t Ticks, uint32_t * pSleptTicks);
 /******************************************************************************/
 
 /******************************************************************************/
@@ -62,6 +62,12 @@ extern "C"
 */
 #define UART_OVERSAMPLING_16                0x00000000U
 #define UART_OVERSAMPLING_8                 0x00008000U
+/**
+ * 16 while BRR can hold the divider, for its better noise immunity, else 8.
+ * Both round the same Clock / BaudRate divider so their baud error is the
+ * same, 8 only reaches baud rates twice as high.
+ */
+#define UART_OVERSAMPLING_AUTO              0x80000000U
  /**
   * @}
 */
@@ -157,6 +163,15 @@ typedef enum
  */
 typedef void (*Uart_CallBack)(void);
 
+/**
+ * @typedef Uart_RxBlockCallBack
+ * @brief Receives one completed half of a continuous reception buffer.
+ *
+ * @param[in] pData First byte of the half.
+ * @param[in] Size Bytes in the half.
+ */
+typedef void (*Uart_RxBlockCallBack)(const char * pData, uint16_t Size);
+
 /**
  * @typedef UART_Init_t
  * @brief Defines a structure containing configuration parameters for UART initialization.
@@ -187,6 +202,25 @@ typedef struct
     uint32_t BaudRate;
 } UART_Init_t;
 
+/**
+ * @typedef UART_BaudInfo_t
+ * @brief Baud rate an instance really runs at, set by UART_Init.
+ */
+typedef struct
+{
+    /** @field Clock - Frequency of the APB bus of the instance, in Hz. */
+    uint32_t Clock;
+
+    /** @field Achieved - Baud rate produced by BRR. */
+    uint32_t Achieved;
+
+    /** @field ErrorCentiPercent - (Achieved - BaudRate) / BaudRate in 0.01 % units. */
+    int32_t ErrorCentiPercent;
+
+    /** @field OverSampling - Oversampling in use, @ref UART_Over_Sampling. */
+    uint32_t OverSampling;
+} UART_BaudInfo_t;
+
 /**
  * @typedef UART_Handle_t
  * @brief Defines a structure representing a UART handle, used to manage a UART instance.
@@ -202,6 +236,22 @@ typedef struct
 
 } UART_Handle_t;
 
+/**
+ * @typedef UART_BufferedStats_t
+ * @brief Fill level and losses of a UART instance in buffered mode.
+ */
+typedef struct
+{
+    /** @field TxPending - Bytes waiting in the transmit ring. */
+    uint16_t TxPending;
+
+    /** @field RxPending - Bytes waiting in the receive ring. */
+    uint16_t RxPending;
+
+    /** @field RxDropped - Bytes lost on a full receive ring or a hardware overrun. */
+    uint32_t RxDropped;
+} UART_BufferedStats_t;
+
 
 /******************************************************************************/
 
@@ -232,9 +282,22 @@ typedef struct
  *         success or failure of initialization.
  * 
  * @note it is mandatory to call init function before utilizing other APIs.
+ * @note BRR is derived from the APB clock read from the RCC driver, call
+ *       UART_Init again after changing the system clock or the prescalers.
  */
 extern UART_ErrorStatus_t UART_Init(const UART_Handle_t * const uartHandle);
 
+/**
+ * @brief Reads the baud rate an instance was set to by UART_Init.
+ *
+ * @param[in] uartHandle Pointer to an initialized UART_Handle_t.
+ * @param[out] pInfo Filled with the bus clock, the achieved baud rate and its error.
+ *
+ * @return UART_ErrorStatus_t UART_ERROR_NONE, UART_NULL_PTR_PASSED or UART_ERROR.
+ */
+extern UART_ErrorStatus_t UART_GetBaudInfo(const UART_Handle_t * const uartHandle,
+                                           UART_BaudInfo_t * pInfo);
+
 /**
  * @brief Transmits data over UART with a timeout mechanism.
  *
@@ -320,6 +383,108 @@ extern void UART_TransmitWithDMA(UART_Handle_t *uartHandle,Uart_CallBack CB);
 */
 extern void UART_ReceiveWithDMA(UART_Handle_t *uartHandle);
 
+/**
+ * @brief Receives without end into a buffer filled by a circular DMA.
+ *
+ * The DMA never stops: while it fills one half of pBuffer the other half,
+ * complete, is handed to CB from the DMA interrupt. CB must be done with
+ * its half before the DMA comes back to it, a half later. A half overwritten
+ * before CB returned is counted as an overrun.
+ *
+ * | Instance | DMA stream           | IRQ to enable      |
+ * |----------|----------------------|--------------------|
+ * | USART1   | DMA2 stream 5, ch 4  | DMA2_Stream5_IRQn  |
+ * | USART2   | DMA1 stream 5, ch 4  | DMA1_Stream5_IRQn  |
+ * | USART6   | DMA2 stream 1, ch 5  | DMA2_Stream1_IRQn  |
+ *
+ * @param[in] uartHandle Pointer to an initialized UART_Handle_t.
+ * @param[in] pBuffer Buffer written by the DMA, kept until reset.
+ * @param[in] Size Size of pBuffer, even and at least 2.
+ * @param[in] CB Called with each completed half.
+ *
+ * @return UART_ERROR_NONE, UART_NULL_PTR_PASSED, UART_PARAM_ERROR or
+ *         UART_ERROR when the instance is already receiving.
+ *
+ * @note The DMA clock and the IRQ of the stream must be enabled by the caller.
+ *       The reception goes on across a later UART_Init with a new baud rate.
+ */
+extern UART_ErrorStatus_t UART_ReceiveContinuousDMA(UART_Handle_t *uartHandle,
+                                                    char *pBuffer, uint16_t Size,
+                                                    Uart_RxBlockCallBack CB);
+
+/**
+ * @brief Reads the number of halves lost by the continuous reception.
+ *
+ * @param[in] uartHandle Pointer to a UART_Handle_t receiving continuously.
+ * @param[out] pOverruns Halves overwritten by the DMA before being handed over.
+ *
+ * @return UART_ERROR_NONE, UART_NULL_PTR_PASSED or UART_ERROR.
+ */
+extern UART_ErrorStatus_t UART_GetRxOverruns(UART_Handle_t *uartHandle,
+                                             uint32_t *pOverruns);
+
+/**
+ * @brief Puts a UART instance in buffered mode, transmit and receive go through
+ *        rings owned by the instance interrupt.
+ *
+ * Every instance has its own rings, so USART1, USART2 and USART6 can all be
+ * buffered at once. The zero-copy asynchronous APIs are refused on a buffered
+ * instance until UART_Init is called again.
+ *
+ * @param[in] uartHandle Pointer to an initialized UART_Handle_t.
+ * @param[in] pTxBuffer Storage of the transmit ring, kept until UART_Init.
+ * @param[in] TxSize Size of pTxBuffer, at least 2, one byte stays unused.
+ * @param[in] pRxBuffer Storage of the receive ring, kept until UART_Init.
+ * @param[in] RxSize Size of pRxBuffer, at least 2, one byte stays unused.
+ *
+ * @return UART_ERROR_NONE, UART_NULL_PTR_PASSED, UART_PARAM_ERROR or
+ *         UART_ERROR when an asynchronous transfer is in progress.
+ *
+ * @note The USARTx_IRQn of the instance must be enabled in the NVIC.
+ */
+extern UART_ErrorStatus_t UART_StartBuffered(UART_Handle_t *uartHandle,
+                                             char *pTxBuffer, uint16_t TxSize,
+                                             char *pRxBuffer, uint16_t RxSize);
+
+/**
+ * @brief Queues bytes in the transmit ring without blocking.
+ *
+ * @param[in] uartHandle Pointer to a buffered UART_Handle_t.
+ * @param[in] pData Bytes to send.
+ * @param[in] Size Number of bytes to send.
+ * @param[out] pWritten Number of bytes queued, less than Size when the ring is full.
+ *
+ * @return UART_ERROR_NONE, UART_NULL_PTR_PASSED or UART_ERROR when the
+ *         instance is not buffered.
+ */
+extern UART_ErrorStatus_t UART_Write(UART_Handle_t *uartHandle, const char *pData,
+                                     uint16_t Size, uint16_t *pWritten);
+
+/**
+ * @brief Takes the received bytes out of the receive ring without blocking.
+ *
+ * @param[in] uartHandle Pointer to a buffered UART_Handle_t.
+ * @param[out] pData Filled with the received bytes.
+ * @param[in] Size Size of pData.
+ * @param[out] pRead Number of bytes copied, 0 when nothing was received.
+ *
+ * @return UART_ERROR_NONE, UART_NULL_PTR_PASSED or UART_ERROR when the
+ *         instance is not buffered.
+ */
+extern UART_ErrorStatus_t UART_Read(UART_Handle_t *uartHandle, char *pData,
+                                    uint16_t Size, uint16_t *pRead);
+
+/**
+ * @brief Reads the fill level and the losses of a buffered instance.
+ *
+ * @param[in] uartHandle Pointer to a buffered UART_Handle_t.
+ * @param[out] pStats Filled with the counters.
+ *
+ * @return UART_ERROR_NONE, UART_NULL_PTR_PASSED or UART_ERROR.
+ */
+extern UART_ErrorStatus_t UART_GetBufferedStats(UART_Handle_t *uartHandle,
+                                                UART_BufferedStats_t *pStats);
+
 
 /******************************************************************************/
 
@@ -25,6 +25,7 @@
 #include "ControlProtocol.h"
 #include "CSwitch.h"
 #include "switch_cfg.h"
+#include "schedular.h"
 /******************************************************************************/
 
 /******************************************************************************/
@@ -40,6 +41,20 @@ static CSWITCH_PressedButton_t MyPbutton = NO_PRESSED;
 
 
 static Message_t Mymsg;
+
+/**
+ * Layout of an event frame (MessageType DATA): the low 16 bits of the time
+ * of the first event, then 2 bytes per event holding the edge, the switch
+ * and the time since the first event.
+ */
+#define EVENT_BASE_SIZE                 (2U)
+#define EVENT_SIZE                      (2U)
+#define EVENTS_PER_FRAME                ((NUMBER_OF_DATA - EVENT_BASE_SIZE) / EVENT_SIZE)
+#define EVENT_EDGE_Pos                  (7U)
+#define EVENT_SWITCH_Pos                (4U)
+#define EVENT_SWITCH_Msk                (0x70U)
+#define EVENT_DELTA_HIGH_Msk            (0x0FU)
+#define EVENT_MAX_DELTA_MS              (0x0FFFU)
 /******************************************************************************/
 
 /******************************************************************************/
@@ -59,6 +74,12 @@ static Message_t Mymsg;
 /* PRIVATE TYPES */
 /******************************************************************************/
 
+typedef struct
+{
+    uint32_t BaseMS;
+    uint8_t  Count;
+    uint8_t  Event[EVENTS_PER_FRAME][EVENT_SIZE];
+} EventBatch_t;
 
 /******************************************************************************/
 
@@ -76,6 +97,15 @@ static volatile uint8_t UPNumberOfPressed = 0;
 static volatile uint32_t UPCounts = 0;
 static volatile uint8_t DownNumberOfPressed = 0;
 static volatile uint32_t DOWNCounts = 0;
+
+/** Slave side, transitions waiting to be sent */
+static EventBatch_t Batch;
+
+/** Master side, transitions received and not read yet */
+static CSWITCH_InputEvent_t EventQueue[CSWITCH_EVENT_QUEUE_DEPTH];
+static volatile uint8_t EventHead = 0;
+static volatile uint8_t EventTail = 0;
+static uint32_t LastBaseMS = 0;
 /******************************************************************************/
 
 /******************************************************************************/
@@ -97,6 +127,11 @@ static void CheckButtonsInNormalState(void);
 static void CheckButtonsInStopWatchState(void);
 static void CheckButtonsInEditState(void);
 static void ReceiveCallBack(void);
+static PROTOCOL_ErrorStatus_t FlushEvents(void);
+static void AddEvent(uint8_t Switch, CSWITCH_Edge_t Edge, uint32_t TimeMS);
+static void SwitchChanged(uint8_t switchName, uint32_t switchStatus);
+static void CollectEvents(void);
+static void DecodeEvents(void);
 
 /******************************************************************************/
 
@@ -109,6 +144,7 @@ static void CheckButtonsInNormalState(void)
     uint32_t ButtonRead;
     Message_t msg;
     msg.MessageType = COMMAND;
+    msg.Channel = PROTOCOL_CHANNEL_CONTROL;
     msg.CallBack =  NULL;
     msg.len = 1;
     SWITCH_enuGetStatus(UP_SWITCH,&ButtonRead);
@@ -133,6 +169,7 @@ static void CheckButtonsInStopWatchState(void)
     uint32_t ButtonRead;
     Message_t msg;
     msg.MessageType = COMMAND;
+    msg.Channel = PROTOCOL_CHANNEL_CONTROL;
     msg.pMessage[0] = 'S';
     msg.CallBack =  NULL;
     msg.len = 2;
@@ -177,14 +214,15 @@ static void CheckButtonsInEditState(void)
     uint32_t ButtonRead;
     Message_t msg;
     msg.MessageType = COMMAND;
+    msg.Channel = PROTOCOL_CHANNEL_CONTROL;
     msg.CallBack =  NULL;
     msg.len = 2;
     msg.pMessage[0] = 'E';
-    UPCounts += 100;
-    DOWNCounts += 100;
+    UPCounts += CSWITCH_UPDATE_PERIOD_MS;
+    DOWNCounts += CSWITCH_UPDATE_PERIOD_MS;
     SWITCH_enuGetStatus(UP_SWITCH,&ButtonRead);
     if(ButtonRead == SWITCH_STATUS_PRESSED) UPNumberOfPressed++;
-    if(UPCounts >= 1600)
+    if(UPCounts >= CSWITCH_MULTI_PRESS_WINDOW_MS)
     {
         UPCounts = 0;
         if(UPNumberOfPressed >= 1 && UPNumberOfPressed < 3)
@@ -206,7 +244,7 @@ static void CheckButtonsInEditState(void)
     }
     SWITCH_enuGetStatus(DOWN_SWITCH,&ButtonRead);
     if(ButtonRead == SWITCH_STATUS_PRESSED) DownNumberOfPressed++;
-    if(DOWNCounts >= 1600)
+    if(DOWNCounts >= CSWITCH_MULTI_PRESS_WINDOW_MS)
     {
         if(DownNumberOfPressed >= 1 && DownNumberOfPressed < 3)
         {
@@ -246,8 +284,120 @@ static void CheckButtonsInEditState(void)
     }
 }
 
+static PROTOCOL_ErrorStatus_t FlushEvents(void)
+{
+    PROTOCOL_ErrorStatus_t RET_ErrorStatus = PROTOCOL_OK;
+    Message_t msg;
+    msg.MessageType = DATA;
+    msg.Channel = PROTOCOL_CHANNEL_CONTROL;
+    msg.CallBack = NULL;
+    msg.len = EVENT_BASE_SIZE + Batch.Count * EVENT_SIZE;
+    msg.pMessage[0] = (char)(Batch.BaseMS & 0xFF);
+    msg.pMessage[1] = (char)((Batch.BaseMS >> 8) & 0xFF);
+    for(uint8_t Event = 0 ; Event < Batch.Count ; Event++)
+    {
+        msg.pMessage[EVENT_BASE_SIZE + Event * EVENT_SIZE]      = (char)Batch.Event[Event][0];
+        msg.pMessage[EVENT_BASE_SIZE + Event * EVENT_SIZE + 1U] = (char)Batch.Event[Event][1];
+    }
+    RET_ErrorStatus = Protocol_SendAsync(&msg);
+    if(RET_ErrorStatus == PROTOCOL_OK)
+    {
+        Batch.Count = 0;
+    }
+    else
+    {
+        /** Kept, sent again on the next update */
+    }
+    return RET_ErrorStatus;
+}
+
+static void AddEvent(uint8_t Switch, CSWITCH_Edge_t Edge, uint32_t TimeMS)
+{
+    /** The delta of the event must fit in 12 bits */
+    if(Batch.Count != 0 && TimeMS - Batch.BaseMS > EVENT_MAX_DELTA_MS)
+    {
+        (void)FlushEvents();
+    }
+    if(Batch.Count == 0)
+    {
+        Batch.BaseMS = TimeMS;
+    }
+    if(Batch.Count < EVENTS_PER_FRAME && TimeMS - Batch.BaseMS <= EVENT_MAX_DELTA_MS)
+    {
+        uint32_t Delta = TimeMS - Batch.BaseMS;
+        Batch.Event[Batch.Count][0] = (uint8_t)((Edge << EVENT_EDGE_Pos) |
+                                                ((Switch << EVENT_SWITCH_Pos) & EVENT_SWITCH_Msk) |
+                                                ((Delta >> 8) & EVENT_DELTA_HIGH_Msk));
+        Batch.Event[Batch.Count][1] = (uint8_t)(Delta & 0xFF);
+        Batch.Count++;
+    }
+    else
+    {
+        /** The link did not take the previous batch, the event is lost */
+    }
+    if(Batch.Count == EVENTS_PER_FRAME)
+    {
+        (void)FlushEvents();
+    }
+}
+
+/** Timestamps a transition in the switch runnable, when it is debounced. */
+static void SwitchChanged(uint8_t switchName, uint32_t switchStatus)
+{
+    AddEvent(switchName,
+             (switchStatus == SWITCH_STATUS_PRESSED) ? CSWITCH_EDGE_PRESSED
+                                                     : CSWITCH_EDGE_RELEASED,
+             schedular_GetTimeMS());
+}
+
+/** Sends the batch once its first event waited CSWITCH_BATCH_DEADLINE_MS. */
+static void CollectEvents(void)
+{
+    uint32_t Now = schedular_GetTimeMS();
+    if(Batch.Count != 0 && Now - Batch.BaseMS >= CSWITCH_BATCH_DEADLINE_MS)
+    {
+        (void)FlushEvents();
+    }
+}
+
+/** Rebuilds the timestamps of an event frame into the event queue. */
+static void DecodeEvents(void)
+{
+    uint32_t Base = (uint8_t)Mymsg.pMessage[0] | ((uint32_t)(uint8_t)Mymsg.pMessage[1] << 8);
+    /** Only 16 bits travel, the upper ones follow the previous frames */
+    Base |= LastBaseMS & 0xFFFF0000UL;
+    if(Base < LastBaseMS)
+    {
+        Base += 0x10000UL;
+    }
+    LastBaseMS = Base;
+    uint8_t Len = (Mymsg.len <= NUMBER_OF_DATA) ? (uint8_t)Mymsg.len : NUMBER_OF_DATA;
+    for(uint8_t Idx = EVENT_BASE_SIZE ; Idx + EVENT_SIZE <= Len ; Idx += EVENT_SIZE)
+    {
+        uint8_t Head = (uint8_t)Mymsg.pMessage[Idx];
+        if((uint8_t)(EventHead - EventTail) < CSWITCH_EVENT_QUEUE_DEPTH)
+        {
+            CSWITCH_InputEvent_t * Event = &EventQueue[EventHead % CSWITCH_EVENT_QUEUE_DEPTH];
+            Event->Edge   = (CSWITCH_Edge_t)(Head >> EVENT_EDGE_Pos);
+            Event->Switch = (Head & EVENT_SWITCH_Msk) >> EVENT_SWITCH_Pos;
+            Event->TimeMS = Base + (((uint32_t)(Head & EVENT_DELTA_HIGH_Msk) << 8) |
+                                    (uint8_t)Mymsg.pMessage[Idx + 1U]);
+            EventHead++;
+        }
+        else
+        {
+            /** Not read in time, the newest events are dropped */
+        }
+    }
+}
+
 void ReceiveCallBack(void)
 {
+    if(Mymsg.MessageType == DATA)
+    {
+        DecodeEvents();
+        return;
+    }
     if(Mymsg.pMessage[0] == 'N')
     {
         MyState = NORMAL;
@@ -309,11 +459,21 @@ void CSWITCH_Init(void)
     Protocol_Init();
 	SWITCH_enuInit();
     Mymsg.CallBack = ReceiveCallBack;
+    Mymsg.Channel = PROTOCOL_CHANNEL_CONTROL;
     Protocol_ReceiveAsync(&Mymsg);
+    if(CSWITCH_INPUT_MODE == CSWITCH_MODE_EVENTS)
+    {
+        SWITCH_enuSetChangeCallBack(SwitchChanged);
+    }
 }
 
 void CSWIRCH_SendUpdate(void)
 {
+    if(CSWITCH_INPUT_MODE == CSWITCH_MODE_EVENTS)
+    {
+        CollectEvents();
+        return;
+    }
     switch (state)
     {
     case NORMAL:
@@ -345,4 +505,23 @@ CSWITCH_ErrorStatus_t CSWIRCH_ReceivedUpdate(CSWITCH_ScreenState_t * Updates)
     return  RET_ErrorStatus;
 }
 
+CSWITCH_ErrorStatus_t CSWITCH_ReadEvent(CSWITCH_InputEvent_t * Event)
+{
+    CSWITCH_ErrorStatus_t RET_ErrorStatus = CSWITCH_OK;
+    if(Event == NULL)
+    {
+        RET_ErrorStatus = CSWITCH_NULL_PTR_PASSES;
+    }
+    else if(EventHead == EventTail)
+    {
+        RET_ErrorStatus = CSWITCH_NO_EVENT;
+    }
+    else
+    {
+        *Event = EventQueue[EventTail % CSWITCH_EVENT_QUEUE_DEPTH];
+        EventTail++;
+    }
+    return RET_ErrorStatus;
+}
+
 /******************************************************************************/
\ No newline at end of file
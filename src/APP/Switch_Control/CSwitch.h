@@ -44,6 +44,43 @@ extern "C"
 /* PUBLIC DEFINES */
 /******************************************************************************/
 
+/** Every button action is sent as its own command frame */
+#define CSWITCH_MODE_COMMANDS           (0U)
+/** Button transitions are timestamped and several are sent per frame */
+#define CSWITCH_MODE_EVENTS             (1U)
+
+/**
+ * @brief Selects how the buttons are reported to the master.
+ *
+ * In CSWITCH_MODE_EVENTS the slave does not keep the screen state machine,
+ * the master reads the transitions with CSWITCH_ReadEvent and decides.
+ */
+#ifndef CSWITCH_INPUT_MODE
+#define CSWITCH_INPUT_MODE              CSWITCH_MODE_COMMANDS
+#endif
+
+/**
+ * @brief Period at which CSWIRCH_SendUpdate is called.
+ *
+ * In CSWITCH_MODE_EVENTS the transitions are timestamped by the switch
+ * runnable when they are debounced, the update only sends the batches and
+ * a few ms keeps them close to CSWITCH_BATCH_DEADLINE_MS.
+ */
+#if CSWITCH_INPUT_MODE == CSWITCH_MODE_EVENTS
+#define CSWITCH_UPDATE_PERIOD_MS        (10U)
+#else
+#define CSWITCH_UPDATE_PERIOD_MS        (100U)
+#endif
+
+/** Window in which the presses of a button are counted in edit mode */
+#define CSWITCH_MULTI_PRESS_WINDOW_MS   (1600U)
+
+/** Longest time the first event of a batch waits before the frame is sent */
+#define CSWITCH_BATCH_DEADLINE_MS       (50U)
+
+/** Events kept on the master until read, must be a power of 2 */
+#define CSWITCH_EVENT_QUEUE_DEPTH       (16U)
+
 
 /******************************************************************************/
 
@@ -60,7 +97,8 @@ typedef enum
 {
     CSWITCH_NULL_PTR_PASSES,
     CSWITCH_WRONG,
-    CSWITCH_OK
+    CSWITCH_OK,
+    CSWITCH_NO_EVENT
 } CSWITCH_ErrorStatus_t;
 
 typedef enum
@@ -84,6 +122,12 @@ typedef enum
     RESET,
     NO_PRESSED
 } CSWITCH_PressedButton_t;
+
+typedef enum
+{
+    CSWITCH_EDGE_RELEASED,
+    CSWITCH_EDGE_PRESSED
+} CSWITCH_Edge_t;
 /******************************************************************************/
 
 /******************************************************************************/
@@ -96,6 +140,14 @@ typedef struct
     uint8_t isStopWatchWorking;
 } CSWITCH_ScreenState_t;
 
+/** Button transition reported in CSWITCH_MODE_EVENTS */
+typedef struct
+{
+    uint8_t Switch;         /**< Switch of the slave, @ref Switches_t */
+    CSWITCH_Edge_t Edge;    /**< Pressed or released */
+    uint32_t TimeMS;        /**< Slave scheduler time of the transition */
+} CSWITCH_InputEvent_t;
+
 
 /******************************************************************************/
 
@@ -121,6 +173,23 @@ extern void CSWIRCH_SendUpdate(void);
 
 extern CSWITCH_ErrorStatus_t CSWIRCH_ReceivedUpdate(CSWITCH_ScreenState_t * Updates);
 
+/**
+ * @brief Takes the oldest button transition received from the slave.
+ *
+ * The timestamps are the ones of the slave, taken by CheckSwitchesStates
+ * when the transition is debounced, the time between two events is exact to
+ * its period whatever the link delays.
+ *
+ * Only the low 16 bits of the first event of a frame travel, the upper ones
+ * follow the previous frame. The times are right only while the frames are
+ * less than 65.5 s apart, an idle link for longer shifts them by a multiple
+ * of 65536 ms.
+ *
+ * @param[out] Event Filled with the transition
+ * @return CSWITCH_OK, CSWITCH_NULL_PTR_PASSES or CSWITCH_NO_EVENT
+ */
+extern CSWITCH_ErrorStatus_t CSWITCH_ReadEvent(CSWITCH_InputEvent_t * Event);
+
 
 /******************************************************************************/
 
@@ -0,0 +1,136 @@
+#include "AppCFG.h"
+
+#if CFG_IS_CURRENT_APP(CFG_APP_DMA_BENCH)
+
+
+#include <string.h>
+#include "console.h"
+#include "stm32f4xx_dma.h"
+#include "stm32f4xx_dwt.h"
+#include "stm32f4xx_nvic.h"
+#include "stm32f4xx_rcc.h"
+
+
+/* Bytes copied by each run, a whole number of the largest burst */
+#define BENCH_BYTES         (8192U)
+
+
+/* Source side (the peripheral port in memory to memory) and memory side of one run */
+typedef struct
+{
+	const char * pName;
+	uint32_t PerAlignment;
+	uint32_t PeriphBurst;
+	uint32_t MemAlignment;
+	uint32_t MemBurst;
+	uint32_t Threshold;
+} BenchConfig_t;
+
+
+static const BenchConfig_t Configs[] =
+{
+	/* Single bytes, what the UART and SPI users do in direct mode */
+	{"byte single",       DMA_PDATAALIGN_BYTE, DMA_PBURST_SINGLE, DMA_MDATAALIGN_BYTE, DMA_MBURST_SINGLE, DMA_FIFO_THRESHOLD_1QUARTERFULL},
+	{"byte INC4 1/4",     DMA_PDATAALIGN_BYTE, DMA_PBURST_INC4,   DMA_MDATAALIGN_BYTE, DMA_MBURST_INC4,   DMA_FIFO_THRESHOLD_1QUARTERFULL},
+	{"byte INC16 full",   DMA_PDATAALIGN_BYTE, DMA_PBURST_INC16,  DMA_MDATAALIGN_BYTE, DMA_MBURST_INC16,  DMA_FIFO_THRESHOLD_FULL},
+	{"byte to word INC4", DMA_PDATAALIGN_BYTE, DMA_PBURST_INC16,  DMA_MDATAALIGN_WORD, DMA_MBURST_INC4,   DMA_FIFO_THRESHOLD_FULL},
+	{"half INC8 full",    DMA_PDATAALIGN_HALFWORD, DMA_PBURST_INC8, DMA_MDATAALIGN_HALFWORD, DMA_MBURST_INC8, DMA_FIFO_THRESHOLD_FULL},
+	{"word single",       DMA_PDATAALIGN_WORD, DMA_PBURST_SINGLE, DMA_MDATAALIGN_WORD, DMA_MBURST_SINGLE, DMA_FIFO_THRESHOLD_HALFFULL},
+	{"word INC4 full",    DMA_PDATAALIGN_WORD, DMA_PBURST_INC4,   DMA_MDATAALIGN_WORD, DMA_MBURST_INC4,   DMA_FIFO_THRESHOLD_FULL},
+	/* Refused: a burst of 16 bytes cannot wait for a half full FIFO */
+	{"word INC4 1/2",     DMA_PDATAALIGN_WORD, DMA_PBURST_INC4,   DMA_MDATAALIGN_WORD, DMA_MBURST_INC4,   DMA_FIFO_THRESHOLD_HALFFULL},
+};
+
+
+static uint32_t Source[BENCH_BYTES / 4U];
+static uint32_t Destination[BENCH_BYTES / 4U];
+static DMA_Handle_t Bench;
+
+
+static void Flush(void)
+{
+	Console_Stats_t Stats;
+	do
+	{
+		Console_GetStats(&Stats);
+	} while(Stats.Pending != 0U);
+}
+
+
+/* Copies Source to Destination with one configuration, the CPU reads SRAM meanwhile */
+static void Run(const BenchConfig_t * pConfig)
+{
+	DMA_States_t State;
+	uint32_t Start;
+	uint32_t Cycles;
+	uint32_t Loops = 0;
+	volatile uint32_t Probe = 0;
+	uint32_t Items = BENCH_BYTES >> (pConfig->PerAlignment >> DMA_SxCR_PSIZE_Pos);
+
+	memset(Destination, 0, sizeof(Destination));
+	Bench.Initialization.PerAlignment = pConfig->PerAlignment;
+	Bench.Initialization.MemAlignment = pConfig->MemAlignment;
+	/* Set by DMA_ConfigFifo, the last run may have left bursts too wide for this one */
+	Bench.Initialization.MemBurst     = DMA_MBURST_SINGLE;
+	Bench.Initialization.PeriphBurst  = DMA_PBURST_SINGLE;
+	if(DMA_Init(&Bench, 1000) != DMA_OK ||
+	   DMA_ConfigFifo(&Bench, pConfig->Threshold, pConfig->MemBurst, pConfig->PeriphBurst) != DMA_OK)
+	{
+		Console_Printf("%-18s refused\r\n", pConfig->pName);
+	}
+	else
+	{
+		Start = DWT_GetCycles();
+		DMA_StartInterrupt(&Bench, Source, Destination, Items);
+		do
+		{
+			/* Stands for the CPU work the bus still allows */
+			Probe += Source[Loops & 0xFFU];
+			Loops++;
+			DMA_GetState(&Bench, &State);
+		} while(State == DMA_STATE_BUSY || State == DMA_STATE_HALF);
+		Cycles = DWT_GetElapsed(Start);
+		Console_Printf("%-18s %6lu cycles %2lu.%02lu /byte %6lu CPU loops%s\r\n", pConfig->pName,
+		               (unsigned long)Cycles, (unsigned long)(Cycles / BENCH_BYTES),
+		               (unsigned long)((Cycles % BENCH_BYTES) * 100U / BENCH_BYTES), (unsigned long)Loops,
+		               (State != DMA_STATE_READY || memcmp(Source, Destination, BENCH_BYTES) != 0) ? " BAD" : "");
+	}
+	Flush();
+}
+
+
+int main(void)
+{
+	Console_Init();
+	DWT_Init();
+	RCC_enuEnablePeripheral(PERIPHERAL_DMA2);
+	for(uint32_t Word = 0; Word < BENCH_BYTES / 4U; Word++)
+	{
+		Source[Word] = Word * 0x9E3779B9U;
+	}
+	Bench.Instance                     = DMA2;
+	Bench.Stream                       = DMA_STREAM_6;
+	Bench.Initialization.Channel       = DMA_CHANNEL_0;
+	Bench.Initialization.Direction     = DMA_MEMORY_TO_MEMORY;
+	Bench.Initialization.Mode          = DMA_NORMAL;
+	Bench.Initialization.Priority      = DMA_PRIORITY_LOW;
+	Bench.Initialization.FIFOMode      = DMA_FIFOMODE_ENABLE;
+	Bench.Initialization.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
+	Bench.Initialization.MemInc        = DMA_MEMORY_INCREMENT_ENABLED;
+	Bench.Initialization.PeriphInc     = DMA_PERIPHERAL_INCREMENT_ENABLED;
+	Bench.Initialization.MemBurst      = DMA_MBURST_SINGLE;
+	Bench.Initialization.PeriphBurst   = DMA_PBURST_SINGLE;
+	NVIC_EnableIRQ(DMA2_Stream6_IRQn);
+
+	Console_Printf("DMA2 memory to memory, %u bytes per run\r\n", BENCH_BYTES);
+	Flush();
+	for(uint32_t Config = 0; Config < sizeof(Configs) / sizeof(Configs[0]); Config++)
+	{
+		Run(&Configs[Config]);
+	}
+	while(1)
+	{
+	}
+    return 0;
+}
+#endif
@@ -0,0 +1,130 @@
+#include "AppCFG.h"
+
+#if CFG_IS_CURRENT_APP(CFG_APP_SPI_BENCH)
+
+
+#include <string.h>
+#include "console.h"
+#include "stm32f4xx_spi.h"
+#include "stm32f4xx_gpio.h"
+#include "stm32f4xx_dwt.h"
+#include "stm32f4xx_rcc.h"
+
+
+/* Frames exchanged by each run, PA7 (MOSI) wired to PA6 (MISO) reads them back */
+#define BENCH_FRAMES        (1024U)
+
+#define BENCH_TIMEOUT       (1000U)
+
+
+/* Clock and frame size of one run, APB2 runs at the core clock */
+typedef struct
+{
+	const char * pName;
+	uint32_t Prescaler;
+	uint32_t Divider;
+	uint32_t DataSize;
+	uint32_t Bits;
+} BenchConfig_t;
+
+
+static const BenchConfig_t Configs[] =
+{
+	{"8-bit /2",   SPI_BAUDRATEPRESCALER_2,  2U,  SPI_DATASIZE_8BIT,  8U},
+	{"8-bit /8",   SPI_BAUDRATEPRESCALER_8,  8U,  SPI_DATASIZE_8BIT,  8U},
+	{"8-bit /32",  SPI_BAUDRATEPRESCALER_32, 32U, SPI_DATASIZE_8BIT,  8U},
+	{"16-bit /2",  SPI_BAUDRATEPRESCALER_2,  2U,  SPI_DATASIZE_16BIT, 16U},
+	{"16-bit /8",  SPI_BAUDRATEPRESCALER_8,  8U,  SPI_DATASIZE_16BIT, 16U},
+};
+
+
+static uint16_t Transmit[BENCH_FRAMES];
+static uint16_t Receive[BENCH_FRAMES];
+static SPI_Handle_t Bench;
+
+
+static void Flush(void)
+{
+	Console_Stats_t Stats;
+	do
+	{
+		Console_GetStats(&Stats);
+	} while(Stats.Pending != 0U);
+}
+
+
+/* One SPI_TransmitReceive of BENCH_FRAMES frames, against the cycles SCK needs for them */
+static void Run(const BenchConfig_t * pConfig)
+{
+	SPI_ErrorStatus Status;
+	uint32_t Start;
+	uint32_t Cycles;
+	uint32_t Ideal = pConfig->Divider * pConfig->Bits;
+	uint32_t Bytes = BENCH_FRAMES * (pConfig->Bits / 8U);
+
+	memset(Receive, 0, sizeof(Receive));
+	Bench.Init.BaudRatePrescaler = pConfig->Prescaler;
+	Bench.Init.DataSize          = pConfig->DataSize;
+	if(SPI_Init(&Bench) != SPI_OK)
+	{
+		Console_Printf("%-10s refused\r\n", pConfig->pName);
+	}
+	else
+	{
+		Start = DWT_GetCycles();
+		Status = SPI_TransmitReceive(&Bench, (const uint8_t *)Transmit, (uint8_t *)Receive, BENCH_FRAMES, BENCH_TIMEOUT);
+		Cycles = DWT_GetElapsed(Start);
+		Console_Printf("%-10s %7lu cycles %3lu.%02lu /frame, SCK %3lu%s\r\n", pConfig->pName,
+		               (unsigned long)Cycles, (unsigned long)(Cycles / BENCH_FRAMES),
+		               (unsigned long)((Cycles % BENCH_FRAMES) * 100U / BENCH_FRAMES), (unsigned long)Ideal,
+		               (Status != SPI_OK || memcmp(Transmit, Receive, Bytes) != 0) ? " BAD" : "");
+	}
+	Flush();
+}
+
+
+int main(void)
+{
+	gpioPin_t Pin =
+	{
+		.GPIO_Port    = GPIO_PORTA,
+		.GPIO_Speed   = GPIO_SPEED_VERY_HIGH,
+		.GPIO_Mode    = GPIO_MODE_AF5,
+		.GPIO_AT_Type = GPIO_AT_PushPull
+	};
+
+	Console_Init();
+	DWT_Init();
+	RCC_enuEnablePeripheral(PERIPHERAL_GPIOA);
+	RCC_enuEnablePeripheral(PERIPHERAL_SPI1);
+	/* SCK, MISO and MOSI of SPI1 */
+	for(uint8_t Line = GPIO_PIN5; Line <= GPIO_PIN7; Line++)
+	{
+		Pin.GPIO_Pin = Line;
+		GPIO_Init(&Pin);
+	}
+	for(uint32_t Frame = 0; Frame < BENCH_FRAMES; Frame++)
+	{
+		Transmit[Frame] = (uint16_t)(Frame * 0x9E37U);
+	}
+	Bench.Instance            = SPI1;
+	Bench.Init.Mode           = SPI_MODE_MASTER;
+	Bench.Init.ByteOrder      = SPI_BYTEORDER_MSB;
+	Bench.Init.NSS            = SPI_NSS_SOFT;
+	Bench.Init.CLKPolarity    = SPI_POLARITY_LOW;
+	Bench.Init.CLKPhase       = SPI_PHASE_FIRST_EDGE;
+	Bench.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
+	Bench.Init.CRCPolynomial  = 7;
+
+	Console_Printf("SPI1 SPI_TransmitReceive, %u frames per run, SCK gives the fewest cycles\r\n", BENCH_FRAMES);
+	Flush();
+	for(uint32_t Config = 0; Config < sizeof(Configs) / sizeof(Configs[0]); Config++)
+	{
+		Run(&Configs[Config]);
+	}
+	while(1)
+	{
+	}
+    return 0;
+}
+#endif
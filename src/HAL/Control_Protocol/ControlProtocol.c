@@ -1,16 +1,22 @@
 /******************************************************************************/
 /**
- * @file FILE.c
- * @brief 
+ * @file ControlProtocol.c
+ * @brief Control protocol between the two micro-controllers.
  *
  * @par Project Name
- * 
+ * Control Protocol
  *
  * @par Code Language
  * C
  *
  * @par Description
- * 
+ * Every message travels in one frame of 13 segments {order, data}. The type
+ * segment carries the logical channel, a sequence bit and the message type.
+ * Frames are acknowledged one at a time, ACK and NACK frames carry the
+ * number of free receive slots (credits) of every channel.
+ * Messages live in pooled buffers: received frames are written in place in
+ * the buffer later handed to the application, queued frames are referenced
+ * and not copied.
  * 
  * @par Author
  * Mahmoud Abou-Hawis
@@ -23,26 +29,45 @@
 /******************************************************************************/
 #include "ControlProtocol.h"
 #include "protocol_physical__layer.h"
+#include "protocol_buffer.h"
 /******************************************************************************/
 
 /******************************************************************************/
 /* PRIVATE DEFINES */
 /******************************************************************************/
 
+#if PROTOCOL_ACK_TIMEOUT_MS == 0
+#error "PROTOCOL_ACK_TIMEOUT_MS must not be 0, a lost frame or ACK would stop the link"
+#endif
+
 #define FRAME_SIZE                         (26U)
 
 #define FRAME_SIZE_IN_SEGMENTS             (13U)
 
-#define MAXIMUM_FRAMES_FOR_MSG             (4U)
-
 #define START_FRAME_SEG                    (0U)
 
 #define DATA_TYPE_SEG                      (1U)  
 #define DATA_LEN_SEG                       (2U)
+#define FIRST_DATA_SEG                     (3U)
 
 #define CHECKSUM_SEG                       (11U)
 #define END_FRAME_SEG                      (12U)
 
+/** Values of the length segment marking the link control frames */
+#define ACK_FRAME_LEN                      (255U)
+#define NACK_FRAME_LEN                     (254U)
+#define CREDIT_FRAME_LEN                   (253U)
+#define NO_CONTROL_FRAME                   (0U)
+
+/** Layout of the type segment */
+#define TYPE_CHANNEL_Pos                   (4U)
+#define TYPE_CHANNEL_Msk                   (0xF0U)
+#define TYPE_SEQUENCE_Pos                  (3U)
+#define TYPE_SEQUENCE_Msk                  (0x08U)
+#define TYPE_MSG_TYPE_Msk                  (0x07U)
+
+/** Expected sequence bit before the first frame of a channel */
+#define SEQUENCE_ANY                       (0xFFU)
 
 /******************************************************************************/
 
@@ -52,7 +77,10 @@
 /* PRIVATE MACROS */
 /******************************************************************************/
 
-#define GET_NUMBER_OF_FRAMES(MSG_LEN)  ((MSG_LEN + 7) / 8)
+#define IS_CHANNEL(CHANNEL)            ((CHANNEL) < _PROTOCOL_CHANNELS_NUM)
+
+#define GET_CHANNEL(TYPE)              (((TYPE) & TYPE_CHANNEL_Msk) >> TYPE_CHANNEL_Pos)
+#define GET_SEQUENCE(TYPE)             (((TYPE) & TYPE_SEQUENCE_Msk) >> TYPE_SEQUENCE_Pos)
 
 /******************************************************************************/
 /* PRIVATE ENUMS */
@@ -78,9 +106,15 @@ typedef struct
 typedef struct 
 {
     bool isStartSent;
-
+    uint8_t NextOrder;      /**< Order of the next segment of the frame */
 } ReceivedMsg;
 
+typedef struct
+{
+    Protocol_Buffer_t * Slot[PROTOCOL_MAX_QUEUE_DEPTH];
+    uint8_t   Head;
+    uint8_t   Count;
+} MsgQueue_t;
 
 /******************************************************************************/
 
@@ -95,37 +129,44 @@ typedef struct
 /* PRIVATE VARIABLE DEFINITIONS */
 /******************************************************************************/
 static Frame_t messageToSend = {0};
-static Frame_t messageToReceive = {0};
+static Frame_t controlFrame = {0};
 
 static ReceivedMsg receivedMsg   = {0};
 static Segment_t SegmentReceived = {0};
 
+/** Buffer the data segments of the current frame are written to */
+static Protocol_Buffer_t * pRxBuffer = NULL;
+/** Payload of control frames, and of data frames when the pool is empty */
+static char RxScratch[NUMBER_OF_DATA];
+static char * pRxPayload = RxScratch;
+static uint8_t RxType     = 0;
+static uint8_t RxLen      = 0;
+static uint8_t RxChecksum = 0;
 
-static Message_t * received = NULL;
-static Message_t * sent     = NULL; 
-
-Frame_t ACK = 
-{
-    .Segment[START_FRAME_SEG].order = 0,
-    .Segment[START_FRAME_SEG].data = 0xff,
-    .Segment[DATA_LEN_SEG].order = DATA_LEN_SEG,
-    .Segment[DATA_LEN_SEG].data = 255,
-    .Segment[END_FRAME_SEG].data = 0xff,
-    .Segment[END_FRAME_SEG].order = END_FRAME_SEG
-};
-
+/** Receive buffers registered by Protocol_ReceiveAsync */
+static Message_t * received[_PROTOCOL_CHANNELS_NUM];
 
-Frame_t sendDataAgain = 
-{
-    .Segment[START_FRAME_SEG].order = 0,
-    .Segment[START_FRAME_SEG].data = 0xff,
-    .Segment[DATA_TYPE_SEG].order = DATA_TYPE_SEG,
-    .Segment[DATA_TYPE_SEG].data = DATA,
-    .Segment[END_FRAME_SEG].data = 0xff,
-    .Segment[END_FRAME_SEG].order = END_FRAME_SEG
-};
+static MsgQueue_t TxQueues[_PROTOCOL_CHANNELS_NUM];
+static MsgQueue_t RxQueues[_PROTOCOL_CHANNELS_NUM];
 
+/** Frames the other side can still take on every channel */
+static uint8_t TxCredits[_PROTOCOL_CHANNELS_NUM];
+/** Sequence bit of the next new frame sent on every channel */
+static uint8_t TxSequence[_PROTOCOL_CHANNELS_NUM];
+/** Sequence bit of the next new frame expected on every channel */
+static uint8_t RxSequence[_PROTOCOL_CHANNELS_NUM];
+/** A control frame told the other side a channel was full */
+static bool isCreditOwed[_PROTOCOL_CHANNELS_NUM];
 
+static volatile bool isTxBusy        = false;
+static volatile bool isWaitingAck    = false;
+static volatile bool isResendPending = false;
+static volatile uint8_t PendingControl = NO_CONTROL_FRAME;
+/** Channel and sequence bit of the frame the pending ACK answers */
+static uint8_t  PendingControlType = 0;
+static uint8_t  InFlightChannel = 0;
+static uint32_t AckTimerMS      = 0;
+static uint32_t CreditTimerMS   = 0;
 
 /******************************************************************************/
 
@@ -145,7 +186,16 @@ Frame_t sendDataAgain =
 /* PRIVATE FUNCTION PROTOTYPES */
 /******************************************************************************/
 static void ConvertMsgToFrames(Message_t * msg);
-static void ConvertFramesToMsg(Frame_t * msg);
+static void BuildControlFrame(uint8_t ControlLen, uint8_t Type);
+static void ApplyCredits(void);
+static uint8_t CalculateChecksum(Frame_t * frame);
+static uint8_t PayloadChecksum(const char * pPayload);
+static uint8_t FreeSlots(uint8_t Channel);
+static void OfferCredits(void);
+static void DeliverReceived(uint8_t Channel);
+static void ReceiveDataFrame(void);
+static void Transmit(void);
+static void ProtocolTransmitCallBack(void);
 /******************************************************************************/
 
 /******************************************************************************/
@@ -154,22 +204,21 @@ static void ConvertFramesToMsg(Frame_t * msg);
 /******************************************************************************/
 static void ConvertMsgToFrames(Message_t * msg)
 {
-    /**This variable carry the checksum of the data*/
-    uint8_t CheckSum = 0;
-
     /** Set the start of the frame */
     messageToSend.Segment[START_FRAME_SEG].data = 0xff;
     messageToSend.Segment[DATA_LEN_SEG].data = msg->len;
-    messageToSend.Segment[DATA_TYPE_SEG].data = msg->MessageType;
+    messageToSend.Segment[DATA_TYPE_SEG].data = 
+        (uint8_t)((msg->Channel << TYPE_CHANNEL_Pos) |
+                  (TxSequence[msg->Channel] << TYPE_SEQUENCE_Pos) |
+                  (msg->MessageType & TYPE_MSG_TYPE_Msk));
 
-    /**Set the date and calculate the check in the frame only */
-    for(uint8_t DataSegmentIdx = 3 ; DataSegmentIdx < FRAME_SIZE_IN_SEGMENTS-2 ; DataSegmentIdx++)
+    /**Set the date in the frame only */
+    for(uint8_t DataSegmentIdx = FIRST_DATA_SEG ; DataSegmentIdx < CHECKSUM_SEG ; DataSegmentIdx++)
     {
-        if(DataSegmentIdx -3 < msg->len)
+        if(DataSegmentIdx - FIRST_DATA_SEG < msg->len)
         {
             messageToSend.Segment[DataSegmentIdx].data 
-            = msg->pMessage[DataSegmentIdx - 3];
-            CheckSum += msg->pMessage[DataSegmentIdx - 3];
+            = msg->pMessage[DataSegmentIdx - FIRST_DATA_SEG];
         }
         else
         {
@@ -178,62 +227,376 @@ static void ConvertMsgToFrames(Message_t * msg)
     }
 
     /**set the checksum and the end of the frame */
-    messageToSend.Segment[CHECKSUM_SEG].data = CheckSum;
+    messageToSend.Segment[CHECKSUM_SEG].data = CalculateChecksum(&messageToSend);
     messageToSend.Segment[END_FRAME_SEG].data = 0xff;
 }
 
-static void ConvertFramesToMsg(Frame_t * frame)
+static uint8_t CalculateChecksum(Frame_t * frame)
+{
+    uint8_t CheckSum = 0;
+    for(uint8_t DataIdx = FIRST_DATA_SEG ; DataIdx < CHECKSUM_SEG ; DataIdx++)
+    {
+        CheckSum += frame->Segment[DataIdx].data;
+    }
+    return CheckSum;
+}
+
+static uint8_t PayloadChecksum(const char * pPayload)
+{
+    uint8_t CheckSum = 0;
+    for(uint8_t Data = 0 ; Data < NUMBER_OF_DATA ; Data++)
+    {
+        CheckSum += (uint8_t)pPayload[Data];
+    }
+    return CheckSum;
+}
+
+/**
+ * Free receive slots of a channel, bounded by the buffers left in the pool
+ * since every accepted frame keeps one until it is read.
+ */
+static uint8_t FreeSlots(uint8_t Channel)
+{
+    uint8_t Slots = ProtocolChannels[Channel].RxQueueDepth - RxQueues[Channel].Count;
+    uint8_t Free  = Protocol_BufferFreeCount();
+    return (Free < Slots) ? Free : Slots;
+}
+
+/** Sends a CREDIT frame once a channel reported full can take frames again. */
+static void OfferCredits(void)
+{
+    bool isCreditReady = false;
+    for(uint8_t Channel = 0 ; Channel < _PROTOCOL_CHANNELS_NUM ; Channel++)
+    {
+        isCreditReady |= (isCreditOwed[Channel] && FreeSlots(Channel) != 0);
+    }
+    if(isCreditReady && PendingControl == NO_CONTROL_FRAME)
+    {
+        PendingControl = CREDIT_FRAME_LEN;
+        Transmit();
+    }
+    else
+    {
+        /* No thing */
+    }
+}
+
+/**
+ * ACK, NACK and CREDIT frames carry in their data segments the number of
+ * free receive slots of every channel, computed when they are sent.
+ */
+static void BuildControlFrame(uint8_t ControlLen, uint8_t Type)
+{
+    controlFrame.Segment[DATA_LEN_SEG].data = ControlLen;
+    controlFrame.Segment[DATA_TYPE_SEG].data = Type;
+    for(uint8_t Channel = 0 ; Channel < FRAME_SIZE_IN_SEGMENTS - 5 ; Channel++)
+    {
+        uint8_t Credits = 0;
+        if(IS_CHANNEL(Channel))
+        {
+            Credits = FreeSlots(Channel);
+            isCreditOwed[Channel] = (Credits == 0);
+        }
+        else
+        {
+            /* No thing */
+        }
+        controlFrame.Segment[FIRST_DATA_SEG + Channel].data = Credits;
+    }
+    controlFrame.Segment[CHECKSUM_SEG].data = CalculateChecksum(&controlFrame);
+}
+
+static void ApplyCredits(void)
 {
-    received->len = frame->Segment[DATA_LEN_SEG].data;
-    received->MessageType = frame->Segment[DATA_TYPE_SEG].data;
-    for(uint8_t Data = 3; Data < FRAME_SIZE_IN_SEGMENTS -2 ; Data++)
+    if(PayloadChecksum(pRxPayload) == RxChecksum)
+    {
+        /** Both sides share the configuration, more credits can not be true */
+        for(uint8_t Channel = 0 ; Channel < _PROTOCOL_CHANNELS_NUM ; Channel++)
+        {
+            uint8_t Credits = (uint8_t)pRxPayload[Channel];
+            TxCredits[Channel] = (Credits < ProtocolChannels[Channel].RxQueueDepth)
+                               ? Credits : ProtocolChannels[Channel].RxQueueDepth;
+        }
+    }
+    else
     {
-        received->pMessage[Data-3] = frame->Segment[Data].data;
+        /* No thing */
     }
 }
 
+/** Hands the queued messages to the buffer registered for the channel. */
+static void DeliverReceived(uint8_t Channel)
+{
+    MsgQueue_t * queue = &RxQueues[Channel];
+    Message_t  * msg   = received[Channel];
+    while(msg != NULL && queue->Count != 0)
+    {
+        Protocol_Buffer_t * head = queue->Slot[queue->Head];
+        msg->MessageType = head->Msg.MessageType;
+        msg->len = head->Msg.len;
+        msg->Channel = head->Msg.Channel;
+        for(uint8_t Data = 0 ; Data < NUMBER_OF_DATA ; Data++)
+        {
+            msg->pMessage[Data] = head->Msg.pMessage[Data];
+        }
+        queue->Head = (queue->Head + 1) % PROTOCOL_MAX_QUEUE_DEPTH;
+        queue->Count--;
+        (void)Protocol_BufferRelease(head);
+        if(msg->CallBack != NULL)
+        {
+            msg->CallBack();
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+}
+
+static void ReceiveDataFrame(void)
+{
+    uint8_t Type    = RxType;
+    uint8_t Channel = GET_CHANNEL(Type);
+    if(PayloadChecksum(pRxPayload) != RxChecksum || RxLen > NUMBER_OF_DATA ||
+       !IS_CHANNEL(Channel))
+    {
+        PendingControl = NACK_FRAME_LEN;
+    }
+    else if(RxSequence[Channel] != SEQUENCE_ANY &&
+            RxSequence[Channel] != GET_SEQUENCE(Type))
+    {
+        /** Our ACK was lost and the frame came again, only acknowledge it */
+        PendingControlType = Type & (TYPE_CHANNEL_Msk | TYPE_SEQUENCE_Msk);
+        PendingControl = ACK_FRAME_LEN;
+    }
+    else if(RxQueues[Channel].Count >= ProtocolChannels[Channel].RxQueueDepth ||
+            pRxBuffer == NULL)
+    {
+        /** The sender had no credit left, it waits for a CREDIT frame */
+        PendingControl = NACK_FRAME_LEN;
+    }
+    else
+    {
+        /** The payload is already in the buffer, it is queued as it is */
+        MsgQueue_t * queue = &RxQueues[Channel];
+        pRxBuffer->Msg.MessageType = (MsgType_t)(Type & TYPE_MSG_TYPE_Msk);
+        pRxBuffer->Msg.len = RxLen;
+        pRxBuffer->Msg.Channel = Channel;
+        pRxBuffer->Msg.CallBack = NULL;
+        queue->Slot[(queue->Head + queue->Count) % PROTOCOL_MAX_QUEUE_DEPTH] = pRxBuffer;
+        queue->Count++;
+        pRxBuffer  = NULL;
+        pRxPayload = RxScratch;
+        RxSequence[Channel] = GET_SEQUENCE(Type) ^ 1U;
+        DeliverReceived(Channel);
+        PendingControlType = Type & (TYPE_CHANNEL_Msk | TYPE_SEQUENCE_Msk);
+        PendingControl = ACK_FRAME_LEN;
+    }
+}
+
+/**
+ * Starts the next frame when the transmitter is free: link control frames
+ * first, then a frame to send again, then the head of the highest priority
+ * channel which has both a message and a credit.
+ */
+static void Transmit(void)
+{
+    if(isTxBusy)
+    {
+        /* No thing */
+    }
+    else if(PendingControl != NO_CONTROL_FRAME)
+    {
+        BuildControlFrame(PendingControl, PendingControlType);
+        PendingControl = NO_CONTROL_FRAME;
+        isTxBusy = true;
+        HardWare_Send((char*)(&controlFrame),FRAME_SIZE);
+    }
+    else if(isResendPending)
+    {
+        isResendPending = false;
+        AckTimerMS = 0;
+        isTxBusy = true;
+        HardWare_Send((char*)(&messageToSend),FRAME_SIZE);
+    }
+    else if(!isWaitingAck)
+    {
+        uint8_t Next = _PROTOCOL_CHANNELS_NUM;
+        for(uint8_t Channel = 0 ; Channel < _PROTOCOL_CHANNELS_NUM ; Channel++)
+        {
+            if(TxQueues[Channel].Count != 0 && TxCredits[Channel] != 0 &&
+               (Next == _PROTOCOL_CHANNELS_NUM ||
+                ProtocolChannels[Channel].Priority < ProtocolChannels[Next].Priority))
+            {
+                Next = Channel;
+            }
+            else
+            {
+                /* No thing */
+            }
+        }
+        if(IS_CHANNEL(Next))
+        {
+            ConvertMsgToFrames(&TxQueues[Next].Slot[TxQueues[Next].Head]->Msg);
+            TxCredits[Next]--;
+            InFlightChannel = Next;
+            isWaitingAck = true;
+            AckTimerMS = 0;
+            isTxBusy = true;
+            HardWare_Send((char*)(&messageToSend),FRAME_SIZE);
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    else
+    {
+        /* No thing */
+    }
+}
+
+static void ProtocolTransmitCallBack(void)
+{
+    isTxBusy = false;
+    Transmit();
+}
+
+/**
+ * Every segment is stored as it arrives: the data segments go straight into
+ * the pooled buffer taken when the length segment announced a data frame.
+ *
+ * A frame is only kept when its segments come in order. When a byte is lost
+ * the reception gets out of step by one byte and the order of every segment
+ * shows up in the data byte, one byte is then read alone as soon as a start
+ * order shows there, so the next frame is received aligned again. Every
+ * segment costs constant time but the end one, which also walks the
+ * NUMBER_OF_DATA payload bytes and the channels.
+ */
 void ProtocolReceiveCallBack(void)
 {
-    if(SegmentReceived.order == 0  && SegmentReceived.data == 255 )
+    uint8_t Order = SegmentReceived.order;
+    uint8_t Data  = SegmentReceived.data;
+    bool isSlipping = false;
+    if(Order == START_FRAME_SEG && Data == 0xff)
     {
         receivedMsg.isStartSent = true;
+        receivedMsg.NextOrder = DATA_TYPE_SEG;
+        pRxPayload = RxScratch;
     }
-    if(SegmentReceived.order == 12 && SegmentReceived.data == 255 && receivedMsg.isStartSent == true)
+    else if(receivedMsg.isStartSent == false || Order != receivedMsg.NextOrder)
     {
+        /** Outside a frame or a segment is missing, the frame is dropped */
         receivedMsg.isStartSent = false;
-        if(messageToReceive.Segment[DATA_LEN_SEG].data == 255)
+        if(Data == START_FRAME_SEG)
         {
-            if(sent->CallBack != NULL) sent->CallBack();
+            SegmentReceived.order = Data;
+            isSlipping = true;
         }
-        else if(messageToReceive.Segment[DATA_TYPE_SEG].data == DATA)
+        else
         {
-            HardWare_Send((char *)(&messageToSend),FRAME_SIZE);
+            /* No thing */
         }
-        else
+    }
+    else if(Order == END_FRAME_SEG)
+    {
+        uint8_t Type = RxType;
+        receivedMsg.isStartSent = false;
+        if(Data != 0xff)
+        {
+            /* No thing */
+        }
+        else if(RxLen == ACK_FRAME_LEN)
+        {
+            ApplyCredits();
+            /** A late ACK of a frame sent twice must not acknowledge the next one */
+            if(isWaitingAck && GET_CHANNEL(Type) == InFlightChannel &&
+               GET_SEQUENCE(Type) == TxSequence[InFlightChannel])
+            {
+                MsgQueue_t * queue = &TxQueues[InFlightChannel];
+                Protocol_Buffer_t * pBuffer = queue->Slot[queue->Head];
+                Protocol_CallBack CallBack = pBuffer->Msg.CallBack;
+                queue->Head = (queue->Head + 1) % PROTOCOL_MAX_QUEUE_DEPTH;
+                queue->Count--;
+                TxSequence[InFlightChannel] ^= 1U;
+                isWaitingAck = false;
+                (void)Protocol_BufferRelease(pBuffer);
+                OfferCredits();
+                if(CallBack != NULL) CallBack();
+            }
+            else
+            {
+                /* No thing */
+            }
+        }
+        else if(RxLen == NACK_FRAME_LEN)
         {
-            uint8_t Checksum = 0;
-            for(uint8_t DataIdx = 3 ;DataIdx <  FRAME_SIZE_IN_SEGMENTS-2 ; DataIdx++ )
+            ApplyCredits();
+            if(isWaitingAck && TxCredits[InFlightChannel] != 0)
+            {
+                isResendPending = true;
+            }
+            else
             {
-                Checksum += messageToReceive.Segment[DataIdx].data;
+                /** Full on the other side, other channels may go meanwhile */
+                isWaitingAck = false;
             }
-            if(Checksum == messageToReceive.Segment[CHECKSUM_SEG].data)
+        }
+        else if(RxLen == CREDIT_FRAME_LEN)
+        {
+            ApplyCredits();
+        }
+        else
+        {
+            ReceiveDataFrame();
+        }
+        Transmit();
+    }
+    else
+    {
+        receivedMsg.NextOrder++;
+        if(Order == DATA_TYPE_SEG)
+        {
+            RxType = Data;
+        }
+        else if(Order == DATA_LEN_SEG)
+        {
+            RxLen = Data;
+            if(Data <= NUMBER_OF_DATA)
             {
-                ConvertFramesToMsg(&messageToReceive);
-                if(received->CallBack != NULL)
+                /** Kept from a rejected frame, or taken now; NULL if the pool is empty */
+                if(pRxBuffer == NULL)
+                {
+                    (void)Protocol_BufferAlloc(&pRxBuffer);
+                }
+                else
                 {
-                    received->CallBack();
+                    /* No thing */
                 }
-                HardWare_Send((char*)(&ACK),FRAME_SIZE);
+                pRxPayload = (pRxBuffer != NULL) ? pRxBuffer->Msg.pMessage : RxScratch;
             }
             else
             {
-                HardWare_Send((char*)(&sendDataAgain),FRAME_SIZE);
+                pRxPayload = RxScratch;
             }
         }
+        else if(Order < CHECKSUM_SEG)
+        {
+            pRxPayload[Order - FIRST_DATA_SEG] = (char)Data;
+        }
+        else
+        {
+            RxChecksum = Data;
+        }
+    }
+    if(isSlipping)
+    {
+        HardWare_Receive((char*)(&SegmentReceived.data),1);
+    }
+    else
+    {
+        HardWare_Receive((char*)(&SegmentReceived),2);
     }
-    messageToReceive.Segment[SegmentReceived.order].order = SegmentReceived.order;
-    messageToReceive.Segment[SegmentReceived.order].data = SegmentReceived.data;
-    HardWare_Receive((char*)(&SegmentReceived),2);
 }
 
 /******************************************************************************/
@@ -243,42 +606,110 @@ void ProtocolReceiveCallBack(void)
 
 PROTOCOL_ErrorStatus_t Protocol_Init(void)
 {
-    HardWare_Init(ProtocolReceiveCallBack);
+    HardWare_Init(ProtocolReceiveCallBack, ProtocolTransmitCallBack);
+    Protocol_BufferInit();
     receivedMsg.isStartSent = false;
-    HardWare_Receive((char*)(&SegmentReceived),2);
-    for(uint8_t Frame = 0 ; Frame < MAXIMUM_FRAMES_FOR_MSG ; Frame++)
+    receivedMsg.NextOrder = START_FRAME_SEG;
+    pRxBuffer  = NULL;
+    pRxPayload = RxScratch;
+    isTxBusy        = false;
+    isWaitingAck    = false;
+    isResendPending = false;
+    PendingControl  = NO_CONTROL_FRAME;
+    for(uint8_t Channel = 0 ; Channel < _PROTOCOL_CHANNELS_NUM ; Channel++)
     {
-        for(uint8_t SegmentIdx = 0 ; SegmentIdx < FRAME_SIZE_IN_SEGMENTS ; SegmentIdx++)
-        {
-            messageToSend.Segment[SegmentIdx].order = SegmentIdx;
-        }
+        received[Channel] = NULL;
+        TxQueues[Channel].Head  = 0;
+        TxQueues[Channel].Count = 0;
+        RxQueues[Channel].Head  = 0;
+        RxQueues[Channel].Count = 0;
+        TxCredits[Channel]  = ProtocolChannels[Channel].RxQueueDepth;
+        TxSequence[Channel] = 0;
+        RxSequence[Channel] = SEQUENCE_ANY;
+        isCreditOwed[Channel] = false;
+    }
+    for(uint8_t SegmentIdx = 0 ; SegmentIdx < FRAME_SIZE_IN_SEGMENTS ; SegmentIdx++)
+    {
+        messageToSend.Segment[SegmentIdx].order = SegmentIdx;
+        controlFrame.Segment[SegmentIdx].order = SegmentIdx;
+        controlFrame.Segment[SegmentIdx].data = 0;
     }
+    controlFrame.Segment[START_FRAME_SEG].data = 0xff;
+    controlFrame.Segment[END_FRAME_SEG].data = 0xff;
+    HardWare_Receive((char*)(&SegmentReceived),2);
     return PROTOCOL_OK;
 }
 
 PROTOCOL_ErrorStatus_t Protocol_SendAsync(Message_t * msg)
 {
     PROTOCOL_ErrorStatus_t RET_ErrorStatus = PROTOCOL_OK;
-    if(msg != NULL)
+    Protocol_Buffer_t * pBuffer = NULL;
+    if(msg == NULL || !IS_CHANNEL(msg->Channel) || msg->len > NUMBER_OF_DATA)
     {
-        sent = msg;
-        ConvertMsgToFrames(sent);
-        HardWare_Send((char*)(&messageToSend),FRAME_SIZE);
+        RET_ErrorStatus = PROTOCOL_ERROR;
+    }
+    else if(TxQueues[msg->Channel].Count >= ProtocolChannels[msg->Channel].TxQueueDepth)
+    {
+        RET_ErrorStatus = PROTOCOL_QUEUE_FULL;
+    }
+    else
+    {
+        RET_ErrorStatus = Protocol_BufferAlloc(&pBuffer);
+    }
+    if(RET_ErrorStatus == PROTOCOL_OK)
+    {
+        pBuffer->Msg = *msg;
+        RET_ErrorStatus = Protocol_SendBuffer(pBuffer);
+        (void)Protocol_BufferRelease(pBuffer);
     }
     else
+    {
+        /* No thing */
+    }
+    return RET_ErrorStatus;
+}
+
+PROTOCOL_ErrorStatus_t Protocol_SendBuffer(Protocol_Buffer_t * pBuffer)
+{
+    PROTOCOL_ErrorStatus_t RET_ErrorStatus = PROTOCOL_OK;
+    if(pBuffer == NULL || !IS_CHANNEL(pBuffer->Msg.Channel) ||
+       pBuffer->Msg.len > NUMBER_OF_DATA)
     {
         RET_ErrorStatus = PROTOCOL_ERROR;
     }
+    else
+    {
+        MsgQueue_t * queue = &TxQueues[pBuffer->Msg.Channel];
+        HardWare_Lock();
+        if(queue->Count >= ProtocolChannels[pBuffer->Msg.Channel].TxQueueDepth)
+        {
+            RET_ErrorStatus = PROTOCOL_QUEUE_FULL;
+        }
+        else if(Protocol_BufferRetain(pBuffer) != PROTOCOL_OK)
+        {
+            RET_ErrorStatus = PROTOCOL_ERROR;
+        }
+        else
+        {
+            queue->Slot[(queue->Head + queue->Count) % PROTOCOL_MAX_QUEUE_DEPTH] = pBuffer;
+            queue->Count++;
+            Transmit();
+        }
+        HardWare_Unlock();
+    }
     return RET_ErrorStatus;
 }
 
 PROTOCOL_ErrorStatus_t Protocol_ReceiveAsync(Message_t* msg)
 {
     PROTOCOL_ErrorStatus_t RET_ErrorStatus = PROTOCOL_OK;
-    if(msg != NULL)
+    if(msg != NULL && IS_CHANNEL(msg->Channel))
     {
-        received = msg;
-        received->len = 0;
+        HardWare_Lock();
+        received[msg->Channel] = msg;
+        msg->len = 0;
+        DeliverReceived(msg->Channel);
+        HardWare_Unlock();
     }
     else
     {
@@ -287,5 +718,116 @@ PROTOCOL_ErrorStatus_t Protocol_ReceiveAsync(Message_t* msg)
     return RET_ErrorStatus;
 }
 
+PROTOCOL_ErrorStatus_t Protocol_Read(uint8_t Channel, Message_t * msg)
+{
+    PROTOCOL_ErrorStatus_t RET_ErrorStatus = PROTOCOL_OK;
+    Protocol_Buffer_t * pBuffer = NULL;
+    if(msg == NULL)
+    {
+        RET_ErrorStatus = PROTOCOL_ERROR;
+    }
+    else
+    {
+        RET_ErrorStatus = Protocol_ReadBuffer(Channel, &pBuffer);
+    }
+    if(RET_ErrorStatus == PROTOCOL_OK)
+    {
+        *msg = pBuffer->Msg;
+        (void)Protocol_BufferRelease(pBuffer);
+        HardWare_Lock();
+        OfferCredits();
+        HardWare_Unlock();
+    }
+    else
+    {
+        /* No thing */
+    }
+    return RET_ErrorStatus;
+}
 
-/******************************************************************************/
\ No newline at end of file
+PROTOCOL_ErrorStatus_t Protocol_ReadBuffer(uint8_t Channel, Protocol_Buffer_t ** ppBuffer)
+{
+    PROTOCOL_ErrorStatus_t RET_ErrorStatus = PROTOCOL_OK;
+    if(ppBuffer == NULL || !IS_CHANNEL(Channel))
+    {
+        RET_ErrorStatus = PROTOCOL_ERROR;
+    }
+    else
+    {
+        MsgQueue_t * queue = &RxQueues[Channel];
+        HardWare_Lock();
+        if(queue->Count == 0)
+        {
+            RET_ErrorStatus = PROTOCOL_QUEUE_EMPTY;
+        }
+        else
+        {
+            *ppBuffer = queue->Slot[queue->Head];
+            queue->Head = (queue->Head + 1) % PROTOCOL_MAX_QUEUE_DEPTH;
+            queue->Count--;
+            OfferCredits();
+        }
+        HardWare_Unlock();
+    }
+    return RET_ErrorStatus;
+}
+
+void Protocol_Runnable(void)
+{
+    /** Buffers taken by Protocol_ReadBuffer come back without notice */
+    HardWare_Lock();
+    OfferCredits();
+    HardWare_Unlock();
+    bool isStalled = false;
+    HardWare_Lock();
+    for(uint8_t Channel = 0 ; Channel < _PROTOCOL_CHANNELS_NUM ; Channel++)
+    {
+        isStalled |= (TxQueues[Channel].Count != 0 && TxCredits[Channel] == 0);
+    }
+    if(isWaitingAck && !isResendPending)
+    {
+        AckTimerMS += PROTOCOL_RUNNABLE_PERIOD_MS;
+        if(AckTimerMS >= PROTOCOL_ACK_TIMEOUT_MS)
+        {
+            isResendPending = true;
+            Transmit();
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    else if(!isWaitingAck && isStalled)
+    {
+        /** The CREDIT frame may have been lost, probe with one frame */
+        CreditTimerMS += PROTOCOL_RUNNABLE_PERIOD_MS;
+        if(CreditTimerMS >= PROTOCOL_ACK_TIMEOUT_MS)
+        {
+            CreditTimerMS = 0;
+            for(uint8_t Channel = 0 ; Channel < _PROTOCOL_CHANNELS_NUM ; Channel++)
+            {
+                if(TxQueues[Channel].Count != 0 && TxCredits[Channel] == 0)
+                {
+                    TxCredits[Channel] = 1;
+                }
+                else
+                {
+                    /* No thing */
+                }
+            }
+            Transmit();
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    else
+    {
+        CreditTimerMS = 0;
+    }
+    HardWare_Unlock();
+}
+
+
+/******************************************************************************/
@@ -0,0 +1,55 @@
+/******************************************************************************/
+/**
+ * @file ControlProtocol_CFG.c
+ * @brief Logical channels configuration of the control protocol.
+ *
+ * @par Project Name
+ * Control Protocol
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Priority and queue depths of every channel listed in Protocol_Channel_t.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include "ControlProtocol.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC CONSTANT DEFINITIONS */
+/******************************************************************************/
+
+/**
+ * @brief Channels Configuration Array
+ *
+ * Each element holds the priority of a channel and the depth of its transmit
+ * and receive queues. The receive depth is also the number of frames the
+ * other side may send on the channel before it waits for the messages to be
+ * read.
+ */
+const Protocol_ChannelCfg_t ProtocolChannels[_PROTOCOL_CHANNELS_NUM] =
+{
+    [PROTOCOL_CHANNEL_CONTROL] =
+    {
+        .Priority     = 0,
+        .TxQueueDepth = 4,
+        .RxQueueDepth = 4
+    },
+    [PROTOCOL_CHANNEL_DIAGNOSTICS] =
+    {
+        .Priority     = 1,
+        .TxQueueDepth = 4,
+        .RxQueueDepth = 2
+    }
+};
+
+/******************************************************************************/
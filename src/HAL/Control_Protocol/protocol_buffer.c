@@ -0,0 +1,166 @@
+/******************************************************************************/
+/**
+ * @file protocol_buffer.c
+ * @brief Message buffer pool of the control protocol.
+ *
+ * @par Project Name
+ * Control Protocol
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * The free buffers are kept in a stack of indexes, allocation and release
+ * are O(1) and run under the transport lock.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include "protocol_buffer.h"
+#include "protocol_physical__layer.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE MACROS */
+/******************************************************************************/
+
+#define IS_POOL_BUFFER(BUFFER)  ((BUFFER) >= &Buffers[0] &&                   \
+                                 (BUFFER) < &Buffers[PROTOCOL_BUFFER_POOL_SIZE])
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+static Protocol_Buffer_t Buffers[PROTOCOL_BUFFER_POOL_SIZE];
+static uint8_t FreeList[PROTOCOL_BUFFER_POOL_SIZE];
+static uint8_t FreeCount = 0;
+static uint8_t PeakInUse = 0;
+static uint32_t Exhausted = 0;
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+void Protocol_BufferInit(void)
+{
+    HardWare_Lock();
+    for(uint8_t Buffer = 0 ; Buffer < PROTOCOL_BUFFER_POOL_SIZE ; Buffer++)
+    {
+        Buffers[Buffer].RefCount = 0;
+        FreeList[Buffer] = Buffer;
+    }
+    FreeCount = PROTOCOL_BUFFER_POOL_SIZE;
+    PeakInUse = 0;
+    Exhausted = 0;
+    HardWare_Unlock();
+}
+
+PROTOCOL_ErrorStatus_t Protocol_BufferAlloc(Protocol_Buffer_t ** ppBuffer)
+{
+    PROTOCOL_ErrorStatus_t RET_ErrorStatus = PROTOCOL_OK;
+    if(ppBuffer == NULL)
+    {
+        RET_ErrorStatus = PROTOCOL_ERROR;
+    }
+    else
+    {
+        HardWare_Lock();
+        if(FreeCount == 0)
+        {
+            Exhausted++;
+            *ppBuffer = NULL;
+            RET_ErrorStatus = PROTOCOL_NO_BUFFER;
+        }
+        else
+        {
+            FreeCount--;
+            *ppBuffer = &Buffers[FreeList[FreeCount]];
+            (*ppBuffer)->RefCount = 1;
+            if(PROTOCOL_BUFFER_POOL_SIZE - FreeCount > PeakInUse)
+            {
+                PeakInUse = PROTOCOL_BUFFER_POOL_SIZE - FreeCount;
+            }
+            else
+            {
+                /* No thing */
+            }
+        }
+        HardWare_Unlock();
+    }
+    return RET_ErrorStatus;
+}
+
+PROTOCOL_ErrorStatus_t Protocol_BufferRetain(Protocol_Buffer_t * pBuffer)
+{
+    PROTOCOL_ErrorStatus_t RET_ErrorStatus = PROTOCOL_OK;
+    HardWare_Lock();
+    if(!IS_POOL_BUFFER(pBuffer) || pBuffer->RefCount == 0 || pBuffer->RefCount == UINT8_MAX)
+    {
+        RET_ErrorStatus = PROTOCOL_ERROR;
+    }
+    else
+    {
+        pBuffer->RefCount++;
+    }
+    HardWare_Unlock();
+    return RET_ErrorStatus;
+}
+
+PROTOCOL_ErrorStatus_t Protocol_BufferRelease(Protocol_Buffer_t * pBuffer)
+{
+    PROTOCOL_ErrorStatus_t RET_ErrorStatus = PROTOCOL_OK;
+    HardWare_Lock();
+    if(!IS_POOL_BUFFER(pBuffer) || pBuffer->RefCount == 0)
+    {
+        RET_ErrorStatus = PROTOCOL_ERROR;
+    }
+    else
+    {
+        pBuffer->RefCount--;
+        if(pBuffer->RefCount == 0)
+        {
+            FreeList[FreeCount] = (uint8_t)(pBuffer - &Buffers[0]);
+            FreeCount++;
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    HardWare_Unlock();
+    return RET_ErrorStatus;
+}
+
+uint8_t Protocol_BufferFreeCount(void)
+{
+    return FreeCount;
+}
+
+PROTOCOL_ErrorStatus_t Protocol_GetBufferStats(Protocol_BufferStats_t * pStats)
+{
+    PROTOCOL_ErrorStatus_t RET_ErrorStatus = PROTOCOL_OK;
+    if(pStats != NULL)
+    {
+        HardWare_Lock();
+        pStats->Size      = PROTOCOL_BUFFER_POOL_SIZE;
+        pStats->InUse     = PROTOCOL_BUFFER_POOL_SIZE - FreeCount;
+        pStats->PeakInUse = PeakInUse;
+        pStats->Exhausted = Exhausted;
+        HardWare_Unlock();
+    }
+    else
+    {
+        RET_ErrorStatus = PROTOCOL_ERROR;
+    }
+    return RET_ErrorStatus;
+}
+
+/******************************************************************************/
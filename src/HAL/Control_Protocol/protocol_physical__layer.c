@@ -1,16 +1,17 @@
 /******************************************************************************/
 /**
- * @file FILE.c
- * @brief 
+ * @file protocol_physical__layer.c
+ * @brief Transport of the control protocol on target.
  *
  * @par Project Name
- * 
+ * Control Protocol
  *
  * @par Code Language
  * C
  *
  * @par Description
- * 
+ * Carries the protocol frames on USART1 (PA9/PA10), DMA2 stream 7 transmits
+ * and DMA2 stream 5 receives.
  * 
  * @par Author
  * Mahmoud Abou-Hawis
@@ -64,6 +65,7 @@ static void *  uart = USART1 + 0x4;
 static DMA_Handle_t handle;
 static DMA_Handle_t handle2;
 static UART_Handle_t uart_handle;
+static volatile uint8_t LockDepth = 0;
 /******************************************************************************/
 
 /******************************************************************************/
@@ -97,7 +99,7 @@ static UART_Handle_t uart_handle;
 /******************************************************************************/
 /* PUBLIC FUNCTION DEFINITIONS */
 /******************************************************************************/
-void HardWare_Init(void (*CallBack)(void))
+void HardWare_Init(void (*CallBack)(void), void (*TransmitCallBack)(void))
 {
 	
 	RCC_enuEnablePeripheral(PERIPHERAL_DMA2);   
@@ -123,7 +125,7 @@ void HardWare_Init(void (*CallBack)(void))
 	handle.Initialization.PerAlignment	= DMA_PDATAALIGN_BYTE;
 	handle.Initialization.PeriphInc		= DMA_PERIPHERAL_INCREMENT_DISABLED;
 	handle.Initialization.PeriphBurst	= DMA_PBURST_SINGLE;
-	handle.CompleteTransferCallBack = NULL;
+	handle.CompleteTransferCallBack = TransmitCallBack;
 	handle.HalfTransferCallBack = NULL;
 	handle.ErrorTransferCallBack = NULL;
 
@@ -188,4 +190,24 @@ void HardWare_Receive(char * data, uint8_t len)
 {
     DMA_StartInterrupt(&handle2,uart,data,len);
 }
+
+void HardWare_Lock(void)
+{
+    NVIC_DisableIRQ(DMA2_Stream5_IRQn);
+    NVIC_DisableIRQ(DMA2_Stream7_IRQn);
+    LockDepth++;
+}
+
+void HardWare_Unlock(void)
+{
+    if(LockDepth > 0)
+    {
+        LockDepth--;
+    }
+    if(LockDepth == 0)
+    {
+        NVIC_EnableIRQ(DMA2_Stream5_IRQn);
+        NVIC_EnableIRQ(DMA2_Stream7_IRQn);
+    }
+}
 /******************************************************************************/
\ No newline at end of file
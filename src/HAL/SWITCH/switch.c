@@ -99,6 +99,8 @@ typedef struct
 
 static SwitchStatusBlock SwitchesStatus[_SWITCHES_NUM];
 
+static SWITCH_ChangeCallBack_t ChangeCallBack = NULL;
+
 /******************************************************************************/
 
 /******************************************************************************/
@@ -190,6 +192,12 @@ SWITCH_errorStatus SWITCH_enuGetStatus(uint8_t switchName,
     return RET_enuErrorStatus;
 }
 
+SWITCH_errorStatus SWITCH_enuSetChangeCallBack(SWITCH_ChangeCallBack_t CallBack)
+{
+    ChangeCallBack = CallBack;
+    return SWITCH_SUCCESS;
+}
+
 /**
  * @brief  This function(Runnable) is intended to be executed periodically
  *          by a scheduler, typically every 5 milliseconds.
@@ -218,6 +226,10 @@ void CheckSwitchesStates(void)
         }
         if(SwitchesStatus[switchIdx].Counts == STABLE_READ )
         {
+            if((switchStatus != SwitchesStatus[switchIdx].CurrentState) && (ChangeCallBack != NULL))
+            {
+                ChangeCallBack((uint8_t)switchIdx, switchStatus);
+            }
             SwitchesStatus[switchIdx].CurrentState = switchStatus;
             SwitchesStatus[switchIdx].Counts = 0;
         }
@@ -0,0 +1,372 @@
+/******************************************************************************/
+/**
+ * @file console.c
+ * @brief Buffered console output on USART2.
+ *
+ * @par Project Name
+ * stm32fxx services
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * The ring holds, in order, the chunk being sent by the DMA [Tail, Pending)
+ * and the bytes waiting for the next chunk [Pending, Head). The writer owns
+ * Head, the DMA interrupt owns Tail, both move Pending, so the writer works
+ * with the DMA1 stream 6 interrupt disabled.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "console.h"
+#include "stm32f4xx_dma.h"
+#include "stm32f4xx_gpio.h"
+#include "stm32f4xx_nvic.h"
+#include "stm32f4xx_rcc.h"
+#include "stm32f4xx_uart.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+
+#define CONSOLE_UART_DR     ((void *)(((uint32_t)USART2 & 0xFFFFFFF0U) + 0x4U))
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE MACROS */
+/******************************************************************************/
+
+#define IS_VALID_OVERFLOW_POLICY(POLICY) (((POLICY) == CONSOLE_POLICY_DROP_NEWEST) || \
+                                          ((POLICY) == CONSOLE_POLICY_DROP_OLDEST) || \
+                                          ((POLICY) == CONSOLE_POLICY_BLOCK))
+
+#if !IS_VALID_OVERFLOW_POLICY(CONSOLE_OVERFLOW_POLICY)
+#error "CONSOLE_OVERFLOW_POLICY must be one of CONSOLE_POLICY"
+#endif
+
+#define RING_NEXT(INDEX, COUNT)  (((INDEX) + (COUNT)) % CONSOLE_BUFFER_SIZE)
+
+#define RING_COUNT(FROM, TO)     (((TO) + CONSOLE_BUFFER_SIZE - (FROM)) % CONSOLE_BUFFER_SIZE)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+static char Ring[CONSOLE_BUFFER_SIZE];
+static volatile uint16_t Head = 0;
+static volatile uint16_t Pending = 0;
+static volatile uint16_t Tail = 0;
+static uint16_t PeakPending = 0;
+static uint32_t Dropped = 0;
+static bool isInitialized = false;
+static DMA_Handle_t ConsoleDMA;
+static UART_Handle_t ConsoleUART;
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION PROTOTYPES */
+/******************************************************************************/
+static void Lock(void);
+static void Unlock(void);
+static void StartChunk(void);
+static void ChunkSent(void);
+static void DropOldest(uint16_t Count);
+static uint16_t CopyIn(const char * pData, uint16_t Size);
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+static void Lock(void)
+{
+    NVIC_DisableIRQ(DMA1_Stream6_IRQn);
+}
+
+static void Unlock(void)
+{
+    NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+}
+
+/**
+ * @brief Hands the waiting bytes up to the end of the ring to the DMA.
+ * @note Called locked or from the DMA interrupt, does nothing while a chunk is sent.
+ *       When the stream does not start the bytes stay waiting and the next
+ *       write tries again.
+ */
+static void StartChunk(void)
+{
+    uint16_t Length;
+    if(Tail == Pending && Pending != Head)
+    {
+        Length = (Head > Pending) ? (uint16_t)(Head - Pending) : (uint16_t)(CONSOLE_BUFFER_SIZE - Pending);
+        Pending = RING_NEXT(Pending, Length);
+        if(DMA_StartInterrupt(&ConsoleDMA, &Ring[Tail], CONSOLE_UART_DR, Length) != DMA_OK)
+        {
+            /* No chunk in flight, ChunkSent will not come to move Tail */
+            Pending = Tail;
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    else
+    {
+        /* No thing */
+    }
+}
+
+/**
+ * @brief Transfer complete of DMA1 stream 6, chains the next chunk.
+ */
+static void ChunkSent(void)
+{
+    Tail = Pending;
+    StartChunk();
+}
+
+/**
+ * @brief Removes the oldest waiting bytes, the chunk being sent is kept.
+ * @note Called locked, Count must not exceed the waiting bytes.
+ */
+static void DropOldest(uint16_t Count)
+{
+    uint16_t From = RING_NEXT(Pending, Count);
+    uint16_t To = Pending;
+    while(From != Head)
+    {
+        Ring[To] = Ring[From];
+        To = RING_NEXT(To, 1U);
+        From = RING_NEXT(From, 1U);
+    }
+    Head = To;
+    Dropped += Count;
+}
+
+/**
+ * @brief Copies what fits of pData into the ring, applying the overflow policy.
+ * @note Called locked.
+ * @return Number of bytes consumed from pData, copied or dropped.
+ */
+static uint16_t CopyIn(const char * pData, uint16_t Size)
+{
+    uint16_t Free = (CONSOLE_BUFFER_SIZE - 1U) - RING_COUNT(Tail, Head);
+    uint16_t Waiting = RING_COUNT(Pending, Head);
+    uint16_t Consumed = Size;
+    uint16_t Byte;
+
+    if(Size > Free && CONSOLE_OVERFLOW_POLICY == CONSOLE_POLICY_DROP_OLDEST)
+    {
+        if(Size - Free > Waiting)
+        {
+            DropOldest(Waiting);
+            Free += Waiting;
+            /* Only the end of the write fits */
+            Dropped += Size - Free;
+            pData += Size - Free;
+            Size = Free;
+        }
+        else
+        {
+            DropOldest(Size - Free);
+        }
+    }
+    else if(Size > Free && CONSOLE_OVERFLOW_POLICY == CONSOLE_POLICY_DROP_NEWEST)
+    {
+        Dropped += Size - Free;
+        Size = Free;
+    }
+    else if(Size > Free)
+    {
+        /* CONSOLE_POLICY_BLOCK, the rest is copied once the DMA made room */
+        Size = Free;
+        Consumed = Free;
+    }
+    else
+    {
+        /* No thing */
+    }
+
+    for(Byte = 0 ; Byte < Size ; Byte++)
+    {
+        Ring[Head] = pData[Byte];
+        Head = RING_NEXT(Head, 1U);
+    }
+    if(RING_COUNT(Tail, Head) > PeakPending)
+    {
+        PeakPending = RING_COUNT(Tail, Head);
+    }
+    else
+    {
+        /* No thing */
+    }
+    StartChunk();
+    return Consumed;
+}
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+CONSOLE_ErrorStatus_t Console_Init(void)
+{
+    CONSOLE_ErrorStatus_t RET_ErrorStatus = CONSOLE_OK;
+    gpioPin_t TX;
+
+    RCC_enuEnablePeripheral(PERIPHERAL_DMA1);
+    RCC_enuEnablePeripheral(PERIPHERAL_GPIOA);
+    RCC_enuEnablePeripheral(PERIPHERAL_USART2);
+
+    Head = 0;
+    Pending = 0;
+    Tail = 0;
+    PeakPending = 0;
+    Dropped = 0;
+
+    ConsoleDMA.Instance                     = DMA1;
+    ConsoleDMA.Stream                       = DMA_STREAM_6;
+    ConsoleDMA.Initialization.Channel       = DMA_CHANNEL_4;
+    ConsoleDMA.Initialization.Direction     = DMA_MEMORY_TO_PERIPH;
+    ConsoleDMA.Initialization.FIFOMode      = DMA_FIFOMODE_DISABLE;
+    ConsoleDMA.Initialization.MemAlignment  = DMA_MDATAALIGN_BYTE;
+    ConsoleDMA.Initialization.MemBurst      = DMA_MBURST_SINGLE;
+    ConsoleDMA.Initialization.MemInc        = DMA_MEMORY_INCREMENT_ENABLED;
+    ConsoleDMA.Initialization.Mode          = DMA_NORMAL;
+    ConsoleDMA.Initialization.Priority      = DMA_PRIORITY_LOW;
+    ConsoleDMA.Initialization.PerAlignment  = DMA_PDATAALIGN_BYTE;
+    ConsoleDMA.Initialization.PeriphInc     = DMA_PERIPHERAL_INCREMENT_DISABLED;
+    ConsoleDMA.Initialization.PeriphBurst   = DMA_PBURST_SINGLE;
+    ConsoleDMA.CompleteTransferCallBack     = ChunkSent;
+    ConsoleDMA.HalfTransferCallBack         = NULL;
+    ConsoleDMA.ErrorTransferCallBack        = NULL;
+
+    TX.GPIO_AT_Type = GPIO_AT_PushPull;
+    TX.GPIO_Mode    = GPIO_MODE_AF7;
+    TX.GPIO_Pin     = GPIO_PIN2;
+    TX.GPIO_Port    = GPIO_PORTA;
+    TX.GPIO_Speed   = GPIO_SPEED_MEDIUM;
+
+    ConsoleUART.pUartInstance                       = USART2;
+    ConsoleUART.UartConfiguration.BaudRate          = CONSOLE_BAUD_RATE;
+    ConsoleUART.UartConfiguration.Mode              = UART_MODE_TX;
+    ConsoleUART.UartConfiguration.Parity            = UART_PARITY_NONE;
+    ConsoleUART.UartConfiguration.StopBits          = UART_STOP_BITS_ONE;
+    ConsoleUART.UartConfiguration.WordLength        = UART_WORDLENGTH_8B;
+    ConsoleUART.UartConfiguration.OverSampling      = UART_OVERSAMPLING_AUTO;
+
+    GPIO_Init(&TX);
+    if(DMA_Init(&ConsoleDMA, -1) != DMA_OK ||
+       UART_Init(&ConsoleUART) != UART_ERROR_NONE)
+    {
+        RET_ErrorStatus = CONSOLE_ERROR;
+    }
+    else
+    {
+        UART_TransmitWithDMA(&ConsoleUART, NULL);
+        NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+        isInitialized = true;
+    }
+    return RET_ErrorStatus;
+}
+
+CONSOLE_ErrorStatus_t Console_Write(const char * pData, uint16_t Size)
+{
+    CONSOLE_ErrorStatus_t RET_ErrorStatus = CONSOLE_OK;
+    uint32_t DroppedBefore;
+    uint16_t Consumed;
+    if(pData == NULL || !isInitialized)
+    {
+        RET_ErrorStatus = CONSOLE_ERROR;
+    }
+    else
+    {
+        DroppedBefore = Dropped;
+        while(Size > 0)
+        {
+            Lock();
+            Consumed = CopyIn(pData, Size);
+            Unlock();
+            pData += Consumed;
+            Size -= Consumed;
+        }
+        if(Dropped != DroppedBefore)
+        {
+            RET_ErrorStatus = CONSOLE_OVERFLOW;
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    return RET_ErrorStatus;
+}
+
+CONSOLE_ErrorStatus_t Console_Printf(const char * pFormat, ...)
+{
+    CONSOLE_ErrorStatus_t RET_ErrorStatus = CONSOLE_OK;
+    char Line[CONSOLE_LINE_SIZE];
+    va_list Arguments;
+    int Length;
+    if(pFormat == NULL)
+    {
+        RET_ErrorStatus = CONSOLE_ERROR;
+    }
+    else
+    {
+        va_start(Arguments, pFormat);
+        Length = vsnprintf(Line, sizeof(Line), pFormat, Arguments);
+        va_end(Arguments);
+        if(Length < 0)
+        {
+            RET_ErrorStatus = CONSOLE_ERROR;
+        }
+        else
+        {
+            if(Length >= (int)sizeof(Line))
+            {
+                Length = sizeof(Line) - 1U;
+            }
+            else
+            {
+                /* No thing */
+            }
+            RET_ErrorStatus = Console_Write(Line, (uint16_t)Length);
+        }
+    }
+    return RET_ErrorStatus;
+}
+
+CONSOLE_ErrorStatus_t Console_GetStats(Console_Stats_t * pStats)
+{
+    CONSOLE_ErrorStatus_t RET_ErrorStatus = CONSOLE_OK;
+    if(pStats != NULL)
+    {
+        Lock();
+        pStats->Pending     = RING_COUNT(Tail, Head);
+        pStats->PeakPending = PeakPending;
+        pStats->Dropped     = Dropped;
+        Unlock();
+    }
+    else
+    {
+        RET_ErrorStatus = CONSOLE_ERROR;
+    }
+    return RET_ErrorStatus;
+}
+
+/******************************************************************************/
@@ -0,0 +1,407 @@
+/******************************************************************************/
+/**
+ * @file dma_copy.c
+ * @brief Memory copies and fills run by DMA2.
+ *
+ * @par Project Name
+ * stm32fxx services
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * The head of the queue is the job on the stream. When a job reaches the
+ * head, the CPU writes the bytes before the first 16 byte aligned address
+ * of the destination and the bytes after the last whole 16 bytes, so the
+ * stream only writes bursts of four words which never cross a 1 KB
+ * boundary. The source side reads bursts of four words when it is aligned
+ * like the destination, single words when it is word aligned and single
+ * bytes otherwise, the FIFO packs them. A part longer than one NDTR runs in
+ * chunks, the transfer complete interrupt starts the next chunk or pops the
+ * job, calls its callback and starts the next one, so the submitter works
+ * with the interrupt of the stream disabled.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include "dma_copy.h"
+#include "stm32f4xx_dma.h"
+#include "stm32f4xx_nvic.h"
+#include "stm32f4xx_rcc.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+
+#if DMA_COPY_CPU_THRESHOLD < 32U
+#error "DMA_COPY_CPU_THRESHOLD must leave a whole burst after the head"
+#endif
+
+#define DMA_COPY_BURST          (16U)       /**< Bytes of one memory burst, INC4 of words */
+#define DMA_COPY_TIMEOUT        (1000U)     /**< Polls of EN in DMA_Init, the stream is off between jobs */
+
+/* Largest chunks, whole bursts below the 16 bit NDTR */
+#define DMA_COPY_MAX_WORDS      (65532U)
+#define DMA_COPY_MAX_BYTES      (65520U)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE MACROS */
+/******************************************************************************/
+
+#define IS_ALIGNED(ADDRESS, SIZE)   ((((uint32_t)(ADDRESS)) & ((SIZE) - 1U)) == 0U)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE TYPES */
+/******************************************************************************/
+
+typedef struct
+{
+    DMA_Handle_t Handle;
+    DmaCopy_Job_t * pHead;          /**< Job on the stream or next to start */
+    DmaCopy_Job_t * pTail;
+    volatile bool isRunning;        /**< pHead is on the stream */
+    uint32_t Chunk;                 /**< Bytes of the chunk on the stream */
+    DmaCopy_Stats_t Stats;
+} DmaCopy_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION PROTOTYPES */
+/******************************************************************************/
+static void Lock(void);
+static void Unlock(void);
+static void CpuCopy(DmaCopy_Job_t * pJob, uint32_t Start, uint32_t End);
+static DMA_ErrorStatus_t Configure(DmaCopy_Job_t * pJob);
+static DMA_ErrorStatus_t StartChunk(DmaCopy_Job_t * pJob);
+static void Submit(DmaCopy_Job_t * pJob);
+static void Finish(DMA_COPY_JobStatus_t Status);
+static void StartNext(void);
+static void ChunkDone(void);
+static void ChunkFailed(void);
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+static DmaCopy_t Copier;
+static bool isInitialized = false;
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+static void Lock(void)
+{
+    NVIC_DisableIRQ(DMA_COPY_STREAM_IRQ);
+}
+
+static void Unlock(void)
+{
+    NVIC_EnableIRQ(DMA_COPY_STREAM_IRQ);
+}
+
+/**
+ * @brief Writes the bytes Start to End of a job by the CPU.
+ */
+static void CpuCopy(DmaCopy_Job_t * pJob, uint32_t Start, uint32_t End)
+{
+    for(uint32_t Index = Start; Index < End; Index++)
+    {
+        pJob->pDest[Index] = (pJob->pSrc != NULL) ? pJob->pSrc[Index] : (uint8_t)pJob->Pattern;
+    }
+}
+
+/**
+ * @brief Sets the stream for the part of a job between Offset and End, the
+ *        widest source access its alignment allows.
+ */
+static DMA_ErrorStatus_t Configure(DmaCopy_Job_t * pJob)
+{
+    DMA_Init_t * pInit = &Copier.Handle.Initialization;
+    uint32_t Source = (uint32_t)pJob->pSrc + pJob->Offset;
+
+    pInit->MemInc        = DMA_MEMORY_INCREMENT_ENABLED;
+    pInit->MemAlignment  = DMA_MDATAALIGN_WORD;
+    pInit->MemBurst      = DMA_MBURST_INC4;
+    if(pJob->pSrc == NULL)
+    {
+        /* The pattern word is read again for every word written */
+        pInit->PeriphInc    = DMA_PERIPHERAL_INCREMENT_DISABLED;
+        pInit->PerAlignment = DMA_PDATAALIGN_WORD;
+        pInit->PeriphBurst  = DMA_PBURST_SINGLE;
+    }
+    else if(IS_ALIGNED(Source, DMA_COPY_BURST))
+    {
+        pInit->PeriphInc    = DMA_PERIPHERAL_INCREMENT_ENABLED;
+        pInit->PerAlignment = DMA_PDATAALIGN_WORD;
+        pInit->PeriphBurst  = DMA_PBURST_INC4;
+    }
+    else if(IS_ALIGNED(Source, sizeof(uint32_t)))
+    {
+        pInit->PeriphInc    = DMA_PERIPHERAL_INCREMENT_ENABLED;
+        pInit->PerAlignment = DMA_PDATAALIGN_WORD;
+        pInit->PeriphBurst  = DMA_PBURST_SINGLE;
+    }
+    else
+    {
+        pInit->PeriphInc    = DMA_PERIPHERAL_INCREMENT_ENABLED;
+        pInit->PerAlignment = DMA_PDATAALIGN_BYTE;
+        pInit->PeriphBurst  = DMA_PBURST_SINGLE;
+    }
+    return DMA_Init(&Copier.Handle, DMA_COPY_TIMEOUT);
+}
+
+/**
+ * @brief Puts the next chunk of a configured job on the stream.
+ */
+static DMA_ErrorStatus_t StartChunk(DmaCopy_Job_t * pJob)
+{
+    uint32_t Items = pJob->End - pJob->Offset;
+    void * pSource = (pJob->pSrc != NULL) ? (void *)&pJob->pSrc[pJob->Offset] : (void *)&pJob->Pattern;
+
+    /* NDTR counts items of the source side */
+    if(Copier.Handle.Initialization.PerAlignment == DMA_PDATAALIGN_WORD)
+    {
+        Items /= sizeof(uint32_t);
+        Items = (Items > DMA_COPY_MAX_WORDS) ? DMA_COPY_MAX_WORDS : Items;
+        Copier.Chunk = Items * sizeof(uint32_t);
+    }
+    else
+    {
+        Items = (Items > DMA_COPY_MAX_BYTES) ? DMA_COPY_MAX_BYTES : Items;
+        Copier.Chunk = Items;
+    }
+    return DMA_StartInterrupt(&Copier.Handle, pSource, &pJob->pDest[pJob->Offset], Items);
+}
+
+/**
+ * @brief Queues a job filled by DmaCopy_Memcpy or DmaCopy_Memset.
+ */
+static void Submit(DmaCopy_Job_t * pJob)
+{
+    Lock();
+    pJob->pNext  = NULL;
+    pJob->Status = DMA_COPY_PENDING;
+    if(Copier.pTail != NULL)
+    {
+        Copier.pTail->pNext = pJob;
+    }
+    else
+    {
+        Copier.pHead = pJob;
+    }
+    Copier.pTail = pJob;
+    StartNext();
+    Unlock();
+}
+
+/**
+ * @brief Pops the head of the queue and calls its callback.
+ * @note Called locked or from the DMA interrupt.
+ */
+static void Finish(DMA_COPY_JobStatus_t Status)
+{
+    DmaCopy_Job_t * pJob = Copier.pHead;
+    Copier.pHead = pJob->pNext;
+    if(Copier.pHead == NULL)
+    {
+        Copier.pTail = NULL;
+    }
+    pJob->pNext = NULL;
+    if(Status == DMA_COPY_FAILED)
+    {
+        Copier.Stats.Errors += 1;
+    }
+    else if(Copier.isRunning)
+    {
+        Copier.Stats.DmaJobs += 1;
+    }
+    else
+    {
+        Copier.Stats.CpuJobs += 1;
+    }
+    Copier.isRunning = false;
+    pJob->Status = Status;
+    if(pJob->CallBack != NULL)
+    {
+        pJob->CallBack(pJob);
+    }
+}
+
+/**
+ * @brief Starts the head of the queue: the CPU writes its short parts and
+ *        the stream takes the rest.
+ * @note Called locked or from the DMA interrupt, does nothing while a job
+ *       runs. Jobs done by the CPU alone are finished in the loop.
+ */
+static void StartNext(void)
+{
+    while(!Copier.isRunning && Copier.pHead != NULL)
+    {
+        DmaCopy_Job_t * pJob = Copier.pHead;
+        if(pJob->Size < DMA_COPY_CPU_THRESHOLD)
+        {
+            CpuCopy(pJob, 0, pJob->Size);
+            Finish(DMA_COPY_DONE);
+        }
+        else
+        {
+            pJob->Offset = (DMA_COPY_BURST - ((uint32_t)pJob->pDest & (DMA_COPY_BURST - 1U))) &
+                           (DMA_COPY_BURST - 1U);
+            pJob->End    = pJob->Offset + ((pJob->Size - pJob->Offset) & ~(DMA_COPY_BURST - 1U));
+            CpuCopy(pJob, 0, pJob->Offset);
+            CpuCopy(pJob, pJob->End, pJob->Size);
+            Copier.isRunning = true;
+            if(Configure(pJob) != DMA_OK || StartChunk(pJob) != DMA_OK)
+            {
+                Finish(DMA_COPY_FAILED);
+            }
+        }
+    }
+}
+
+static void ChunkDone(void)
+{
+    DmaCopy_Job_t * pJob = Copier.pHead;
+    pJob->Offset += Copier.Chunk;
+    Copier.Stats.DmaBytes += Copier.Chunk;
+    if(pJob->Offset < pJob->End)
+    {
+        if(StartChunk(pJob) != DMA_OK)
+        {
+            Finish(DMA_COPY_FAILED);
+            StartNext();
+        }
+    }
+    else
+    {
+        Finish(DMA_COPY_DONE);
+        StartNext();
+    }
+}
+
+static void ChunkFailed(void)
+{
+    Finish(DMA_COPY_FAILED);
+    StartNext();
+}
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+DMA_COPY_ErrorStatus_t DmaCopy_Init(void)
+{
+    DMA_COPY_ErrorStatus_t RET_ErrorStatus = DMA_COPY_OK;
+
+    RCC_enuEnablePeripheral(PERIPHERAL_DMA2);
+    Copier.Handle.Instance                     = DMA2;
+    Copier.Handle.Stream                       = DMA_COPY_STREAM;
+    Copier.Handle.Initialization.Channel       = DMA_CHANNEL_0;
+    Copier.Handle.Initialization.Direction     = DMA_MEMORY_TO_MEMORY;
+    Copier.Handle.Initialization.Mode          = DMA_NORMAL;
+    Copier.Handle.Initialization.Priority      = DMA_COPY_PRIORITY;
+    Copier.Handle.Initialization.FIFOMode      = DMA_FIFOMODE_ENABLE;
+    Copier.Handle.Initialization.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
+    Copier.Handle.Initialization.MemInc        = DMA_MEMORY_INCREMENT_ENABLED;
+    Copier.Handle.Initialization.MemAlignment  = DMA_MDATAALIGN_WORD;
+    Copier.Handle.Initialization.MemBurst      = DMA_MBURST_INC4;
+    Copier.Handle.Initialization.PeriphInc     = DMA_PERIPHERAL_INCREMENT_ENABLED;
+    Copier.Handle.Initialization.PerAlignment  = DMA_PDATAALIGN_WORD;
+    Copier.Handle.Initialization.PeriphBurst   = DMA_PBURST_INC4;
+    Copier.Handle.HalfTransferCallBack         = NULL;
+    Copier.Handle.CompleteTransferCallBack     = ChunkDone;
+    Copier.Handle.ErrorTransferCallBack        = ChunkFailed;
+    Copier.pHead     = NULL;
+    Copier.pTail     = NULL;
+    Copier.isRunning = false;
+    Copier.Stats     = (DmaCopy_Stats_t){0};
+    if(DMA_Init(&Copier.Handle, DMA_COPY_TIMEOUT) != DMA_OK)
+    {
+        RET_ErrorStatus = DMA_COPY_ERROR;
+    }
+    else
+    {
+        Unlock();
+    }
+    isInitialized = (RET_ErrorStatus == DMA_COPY_OK);
+    return RET_ErrorStatus;
+}
+
+DMA_COPY_ErrorStatus_t DmaCopy_Memcpy(DmaCopy_Job_t * pJob, void * pDest, const void * pSrc,
+                                      uint32_t Size, DmaCopy_CallBack_t CallBack)
+{
+    DMA_COPY_ErrorStatus_t RET_ErrorStatus = DMA_COPY_OK;
+    if(!isInitialized || pJob == NULL || pDest == NULL || pSrc == NULL || Size == 0)
+    {
+        RET_ErrorStatus = DMA_COPY_ERROR;
+    }
+    else
+    {
+        pJob->pDest    = (uint8_t *)pDest;
+        pJob->pSrc     = (const uint8_t *)pSrc;
+        pJob->Size     = Size;
+        pJob->Pattern  = 0;
+        pJob->CallBack = CallBack;
+        Submit(pJob);
+    }
+    return RET_ErrorStatus;
+}
+
+DMA_COPY_ErrorStatus_t DmaCopy_Memset(DmaCopy_Job_t * pJob, void * pDest, uint8_t Value,
+                                      uint32_t Size, DmaCopy_CallBack_t CallBack)
+{
+    DMA_COPY_ErrorStatus_t RET_ErrorStatus = DMA_COPY_OK;
+    if(!isInitialized || pJob == NULL || pDest == NULL || Size == 0)
+    {
+        RET_ErrorStatus = DMA_COPY_ERROR;
+    }
+    else
+    {
+        pJob->pDest    = (uint8_t *)pDest;
+        pJob->pSrc     = NULL;
+        pJob->Size     = Size;
+        pJob->Pattern  = 0x01010101U * Value;
+        pJob->CallBack = CallBack;
+        Submit(pJob);
+    }
+    return RET_ErrorStatus;
+}
+
+bool DmaCopy_IsBusy(void)
+{
+    return (Copier.pHead != NULL);
+}
+
+DMA_COPY_ErrorStatus_t DmaCopy_GetStats(DmaCopy_Stats_t * pStats)
+{
+    DMA_COPY_ErrorStatus_t RET_ErrorStatus = DMA_COPY_OK;
+    if(!isInitialized || pStats == NULL)
+    {
+        RET_ErrorStatus = DMA_COPY_ERROR;
+    }
+    else
+    {
+        Lock();
+        *pStats = Copier.Stats;
+        Unlock();
+    }
+    return RET_ErrorStatus;
+}
+
+/******************************************************************************/
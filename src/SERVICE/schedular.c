@@ -29,12 +29,47 @@
 #include "schedular.h"
 #include "schedular_CFG.h"
 #include "stm32f4xx_systick.h"
+#include "stm32f4xx_nvic.h"
+#include "stm32f4xx_dwt.h"
 /******************************************************************************/
 
 /******************************************************************************/
 /* PRIVATE DEFINES */
 /******************************************************************************/
 
+/** Slots of one level of the timer wheel. */
+#define WHEEL_SLOTS             (1UL << SCHEDULAR_WHEEL_BITS)
+
+/** Mask of the slot index inside one level. */
+#define WHEEL_MASK              (WHEEL_SLOTS - 1UL)
+
+/** Level 0 holds the runnables due within WHEEL_SLOTS ticks. */
+#define WHEEL_NEAR              (0U)
+
+/** Level 1 holds the runnables due later, one slot per WHEEL_SLOTS ticks. */
+#define WHEEL_FAR               (1U)
+
+#define WHEEL_LEVELS            (2U)
+
+/** End of a list of runnables. */
+#define NO_RUNNABLE             (0xFFFFU)
+
+/** Words of the ready bitmap, one bit per runnable. */
+#define READY_WORDS             ((MAX_RUNNABLES + 31U) / 32U)
+
+#if (SCHEDULAR_WHEEL_BITS < 1) || (SCHEDULAR_WHEEL_BITS > 8)
+#error "SCHEDULAR_WHEEL_BITS must be between 1 and 8"
+#endif
+
+/** The far level is scanned once, a longer sleep ends on its next turn. */
+#define IDLE_MAX_TICKS          (WHEEL_SLOTS * WHEEL_SLOTS)
+
+/** Core clock cycles of one tick, the DWT counter runs at SYS_CLK. */
+#define CYCLES_PER_TICK         ((SYS_CLK / 1000UL) * TICK_TIME)
+
+#if MAX_RUNNABLES >= NO_RUNNABLE
+#error "MAX_RUNNABLES must be below 65535"
+#endif
 
 /******************************************************************************/
 
@@ -44,19 +79,68 @@
 /* PRIVATE MACROS */
 /******************************************************************************/
 
-#define IS_RUNNABLE_WILL_EXECUTE_NOW(RunnableIdx)  \
-                            (RemainingTimeForAllRunnables[RunnableIdx]  == 0)
+/** Ticks between two releases of a runnable, at least one. */
+#define RUNNABLE_PERIOD_TICKS(RunnableIdx)                                     \
+    ((Runnables[RunnableIdx].periodicityMS < TICK_TIME) ? 1UL :                \
+     (Runnables[RunnableIdx].periodicityMS / TICK_TIME))
+
+/** Tick of the first release from now, the tick after the delay has elapsed. */
+#define RUNNABLE_FIRST_TICK(RunnableIdx)                                       \
+    (WheelTime + (Runnables[RunnableIdx].DelayMS / TICK_TIME) + 1UL)
+
+/** A handle given by the configuration table or schedular_AddRunnable. */
+#define IS_RUNNABLE_HANDLE(Handle)                                             \
+    (((Handle) < MAX_RUNNABLES) && (RunnableStates[Handle] != RUNNABLE_FREE))
+
+/** Ticks counted by the interrupt and not yet served by the wheel. */
+#define IS_TICK_PENDING()       (TickCount != WheelTime)
+
+#define IS_RUNNABLE_READY(Rank)                                                \
+    ((ReadyRunnables[(Rank) >> 5] & (1UL << ((Rank) & 31U))) != 0)
+
+#define SET_RUNNABLE_READY(Rank)                                               \
+    (ReadyRunnables[(Rank) >> 5] |= (1UL << ((Rank) & 31U)))
+
+#define CLEAR_RUNNABLE_READY(Rank)                                             \
+    (ReadyRunnables[(Rank) >> 5] &= ~(1UL << ((Rank) & 31U)))
 
 /******************************************************************************/
 /* PRIVATE ENUMS */
 /******************************************************************************/
 
+/**
+ * @brief State of a slot of the runnables pool.
+ */
+typedef enum
+{
+    /** Empty, its callback is never called. */
+    RUNNABLE_FREE = 0,
+    /** Released by the wheel at its period. */
+    RUNNABLE_ACTIVE,
+    /** Kept with its rank but out of the wheel until resumed. */
+    RUNNABLE_SUSPENDED
+} RunnableState_t;
+
 /******************************************************************************/
 
 /******************************************************************************/
 /* PRIVATE TYPES */
 /******************************************************************************/
 
+/**
+ * @brief Place of a runnable in the timer wheel.
+ */
+typedef struct
+{
+    /** Tick of the next release, it never drifts from the period. */
+    uint32_t Expiry;
+    /** Next runnable in the same slot, NO_RUNNABLE at the end. */
+    uint16_t Next;
+    /** Previous runnable in the same slot, NO_RUNNABLE at the head. */
+    uint16_t Prev;
+    /** Head of the slot holding it, NULL out of the wheel. */
+    uint16_t * pHead;
+} Schedular_timer_t;
 
 /******************************************************************************/
 
@@ -72,16 +156,106 @@
 /******************************************************************************/
 
 /**
- * @brief An array to store the remaining execution time for all runnable tasks.
- * 
- * This array likely keeps track of the time remaining for all runnables.
+ * @brief Pool of runnables, filled from AllRunnablesSystemList by
+ *        schedular_init then by schedular_AddRunnable.
+ */
+static Schedular_runnable_t Runnables[MAX_RUNNABLES];
+
+/**
+ * @brief State of every slot of the pool.
+ */
+static uint8_t RunnableStates[MAX_RUNNABLES];
+
+/**
+ * @brief Next release of every runnable and its link in the wheel.
+ */
+static Schedular_timer_t RunnableTimers[MAX_RUNNABLES];
+
+/**
+ * @brief Heads of the lists of runnables released in each slot.
+ *
+ * A tick only visits the near slot it points at, and once every WHEEL_SLOTS
+ * ticks moves one far slot into the near level, so its cost follows the
+ * runnables due instead of MAX_RUNNABLES.
+ */
+static uint16_t WheelSlots[WHEEL_LEVELS][WHEEL_SLOTS];
+
+/**
+ * @brief Ticks served by the wheel since schedular_init.
+ */
+static uint32_t WheelTime = 0;
+
+/**
+ * @brief Runnables released by a tick and still waiting for the CPU.
+ *
+ * One bit per rank in RunnablesByPriority, the lowest bit set is the ready
+ * runnable of the highest priority.
+ */
+static uint32_t ReadyRunnables[READY_WORDS];
+
+/**
+ * @brief Number of bits set in ReadyRunnables.
+ */
+static uint32_t ReadyCount = 0;
+
+/**
+ * @brief Indexes of the runnables sorted by priority, the highest first.
+ *
+ * Runnables of the same priority keep the order they were added in, the
+ * free slots are not in it.
+ */
+static uint16_t RunnablesByPriority[MAX_RUNNABLES];
+
+/**
+ * @brief Runnables in RunnablesByPriority, active or suspended.
+ */
+static uint32_t RunnablesCount = 0;
+
+/**
+ * @brief Rank of every runnable in RunnablesByPriority.
+ */
+static uint16_t RunnableRank[MAX_RUNNABLES];
+
+/**
+ * @brief Ticks counted by the SysTick interrupt since schedular_init.
+ *
+ * Only the interrupt writes it while they are unmasked, the ticks still to
+ * serve are TickCount - WheelTime, so none is lost to a read-modify-write.
+ */
+static volatile uint32_t TickCount = 0;
+
+/**
+ * @brief Time elapsed since the scheduler started, in milliseconds.
+ */
+static volatile uint32_t ElapsedTimeMS = 0;
+
+#if SCHEDULAR_ENABLE_STATS == 1
+/**
+ * @brief Statistics of every runnable, AvgCycles and JitterCycles are
+ *        computed when they are read.
+ */
+static Schedular_stats_t RunnableStats[MAX_RUNNABLES];
+
+/**
+ * @brief Cycles of all the runs of every runnable, for the average.
+ */
+static uint64_t RunnableTotalCycles[MAX_RUNNABLES];
+
+/**
+ * @brief Cycle counter at the ideal start of the last release of every runnable.
  */
-static uint32_t RemainingTimeForAllRunnables[MAX_RUNNABLES];
+static uint32_t RunnableReleaseCycles[MAX_RUNNABLES];
 
 /**
- * @brief Track if the tasks is pending.
+ * @brief Cycle counter at the last SysTick interrupt, stamped with TickCount.
  */
-static volatile uint8_t PendingRunnables = 0;
+static volatile uint32_t TickCycles = 0;
+
+/**
+ * @brief Largest number of ticks which waited together to be served.
+ */
+static uint32_t PeakPendingTicks = 0;
+#endif
 /******************************************************************************/
 
 /******************************************************************************/
@@ -121,30 +295,480 @@ extern const Schedular_runnable_t AllRunnablesSystemList[MAX_RUNNABLES];
 static void TickCB(void)
 {
     /** The scheduler must now execute the runnables.  */
-    PendingRunnables++;
+#if SCHEDULAR_ENABLE_STATS == 1
+    TickCycles = DWT_GetCycles();
+#endif
+    TickCount++;
+    ElapsedTimeMS += TICK_TIME;
 }
 
+#if SCHEDULAR_ENABLE_STATS == 1
 /**
- * @brief Schedules and executes a runnable based on its priority and periodicity.
+ * @brief Cycle counter at the ideal time of the tick the wheel serves now.
+ *
+ * The last interrupt was stamped, the tick served is as many periods before
+ * it as ticks still wait. Records the peak of waiting ticks.
  */
-static void Schedular(void)
+static uint32_t StatsTickCycles(void)
+{
+    uint32_t Count;
+    uint32_t Cycles;
+    uint32_t Pending;
+
+    /** Read both again if a tick came between them */
+    do
+    {
+        Count = TickCount;
+        Cycles = TickCycles;
+    } while(Count != TickCount);
+
+    Pending = Count - WheelTime;
+    if((Pending + 1UL) > PeakPendingTicks)
+    {
+        PeakPendingTicks = Pending + 1UL;
+    }
+    else
+    {
+        /* No thing */
+    }
+    return Cycles - (Pending * CYCLES_PER_TICK);
+}
+
+/**
+ * @brief Adds one run to the statistics of a runnable.
+ *
+ * @param Runnable Index of the runnable.
+ * @param Latency  Cycles from its release to its start.
+ * @param Cycles   Cycles of the run.
+ */
+static void StatsRecordRun(uint32_t Runnable, uint32_t Latency, uint32_t Cycles)
+{
+    Schedular_stats_t * pStats = &RunnableStats[Runnable];
+
+    if((pStats->Calls == 0) || (Cycles < pStats->MinCycles))
+    {
+        pStats->MinCycles = Cycles;
+    }
+    else
+    {
+        /* No thing */
+    }
+    if((pStats->Calls == 0) || (Latency < pStats->MinLatencyCycles))
+    {
+        pStats->MinLatencyCycles = Latency;
+    }
+    else
+    {
+        /* No thing */
+    }
+    if(Cycles > pStats->MaxCycles)
+    {
+        pStats->MaxCycles = Cycles;
+    }
+    else
+    {
+        /* No thing */
+    }
+    if(Latency > pStats->MaxLatencyCycles)
+    {
+        pStats->MaxLatencyCycles = Latency;
+    }
+    else
+    {
+        /* No thing */
+    }
+    /** It ended after its next release was due */
+    if((Latency + Cycles) > (RUNNABLE_PERIOD_TICKS(Runnable) * CYCLES_PER_TICK))
+    {
+        pStats->Missed++;
+    }
+    else
+    {
+        /* No thing */
+    }
+    pStats->Calls++;
+    RunnableTotalCycles[Runnable] += Cycles;
+}
+
+/**
+ * @brief Writes Bytes bytes of Value in little endian.
+ */
+static uint8_t * StatsPut(uint8_t * pBuffer, uint32_t Value, uint32_t Bytes)
+{
+    for(uint32_t Byte = 0 ; Byte < Bytes ; Byte++)
+    {
+        pBuffer[Byte] = (uint8_t)(Value >> (Byte * 8U));
+    }
+    return &pBuffer[Bytes];
+}
+#endif
+
+/**
+ * @brief Links a runnable in the slot of its next release.
+ *
+ * @param Runnable Index of the runnable, its Expiry after WheelTime.
+ */
+static void WheelInsert(uint32_t Runnable)
+{
+    uint32_t Expiry = RunnableTimers[Runnable].Expiry;
+    uint16_t * pSlot;
+
+    if((Expiry - WheelTime) < WHEEL_SLOTS)
+    {
+        pSlot = &WheelSlots[WHEEL_NEAR][Expiry & WHEEL_MASK];
+    }
+    else
+    {
+        /** Later than one turn of the far level comes back to it until due */
+        pSlot = &WheelSlots[WHEEL_FAR][(Expiry >> SCHEDULAR_WHEEL_BITS) & WHEEL_MASK];
+    }
+    RunnableTimers[Runnable].Next = *pSlot;
+    RunnableTimers[Runnable].Prev = NO_RUNNABLE;
+    RunnableTimers[Runnable].pHead = pSlot;
+    if(*pSlot != NO_RUNNABLE)
+    {
+        RunnableTimers[*pSlot].Prev = (uint16_t)Runnable;
+    }
+    else
+    {
+        /* No thing */
+    }
+    *pSlot = (uint16_t)Runnable;
+}
+
+/**
+ * @brief Unlinks a runnable from its slot of the wheel.
+ *
+ * @param Runnable Index of the runnable, nothing is done out of the wheel.
+ */
+static void WheelRemove(uint32_t Runnable)
+{
+    Schedular_timer_t * pTimer = &RunnableTimers[Runnable];
+
+    if(pTimer->pHead != NULL)
+    {
+        if(pTimer->Prev == NO_RUNNABLE)
+        {
+            *pTimer->pHead = pTimer->Next;
+        }
+        else
+        {
+            RunnableTimers[pTimer->Prev].Next = pTimer->Next;
+        }
+        if(pTimer->Next != NO_RUNNABLE)
+        {
+            RunnableTimers[pTimer->Next].Prev = pTimer->Prev;
+        }
+        else
+        {
+            /* No thing */
+        }
+        pTimer->pHead = NULL;
+    }
+    else
+    {
+        /* No thing */
+    }
+}
+
+/**
+ * @brief Inserts a runnable in the priority order after the ones of the same
+ *        or a higher priority, the ranks after it move with their ready bit.
+ *
+ * @param Runnable Index of a runnable not in the order yet.
+ */
+static void OrderInsert(uint32_t Runnable)
 {
-    uint32_t CurrentRunnable ;
-    /**
-     * Looping through all runnables to update the remaining time for each runnable
-     * and calling the runnable if the remaining time has ended.
-     */
-    for(CurrentRunnable = 0 ; CurrentRunnable < MAX_RUNNABLES ; CurrentRunnable++)
+    uint32_t Order ;
+
+    for(Order = RunnablesCount ; Order > 0 ; Order--)
     {
-        if(IS_RUNNABLE_WILL_EXECUTE_NOW(CurrentRunnable))
+        if(Runnables[RunnablesByPriority[Order - 1]].priority <=
+           Runnables[Runnable].priority)
+        {
+            break;
+        }
+        else
         {
-            /** Executes the runnable if the designated time has arrived. */
-            AllRunnablesSystemList[CurrentRunnable].CallBack();
-            RemainingTimeForAllRunnables[CurrentRunnable] =
-                            AllRunnablesSystemList[CurrentRunnable].periodicityMS;
+            RunnablesByPriority[Order] = RunnablesByPriority[Order - 1];
+            RunnableRank[RunnablesByPriority[Order]] = (uint16_t)Order;
+            if(IS_RUNNABLE_READY(Order - 1))
+            {
+                SET_RUNNABLE_READY(Order);
+            }
+            else
+            {
+                CLEAR_RUNNABLE_READY(Order);
+            }
         }
-        /**update the remaining time for the runnable */
-        RemainingTimeForAllRunnables[CurrentRunnable] -= TICK_TIME;
+    }
+    CLEAR_RUNNABLE_READY(Order);
+    RunnablesByPriority[Order] = (uint16_t)Runnable;
+    RunnableRank[Runnable] = (uint16_t)Order;
+    RunnablesCount++;
+}
+
+/**
+ * @brief Takes a runnable out of the priority order, and out of the ready
+ *        ones, the ranks after it move with their ready bit.
+ *
+ * @param Runnable Index of a runnable in the order.
+ */
+static void OrderRemove(uint32_t Runnable)
+{
+    uint32_t Order = RunnableRank[Runnable];
+
+    if(IS_RUNNABLE_READY(Order))
+    {
+        ReadyCount--;
+    }
+    else
+    {
+        /* No thing */
+    }
+    RunnablesCount--;
+    for( ; Order < RunnablesCount ; Order++)
+    {
+        RunnablesByPriority[Order] = RunnablesByPriority[Order + 1];
+        RunnableRank[RunnablesByPriority[Order]] = (uint16_t)Order;
+        if(IS_RUNNABLE_READY(Order + 1))
+        {
+            SET_RUNNABLE_READY(Order);
+        }
+        else
+        {
+            CLEAR_RUNNABLE_READY(Order);
+        }
+    }
+    CLEAR_RUNNABLE_READY(RunnablesCount);
+}
+
+/**
+ * @brief Drops the ready bit of a runnable, its release is lost.
+ */
+static void ReadyClear(uint32_t Runnable)
+{
+    uint32_t Rank = RunnableRank[Runnable];
+
+    if(IS_RUNNABLE_READY(Rank))
+    {
+        CLEAR_RUNNABLE_READY(Rank);
+        ReadyCount--;
+    }
+    else
+    {
+        /* No thing */
+    }
+}
+
+/**
+ * @brief Moves the far slot of the block starting now into the near level.
+ */
+static void WheelCascade(void)
+{
+    uint16_t * pSlot = &WheelSlots[WHEEL_FAR][(WheelTime >> SCHEDULAR_WHEEL_BITS) & WHEEL_MASK];
+    uint16_t Runnable = *pSlot;
+    uint16_t Next;
+
+    *pSlot = NO_RUNNABLE;
+    while(Runnable != NO_RUNNABLE)
+    {
+        Next = RunnableTimers[Runnable].Next;
+        WheelInsert(Runnable);
+        Runnable = Next;
+    }
+}
+
+/**
+ * @brief Releases the runnables whose period ended at this tick.
+ *
+ * A runnable released while it is still waiting stays ready once, its
+ * previous release is merged with the new one.
+ */
+static void ReleaseRunnables(void)
+{
+    uint16_t * pSlot;
+    uint16_t Runnable;
+    uint16_t Next;
+    uint16_t Rank;
+#if SCHEDULAR_ENABLE_STATS == 1
+    uint32_t ReleaseCycles;
+#endif
+
+    WheelTime++;
+    if((WheelTime & WHEEL_MASK) == 0)
+    {
+        WheelCascade();
+    }
+    else
+    {
+        /* No thing */
+    }
+
+#if SCHEDULAR_ENABLE_STATS == 1
+    ReleaseCycles = StatsTickCycles();
+#endif
+
+    pSlot = &WheelSlots[WHEEL_NEAR][WheelTime & WHEEL_MASK];
+    Runnable = *pSlot;
+    *pSlot = NO_RUNNABLE;
+    while(Runnable != NO_RUNNABLE)
+    {
+        Next = RunnableTimers[Runnable].Next;
+        Rank = RunnableRank[Runnable];
+        if(!IS_RUNNABLE_READY(Rank))
+        {
+            SET_RUNNABLE_READY(Rank);
+            ReadyCount++;
+        }
+        else
+        {
+#if SCHEDULAR_ENABLE_STATS == 1
+            /** The previous release never started before this one */
+            RunnableStats[Runnable].Missed++;
+#endif
+        }
+#if SCHEDULAR_ENABLE_STATS == 1
+        RunnableReleaseCycles[Runnable] = ReleaseCycles;
+#endif
+        RunnableTimers[Runnable].Expiry += RUNNABLE_PERIOD_TICKS(Runnable);
+        WheelInsert(Runnable);
+        Runnable = Next;
+    }
+}
+
+/**
+ * @brief Executes the ready runnable of the highest priority.
+ *
+ * Only one runnable is executed per call, so ticks which arrived during a
+ * long runnable are released before anything of a lower priority runs.
+ */
+static void DispatchRunnable(void)
+{
+    uint32_t Word ;
+    uint32_t Rank ;
+    uint32_t Runnable ;
+#if SCHEDULAR_ENABLE_STATS == 1
+    uint32_t Start ;
+#endif
+    if(ReadyCount != 0)
+    {
+        for(Word = 0 ; ReadyRunnables[Word] == 0 ; Word++)
+        {
+            /* Skip the words without a ready runnable */
+        }
+        Rank = (Word << 5) + (uint32_t)__builtin_ctz(ReadyRunnables[Word]);
+        CLEAR_RUNNABLE_READY(Rank);
+        ReadyCount--;
+        Runnable = RunnablesByPriority[Rank];
+#if SCHEDULAR_ENABLE_STATS == 1
+        Start = DWT_GetCycles();
+        Runnables[Runnable].CallBack();
+        StatsRecordRun(Runnable, Start - RunnableReleaseCycles[Runnable],
+                       DWT_GetElapsed(Start));
+#else
+        Runnables[Runnable].CallBack();
+#endif
+    }
+    else
+    {
+        /* No thing */
+    }
+}
+
+#if SCHEDULAR_TICKLESS_IDLE == 1
+/**
+ * @brief Ticks until the wheel has something to do.
+ *
+ * @param MaxTicks Bound of the search.
+ * @return Ticks until the next release or the next cascade of a far slot
+ *         which is not empty, MaxTicks when none comes before.
+ */
+static uint32_t TicksToNextRelease(uint32_t MaxTicks)
+{
+    uint32_t Ticks = 0;
+    uint32_t Time;
+    uint8_t Found = 0;
+
+    while((Found == 0) && (Ticks < MaxTicks))
+    {
+        Ticks++;
+        Time = WheelTime + Ticks;
+        if(((Time & WHEEL_MASK) == 0) &&
+           (WheelSlots[WHEEL_FAR][(Time >> SCHEDULAR_WHEEL_BITS) & WHEEL_MASK] != NO_RUNNABLE))
+        {
+            Found = 1;
+        }
+        else if((Ticks <= WHEEL_SLOTS) &&
+                (WheelSlots[WHEEL_NEAR][Time & WHEEL_MASK] != NO_RUNNABLE))
+        {
+            Found = 1;
+        }
+        else if(Ticks >= WHEEL_SLOTS)
+        {
+            /** The near level is empty past here, jump to the end of the block */
+            Ticks += WHEEL_MASK - (Time & WHEEL_MASK);
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    return (Ticks < MaxTicks) ? Ticks : MaxTicks;
+}
+
+/**
+ * @brief Sleeps until the next release or any interrupt.
+ *
+ * SysTick is stretched up to the next tick with work, the ticks which ended
+ * during the sleep without their interrupt had nothing due, so the wheel and
+ * the time jump over them at wakeup.
+ */
+static void IdleSleep(void)
+{
+    uint32_t IdleTicks = TicksToNextRelease(IDLE_MAX_TICKS);
+    uint32_t SleptTicks = 0;
+    uint32_t PriMask = NVIC_DisableInterrupts();
+
+    /** A tick which came after the check above is served before sleeping */
+    if(!IS_TICK_PENDING() &&
+       (SysTick_SleepTicks(IdleTicks, &SleptTicks) == SYSTICK_OK))
+    {
+        WheelTime += SleptTicks;
+        TickCount += SleptTicks;
+        ElapsedTimeMS += SleptTicks * TICK_TIME;
+    }
+    else
+    {
+        /* No thing */
+    }
+    NVIC_RestoreInterrupts(PriMask);
+}
+#endif
+
+/**
+ * @brief Schedules and executes a runnable based on its priority and periodicity.
+ *
+ * Pending ticks are served first, the ready runnables are executed in
+ * priority order in the idle slots between them. When a tick overruns the
+ * lower priorities are deferred instead of delaying the higher ones. With
+ * SCHEDULAR_TICKLESS_IDLE the core sleeps when nothing is left.
+ */
+static void Schedular(void)
+{
+    if(IS_TICK_PENDING())
+    {
+        ReleaseRunnables();
+    }
+    else if(ReadyCount != 0)
+    {
+        DispatchRunnable();
+    }
+    else
+    {
+#if SCHEDULAR_TICKLESS_IDLE == 1
+        IdleSleep();
+#endif
     }
 }
 
@@ -153,12 +777,45 @@ static void Schedular(void)
 /******************************************************************************/
 void schedular_init(void)
 {
-    /** make the remaining time equal to the delay function */
+    uint32_t Slot ;
+
+#if SCHEDULAR_ENABLE_STATS == 1
+    DWT_Init();
+    schedular_ResetStats();
+#endif
+    WheelTime = 0;
+    TickCount = 0;
+    ReadyCount = 0;
+    RunnablesCount = 0;
+    for(Slot = 0 ; Slot < WHEEL_SLOTS ; Slot++)
+    {
+        WheelSlots[WHEEL_NEAR][Slot] = NO_RUNNABLE;
+        WheelSlots[WHEEL_FAR][Slot] = NO_RUNNABLE;
+    }
+    for(Slot = 0 ; Slot < READY_WORDS ; Slot++)
+    {
+        ReadyRunnables[Slot] = 0;
+    }
+
+    /** the entries without callback are free slots of the pool */
     for(uint32_t runnable = 0 ; runnable < MAX_RUNNABLES ; runnable++)
     {
-        RemainingTimeForAllRunnables[runnable] = 
-                                AllRunnablesSystemList[runnable].DelayMS;
+        Runnables[runnable] = AllRunnablesSystemList[runnable];
+        RunnableTimers[runnable].pHead = NULL;
+        if(Runnables[runnable].CallBack != NULL)
+        {
+            RunnableStates[runnable] = RUNNABLE_ACTIVE;
+            /** the first release comes after the delay of the runnable */
+            RunnableTimers[runnable].Expiry = RUNNABLE_FIRST_TICK(runnable);
+            WheelInsert(runnable);
+            OrderInsert(runnable);
+        }
+        else
+        {
+            RunnableStates[runnable] = RUNNABLE_FREE;
+        }
     }
+
     SysTick_CFG_t SysTickConf = 
     {
         .CLK = SYS_CLK,
@@ -171,20 +828,239 @@ void schedular_init(void)
     SysTick_SetCallback(TickCB);
 }
 
-void schedular_start(void)
+uint32_t schedular_GetTimeMS(void)
 {
-    SysTick_Start();
-    while(1)
+    return ElapsedTimeMS;
+}
+
+Schedular_ErrorStatus_t schedular_AddRunnable(const Schedular_runnable_t * pRunnable,
+                                              uint32_t * pHandle)
+{
+    Schedular_ErrorStatus_t RET_ErrorStatus = SCHEDULAR_OK;
+    uint32_t Runnable = 0;
+
+    if((pRunnable == NULL) || (pHandle == NULL) || (pRunnable->CallBack == NULL))
+    {
+        RET_ErrorStatus = SCHEDULAR_NULL_PTR_PASSED;
+    }
+    else
     {
-        if(PendingRunnables)
+        while((Runnable < MAX_RUNNABLES) && (RunnableStates[Runnable] != RUNNABLE_FREE))
+        {
+            Runnable++;
+        }
+        if(Runnable == MAX_RUNNABLES)
         {
-            Schedular();
-            PendingRunnables--;
+            /** The pool is full */
+            RET_ErrorStatus = SCHEDULAR_NOT_OK;
         }
         else
         {
-            
+            Runnables[Runnable] = *pRunnable;
+            RunnableStates[Runnable] = RUNNABLE_ACTIVE;
+            RunnableTimers[Runnable].Expiry = RUNNABLE_FIRST_TICK(Runnable);
+            WheelInsert(Runnable);
+            OrderInsert(Runnable);
+#if SCHEDULAR_ENABLE_STATS == 1
+            RunnableStats[Runnable] = (Schedular_stats_t){0};
+            RunnableTotalCycles[Runnable] = 0;
+#endif
+            *pHandle = Runnable;
+        }
+    }
+    return RET_ErrorStatus;
+}
+
+Schedular_ErrorStatus_t schedular_RemoveRunnable(uint32_t Handle)
+{
+    Schedular_ErrorStatus_t RET_ErrorStatus = SCHEDULAR_OK;
+    if(!IS_RUNNABLE_HANDLE(Handle))
+    {
+        RET_ErrorStatus = SCHEDULAR_NOT_OK;
+    }
+    else
+    {
+        WheelRemove(Handle);
+        OrderRemove(Handle);
+        RunnableStates[Handle] = RUNNABLE_FREE;
+        Runnables[Handle].CallBack = NULL;
+    }
+    return RET_ErrorStatus;
+}
+
+Schedular_ErrorStatus_t schedular_SuspendRunnable(uint32_t Handle)
+{
+    Schedular_ErrorStatus_t RET_ErrorStatus = SCHEDULAR_OK;
+    if(!IS_RUNNABLE_HANDLE(Handle))
+    {
+        RET_ErrorStatus = SCHEDULAR_NOT_OK;
+    }
+    else
+    {
+        WheelRemove(Handle);
+        ReadyClear(Handle);
+        RunnableStates[Handle] = RUNNABLE_SUSPENDED;
+    }
+    return RET_ErrorStatus;
+}
+
+Schedular_ErrorStatus_t schedular_ResumeRunnable(uint32_t Handle)
+{
+    Schedular_ErrorStatus_t RET_ErrorStatus = SCHEDULAR_OK;
+    if(!IS_RUNNABLE_HANDLE(Handle))
+    {
+        RET_ErrorStatus = SCHEDULAR_NOT_OK;
+    }
+    else if(RunnableStates[Handle] == RUNNABLE_SUSPENDED)
+    {
+        /** Released again after its delay, like when it was added */
+        RunnableStates[Handle] = RUNNABLE_ACTIVE;
+        RunnableTimers[Handle].Expiry = RUNNABLE_FIRST_TICK(Handle);
+        WheelInsert(Handle);
+    }
+    else
+    {
+        /* No thing */
+    }
+    return RET_ErrorStatus;
+}
+
+Schedular_ErrorStatus_t schedular_SetPeriod(uint32_t Handle, uint32_t PeriodMS)
+{
+    Schedular_ErrorStatus_t RET_ErrorStatus = SCHEDULAR_OK;
+    uint32_t LastRelease;
+    if(!IS_RUNNABLE_HANDLE(Handle) || (PeriodMS == 0))
+    {
+        RET_ErrorStatus = SCHEDULAR_NOT_OK;
+    }
+    else
+    {
+        LastRelease = RunnableTimers[Handle].Expiry - RUNNABLE_PERIOD_TICKS(Handle);
+        Runnables[Handle].periodicityMS = PeriodMS;
+        if(RunnableStates[Handle] == RUNNABLE_ACTIVE)
+        {
+            /** The next release moves to one new period after the last one */
+            WheelRemove(Handle);
+            RunnableTimers[Handle].Expiry = LastRelease + RUNNABLE_PERIOD_TICKS(Handle);
+            if((int32_t)(RunnableTimers[Handle].Expiry - WheelTime) <= 0)
+            {
+                RunnableTimers[Handle].Expiry = WheelTime + 1UL;
+            }
+            else
+            {
+                /* No thing */
+            }
+            WheelInsert(Handle);
         }
+        else
+        {
+            /* No thing */
+        }
+    }
+    return RET_ErrorStatus;
+}
+
+Schedular_ErrorStatus_t schedular_GetStats(uint32_t Runnable, Schedular_stats_t * pStats)
+{
+    Schedular_ErrorStatus_t RET_ErrorStatus = SCHEDULAR_OK;
+    if(pStats == NULL)
+    {
+        RET_ErrorStatus = SCHEDULAR_NULL_PTR_PASSED;
+    }
+    else if(Runnable >= MAX_RUNNABLES)
+    {
+        RET_ErrorStatus = SCHEDULAR_NOT_OK;
+    }
+    else
+    {
+#if SCHEDULAR_ENABLE_STATS == 1
+        *pStats = RunnableStats[Runnable];
+        if(pStats->Calls != 0)
+        {
+            pStats->AvgCycles = (uint32_t)(RunnableTotalCycles[Runnable] / pStats->Calls);
+        }
+        else
+        {
+            /* No thing */
+        }
+        pStats->JitterCycles = pStats->MaxLatencyCycles - pStats->MinLatencyCycles;
+#else
+        RET_ErrorStatus = SCHEDULAR_NOT_OK;
+#endif
+    }
+    return RET_ErrorStatus;
+}
+
+uint32_t schedular_GetPeakPendingTicks(void)
+{
+#if SCHEDULAR_ENABLE_STATS == 1
+    return PeakPendingTicks;
+#else
+    return 0;
+#endif
+}
+
+void schedular_ResetStats(void)
+{
+#if SCHEDULAR_ENABLE_STATS == 1
+    for(uint32_t runnable = 0 ; runnable < MAX_RUNNABLES ; runnable++)
+    {
+        RunnableStats[runnable] = (Schedular_stats_t){0};
+        RunnableTotalCycles[runnable] = 0;
+    }
+    PeakPendingTicks = 0;
+#endif
+}
+
+Schedular_ErrorStatus_t schedular_ExportStats(uint8_t * pBuffer, uint32_t Size,
+                                              uint32_t * pLength)
+{
+    Schedular_ErrorStatus_t RET_ErrorStatus = SCHEDULAR_OK;
+    if((pBuffer == NULL) || (pLength == NULL))
+    {
+        RET_ErrorStatus = SCHEDULAR_NULL_PTR_PASSED;
+    }
+    else if(Size < SCHEDULAR_STATS_SIZE(MAX_RUNNABLES))
+    {
+        RET_ErrorStatus = SCHEDULAR_NOT_OK;
+    }
+    else
+    {
+#if SCHEDULAR_ENABLE_STATS == 1
+        Schedular_stats_t Stats;
+        uint8_t * pNext = pBuffer;
+
+        *pNext++ = SCHEDULAR_STATS_VERSION;
+        pNext = StatsPut(pNext, MAX_RUNNABLES, 2U);
+        pNext = StatsPut(pNext, (PeakPendingTicks > 0xFFFFUL) ? 0xFFFFUL : PeakPendingTicks, 2U);
+        pNext = StatsPut(pNext, CYCLES_PER_TICK, 4U);
+        for(uint32_t runnable = 0 ; runnable < MAX_RUNNABLES ; runnable++)
+        {
+            schedular_GetStats(runnable, &Stats);
+            pNext = StatsPut(pNext, Stats.Calls, 4U);
+            pNext = StatsPut(pNext, Stats.MinCycles, 4U);
+            pNext = StatsPut(pNext, Stats.AvgCycles, 4U);
+            pNext = StatsPut(pNext, Stats.MaxCycles, 4U);
+            pNext = StatsPut(pNext, Stats.MinLatencyCycles, 4U);
+            pNext = StatsPut(pNext, Stats.MaxLatencyCycles, 4U);
+            pNext = StatsPut(pNext, Stats.Missed, 4U);
+            pNext = StatsPut(pNext, Runnables[runnable].priority, 2U);
+        }
+        *pLength = (uint32_t)(pNext - pBuffer);
+#else
+        *pLength = 0;
+        RET_ErrorStatus = SCHEDULAR_NOT_OK;
+#endif
+    }
+    return RET_ErrorStatus;
+}
+
+void schedular_start(void)
+{
+    SysTick_Start();
+    while(1)
+    {
+        Schedular();
     }
 }
 
@@ -31,6 +31,7 @@
 /******************************************************************************/
 #include "schedular.h"
 #include "schedular_CFG.h"
+#include "ControlProtocol_CFG.h"
 /******************************************************************************/
 
 /******************************************************************************/
@@ -39,6 +40,8 @@
 
 
 extern void CheckSwitchesStates(void);
+extern void LCD_Runnable(void);
+extern void Protocol_Runnable(void);
 
 
 
@@ -48,7 +51,8 @@ extern void CheckSwitchesStates(void);
  * @par This constant array `AllRunnableInSystemList` of type `Schedular_runnable_t`
  * holds up to `MAX_RUNNABLES` (defined in schedular_CFG.h) runnables  
  * These runnables are managed by the scheduler and will be scheduled for execution 
- * based on their priority and periodicity.
+ * based on their priority and periodicity. The index of an entry is its
+ * handle, the entries left out are free slots of the pool.
  */
 const Schedular_runnable_t AllRunnablesSystemList[MAX_RUNNABLES] =
 {
@@ -57,7 +61,24 @@ const Schedular_runnable_t AllRunnablesSystemList[MAX_RUNNABLES] =
         .CallBack = CheckSwitchesStates,
         .DelayMS = 0,
         .periodicityMS = 5,
+        .priority = PRIORITY_0,
+        .name = "Switch task"
+    },
+    [PRIORITY_1] =
+    {
+        .CallBack = LCD_Runnable,
+        .DelayMS = 0,
+        .periodicityMS = 1,
+        .priority = PRIORITY_1,
         .name = "LCD task"
+    },
+    [PRIORITY_2] =
+    {
+        .CallBack = Protocol_Runnable,
+        .DelayMS = 0,
+        .periodicityMS = PROTOCOL_RUNNABLE_PERIOD_MS,
+        .priority = PRIORITY_2,
+        .name = "Protocol task"
     }
 };
 
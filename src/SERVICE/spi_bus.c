@@ -0,0 +1,505 @@
+/******************************************************************************/
+/**
+ * @file spi_bus.c
+ * @brief SPI buses shared by several devices.
+ *
+ * @par Project Name
+ * stm32fxx services
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * One bus per SPI instance used in SpiBusDevices, each with its own handle
+ * and queue. The head of a queue is the transfer on the wire; the end of
+ * its DMA transfer pops it, calls its callback and starts the next one, so
+ * the submitter works with the interrupts of the two streams of the bus
+ * disabled. Bus->Device remembers whose format is in CR1 and Bus->Selected
+ * whose chip select is low, a transfer for the same device changes neither.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include "spi_bus.h"
+#include "stm32f4xx_gpio.h"
+#include "stm32f4xx_nvic.h"
+#include "stm32f4xx_rcc.h"
+#include "stm32f4xx_spi.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+
+#define SPI_BUS_INSTANCES       (4U)
+#define SPI_BUS_NO_DEVICE       (0xFFU)     /**< Bus->Device or Bus->Selected unset */
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE MACROS */
+/******************************************************************************/
+
+#define IS_SPI_BUS_DEVICE(DEVICE)   ((DEVICE) < _SPI_BUS_DEVICES_NUM)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE TYPES */
+/******************************************************************************/
+
+typedef struct
+{
+    SPI_Handle_t Handle;
+    SpiBus_Transfer_t * pHead;      /**< Transfer on the wire or next to start */
+    SpiBus_Transfer_t * pTail;
+    volatile bool isRunning;        /**< pHead is on the wire */
+    bool isUsed;                    /**< A device of SpiBusDevices is on this bus */
+    uint8_t Device;                 /**< Device whose format is in CR1 */
+    uint8_t Selected;               /**< Device whose chip select is low */
+    SpiBus_Stats_t Stats;
+} SpiBus_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION PROTOTYPES */
+/******************************************************************************/
+static uint8_t GetBus(void * Instance);
+static uint32_t GetPortClock(void * Port);
+static void Lock(uint8_t Bus);
+static void Unlock(uint8_t Bus);
+static void Select(SpiBus_t * pBus, uint8_t Device);
+static void Release(SpiBus_t * pBus);
+static void Finish(SpiBus_t * pBus, SPI_BUS_TransferStatus_t Status);
+static void StartNext(SpiBus_t * pBus);
+static void TransferDone(uint8_t Bus);
+static void TransferFailed(uint8_t Bus);
+static void SPI1_Done(void);
+static void SPI2_Done(void);
+static void SPI3_Done(void);
+static void SPI4_Done(void);
+static void SPI1_Failed(void);
+static void SPI2_Failed(void);
+static void SPI3_Failed(void);
+static void SPI4_Failed(void);
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE CONSTANT DEFINITIONS */
+/******************************************************************************/
+
+static void * const Instances[SPI_BUS_INSTANCES] = {SPI1, SPI2, SPI3, SPI4};
+
+/* SPI and DMA clocks of each bus */
+static const uint32_t Clocks[SPI_BUS_INSTANCES][2] =
+{
+    {PERIPHERAL_SPI1, PERIPHERAL_DMA2},
+    {PERIPHERAL_SPI2, PERIPHERAL_DMA1},
+    {PERIPHERAL_SPI3, PERIPHERAL_DMA1},
+    {PERIPHERAL_SPI4, PERIPHERAL_DMA2}
+};
+
+/* Receive and transmit streams of each bus, @ref SPI_DMA_Streams */
+static const IRQn_Type StreamIRQs[SPI_BUS_INSTANCES][2] =
+{
+    {DMA2_Stream2_IRQn, DMA2_Stream3_IRQn},
+    {DMA1_Stream3_IRQn, DMA1_Stream4_IRQn},
+    {DMA1_Stream0_IRQn, DMA1_Stream7_IRQn},
+    {DMA2_Stream0_IRQn, DMA2_Stream4_IRQn}
+};
+
+/* Done and failed callbacks given to the SPI driver by each bus */
+static void (*const CallBacks[SPI_BUS_INSTANCES][2])(void) =
+{
+    {SPI1_Done, SPI1_Failed},
+    {SPI2_Done, SPI2_Failed},
+    {SPI3_Done, SPI3_Failed},
+    {SPI4_Done, SPI4_Failed}
+};
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+static SpiBus_t Buses[SPI_BUS_INSTANCES];
+static bool isInitialized = false;
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+static uint8_t GetBus(void * Instance)
+{
+    uint8_t RET_Bus = SPI_BUS_INSTANCES;
+    for(uint8_t Bus = 0; Bus < SPI_BUS_INSTANCES && RET_Bus == SPI_BUS_INSTANCES; Bus++)
+    {
+        if(Instances[Bus] == Instance)
+        {
+            RET_Bus = Bus;
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    return RET_Bus;
+}
+
+static uint32_t GetPortClock(void * Port)
+{
+    uint32_t RET_Clock = 0;
+    if(Port == GPIO_PORTA)
+    {
+        RET_Clock = PERIPHERAL_GPIOA;
+    }
+    else if(Port == GPIO_PORTB)
+    {
+        RET_Clock = PERIPHERAL_GPIOB;
+    }
+    else if(Port == GPIO_PORTC)
+    {
+        RET_Clock = PERIPHERAL_GPIOC;
+    }
+    else if(Port == GPIO_PORTD)
+    {
+        RET_Clock = PERIPHERAL_GPIOD;
+    }
+    else if(Port == GPIO_PORTE)
+    {
+        RET_Clock = PERIPHERAL_GPIOE;
+    }
+    else if(Port == GPIO_PORTH)
+    {
+        RET_Clock = PERIPHERAL_GPIOH;
+    }
+    else
+    {
+        /* No thing */
+    }
+    return RET_Clock;
+}
+
+static void Lock(uint8_t Bus)
+{
+    NVIC_DisableIRQ(StreamIRQs[Bus][0]);
+    NVIC_DisableIRQ(StreamIRQs[Bus][1]);
+}
+
+static void Unlock(uint8_t Bus)
+{
+    NVIC_EnableIRQ(StreamIRQs[Bus][0]);
+    NVIC_EnableIRQ(StreamIRQs[Bus][1]);
+}
+
+/**
+ * @brief Drives the chip select of a device low, after releasing the one
+ *        left low by another device.
+ */
+static void Select(SpiBus_t * pBus, uint8_t Device)
+{
+    if(pBus->Selected != Device)
+    {
+        Release(pBus);
+        GPIO_SetPinValue(SpiBusDevices[Device].CSPort, SpiBusDevices[Device].CSPin, GPIO_STATE_RESET);
+        pBus->Selected = Device;
+    }
+    else
+    {
+        /* No thing */
+    }
+}
+
+static void Release(SpiBus_t * pBus)
+{
+    if(pBus->Selected != SPI_BUS_NO_DEVICE)
+    {
+        GPIO_SetPinValue(SpiBusDevices[pBus->Selected].CSPort, SpiBusDevices[pBus->Selected].CSPin,
+                         GPIO_STATE_SET);
+        pBus->Selected = SPI_BUS_NO_DEVICE;
+    }
+    else
+    {
+        /* No thing */
+    }
+}
+
+/**
+ * @brief Pops the head of the queue and calls its callback.
+ * @note Called locked or from the DMA interrupt of the bus.
+ */
+static void Finish(SpiBus_t * pBus, SPI_BUS_TransferStatus_t Status)
+{
+    SpiBus_Transfer_t * pTransfer = pBus->pHead;
+    pBus->pHead = pTransfer->pNext;
+    if(pBus->pHead == NULL)
+    {
+        pBus->pTail = NULL;
+    }
+    pTransfer->pNext = NULL;
+    pBus->Stats.Pending -= 1;
+    if(Status == SPI_BUS_DONE)
+    {
+        pBus->Stats.Transfers += 1;
+    }
+    else
+    {
+        pBus->Stats.Errors += 1;
+    }
+    if(Status != SPI_BUS_DONE || !pTransfer->KeepSelected)
+    {
+        Release(pBus);
+    }
+    pBus->isRunning = false;
+    pTransfer->Status = Status;
+    if(pTransfer->CallBack != NULL)
+    {
+        pTransfer->CallBack(pTransfer);
+    }
+}
+
+/**
+ * @brief Puts the head of the queue on the wire, after switching the format
+ *        of the SPI to its device if needed.
+ * @note Called locked or from the DMA interrupt, does nothing while a
+ *       transfer runs. A transfer the SPI refuses fails and the next one is
+ *       tried.
+ */
+static void StartNext(SpiBus_t * pBus)
+{
+    while(!pBus->isRunning && pBus->pHead != NULL)
+    {
+        SpiBus_Transfer_t * pTransfer = pBus->pHead;
+        const SpiBus_Device_t * pDevice = &SpiBusDevices[pTransfer->Device];
+        SPI_ErrorStatus Status = SPI_OK;
+        if(pBus->Device != pTransfer->Device)
+        {
+            pBus->Handle.Init.CLKPolarity       = pDevice->CLKPolarity;
+            pBus->Handle.Init.CLKPhase          = pDevice->CLKPhase;
+            pBus->Handle.Init.BaudRatePrescaler = pDevice->BaudRatePrescaler;
+            pBus->Handle.Init.DataSize          = pDevice->DataSize;
+            Status = SPI_UpdateFormat(&pBus->Handle);
+            pBus->Device = (Status == SPI_OK) ? pTransfer->Device : SPI_BUS_NO_DEVICE;
+            pBus->Stats.Reconfigurations += 1;
+        }
+        if(Status == SPI_OK)
+        {
+            Select(pBus, pTransfer->Device);
+            pBus->isRunning = true;
+            if(pTransfer->pTxData != NULL && pTransfer->pRxData != NULL)
+            {
+                Status = SPI_TransmitReceiveDMA(&pBus->Handle, pTransfer->pTxData, pTransfer->pRxData,
+                                                pTransfer->Size, CallBacks[GetBus(pDevice->Instance)][0]);
+            }
+            else if(pTransfer->pTxData != NULL)
+            {
+                Status = SPI_TransmitDMA(&pBus->Handle, pTransfer->pTxData, pTransfer->Size,
+                                         CallBacks[GetBus(pDevice->Instance)][0]);
+            }
+            else
+            {
+                Status = SPI_ReceiveDMA(&pBus->Handle, pTransfer->pRxData, pTransfer->Size,
+                                        CallBacks[GetBus(pDevice->Instance)][0]);
+            }
+        }
+        if(Status != SPI_OK)
+        {
+            Finish(pBus, SPI_BUS_FAILED);
+        }
+    }
+}
+
+static void TransferDone(uint8_t Bus)
+{
+    Finish(&Buses[Bus], SPI_BUS_DONE);
+    StartNext(&Buses[Bus]);
+}
+
+static void TransferFailed(uint8_t Bus)
+{
+    Finish(&Buses[Bus], SPI_BUS_FAILED);
+    StartNext(&Buses[Bus]);
+}
+
+static void SPI1_Done(void)
+{
+    TransferDone(0);
+}
+
+static void SPI2_Done(void)
+{
+    TransferDone(1);
+}
+
+static void SPI3_Done(void)
+{
+    TransferDone(2);
+}
+
+static void SPI4_Done(void)
+{
+    TransferDone(3);
+}
+
+static void SPI1_Failed(void)
+{
+    TransferFailed(0);
+}
+
+static void SPI2_Failed(void)
+{
+    TransferFailed(1);
+}
+
+static void SPI3_Failed(void)
+{
+    TransferFailed(2);
+}
+
+static void SPI4_Failed(void)
+{
+    TransferFailed(3);
+}
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+SPI_BUS_ErrorStatus_t SpiBus_Init(void)
+{
+    SPI_BUS_ErrorStatus_t RET_ErrorStatus = SPI_BUS_OK;
+    gpioPin_t CS;
+
+    for(uint8_t Bus = 0; Bus < SPI_BUS_INSTANCES; Bus++)
+    {
+        Buses[Bus].isUsed = false;
+    }
+
+    for(uint8_t Device = 0; Device < _SPI_BUS_DEVICES_NUM && RET_ErrorStatus == SPI_BUS_OK; Device++)
+    {
+        const SpiBus_Device_t * pDevice = &SpiBusDevices[Device];
+        uint8_t Bus = GetBus(pDevice->Instance);
+        uint32_t PortClock = GetPortClock(pDevice->CSPort);
+        if(Bus == SPI_BUS_INSTANCES || PortClock == 0)
+        {
+            RET_ErrorStatus = SPI_BUS_ERROR;
+        }
+        else
+        {
+            RCC_enuEnablePeripheral(PortClock);
+            CS.GPIO_Port    = pDevice->CSPort;
+            CS.GPIO_Pin     = pDevice->CSPin;
+            CS.GPIO_Mode    = GPIO_MODE_OUT_PP;
+            CS.GPIO_AT_Type = GPIO_AT_None;
+            CS.GPIO_Speed   = GPIO_SPEED_VERY_HIGH;
+            GPIO_SetPinValue(pDevice->CSPort, pDevice->CSPin, GPIO_STATE_SET);
+            if(GPIO_Init(&CS) != GPIO_SUCCESS)
+            {
+                RET_ErrorStatus = SPI_BUS_ERROR;
+            }
+            else if(!Buses[Bus].isUsed)
+            {
+                /* The first device of a bus gives its starting format */
+                SpiBus_t * pBus = &Buses[Bus];
+                RCC_enuEnablePeripheral(Clocks[Bus][0]);
+                RCC_enuEnablePeripheral(Clocks[Bus][1]);
+                pBus->Handle.Instance                = pDevice->Instance;
+                pBus->Handle.Init.Mode               = SPI_MODE_MASTER;
+                pBus->Handle.Init.ByteOrder          = SPI_BYTEORDER_MSB;
+                pBus->Handle.Init.NSS                = SPI_NSS_SOFT;
+                pBus->Handle.Init.CRCCalculation     = SPI_CRCCALCULATION_DISABLE;
+                pBus->Handle.Init.CRCPolynomial      = 7;
+                pBus->Handle.Init.CLKPolarity        = pDevice->CLKPolarity;
+                pBus->Handle.Init.CLKPhase           = pDevice->CLKPhase;
+                pBus->Handle.Init.BaudRatePrescaler  = pDevice->BaudRatePrescaler;
+                pBus->Handle.Init.DataSize           = pDevice->DataSize;
+                pBus->Handle.errorCallBack           = CallBacks[Bus][1];
+                pBus->pHead     = NULL;
+                pBus->pTail     = NULL;
+                pBus->isRunning = false;
+                pBus->Device    = Device;
+                pBus->Selected  = SPI_BUS_NO_DEVICE;
+                pBus->Stats     = (SpiBus_Stats_t){0};
+                if(SPI_Init(&pBus->Handle) != SPI_OK)
+                {
+                    RET_ErrorStatus = SPI_BUS_ERROR;
+                }
+                else
+                {
+                    pBus->isUsed = true;
+                    Unlock(Bus);
+                }
+            }
+            else
+            {
+                /* No thing */
+            }
+        }
+    }
+    isInitialized = (RET_ErrorStatus == SPI_BUS_OK);
+    return RET_ErrorStatus;
+}
+
+SPI_BUS_ErrorStatus_t SpiBus_Submit(SpiBus_Transfer_t * pTransfer)
+{
+    SPI_BUS_ErrorStatus_t RET_ErrorStatus = SPI_BUS_OK;
+    if(!isInitialized || pTransfer == NULL || !IS_SPI_BUS_DEVICE(pTransfer->Device) ||
+       pTransfer->Size == 0 || (pTransfer->pTxData == NULL && pTransfer->pRxData == NULL))
+    {
+        RET_ErrorStatus = SPI_BUS_ERROR;
+    }
+    else
+    {
+        uint8_t Bus = GetBus(SpiBusDevices[pTransfer->Device].Instance);
+        SpiBus_t * pBus = &Buses[Bus];
+        Lock(Bus);
+        pTransfer->pNext  = NULL;
+        pTransfer->Status = SPI_BUS_PENDING;
+        if(pBus->pTail != NULL)
+        {
+            pBus->pTail->pNext = pTransfer;
+        }
+        else
+        {
+            pBus->pHead = pTransfer;
+        }
+        pBus->pTail = pTransfer;
+        pBus->Stats.Pending += 1;
+        if(pBus->Stats.Pending > pBus->Stats.PeakPending)
+        {
+            pBus->Stats.PeakPending = pBus->Stats.Pending;
+        }
+        StartNext(pBus);
+        Unlock(Bus);
+    }
+    return RET_ErrorStatus;
+}
+
+SPI_BUS_ErrorStatus_t SpiBus_GetStats(uint8_t Device, SpiBus_Stats_t * pStats)
+{
+    SPI_BUS_ErrorStatus_t RET_ErrorStatus = SPI_BUS_OK;
+    if(!isInitialized || pStats == NULL || !IS_SPI_BUS_DEVICE(Device))
+    {
+        RET_ErrorStatus = SPI_BUS_ERROR;
+    }
+    else
+    {
+        uint8_t Bus = GetBus(SpiBusDevices[Device].Instance);
+        Lock(Bus);
+        *pStats = Buses[Bus].Stats;
+        Unlock(Bus);
+    }
+    return RET_ErrorStatus;
+}
+
+/******************************************************************************/
@@ -0,0 +1,74 @@
+/******************************************************************************/
+/**
+ * @file spi_bus_CFG.c
+ * @brief Devices of the shared SPI buses.
+ *
+ * @par Project Name
+ * stm32fxx services
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * Chip select and clock profile of every device of spi_bus_CFG.h. Devices
+ * given the same instance share its bus.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include "spi_bus.h"
+#include "stm32f4xx_gpio.h"
+#include "stm32f4xx_spi.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC CONSTANT DEFINITIONS */
+/******************************************************************************/
+
+/**
+ * @brief Device Configuration Array
+ *
+ * The TFT keeps the mode 3 and prescaler 2 of TFT_COM, the flash and the
+ * sensor share SPI1 with it.
+ */
+const SpiBus_Device_t SpiBusDevices[_SPI_BUS_DEVICES_NUM] =
+{
+    [SPI_BUS_TFT] =
+    {
+        .Instance          = SPI1,
+        .CSPort            = GPIO_PORTA,
+        .CSPin             = GPIO_PIN0,
+        .CLKPolarity       = SPI_POLARITY_HIGH,
+        .CLKPhase          = SPI_PHASE_SECOND_EDGE,
+        .BaudRatePrescaler = SPI_BAUDRATEPRESCALER_2,
+        .DataSize          = SPI_DATASIZE_8BIT
+    },
+    [SPI_BUS_FLASH] =
+    {
+        .Instance          = SPI1,
+        .CSPort            = GPIO_PORTA,
+        .CSPin             = GPIO_PIN4,
+        .CLKPolarity       = SPI_POLARITY_LOW,
+        .CLKPhase          = SPI_PHASE_FIRST_EDGE,
+        .BaudRatePrescaler = SPI_BAUDRATEPRESCALER_4,
+        .DataSize          = SPI_DATASIZE_8BIT
+    },
+    [SPI_BUS_SENSOR] =
+    {
+        .Instance          = SPI1,
+        .CSPort            = GPIO_PORTB,
+        .CSPin             = GPIO_PIN0,
+        .CLKPolarity       = SPI_POLARITY_HIGH,
+        .CLKPhase          = SPI_PHASE_SECOND_EDGE,
+        .BaudRatePrescaler = SPI_BAUDRATEPRESCALER_16,
+        .DataSize          = SPI_DATASIZE_16BIT
+    }
+};
+
+/******************************************************************************/
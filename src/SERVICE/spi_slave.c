@@ -0,0 +1,350 @@
+/******************************************************************************/
+/**
+ * @file spi_slave.c
+ * @brief Register map served by SPI1 as a slave.
+ *
+ * @par Project Name
+ * stm32fxx services
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * The map lives in Storage[1..], Storage[0] only fills the undefined first
+ * byte of an answer from register 0: the transmit stream is armed on
+ * &Storage[ReadAddress], so the second byte of a transaction is
+ * Map[ReadAddress]. RxStart is where the next transaction begins in the
+ * ring; the NSS interrupt takes the bytes up to the position of the
+ * receive stream, so no edge is needed at the start of a transaction.
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include "spi_slave.h"
+#include "stm32f4xx_exti.h"
+#include "stm32f4xx_gpio.h"
+#include "stm32f4xx_nvic.h"
+#include "stm32f4xx_rcc.h"
+#include "stm32f4xx_spi.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+
+#if (SPI_SLAVE_MAP_SIZE < 2U) || (SPI_SLAVE_MAP_SIZE > 128U)
+#error "SPI_SLAVE_MAP_SIZE must be 2 to 128"
+#endif
+
+#if (SPI_SLAVE_RX_RING_SIZE <= SPI_SLAVE_MAP_SIZE)
+#error "SPI_SLAVE_RX_RING_SIZE must be longer than a write of the whole map"
+#endif
+
+#define SPI_SLAVE_PINS          (4U)
+#define SPI_SLAVE_NSS_PORT      GPIO_PORTA
+#define SPI_SLAVE_NSS_PIN       GPIO_PIN4
+#define SPI_SLAVE_NSS_IRQ       EXTI4_IRQn
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE TYPES */
+/******************************************************************************/
+
+typedef struct
+{
+    uint8_t Pin;
+    uint8_t Type;
+} SpiSlave_Pin_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION PROTOTYPES */
+/******************************************************************************/
+static void Lock(void);
+static void Unlock(void);
+static void ArmAnswer(void);
+static void Parse(uint16_t End);
+static void TransactionEnd(void);
+static void Recover(void);
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE CONSTANT DEFINITIONS */
+/******************************************************************************/
+
+/* NSS, SCK, MISO and MOSI of SPI1 on port A */
+static const SpiSlave_Pin_t Pins[SPI_SLAVE_PINS] =
+{
+    {GPIO_PIN4, GPIO_AT_PullUp},
+    {GPIO_PIN5, GPIO_AT_PullDown},
+    {GPIO_PIN6, GPIO_AT_PushPull},
+    {GPIO_PIN7, GPIO_AT_PullDown}
+};
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+static SPI_Handle_t Handle;
+static uint8_t RxRing[SPI_SLAVE_RX_RING_SIZE];
+static uint8_t Storage[1U + SPI_SLAVE_MAP_SIZE];
+static uint8_t * const Map = &Storage[1];
+static uint16_t RxStart;
+static uint8_t ReadAddress;
+static SpiSlave_WriteCallBack_t WriteCB;
+static SpiSlave_ReadCallBack_t ReadCB;
+static SpiSlave_Stats_t Stats;
+static bool isInitialized = false;
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+/**
+ * Masked in the NVIC and not in EXTI: a line masked in EXTI_IMR does not
+ * latch its edge, an NSS edge meanwhile would be lost and two transactions
+ * parsed as one. The edge stays pending here and is served on unlock.
+ */
+static void Lock(void)
+{
+    NVIC_DisableIRQ(SPI_SLAVE_NSS_IRQ);
+}
+
+static void Unlock(void)
+{
+    NVIC_EnableIRQ(SPI_SLAVE_NSS_IRQ);
+}
+
+static void ArmAnswer(void)
+{
+    SPI_SlaveLoadDMA(&Handle, &Storage[ReadAddress], (uint16_t)(SPI_SLAVE_MAP_SIZE + 1U - ReadAddress));
+}
+
+/**
+ * @brief Applies the transaction received from RxStart to End.
+ * @note Called from the NSS interrupt.
+ */
+static void Parse(uint16_t End)
+{
+    uint16_t Length = (uint16_t)((End + SPI_SLAVE_RX_RING_SIZE - RxStart) % SPI_SLAVE_RX_RING_SIZE);
+    uint8_t Command = RxRing[RxStart];
+    uint8_t Address = Command & SPI_SLAVE_ADDRESS_MASK;
+    uint8_t Answered = ReadAddress;
+    Stats.Transactions += 1;
+    if((Command & SPI_SLAVE_READ) != 0U)
+    {
+        /* The answer matches the command only once the address was selected */
+        if(Address == Answered && Length > 1U)
+        {
+            uint16_t Size = Length - 1U;
+            if(Size > SPI_SLAVE_MAP_SIZE - Answered)
+            {
+                Size = SPI_SLAVE_MAP_SIZE - Answered;
+            }
+            Stats.Reads += 1;
+            if(ReadCB != NULL)
+            {
+                ReadCB(Answered, Size);
+            }
+        }
+        else
+        {
+            /* No thing */
+        }
+        if(Address < SPI_SLAVE_MAP_SIZE)
+        {
+            ReadAddress = Address;
+        }
+        else
+        {
+            /* No thing */
+        }
+    }
+    else
+    {
+        uint16_t Written = 0;
+        uint16_t Position = (RxStart + 1U) % SPI_SLAVE_RX_RING_SIZE;
+        for(uint16_t Byte = 1; Byte < Length; Byte++)
+        {
+            if(Address + Written < SPI_SLAVE_MAP_SIZE)
+            {
+                Map[Address + Written] = RxRing[Position];
+                Written++;
+            }
+            else
+            {
+                Stats.Dropped += 1;
+            }
+            Position = (Position + 1U) % SPI_SLAVE_RX_RING_SIZE;
+        }
+        Stats.Writes += 1;
+        if(WriteCB != NULL)
+        {
+            WriteCB(Address, &Map[(Address < SPI_SLAVE_MAP_SIZE) ? Address : SPI_SLAVE_MAP_SIZE], Written);
+        }
+    }
+    RxStart = End;
+}
+
+/**
+ * @brief Rising edge of NSS, the master ended a transaction.
+ */
+static void TransactionEnd(void)
+{
+    uint16_t End;
+    if(SPI_SlaveGetRxPosition(&Handle, &End) == SPI_OK && End != RxStart)
+    {
+        Parse(End);
+        ArmAnswer();
+    }
+    else
+    {
+        /* No thing */
+    }
+}
+
+/**
+ * @brief A stream failed, both were stopped by the SPI driver.
+ */
+static void Recover(void)
+{
+    Stats.Errors += 1;
+    SPI_SlaveStopDMA(&Handle);
+    RxStart = 0;
+    if(SPI_SlaveStartDMA(&Handle, RxRing, SPI_SLAVE_RX_RING_SIZE) == SPI_OK)
+    {
+        ArmAnswer();
+    }
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+SPI_SLAVE_ErrorStatus_t SpiSlave_Init(SpiSlave_WriteCallBack_t WriteCallBack,
+                                      SpiSlave_ReadCallBack_t ReadCallBack)
+{
+    SPI_SLAVE_ErrorStatus_t RET_ErrorStatus = SPI_SLAVE_OK;
+    gpioPin_t Pin;
+    EXTI_Config_t NSS;
+
+    RCC_enuEnablePeripheral(PERIPHERAL_GPIOA);
+    RCC_enuEnablePeripheral(PERIPHERAL_SPI1);
+    RCC_enuEnablePeripheral(PERIPHERAL_DMA2);
+    for(uint8_t Index = 0; Index < SPI_SLAVE_PINS && RET_ErrorStatus == SPI_SLAVE_OK; Index++)
+    {
+        Pin.GPIO_Port    = GPIO_PORTA;
+        Pin.GPIO_Pin     = Pins[Index].Pin;
+        Pin.GPIO_Mode    = GPIO_MODE_AF5;
+        Pin.GPIO_AT_Type = Pins[Index].Type;
+        Pin.GPIO_Speed   = GPIO_SPEED_VERY_HIGH;
+        if(GPIO_Init(&Pin) != GPIO_SUCCESS)
+        {
+            RET_ErrorStatus = SPI_SLAVE_ERROR;
+        }
+    }
+
+    if(RET_ErrorStatus == SPI_SLAVE_OK)
+    {
+        WriteCB     = WriteCallBack;
+        ReadCB      = ReadCallBack;
+        Stats       = (SpiSlave_Stats_t){0};
+        RxStart     = 0;
+        ReadAddress = 0;
+        Handle.Instance                = SPI1;
+        Handle.Init.Mode               = SPI_MODE_SLAVE;
+        Handle.Init.ByteOrder          = SPI_BYTEORDER_MSB;
+        Handle.Init.NSS                = SPI_NSS_HW_INPUT;
+        Handle.Init.CRCCalculation     = SPI_CRCCALCULATION_DISABLE;
+        Handle.Init.CRCPolynomial      = 7;
+        Handle.Init.CLKPolarity        = SPI_SLAVE_CLK_POLARITY;
+        Handle.Init.CLKPhase           = SPI_SLAVE_CLK_PHASE;
+        Handle.Init.BaudRatePrescaler  = SPI_BAUDRATEPRESCALER_2;
+        Handle.Init.DataSize           = SPI_DATASIZE_8BIT;
+        Handle.errorCallBack           = Recover;
+        NSS.Port     = SPI_SLAVE_NSS_PORT;
+        NSS.Pin      = SPI_SLAVE_NSS_PIN;
+        NSS.Trigger  = EXTI_TRIGGER_RISING;
+        NSS.CallBack = TransactionEnd;
+        if(SPI_Init(&Handle) != SPI_OK ||
+           SPI_SlaveStartDMA(&Handle, RxRing, SPI_SLAVE_RX_RING_SIZE) != SPI_OK)
+        {
+            RET_ErrorStatus = SPI_SLAVE_ERROR;
+        }
+        else
+        {
+            ArmAnswer();
+            NVIC_EnableIRQ(DMA2_Stream2_IRQn);
+            NVIC_EnableIRQ(DMA2_Stream3_IRQn);
+            if(EXTI_Init(&NSS) != EXTI_OK)
+            {
+                RET_ErrorStatus = SPI_SLAVE_ERROR;
+            }
+            else
+            {
+                isInitialized = true;
+            }
+        }
+    }
+    return RET_ErrorStatus;
+}
+
+SPI_SLAVE_ErrorStatus_t SpiSlave_SetRegisters(uint8_t Address, const uint8_t * pData, uint16_t Size)
+{
+    SPI_SLAVE_ErrorStatus_t RET_ErrorStatus = SPI_SLAVE_ERROR;
+    if(isInitialized && pData != NULL && Address < SPI_SLAVE_MAP_SIZE &&
+       Size <= SPI_SLAVE_MAP_SIZE - Address)
+    {
+        Lock();
+        for(uint16_t Index = 0; Index < Size; Index++)
+        {
+            Map[Address + Index] = pData[Index];
+        }
+        Unlock();
+        RET_ErrorStatus = SPI_SLAVE_OK;
+    }
+    return RET_ErrorStatus;
+}
+
+SPI_SLAVE_ErrorStatus_t SpiSlave_GetRegisters(uint8_t Address, uint8_t * pData, uint16_t Size)
+{
+    SPI_SLAVE_ErrorStatus_t RET_ErrorStatus = SPI_SLAVE_ERROR;
+    if(isInitialized && pData != NULL && Address < SPI_SLAVE_MAP_SIZE &&
+       Size <= SPI_SLAVE_MAP_SIZE - Address)
+    {
+        Lock();
+        for(uint16_t Index = 0; Index < Size; Index++)
+        {
+            pData[Index] = Map[Address + Index];
+        }
+        Unlock();
+        RET_ErrorStatus = SPI_SLAVE_OK;
+    }
+    return RET_ErrorStatus;
+}
+
+SPI_SLAVE_ErrorStatus_t SpiSlave_GetStats(SpiSlave_Stats_t * pStats)
+{
+    SPI_SLAVE_ErrorStatus_t RET_ErrorStatus = SPI_SLAVE_ERROR;
+    if(isInitialized && pStats != NULL)
+    {
+        Lock();
+        *pStats = Stats;
+        Unlock();
+        RET_ErrorStatus = SPI_SLAVE_OK;
+    }
+    return RET_ErrorStatus;
+}
+
+/******************************************************************************/
@@ -111,81 +111,21 @@
 #define DMA_SxFCR_FTH            DMA_SxFCR_FTH_Msk 
 
 
-#define DMA_HIFCR_CDMEIF7_Pos   (24)
-#define DMA_HIFCR_CDMEIF7_Msk   (0x1UL << DMA_HIFCR_CDMEIF7_Pos)                 
-#define DMA_HIFCR_CDMEIF7       DMA_HIFCR_CDMEIF7_Msk
-
-#define DMA_HISR_DMEIF7_Pos   (24)
-#define DMA_HISR_DMEIF7_Msk   (0x1UL << DMA_HISR_DMEIF7_Pos)                 
-#define DMA_HISR_DMEIF7       DMA_HISR_DMEIF7_Msk
-
-
-#define DMA_HIFCR_CTEIF7_Pos   (25)
-#define DMA_HIFCR_CTEIF7_Msk   (0x1UL << DMA_HIFCR_CTEIF7_Pos)                 
-#define DMA_HIFCR_CTEIF7       DMA_HIFCR_CTEIF7_Msk
-
-#define DMA_HISR_TEIF7_Pos   (25)
-#define DMA_HISR_TEIF7_Msk   (0x1UL << DMA_HISR_TEIF7_Pos)                 
-#define DMA_HISR_TEIF7       DMA_HISR_TEIF7_Msk
-
-
-#define DMA_HIFCR_CHTIF7_Pos   (26)
-#define DMA_HIFCR_CHTIF7_Msk   (0x1UL << DMA_HIFCR_CHTIF7_Pos)                 
-#define DMA_HIFCR_CHTIF7       DMA_HIFCR_CHTIF7_Msk
-
-#define DMA_HISR_HTIF7_Pos   (26)
-#define DMA_HISR_HTIF7_Msk  (0x1UL << DMA_HISR_HTIF7_Pos)                 
-#define DMA_HISR_HTIF7       DMA_HISR_HTIF7_Msk
-
-
-#define DMA_HIFCR_CTCIF7_Pos   (27)
-#define DMA_HIFCR_CTCIF7_Msk   (0x1UL << DMA_HIFCR_CTCIF7_Pos)                 
-#define DMA_HIFCR_CTCIF7       DMA_HIFCR_CTCIF7_Msk
-
-#define DMA_HISR_TCIF7_Pos   (27)
-#define DMA_HISR_TCIF7_Msk   (0x1UL << DMA_HISR_TCIF7_Pos)                 
-#define DMA_HISR_TCIF7       DMA_HISR_TCIF7_Msk
-
-
-#define DMA_HIFCR_CDMEIF5_Pos   (8U)
-#define DMA_HIFCR_CDMEIF5_Msk   (0x1UL << DMA_HIFCR_CDMEIF5_Pos)                 
-#define DMA_HIFCR_CDMEIF5       DMA_HIFCR_CDMEIF5_Msk
-
-#define DMA_HISR_DMEIF5_Pos   (8U)
-#define DMA_HISR_DMEIF5_Msk   (0x1UL << DMA_HISR_DMEIF5_Pos)                 
-#define DMA_HISR_DMEIF5       DMA_HISR_DMEIF5_Msk
-
-
-#define DMA_HIFCR_CTEIF5_Pos   (9U)
-#define DMA_HIFCR_CTEIF5_Msk   (0x1UL << DMA_HIFCR_CTEIF5_Pos)                 
-#define DMA_HIFCR_CTEIF5       DMA_HIFCR_CTEIF5_Msk
-
-#define DMA_HISR_TEIF5_Pos   (9U)
-#define DMA_HISR_TEIF5_Msk   (0x1UL << DMA_HISR_TEIF5_Pos)                 
-#define DMA_HISR_TEIF5       DMA_HISR_TEIF5_Msk
-
-
-#define DMA_HIFCR_CHTIF5_Pos   (10U)
-#define DMA_HIFCR_CHTIF5_Msk   (0x1UL << DMA_HIFCR_CHTIF5_Pos)                 
-#define DMA_HIFCR_CHTIF5       DMA_HIFCR_CHTIF5_Msk
-
-#define DMA_HISR_HTIF5_Pos   (10U)
-#define DMA_HISR_HTIF5_Msk  (0x1UL << DMA_HISR_HTIF5_Pos)                 
-#define DMA_HISR_HTIF5       DMA_HISR_HTIF5_Msk
-
-
-#define DMA_HIFCR_CTCIF5_Pos   (11U)
-#define DMA_HIFCR_CTCIF5_Msk   (0x1UL << DMA_HIFCR_CTCIF5_Pos)                 
-#define DMA_HIFCR_CTCIF5       DMA_HIFCR_CTCIF5_Msk
+#define NUMBER_OF_STREAMS   (8U)
+#define NUMBER_OF_DMA       (2U)
 
-#define DMA_HISR_TCIF5_Pos   (11U)
-#define DMA_HISR_TCIF5_Msk   (0x1UL << DMA_HISR_TCIF5_Pos)                 
-#define DMA_HISR_TCIF5       DMA_HISR_TCIF5_Msk
+/* Stream interrupt enable bits in FCR */
+#define DMA_SxFCR_FEIE      (0x1UL << 7)
 
+/* Flags of a stream in LISR/HISR and LIFCR/HIFCR, before the shift of the stream */
+#define DMA_FLAG_FEIF       (0x01UL)
+#define DMA_FLAG_DMEIF      (0x04UL)
+#define DMA_FLAG_TEIF       (0x08UL)
+#define DMA_FLAG_HTIF       (0x10UL)
+#define DMA_FLAG_TCIF       (0x20UL)
+#define DMA_FLAGS_ALL       (0x3DUL)
 
-#define NUMBER_OF_STREAMS   (8U)
-#define STREAM_7            (7U)
-#define STREAM_5            (5U)
+#define DMA_FIFO_BYTES      (16UL)          /**< Depth of the FIFO of a stream */
 /******************************************************************************/
 
 /******************************************************************************/
@@ -195,6 +135,10 @@
 /******************************************************************************/
 
 
+/* Registers of stream 0 to 7 of DMA1 or DMA2 */
+#define DMA_STREAM_REGISTERS(INSTANCE, STREAM) \
+                ((DMA_Stream_t *)((uint32_t)(INSTANCE) + 0x10U + (0x18U * (uint32_t)(STREAM))))
+
 #define IS_DMA_CHANNEL(CHANNEL) (((CHANNEL) == DMA_CHANNEL_0) || \
                                  ((CHANNEL) == DMA_CHANNEL_1) || \
                                  ((CHANNEL) == DMA_CHANNEL_2) || \
@@ -219,6 +163,10 @@
                                      ((DIRECTION) == DMA_MEMORY_TO_PERIPH) || \
                                      ((DIRECTION) == DMA_MEMORY_TO_MEMORY))
 
+/* Only DMA2 reaches both memory ports, and it stops after one pass */
+#define IS_DMA_DIRECTION_SUPPORTED(BASE, DIRECTION, MODE) (((DIRECTION) != DMA_MEMORY_TO_MEMORY) || \
+                                                           (((BASE) == DMA2) && ((MODE) == DMA_NORMAL)))
+
 #define IS_DMA_TRANSFER_MODE(MODE) (((MODE) == DMA_NORMAL) || \
                                     ((MODE) == DMA_CIRCULAR) || \
                                     ((MODE) == DMA_PFCTRL))
@@ -265,8 +213,19 @@
 
 #define IS_NULL_PARAM(PARAM) ((PARAM) == NULL)
 
+/* Bytes of one burst: beats of MBURST/PBURST times the bytes of MSIZE/PSIZE */
+#define DMA_BURST_BYTES(BURST, BURST_POS, SIZE, SIZE_POS) \
+            (BurstBeats[((BURST) >> (BURST_POS)) & 0x3U] * (1UL << (((SIZE) >> (SIZE_POS)) & 0x3U)))
+
+/* Bytes in the FIFO when it reaches a threshold, a quarter of 16 bytes per step */
+#define DMA_FIFO_THRESHOLD_BYTES(THRESHOLD)     ((((THRESHOLD) & DMA_SxFCR_FTH) + 1UL) * 4UL)
 
-#define IS_DMA_BUSY(STATUS) (STATUS == DMA_STATE_BUSY)
+/* NDTR is 16 bits wide, 0 would not start the stream */
+#define IS_DMA_LENGTH(LENGTH) (((LENGTH) != 0U) && ((LENGTH) <= 0xFFFFU))
+
+
+/* A half done transfer still runs */
+#define IS_DMA_BUSY(STATUS) (((STATUS) == DMA_STATE_BUSY) || ((STATUS) == DMA_STATE_HALF))
 
 
 /******************************************************************************/
@@ -308,14 +267,25 @@ typedef struct
 /* PRIVATE CONSTANT DEFINITIONS */
 /******************************************************************************/
 
+static void * const Controllers[NUMBER_OF_DMA] = {DMA1, DMA2};
+
+/* Beats of a burst for each value of MBURST and PBURST */
+static const uint8_t BurstBeats[4] = {1U, 4U, 8U, 16U};
+
 
 /******************************************************************************/
 
 /******************************************************************************/
 /* PRIVATE VARIABLE DEFINITIONS */
 /******************************************************************************/
-static DMA_Handle_t * HandlesDMA2[NUMBER_OF_STREAMS] = {0};
-static DMA_Handle_t * HandlesDMA1[NUMBER_OF_STREAMS] = {0};
+/** @brief Handle given to DMA_Init for each stream, DMA1 then DMA2 */
+static DMA_Handle_t * Handles[NUMBER_OF_DMA][NUMBER_OF_STREAMS] = {0};
+
+/**
+ * @brief Position of the flags of each stream, streams 0 to 3 in LISR and
+ *        4 to 7 at the same places in HISR
+ */
+static const uint8_t StreamFlagsShift[NUMBER_OF_STREAMS / 2U] = {0U, 6U, 16U, 22U};
 /******************************************************************************/
 
 /******************************************************************************/
@@ -334,13 +304,178 @@ static DMA_Handle_t * HandlesDMA1[NUMBER_OF_STREAMS] = {0};
 /* PRIVATE FUNCTION PROTOTYPES */
 /******************************************************************************/
 
+/**
+ * @brief Serves the interrupt of one stream: clears its flags, then calls
+ *        the callbacks of its handle for the enabled ones
+ * @param Controller 0 for DMA1, 1 for DMA2
+ * @param Stream     Stream number, 0 to 7
+ */
+static void DMA_IRQStream(uint8_t Controller, uint8_t Stream);
+
+/**
+ * @brief Checks the FIFO threshold and the bursts of a configuration
+ *
+ * In direct mode the hardware forces single transfers, bursts are refused,
+ * and so is memory to memory, which needs the FIFO. In FIFO mode a burst
+ * must fit in the 16 bytes of the FIFO and a memory burst must divide the
+ * threshold, so a threshold is always a whole number of bursts.
+ *
+ * @return DMA_OK, or DMA_ERROR for a forbidden combination
+ */
+static DMA_ErrorStatus_t DMA_CheckFifo(const DMA_Init_t * pInit);
+
+/**
+ * @brief Enables the interrupts of a transfer about to start and clears
+ *        the errors of the last one
+ * @return CR of the stream with the interrupt enable bits set, to be written
+ */
+static uint32_t DMA_TransferInterrupts(DMA_Handle_t * pHandleDMA, DMA_Stream_t * stream);
+
 /******************************************************************************/
 
 /******************************************************************************/
 /* PRIVATE FUNCTION DEFINITIONS */
 /******************************************************************************/
+
+static void DMA_IRQStream(uint8_t Controller, uint8_t Stream)
+{
+    DMA_t * instance = (DMA_t *)Controllers[Controller];
+    DMA_Stream_t * stream = DMA_STREAM_REGISTERS(instance, Stream);
+    uint8_t Shift = StreamFlagsShift[Stream & 0x3U];
+    __IOM uint32_t * pISR  = (Stream < 4U) ? &instance->LISR  : &instance->HISR;
+    __IOM uint32_t * pIFCR = (Stream < 4U) ? &instance->LIFCR : &instance->HIFCR;
+    uint32_t Flags = (*pISR >> Shift) & DMA_FLAGS_ALL;
+    uint32_t CR = stream->CR;
+    DMA_Handle_t * pHandle = Handles[Controller][Stream];
+
+    /* Cleared first, the callbacks may start the next transfer */
+    *pIFCR = Flags << Shift;
+    /* A flag whose interrupt is off was not asked for */
+    if((CR & DMA_SxCR_HTIE) == 0U)
+    {
+        Flags &= ~DMA_FLAG_HTIF;
+    }
+    if((CR & DMA_SxCR_TCIE) == 0U)
+    {
+        Flags &= ~DMA_FLAG_TCIF;
+    }
+    if((CR & DMA_SxCR_DMEIE) == 0U)
+    {
+        Flags &= ~DMA_FLAG_DMEIF;
+    }
+    if((stream->FCR & DMA_SxFCR_FEIE) == 0U)
+    {
+        Flags &= ~DMA_FLAG_FEIF;
+    }
+    if(pHandle != NULL)
+    {
+        /* The next piece of a chain is started first, the peripheral waits for it */
+        if((Flags & (DMA_FLAG_TCIF | DMA_FLAG_TEIF)) == DMA_FLAG_TCIF && pHandle->pSegments != NULL &&
+           (pHandle->Segment + 1U) < pHandle->Segments)
+        {
+            const DMA_Segment_t * pNext = &pHandle->pSegments[pHandle->Segment + 1U];
+            stream->M0AR = (uint32_t)pNext->pMemory;
+            stream->NDTR = pNext->Length;
+            stream->CR   = CR | DMA_SxCR_EN;
+            pHandle->Length   = pNext->Length;
+            pHandle->Segment += 1U;
+            Flags &= ~DMA_FLAG_TCIF;
+        }
+        /* Set before the callbacks, they may start the next transfer */
+        else if(Flags & DMA_FLAG_TEIF)
+        {
+            pHandle->State = DMA_STATE_ERROR;
+        }
+        else if(Flags & DMA_FLAG_TCIF)
+        {
+            pHandle->State = (CR & (DMA_SxCR_CIRC | DMA_SxCR_DBM)) ? DMA_STATE_BUSY : DMA_STATE_READY;
+        }
+        else if(Flags & DMA_FLAG_HTIF)
+        {
+            pHandle->State = DMA_STATE_HALF;
+        }
+        else
+        {
+            /* No thing */
+        }
+        /* The stream goes on after a FIFO or direct mode error, they are only recorded */
+        if(Flags & DMA_FLAG_FEIF)
+        {
+            pHandle->ErrorCode |= DMA_ERROR_FE;
+        }
+        if(Flags & DMA_FLAG_DMEIF)
+        {
+            pHandle->ErrorCode |= DMA_ERROR_DME;
+        }
+        /* Half first, both are set when a short transfer is served late */
+        if((Flags & DMA_FLAG_HTIF) && pHandle->HalfTransferCallBack != NULL)
+        {
+            pHandle->HalfTransferCallBack();
+        }
+        if((Flags & DMA_FLAG_TCIF) && pHandle->CompleteTransferCallBack != NULL)
+        {
+            pHandle->CompleteTransferCallBack();
+        }
+        if(Flags & DMA_FLAG_TEIF)
+        {
+            /* The hardware disabled the stream */
+            pHandle->ErrorCode |= DMA_ERROR_TE;
+            if(pHandle->ErrorTransferCallBack != NULL)
+            {
+                pHandle->ErrorTransferCallBack();
+            }
+        }
+    }
+}
 /******************************************************************************/
 
+static DMA_ErrorStatus_t DMA_CheckFifo(const DMA_Init_t * pInit)
+{
+    DMA_ErrorStatus_t RET_ErrorStatus = DMA_OK;
+    if(pInit->FIFOMode == DMA_FIFOMODE_DISABLE)
+    {
+        if(pInit->MemBurst != DMA_MBURST_SINGLE || pInit->PeriphBurst != DMA_PBURST_SINGLE ||
+           pInit->Direction == DMA_MEMORY_TO_MEMORY)
+        {
+            RET_ErrorStatus = DMA_ERROR;
+        }
+    }
+    else
+    {
+        uint32_t Threshold   = DMA_FIFO_THRESHOLD_BYTES(pInit->FIFOThreshold);
+        uint32_t MemBurst    = DMA_BURST_BYTES(pInit->MemBurst, DMA_SxCR_MBURST_Pos,
+                                               pInit->MemAlignment, DMA_SxCR_MSIZE_Pos);
+        uint32_t PeriphBurst = DMA_BURST_BYTES(pInit->PeriphBurst, DMA_SxCR_PBURST_Pos,
+                                               pInit->PerAlignment, DMA_SxCR_PSIZE_Pos);
+        if(!IS_DMA_FIFO_THRESHOLD(pInit->FIFOThreshold) || PeriphBurst > DMA_FIFO_BYTES ||
+           (pInit->MemBurst != DMA_MBURST_SINGLE && (MemBurst > Threshold || (Threshold % MemBurst) != 0U)))
+        {
+            RET_ErrorStatus = DMA_ERROR;
+        }
+    }
+    return RET_ErrorStatus;
+}
+
+static uint32_t DMA_TransferInterrupts(DMA_Handle_t * pHandleDMA, DMA_Stream_t * stream)
+{
+    uint32_t Temp = stream->CR;
+    Temp |= (DMA_IT_TC | DMA_IT_TE | DMA_IT_HT);
+    pHandleDMA->ErrorCode = DMA_ERROR_NONE;
+    /* Set again by DMA_StartChain */
+    pHandleDMA->pSegments = NULL;
+    pHandleDMA->Segments  = 0U;
+    pHandleDMA->Segment   = 0U;
+    /* Only one of the FIFO and direct mode errors can happen */
+    if(pHandleDMA->Initialization.FIFOMode == DMA_FIFOMODE_ENABLE)
+    {
+        stream->FCR |= DMA_SxFCR_FEIE;
+    }
+    else
+    {
+        Temp |= DMA_IT_DME;
+    }
+    return Temp;
+}
 /******************************************************************************/
 /* PUBLIC FUNCTION DEFINITIONS */
 /******************************************************************************/
@@ -353,6 +488,8 @@ DMA_ErrorStatus_t DMA_Init(DMA_Handle_t * pHandleDMA, uint32_t TimeOut)
         IS_DMA_BASE_ADDRESS(pHandleDMA->Instance) &&
         IS_DMA_STREAM(pHandleDMA->Stream) &&
         IS_DMA_DIRECTION(pHandleDMA->Initialization.Direction) &&
+        IS_DMA_DIRECTION_SUPPORTED(pHandleDMA->Instance, pHandleDMA->Initialization.Direction,
+                                   pHandleDMA->Initialization.Mode) &&
         IS_DMA_CHANNEL(pHandleDMA->Initialization.Channel) &&
         IS_DMA_TRANSFER_MODE(pHandleDMA->Initialization.Mode) &&
         IS_DMA_MEMORY_BURST_SIZE(pHandleDMA->Initialization.MemBurst) &&
@@ -362,16 +499,18 @@ DMA_ErrorStatus_t DMA_Init(DMA_Handle_t * pHandleDMA, uint32_t TimeOut)
         IS_DMA_PERIPHERAL_DATA_ALIGNMENT(pHandleDMA->Initialization.PerAlignment) &&
         IS_DMA_PERIPHERAL_BURST_SIZE(pHandleDMA->Initialization.PeriphBurst) &&
         IS_DMA_PERIPHERAL_INCREMENT_MODE(pHandleDMA->Initialization.PeriphInc) &&
-        IS_DMA_FIFO_MODE(pHandleDMA->Initialization.FIFOMode) )
+        IS_DMA_FIFO_MODE(pHandleDMA->Initialization.FIFOMode) &&
+        DMA_CheckFifo(&pHandleDMA->Initialization) == DMA_OK )
     {
-        pHandleDMA->State = DMA_STATE_BUSY;
-
         /** get the stream which will configured */
         DMA_Stream_t * stream = (DMA_Stream_t *)((uint32_t)pHandleDMA->Instance + 
                                                  ((uint32_t)(pHandleDMA->Stream) >> 4));
-        /** Check if the stram not busy */
-        while ((stream->CR & DMA_SxCR_EN) == DMA_BUSY && TimeOut--);
-        if(TimeOut == 0)
+        /** Check if the stram not busy, the state is kept if it stays busy */
+        while ((stream->CR & DMA_SxCR_EN) && TimeOut)
+        {
+            TimeOut--;
+        }
+        if(stream->CR & DMA_SxCR_EN)
         {
             RET_ErrorStatus = DMA_TIMEOUT;
         }
@@ -386,9 +525,9 @@ DMA_ErrorStatus_t DMA_Init(DMA_Handle_t * pHandleDMA, uint32_t TimeOut)
             /** set the new configuration */
             Temp |= (pHandleDMA->Initialization.Channel     | pHandleDMA->Initialization.Priority     |
                      pHandleDMA->Initialization.Direction   | pHandleDMA->Initialization.Mode         |
-                     pHandleDMA->Initialization.MemInc      | pHandleDMA->Initialization.PerAlignment |
-                     pHandleDMA->Initialization.PeriphBurst | pHandleDMA->Initialization.MemAlignment );
-                     
+                     pHandleDMA->Initialization.MemInc      | pHandleDMA->Initialization.PeriphInc    |
+                     pHandleDMA->Initialization.MemAlignment | pHandleDMA->Initialization.PerAlignment );
+            /** Bursts exist only in FIFO mode, DMA_CheckFifo refused them in direct mode */
             if(pHandleDMA->Initialization.FIFOMode == DMA_FIFOMODE_ENABLE)
             {
                 Temp |= (pHandleDMA->Initialization.MemBurst | pHandleDMA->Initialization.PeriphBurst);
@@ -402,14 +541,7 @@ DMA_ErrorStatus_t DMA_Init(DMA_Handle_t * pHandleDMA, uint32_t TimeOut)
             }
             stream->FCR = Temp;
             pHandleDMA->State = DMA_STATE_READY;
-            if(pHandleDMA->Instance == DMA2)
-            {
-                HandlesDMA2[(pHandleDMA->Stream &0x00F)] = pHandleDMA;
-            }
-            else
-            {
-                HandlesDMA1[(pHandleDMA->Stream &0x00F)] = pHandleDMA;
-            }
+            Handles[(pHandleDMA->Instance == DMA2) ? 1U : 0U][(pHandleDMA->Stream &0x00F)] = pHandleDMA;
         }
     }
     else
@@ -419,6 +551,44 @@ DMA_ErrorStatus_t DMA_Init(DMA_Handle_t * pHandleDMA, uint32_t TimeOut)
     return RET_ErrorStatus;
 }
 
+DMA_ErrorStatus_t DMA_ConfigFifo(DMA_Handle_t * pHandleDMA, uint32_t Threshold,
+                                 uint32_t MemBurst, uint32_t PeriphBurst)
+{
+    DMA_ErrorStatus_t RET_ErrorStatus = DMA_OK;
+    DMA_Init_t Init;
+    if(IS_NULL_PARAM(pHandleDMA) || !IS_DMA_BASE_ADDRESS(pHandleDMA->Instance) ||
+       !IS_DMA_STREAM(pHandleDMA->Stream) || !IS_DMA_MEMORY_BURST_SIZE(MemBurst) ||
+       !IS_DMA_PERIPHERAL_BURST_SIZE(PeriphBurst))
+    {
+        RET_ErrorStatus = DMA_ERROR;
+    }
+    else
+    {
+        DMA_Stream_t * stream = (DMA_Stream_t *)((uint32_t)pHandleDMA->Instance + 
+                                                 (uint32_t)(pHandleDMA->Stream >> 4));
+        Init               = pHandleDMA->Initialization;
+        Init.FIFOMode      = DMA_FIFOMODE_ENABLE;
+        Init.FIFOThreshold = Threshold;
+        Init.MemBurst      = MemBurst;
+        Init.PeriphBurst   = PeriphBurst;
+        if(DMA_CheckFifo(&Init) != DMA_OK)
+        {
+            RET_ErrorStatus = DMA_ERROR;
+        }
+        else if(IS_DMA_BUSY(pHandleDMA->State) || (stream->CR & DMA_SxCR_EN))
+        {
+            RET_ErrorStatus = DMA_BUSY;
+        }
+        else
+        {
+            pHandleDMA->Initialization = Init;
+            stream->CR  = (stream->CR & ~(DMA_SxCR_MBURST | DMA_SxCR_PBURST)) | MemBurst | PeriphBurst;
+            stream->FCR = (stream->FCR & ~(DMA_SxFCR_DMDIS | DMA_SxFCR_FTH)) | Threshold | DMA_FIFOMODE_ENABLE;
+        }
+    }
+    return RET_ErrorStatus;
+}
+
 DMA_ErrorStatus_t DMA_RegisterCallBack(DMA_Handle_t *pHandleDMA, 
                                             DMA_InterruptId IntId,void (*CallBack)(void))
 {
@@ -499,6 +669,107 @@ DMA_ErrorStatus_t DMA_GetState(DMA_Handle_t *pHandleDMA, DMA_States_t * state)
     return RET_ErrorStatus;
 }
 
+DMA_ErrorStatus_t DMA_GetProgress(DMA_Handle_t *pHandleDMA, uint32_t * pDone)
+{
+    DMA_ErrorStatus_t RET_ErrorStatus = DMA_OK;
+    if(IS_NULL_PARAM(pHandleDMA) || IS_NULL_PARAM(pDone))
+    {
+        RET_ErrorStatus = DMA_ERROR;
+    }
+    else
+    {
+        DMA_Stream_t * stream = (DMA_Stream_t *)((uint32_t)pHandleDMA->Instance + 
+                                                 (uint32_t)(pHandleDMA->Stream >> 4));
+        uint32_t Segment;
+        uint32_t Length;
+        uint32_t Remaining;
+        /* The interrupt may move a chain to its next piece between the reads */
+        do
+        {
+            Segment   = pHandleDMA->Segment;
+            Length    = pHandleDMA->Length;
+            Remaining = stream->NDTR;
+        } while(Segment != pHandleDMA->Segment);
+        *pDone = (Remaining <= Length) ? (Length - Remaining) : 0U;
+        for(uint32_t Piece = 0; pHandleDMA->pSegments != NULL && Piece < Segment; Piece++)
+        {
+            *pDone += pHandleDMA->pSegments[Piece].Length;
+        }
+    }
+    return RET_ErrorStatus;
+}
+
+DMA_ErrorStatus_t DMA_GetError(DMA_Handle_t *pHandleDMA, uint32_t * pError)
+{
+    DMA_ErrorStatus_t RET_ErrorStatus = DMA_OK;
+    if(IS_NULL_PARAM(pHandleDMA) || IS_NULL_PARAM(pError))
+    {
+        RET_ErrorStatus = DMA_ERROR;
+    }
+    else
+    {
+        *pError = pHandleDMA->ErrorCode;
+    }
+    return RET_ErrorStatus;
+}
+
+DMA_ErrorStatus_t DMA_GetCounter(DMA_Handle_t *pHandleDMA, uint32_t * pCounter)
+{
+    DMA_ErrorStatus_t RET_ErrorStatus = DMA_OK;
+    if(IS_NULL_PARAM(pHandleDMA) || IS_NULL_PARAM(pCounter))
+    {
+        RET_ErrorStatus = DMA_ERROR;
+    }
+    else
+    {
+        DMA_Stream_t * stream = (DMA_Stream_t *)((uint32_t)pHandleDMA->Instance + 
+                                                 (uint32_t)(pHandleDMA->Stream >> 4));
+        *pCounter = stream->NDTR;
+    }
+    return RET_ErrorStatus;
+}
+
+DMA_ErrorStatus_t DMA_Abort(DMA_Handle_t *pHandleDMA, uint32_t TimeOut)
+{
+    DMA_ErrorStatus_t RET_ErrorStatus = DMA_OK;
+    if(IS_NULL_PARAM(pHandleDMA) || !IS_DMA_BASE_ADDRESS(pHandleDMA->Instance) ||
+       !IS_DMA_STREAM(pHandleDMA->Stream))
+    {
+        RET_ErrorStatus = DMA_ERROR;
+    }
+    else
+    {
+        DMA_t * instance = (DMA_t *)pHandleDMA->Instance;
+        uint8_t Stream = (uint8_t)(pHandleDMA->Stream & 0x00F);
+        DMA_Stream_t * stream = (DMA_Stream_t *)((uint32_t)pHandleDMA->Instance + 
+                                                 (uint32_t)(pHandleDMA->Stream >> 4));
+        stream->CR &= ~(DMA_IT_TC | DMA_IT_TE | DMA_IT_HT | DMA_IT_DME | DMA_SxCR_EN);
+        stream->FCR &= ~DMA_SxFCR_FEIE;
+        /** The stream ends its current beat before EN reads 0 */
+        while ((stream->CR & DMA_SxCR_EN) && TimeOut)
+        {
+            TimeOut--;
+        }
+        if(stream->CR & DMA_SxCR_EN)
+        {
+            RET_ErrorStatus = DMA_TIMEOUT;
+        }
+        else
+        {
+            if(Stream < 4U)
+            {
+                instance->LIFCR = DMA_FLAGS_ALL << StreamFlagsShift[Stream];
+            }
+            else
+            {
+                instance->HIFCR = DMA_FLAGS_ALL << StreamFlagsShift[Stream & 0x3U];
+            }
+            pHandleDMA->State = DMA_STATE_READY;
+        }
+    }
+    return RET_ErrorStatus;
+}
+
 DMA_ErrorStatus_t DMA_StartInterrupt(DMA_Handle_t * pHandleDMA,void * srcAddress,
                                    void * destAddress , uint32_t DataLength)
 {
@@ -507,19 +778,22 @@ DMA_ErrorStatus_t DMA_StartInterrupt(DMA_Handle_t * pHandleDMA,void * srcAddress
     {
         RET_ErrorStatus = DMA_ERROR;
     }
-    else if(pHandleDMA->State == DMA_STATE_BUSY)
+    else if(IS_DMA_BUSY(pHandleDMA->State))
     {
         RET_ErrorStatus = DMA_BUSY;
     }
     else
     {
-        pHandleDMA->State = DMA_BUSY;
+        pHandleDMA->State  = DMA_STATE_BUSY;
+        pHandleDMA->Length = DataLength;
         DMA_Stream_t * stream = (DMA_Stream_t *)((uint32_t)pHandleDMA->Instance + 
                                                  (uint32_t)(pHandleDMA->Stream >> 4));
-        uint32_t Temp = stream->CR;
-        Temp |= (DMA_IT_TC | DMA_IT_TE | DMA_IT_HT);
+        uint32_t Temp = DMA_TransferInterrupts(pHandleDMA, stream);
+        /* Left by DMA_StartDoubleBuffer */
+        Temp &= ~(DMA_SxCR_DBM | DMA_SxCR_CT);
         stream->CR = Temp;
-        if(pHandleDMA->Initialization.Direction == DMA_PERIPH_TO_MEMORY)
+        /* The peripheral port is the source of a memory to memory transfer */
+        if(pHandleDMA->Initialization.Direction != DMA_MEMORY_TO_PERIPH)
         {
             stream->PAR  = (uint32_t)srcAddress;
             stream->M0AR = (uint32_t)destAddress; 
@@ -535,63 +809,223 @@ DMA_ErrorStatus_t DMA_StartInterrupt(DMA_Handle_t * pHandleDMA,void * srcAddress
     return RET_ErrorStatus;
 }
 
-void DMA2_Stream7_IRQHandler(void)
+DMA_ErrorStatus_t DMA_StartDoubleBuffer(DMA_Handle_t * pHandleDMA, void * pPeripheral,
+                                        void * pBuffer0, void * pBuffer1, uint32_t DataLength)
 {
-    DMA_t * instance = ((DMA_t*)DMA2);
-    if((instance->HISR & DMA_HISR_TCIF7 )== DMA_HISR_TCIF7)
+    DMA_ErrorStatus_t RET_ErrorStatus = DMA_OK;
+    if(IS_NULL_PARAM(pHandleDMA) || IS_NULL_PARAM(pPeripheral) || IS_NULL_PARAM(pBuffer0) ||
+       IS_NULL_PARAM(pBuffer1) || DataLength == 0U ||
+       pHandleDMA->Initialization.Direction == DMA_MEMORY_TO_MEMORY)
     {
-        if(HandlesDMA2[STREAM_7]->CompleteTransferCallBack != NULL)
-        {
-            HandlesDMA2[STREAM_7]->CompleteTransferCallBack();
-        }
-        instance->HIFCR |= DMA_HIFCR_CTCIF7;
+        RET_ErrorStatus = DMA_ERROR;
     }
-    if((instance->HISR & DMA_HISR_HTIF7) == DMA_HISR_HTIF7)
+    else if(IS_DMA_BUSY(pHandleDMA->State))
     {
-        if(HandlesDMA2[STREAM_7]->HalfTransferCallBack != NULL)
-        {
-            HandlesDMA2[STREAM_7]->HalfTransferCallBack();
-        }
-        instance->HIFCR |= DMA_HIFCR_CHTIF7;
+        RET_ErrorStatus = DMA_BUSY;
     }
-    if((instance->HISR & DMA_HISR_TEIF7) == DMA_HISR_TEIF7)
+    else
     {
-        if(HandlesDMA2[STREAM_7]->ErrorTransferCallBack != NULL)
-        {
-            HandlesDMA2[STREAM_7]->ErrorTransferCallBack();
-        }
-        instance->HIFCR |= DMA_HIFCR_CTEIF7;
+        pHandleDMA->State  = DMA_STATE_BUSY;
+        pHandleDMA->Length = DataLength;
+        DMA_Stream_t * stream = (DMA_Stream_t *)((uint32_t)pHandleDMA->Instance + 
+                                                 (uint32_t)(pHandleDMA->Stream >> 4));
+        uint32_t Temp = DMA_TransferInterrupts(pHandleDMA, stream);
+        /* The hardware runs circular in double buffer mode, buffer 0 first */
+        Temp &= ~DMA_SxCR_CT;
+        Temp |= DMA_SxCR_DBM;
+        stream->CR   = Temp;
+        stream->PAR  = (uint32_t)pPeripheral;
+        stream->M0AR = (uint32_t)pBuffer0;
+        stream->M1AR = (uint32_t)pBuffer1;
+        stream->NDTR = DataLength;
+        stream->CR |= DMA_SxCR_EN;
     }
-    instance->HIFCR |= 0x0F400000;
+    return RET_ErrorStatus;
 }
 
-void DMA2_Stream5_IRQHandler(void)
+DMA_ErrorStatus_t DMA_GetCurrentTarget(DMA_Handle_t * pHandleDMA, uint8_t * pTarget)
 {
-    DMA_t * instance = ((DMA_t*)DMA2);
-    if((instance->HISR & DMA_HISR_TCIF5 )== DMA_HISR_TCIF5)
+    DMA_ErrorStatus_t RET_ErrorStatus = DMA_OK;
+    if(IS_NULL_PARAM(pHandleDMA) || IS_NULL_PARAM(pTarget))
     {
-        instance->HIFCR |= DMA_HIFCR_CTCIF5;
-        if(HandlesDMA2[STREAM_5]->CompleteTransferCallBack != NULL)
-        {
-            HandlesDMA2[STREAM_5]->CompleteTransferCallBack();
-        }
+        RET_ErrorStatus = DMA_ERROR;
     }
-    if((instance->HISR & DMA_HISR_HTIF5) == DMA_HISR_HTIF5)
+    else
     {
-        instance->HIFCR |= DMA_HIFCR_CHTIF5; 
-        if(HandlesDMA2[STREAM_5]->HalfTransferCallBack != NULL)
+        DMA_Stream_t * stream = (DMA_Stream_t *)((uint32_t)pHandleDMA->Instance + 
+                                                 (uint32_t)(pHandleDMA->Stream >> 4));
+        *pTarget = ((stream->CR & DMA_SxCR_CT) != 0U) ? DMA_BUFFER_1 : DMA_BUFFER_0;
+    }
+    return RET_ErrorStatus;
+}
+
+DMA_ErrorStatus_t DMA_SetBuffer(DMA_Handle_t * pHandleDMA, uint8_t Target, void * pBuffer)
+{
+    DMA_ErrorStatus_t RET_ErrorStatus = DMA_OK;
+    if(IS_NULL_PARAM(pHandleDMA) || IS_NULL_PARAM(pBuffer) ||
+       (Target != DMA_BUFFER_0 && Target != DMA_BUFFER_1))
+    {
+        RET_ErrorStatus = DMA_ERROR;
+    }
+    else
+    {
+        DMA_Stream_t * stream = (DMA_Stream_t *)((uint32_t)pHandleDMA->Instance + 
+                                                 (uint32_t)(pHandleDMA->Stream >> 4));
+        uint32_t CR = stream->CR;
+        uint8_t Current = ((CR & DMA_SxCR_CT) != 0U) ? DMA_BUFFER_1 : DMA_BUFFER_0;
+        /** The hardware ignores a write to the address it works on */
+        if((CR & DMA_SxCR_EN) != 0U && Target == Current)
+        {
+            RET_ErrorStatus = DMA_BUSY;
+        }
+        else if(Target == DMA_BUFFER_0)
         {
-            HandlesDMA2[STREAM_5]->HalfTransferCallBack();
+            stream->M0AR = (uint32_t)pBuffer;
+        }
+        else
+        {
+            stream->M1AR = (uint32_t)pBuffer;
         }
     }
-    if((instance->HISR & DMA_HISR_TEIF5) == DMA_HISR_TEIF5)
+    return RET_ErrorStatus;
+}
+
+DMA_ErrorStatus_t DMA_StartChain(DMA_Handle_t * pHandleDMA, void * pPeripheral,
+                                 const DMA_Segment_t * pSegments, uint32_t Segments)
+{
+    DMA_ErrorStatus_t RET_ErrorStatus = DMA_OK;
+    uint32_t Checked = 0;
+    if(!IS_NULL_PARAM(pSegments))
     {
-        instance->HIFCR |= DMA_HIFCR_CTEIF5;
-        if(HandlesDMA2[STREAM_5]->ErrorTransferCallBack != NULL)
+        while(Checked < Segments && !IS_NULL_PARAM(pSegments[Checked].pMemory) &&
+              IS_DMA_LENGTH(pSegments[Checked].Length))
         {
-            HandlesDMA2[STREAM_5]->ErrorTransferCallBack();
+            Checked++;
         }
     }
-    instance->HIFCR |= 0x00000F40;
+    if(IS_NULL_PARAM(pHandleDMA) || IS_NULL_PARAM(pPeripheral) || IS_NULL_PARAM(pSegments) ||
+       Segments == 0U || Checked != Segments ||
+       pHandleDMA->Initialization.Direction == DMA_MEMORY_TO_MEMORY ||
+       pHandleDMA->Initialization.Mode != DMA_NORMAL)
+    {
+        RET_ErrorStatus = DMA_ERROR;
+    }
+    else if(IS_DMA_BUSY(pHandleDMA->State))
+    {
+        RET_ErrorStatus = DMA_BUSY;
+    }
+    else
+    {
+        pHandleDMA->State = DMA_STATE_BUSY;
+        DMA_Stream_t * stream = (DMA_Stream_t *)((uint32_t)pHandleDMA->Instance + 
+                                                 (uint32_t)(pHandleDMA->Stream >> 4));
+        uint32_t Temp = DMA_TransferInterrupts(pHandleDMA, stream);
+        /* A half of one piece means nothing for the chain */
+        Temp &= ~(DMA_SxCR_DBM | DMA_SxCR_CT | DMA_IT_HT);
+        stream->CR = Temp;
+        pHandleDMA->pSegments = pSegments;
+        pHandleDMA->Segments  = Segments;
+        pHandleDMA->Segment   = 0U;
+        pHandleDMA->Length    = pSegments[0].Length;
+        stream->PAR  = (uint32_t)pPeripheral;
+        stream->M0AR = (uint32_t)pSegments[0].pMemory;
+        stream->NDTR = pSegments[0].Length;
+        stream->CR  |= DMA_SxCR_EN;
+    }
+    return RET_ErrorStatus;
 }
-/******************************************************************************/
\ No newline at end of file
+
+DMA_ErrorStatus_t DMA_GetChainPosition(DMA_Handle_t * pHandleDMA, uint32_t * pSegment)
+{
+    DMA_ErrorStatus_t RET_ErrorStatus = DMA_OK;
+    if(IS_NULL_PARAM(pHandleDMA) || IS_NULL_PARAM(pSegment) || IS_NULL_PARAM(pHandleDMA->pSegments))
+    {
+        RET_ErrorStatus = DMA_ERROR;
+    }
+    else
+    {
+        *pSegment = pHandleDMA->Segment;
+    }
+    return RET_ErrorStatus;
+}
+
+void DMA1_Stream0_IRQHandler(void)
+{
+    DMA_IRQStream(0U, 0U);
+}
+
+void DMA1_Stream1_IRQHandler(void)
+{
+    DMA_IRQStream(0U, 1U);
+}
+
+void DMA1_Stream2_IRQHandler(void)
+{
+    DMA_IRQStream(0U, 2U);
+}
+
+void DMA1_Stream3_IRQHandler(void)
+{
+    DMA_IRQStream(0U, 3U);
+}
+
+void DMA1_Stream4_IRQHandler(void)
+{
+    DMA_IRQStream(0U, 4U);
+}
+
+void DMA1_Stream5_IRQHandler(void)
+{
+    DMA_IRQStream(0U, 5U);
+}
+
+void DMA1_Stream6_IRQHandler(void)
+{
+    DMA_IRQStream(0U, 6U);
+}
+
+void DMA1_Stream7_IRQHandler(void)
+{
+    DMA_IRQStream(0U, 7U);
+}
+
+void DMA2_Stream0_IRQHandler(void)
+{
+    DMA_IRQStream(1U, 0U);
+}
+
+void DMA2_Stream1_IRQHandler(void)
+{
+    DMA_IRQStream(1U, 1U);
+}
+
+void DMA2_Stream2_IRQHandler(void)
+{
+    DMA_IRQStream(1U, 2U);
+}
+
+void DMA2_Stream3_IRQHandler(void)
+{
+    DMA_IRQStream(1U, 3U);
+}
+
+void DMA2_Stream4_IRQHandler(void)
+{
+    DMA_IRQStream(1U, 4U);
+}
+
+void DMA2_Stream5_IRQHandler(void)
+{
+    DMA_IRQStream(1U, 5U);
+}
+
+void DMA2_Stream6_IRQHandler(void)
+{
+    DMA_IRQStream(1U, 6U);
+}
+
+void DMA2_Stream7_IRQHandler(void)
+{
+    DMA_IRQStream(1U, 7U);
+}
+/******************************************************************************/
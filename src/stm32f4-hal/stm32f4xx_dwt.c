@@ -0,0 +1,88 @@
+/******************************************************************************/
+/**
+ * @file stm32f4xx_dwt.c
+ * @brief STM32F401CC DWT Cycle Counter Driver Implementation
+ *
+ * @par Project Name
+ *  stm32f4xx drivers
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * TRCENA of the debug exception and monitor control register powers the
+ * DWT, CYCCNTENA of its control register starts CYCCNT.
+ *
+ * @par Dependencies
+ * - stm32f4xx_dwt.h (header file for this driver)
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include "stm32f4xx_dwt.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+#define     __IO    volatile             /*!< Defines 'read / write' permissions */
+
+#define DWT                 ((DWT_t *)0xE0001000UL)
+#define DEMCR               (*(__IO uint32_t *)0xE000EDFCUL)
+
+#define DEMCR_TRCENA        (0x1UL << 24)
+#define DWT_CTRL_CYCCNTENA  (0x1UL << 0)
+#define DWT_CTRL_NOCYCCNT   (0x1UL << 25)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE TYPES */
+/******************************************************************************/
+
+typedef struct
+{
+  __IO uint32_t CTRL;       /*!< Control register */
+  __IO uint32_t CYCCNT;     /*!< Cycle count register */
+} DWT_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+DWT_ErrorStatus_t DWT_Init(void)
+{
+  DWT_ErrorStatus_t RET_ErrorStatus = DWT_OK;
+  DEMCR |= DEMCR_TRCENA;
+  if(DWT->CTRL & DWT_CTRL_NOCYCCNT)
+  {
+    RET_ErrorStatus = DWT_ERROR;
+  }
+  else
+  {
+    DWT->CYCCNT = 0U;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA;
+  }
+  return RET_ErrorStatus;
+}
+
+uint32_t DWT_GetCycles(void)
+{
+  return DWT->CYCCNT;
+}
+
+uint32_t DWT_GetElapsed(uint32_t Start)
+{
+  /* Unsigned arithmetic absorbs one wrap */
+  return DWT->CYCCNT - Start;
+}
+
+/******************************************************************************/
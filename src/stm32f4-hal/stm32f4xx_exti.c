@@ -0,0 +1,303 @@
+/******************************************************************************/
+/**
+ * @file stm32f4xx_exti.c
+ * @brief STM32F401CC EXTI Driver Implementation
+ *
+ * @par Project Name
+ *  stm32f4xx drivers
+ *
+ * @par Code Language
+ * C
+ *
+ * @par Description
+ * SYSCFG EXTICR selects the port of each line, EXTI masks, triggers and
+ * latches it. Lines 5 to 9 and 10 to 15 share one interrupt each, their
+ * handlers serve every pending line of the group.
+ *
+ * @par Dependencies
+ * - stm32f4xx_exti.h (header file for this driver)
+ *
+ * @par Author
+ * Mahmoud Abou-Hawis
+ *
+ */
+/******************************************************************************/
+
+/******************************************************************************/
+/* INCLUDES */
+/******************************************************************************/
+#include "stm32f4xx_exti.h"
+#include "stm32f4xx_gpio.h"
+#include "stm32f4xx_nvic.h"
+#include "stm32f4xx_rcc.h"
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE DEFINES */
+/******************************************************************************/
+#define     __IO    volatile             /*!< Defines 'read / write' permissions */
+
+#define SYSCFG              ((SYSCFG_t *)0x40013800UL)
+#define EXTI                ((EXTI_t *)0x40013C00UL)
+
+#define NUMBER_OF_LINES     (16U)
+#define LINES_PER_EXTICR    (4U)
+#define EXTICR_FIELD_Msk    (0xFUL)
+#define EXTICR_FIELD_SIZE   (4U)
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE MACROS */
+/******************************************************************************/
+
+#define IS_EXTI_LINE(LINE)          ((LINE) < NUMBER_OF_LINES)
+
+#define IS_EXTI_TRIGGER(TRIGGER)    (((TRIGGER) == EXTI_TRIGGER_RISING) || \
+                                     ((TRIGGER) == EXTI_TRIGGER_FALLING) || \
+                                     ((TRIGGER) == EXTI_TRIGGER_BOTH))
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE TYPES */
+/******************************************************************************/
+
+typedef struct
+{
+  __IO uint32_t MEMRMP;     /*!< Memory remap register */
+  __IO uint32_t PMC;        /*!< Peripheral mode configuration register */
+  __IO uint32_t EXTICR[4];  /*!< External interrupt configuration registers */
+  uint32_t RESERVED[2];
+  __IO uint32_t CMPCR;      /*!< Compensation cell control register */
+} SYSCFG_t;
+
+typedef struct
+{
+  __IO uint32_t IMR;        /*!< Interrupt mask register */
+  __IO uint32_t EMR;        /*!< Event mask register */
+  __IO uint32_t RTSR;       /*!< Rising trigger selection register */
+  __IO uint32_t FTSR;       /*!< Falling trigger selection register */
+  __IO uint32_t SWIER;      /*!< Software interrupt event register */
+  __IO uint32_t PR;         /*!< Pending register */
+} EXTI_t;
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE VARIABLE DEFINITIONS */
+/******************************************************************************/
+
+static EXTI_CallBack_t CallBacks[NUMBER_OF_LINES];
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION PROTOTYPES */
+/******************************************************************************/
+
+/**
+ * @brief Gives the EXTICR code of a port
+ * @return 0 to 7, 0xFF for an unknown port
+ */
+static uint8_t EXTI_GetPortCode(void * Port);
+
+/**
+ * @brief Gives the interrupt serving a line
+ */
+static IRQn_Type EXTI_GetIRQn(uint8_t Line);
+
+/**
+ * @brief Serves the pending lines of an interrupt
+ * @param First First line of the interrupt
+ * @param Last  Last line of the interrupt
+ */
+static void EXTI_IRQDispatch(uint8_t First, uint8_t Last);
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PRIVATE FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+static uint8_t EXTI_GetPortCode(void * Port)
+{
+  uint8_t RET_Code = 0xFFU;
+  if(Port == GPIO_PORTA)
+  {
+    RET_Code = 0U;
+  }
+  else if(Port == GPIO_PORTB)
+  {
+    RET_Code = 1U;
+  }
+  else if(Port == GPIO_PORTC)
+  {
+    RET_Code = 2U;
+  }
+  else if(Port == GPIO_PORTD)
+  {
+    RET_Code = 3U;
+  }
+  else if(Port == GPIO_PORTE)
+  {
+    RET_Code = 4U;
+  }
+  else if(Port == GPIO_PORTH)
+  {
+    RET_Code = 7U;
+  }
+  else
+  {
+    /* No thing */
+  }
+  return RET_Code;
+}
+
+static IRQn_Type EXTI_GetIRQn(uint8_t Line)
+{
+  IRQn_Type RET_IRQn = EXTI15_10_IRQn;
+  if(Line <= 4U)
+  {
+    RET_IRQn = (IRQn_Type)(EXTI0_IRQn + Line);
+  }
+  else if(Line <= 9U)
+  {
+    RET_IRQn = EXTI9_5_IRQn;
+  }
+  else
+  {
+    /* No thing */
+  }
+  return RET_IRQn;
+}
+
+static void EXTI_IRQDispatch(uint8_t First, uint8_t Last)
+{
+  uint32_t Pending = EXTI->PR & EXTI->IMR;
+  for(uint8_t Line = First; Line <= Last; Line++)
+  {
+    if(Pending & (1UL << Line))
+    {
+      /* Cleared first, an edge during the callback is served again */
+      EXTI->PR = (1UL << Line);
+      if(CallBacks[Line] != NULL)
+      {
+        CallBacks[Line]();
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+/******************************************************************************/
+/* PUBLIC FUNCTION DEFINITIONS */
+/******************************************************************************/
+
+EXTI_ErrorStatus_t EXTI_Init(const EXTI_Config_t * pConfig)
+{
+  EXTI_ErrorStatus_t RET_ErrorStatus = EXTI_OK;
+  if(pConfig == NULL || !IS_EXTI_LINE(pConfig->Pin) || !IS_EXTI_TRIGGER(pConfig->Trigger) ||
+     EXTI_GetPortCode(pConfig->Port) == 0xFFU)
+  {
+    RET_ErrorStatus = EXTI_ERROR;
+  }
+  else
+  {
+    uint8_t Line  = pConfig->Pin;
+    uint8_t Shift = (uint8_t)((Line % LINES_PER_EXTICR) * EXTICR_FIELD_SIZE);
+    uint32_t Mask = (1UL << Line);
+    RCC_enuEnablePeripheral(PERIPHERAL_SYSCF);
+    EXTI->IMR &= ~Mask;
+    CallBacks[Line] = pConfig->CallBack;
+    SYSCFG->EXTICR[Line / LINES_PER_EXTICR] =
+        (SYSCFG->EXTICR[Line / LINES_PER_EXTICR] & ~(EXTICR_FIELD_Msk << Shift)) |
+        ((uint32_t)EXTI_GetPortCode(pConfig->Port) << Shift);
+    if(pConfig->Trigger & EXTI_TRIGGER_RISING)
+    {
+      EXTI->RTSR |= Mask;
+    }
+    else
+    {
+      EXTI->RTSR &= ~Mask;
+    }
+    if(pConfig->Trigger & EXTI_TRIGGER_FALLING)
+    {
+      EXTI->FTSR |= Mask;
+    }
+    else
+    {
+      EXTI->FTSR &= ~Mask;
+    }
+    EXTI->PR = Mask;
+    EXTI->IMR |= Mask;
+    NVIC_EnableIRQ(EXTI_GetIRQn(Line));
+  }
+  return RET_ErrorStatus;
+}
+
+EXTI_ErrorStatus_t EXTI_Disable(uint8_t Line)
+{
+  EXTI_ErrorStatus_t RET_ErrorStatus = EXTI_OK;
+  if(!IS_EXTI_LINE(Line))
+  {
+    RET_ErrorStatus = EXTI_ERROR;
+  }
+  else
+  {
+    EXTI->IMR &= ~(1UL << Line);
+  }
+  return RET_ErrorStatus;
+}
+
+EXTI_ErrorStatus_t EXTI_Enable(uint8_t Line)
+{
+  EXTI_ErrorStatus_t RET_ErrorStatus = EXTI_OK;
+  if(!IS_EXTI_LINE(Line))
+  {
+    RET_ErrorStatus = EXTI_ERROR;
+  }
+  else
+  {
+    EXTI->IMR |= (1UL << Line);
+  }
+  return RET_ErrorStatus;
+}
+
+void EXTI0_IRQHandler(void)
+{
+  EXTI_IRQDispatch(0U, 0U);
+}
+
+void EXTI1_IRQHandler(void)
+{
+  EXTI_IRQDispatch(1U, 1U);
+}
+
+void EXTI2_IRQHandler(void)
+{
+  EXTI_IRQDispatch(2U, 2U);
+}
+
+void EXTI3_IRQHandler(void)
+{
+  EXTI_IRQDispatch(3U, 3U);
+}
+
+void EXTI4_IRQHandler(void)
+{
+  EXTI_IRQDispatch(4U, 4U);
+}
+
+void EXTI9_5_IRQHandler(void)
+{
+  EXTI_IRQDispatch(5U, 9U);
+}
+
+void EXTI15_10_IRQHandler(void)
+{
+  EXTI_IRQDispatch(10U, 15U);
+}
+
+/******************************************************************************/
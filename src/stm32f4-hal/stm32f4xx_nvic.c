@@ -471,4 +471,18 @@ NVIC_ErrorStatus_t NVIC_GetActive(IRQn_Type IRQn,uint32_t * pActiveState)
     } 
     return RET_ErrorStatus;
 }
-/******************************************************************************/
\ No newline at end of file
+
+uint32_t NVIC_DisableInterrupts(void)
+{
+    uint32_t PriMask;
+    /** Save the mask then set it, the memory clobber keeps accesses inside */
+    __asm volatile ("mrs %0, primask" : "=r" (PriMask));
+    __asm volatile ("cpsid i" : : : "memory");
+    return PriMask;
+}
+
+void NVIC_RestoreInterrupts(uint32_t PriMask)
+{
+    __asm volatile ("msr primask, %0" : : "r" (PriMask) : "memory");
+}
+/******************************************************************************/
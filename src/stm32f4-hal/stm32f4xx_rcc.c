@@ -136,6 +136,26 @@
  * @brief represent the APB2 bus.
  */
 #define              APB2_BUS                           ((uint32_t)1)
+
+/**
+ * @brief Fields of the PLL configuration register.
+ */
+#define              PLLCFGR_PLLM                       ((uint32_t)0x0000003F)
+#define              PLLCFGR_PLLN_Pos                   (6U)
+#define              PLLCFGR_PLLN                       ((uint32_t)0x00007FC0)
+#define              PLLCFGR_PLLP_Pos                   (16U)
+#define              PLLCFGR_PLLP                       ((uint32_t)0x00030000)
+#define              PLLCFGR_PLLSRC_HSE                 ((uint32_t)0x00400000)
+
+/**
+ * @brief Fields of the clock configuration register.
+ */
+#define              CFGR_HPRE_Pos                      (4U)
+#define              CFGR_HPRE                          ((uint32_t)0x000000F0)
+#define              CFGR_PPRE1_Pos                     (10U)
+#define              CFGR_PPRE1                         ((uint32_t)0x00001C00)
+#define              CFGR_PPRE2_Pos                     (13U)
+#define              CFGR_PPRE2                         ((uint32_t)0x0000E000)
 /******************************************************************************/
 
 /******************************************************************************/
@@ -690,6 +710,92 @@ RCC_enuErrorStatus  RCC_enuDisableClk(uint32_t CLK)
     return RET_enuErrorStatus;
 }
 
+RCC_enuErrorStatus  RCC_enuGetBusClock(uint32_t BUS, uint32_t * Frequency)
+{
+    RCC_enuErrorStatus RET_enuErrorStatus = RCC_FUNC_DONE;
+    /** AHB prescaler as a shift, indexed by CFGR.HPRE, 512 is the largest */
+    static const uint8_t AHBShift[16]  = {0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 6, 7, 8, 9};
+    /** APB prescaler as a shift, indexed by CFGR.PPREx */
+    static const uint8_t APBShift[8]   = {0, 0, 0, 0, 1, 2, 3, 4};
+    uint32_t CFGR = RCC->CFGR;
+    uint32_t PLLCFGR = RCC->PLLCFGR;
+    uint32_t Clock = HSI_FREQ * 1000000U;
+
+    if(Frequency == NULL)
+    {
+        RET_enuErrorStatus = RCC_NULL_PTR_PASSED;
+    }
+    else if(BUS != RCC_BUS_SYSCLK && BUS != RCC_BUS_AHB &&
+            BUS != RCC_BUS_APB1   && BUS != RCC_BUS_APB2)
+    {
+        RET_enuErrorStatus = RCC_WRONG_BUS_PRESCLER;
+    }
+    else
+    {
+        switch(u32GetSysClk())
+        {
+        case SYSCLK_HSE:
+            Clock = HSEFreq * 1000000U;
+            if(HSEFreq == 4294967295)
+            {
+                RET_enuErrorStatus = RCC_HSE_NOT_CONFIGURED;
+            }
+            else
+            {
+                /* No thing */
+            }
+            break;
+        case SYSCLK_PLL:
+            if(PLLCFGR & PLLCFGR_PLLSRC_HSE)
+            {
+                Clock = HSEFreq * 1000000U;
+                if(HSEFreq == 4294967295)
+                {
+                    RET_enuErrorStatus = RCC_HSE_NOT_CONFIGURED;
+                }
+                else
+                {
+                    /* No thing */
+                }
+            }
+            else
+            {
+                /* No thing */
+            }
+            /** f = f_in / PLLM * PLLN / PLLP, PLLM divides first to stay in 32 bits */
+            Clock = (Clock / (PLLCFGR & PLLCFGR_PLLM)) *
+                    ((PLLCFGR & PLLCFGR_PLLN) >> PLLCFGR_PLLN_Pos) /
+                    ((((PLLCFGR & PLLCFGR_PLLP) >> PLLCFGR_PLLP_Pos) + 1U) * 2U);
+            break;
+        default:
+            /** HSI */
+            break;
+        }
+        if(BUS != RCC_BUS_SYSCLK)
+        {
+            Clock >>= AHBShift[(CFGR & CFGR_HPRE) >> CFGR_HPRE_Pos];
+        }
+        else
+        {
+            /* No thing */
+        }
+        if(BUS == RCC_BUS_APB1)
+        {
+            Clock >>= APBShift[(CFGR & CFGR_PPRE1) >> CFGR_PPRE1_Pos];
+        }
+        else if(BUS == RCC_BUS_APB2)
+        {
+            Clock >>= APBShift[(CFGR & CFGR_PPRE2) >> CFGR_PPRE2_Pos];
+        }
+        else
+        {
+            /* No thing */
+        }
+        *Frequency = Clock;
+    }
+    return RET_enuErrorStatus;
+}
+
 uint32_t 			RCC_enuGetSysClk(void)
 {
 	uint32_t SysClk = u32GetSysClk();
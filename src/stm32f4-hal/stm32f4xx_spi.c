@@ -26,6 +26,8 @@
 /* INCLUDES */
 /******************************************************************************/
 #include "stm32f4xx_spi.h"
+#include "stm32f4xx_gpio.h"
+#include "stm32f4xx_dma.h"
 /******************************************************************************/
 
 /******************************************************************************/
@@ -69,15 +71,34 @@
 #define SPI_SR_RXNE_Msk     (0x1UL << SPI_SR_RXNE_Pos)
 #define SPI_SR_RXNE         SPI_SR_RXNE_Msk
 
+#define SPI_SR_MODF_Pos     (5U)
+#define SPI_SR_MODF_Msk     (0x1UL << SPI_SR_MODF_Pos)
+#define SPI_SR_MODF         SPI_SR_MODF_Msk
+
+#define SPI_SR_OVR_Pos      (6U)
+#define SPI_SR_OVR_Msk      (0x1UL << SPI_SR_OVR_Pos)
+#define SPI_SR_OVR          SPI_SR_OVR_Msk
+
 #define SPI_CR2_TXEIE_Pos    (7U)
 #define SPI_CR2_TXEIE_Msk    (0x1UL << SPI_CR2_TXEIE_Pos)
 #define SPI_CR2_TXEIE        SPI_CR2_TXEIE_Msk
 
+#define SPI_CR2_RXDMAEN_Pos   (0U)
+#define SPI_CR2_RXDMAEN_Msk   (0x1UL << SPI_CR2_RXDMAEN_Pos)
+#define SPI_CR2_RXDMAEN       SPI_CR2_RXDMAEN_Msk
+
+#define SPI_CR2_TXDMAEN_Pos   (1U)
+#define SPI_CR2_TXDMAEN_Msk   (0x1UL << SPI_CR2_TXDMAEN_Pos)
+#define SPI_CR2_TXDMAEN       SPI_CR2_TXDMAEN_Msk
+
 #define SPI_CR2_RXNEIE_Pos    (6U)
 #define SPI_CR2_RXNEIE_Msk    (0x1UL << SPI_CR2_RXNEIE_Pos)
 #define SPI_CR2_RXNEIE        SPI_CR2_RXNEIE_Msk
 
 
+#define SPI_CR1_FORMAT_Msk    (SPI_POLARITY_HIGH | SPI_PHASE_SECOND_EDGE | SPI_BAUDRATEPRESCALER_256 | \
+                               SPI_DATASIZE_16BIT | SPI_BYTEORDER_LSB)  /*!< Bits set by SPI_UpdateFormat */
+
 #define SPI_CR1_SSM_Pos       (9U)                                       
 #define SPI_CR1_SSM_Msk       (0x1UL << SPI_CR1_SSM_Pos)                  /*!< 0x00000200 */
 #define SPI_CR1_SSM           SPI_CR1_SSM_Msk                            /*!<Software slave management  */
@@ -86,7 +107,15 @@
 #define SPI_CR1_SSI_Msk       (0x1UL << SPI_CR1_SSI_Pos)                  /*!< 0x00000100 */
 #define SPI_CR1_SSI           SPI_CR1_SSI_Msk                            /*!<Internal slave select    */
 
-#define NUMBER_OF_SPI      (3U)
+#define NUMBER_OF_SPI      (4U)
+
+#define SPI_DUMMY_BYTE     (0xFFU)       /*!< Sent by jobs without transmit data */
+
+#define SPI_FRAMES_IN_FLIGHT (2U)       /*!< Shift register and transmit buffer of SPI_TransmitReceive */
+
+#define SPI_DMA_RX         (0U)          /*!< Index of the receive stream in SpiDMA */
+#define SPI_DMA_TX         (1U)          /*!< Index of the transmit stream in SpiDMA */
+#define SPI_DMA_TIMEOUT    (1000U)       /*!< Polls of a stream still enabled by DMA_Init */
 /******************************************************************************/
 
 /******************************************************************************/
@@ -244,6 +273,18 @@
   */
 #define GET_FLAG_STATE(__REG__,__FLAG__)    (((__REG__) & (__FLAG__)))
 
+/**
+  * @brief  Check if a job can be queued on a handle.
+  * @param  HSPI: the SPI handle, initialized.
+  * @param  JOB: the job.
+  * @retval 1 if the job can run on it, otherwise 0.
+  */
+#define IS_SPI_JOB_VALID(HSPI,JOB)    (((JOB)->Size != 0U) && \
+                                       ((HSPI)->Init.Mode == SPI_MODE_MASTER) && \
+                                       ((HSPI)->Init.DataSize == SPI_DATASIZE_8BIT) && \
+                                       (((JOB)->CSAction == SPI_CS_NONE) || IS_NOT_NULL((JOB)->CSPort)) && \
+                                       ((JOB)->CSAction <= SPI_CS_FRAME))
+
 /******************************************************************************/
 /* PRIVATE ENUMS */
 /******************************************************************************/
@@ -270,6 +311,16 @@ typedef struct
     __IO uint32_t I2SPR; /*!< I2S prescaler register */
 } SPI_t;
 
+/**
+ * @brief DMA stream serving one direction of an instance
+ */
+typedef struct
+{
+  void * Instance;
+  uint32_t Stream;
+  uint32_t Channel;
+} SPI_DMAMap_t;
+
 /******************************************************************************/
 
 /******************************************************************************/
@@ -283,6 +334,26 @@ typedef struct
 /* PRIVATE VARIABLE DEFINITIONS */
 /******************************************************************************/
 
+/* Handle of each SPI, set by SPI_Init, for the interrupts */
+static SPI_Handle_t * SpiHandles[NUMBER_OF_SPI];
+
+/**
+ * @brief Receive and transmit streams of each instance, @ref SPI_DMA_Streams
+ */
+static const SPI_DMAMap_t SpiDMAMap[NUMBER_OF_SPI][2] =
+{
+  {{DMA2, DMA_STREAM_2, DMA_CHANNEL_3}, {DMA2, DMA_STREAM_3, DMA_CHANNEL_3}},
+  {{DMA1, DMA_STREAM_3, DMA_CHANNEL_0}, {DMA1, DMA_STREAM_4, DMA_CHANNEL_0}},
+  {{DMA1, DMA_STREAM_0, DMA_CHANNEL_0}, {DMA1, DMA_STREAM_7, DMA_CHANNEL_0}},
+  {{DMA2, DMA_STREAM_0, DMA_CHANNEL_4}, {DMA2, DMA_STREAM_4, DMA_CHANNEL_5}}
+};
+
+static DMA_Handle_t SpiDMA[NUMBER_OF_SPI][2];
+
+/* Sent when there is nothing to transmit, and where unwanted frames land */
+static uint16_t SpiDMADummyTx = 0xFFFFU;
+static uint16_t SpiDMADummyRx;
+
 /******************************************************************************/
 
 /******************************************************************************/
@@ -301,11 +372,415 @@ typedef struct
 /* PRIVATE FUNCTION PROTOTYPES */
 /******************************************************************************/
 
+/**
+ * @brief Gives the index of an SPI instance in SpiHandles
+ * @param Instance @ref SPI_Instances
+ * @return 0 to 3, NUMBER_OF_SPI for an unknown instance
+ */
+static uint8_t SPI_GetIndex(void * Instance);
+
+/**
+ * @brief Puts the job at the head of the queue on the wire
+ * @param hspi Handle, its queue is not empty
+ */
+static void SPI_StartJob(SPI_Handle_t * hspi);
+
+/**
+ * @brief Stores a byte of the running job and sends the next one, ends the
+ *        job after its last byte
+ * @param hspi Handle running a job
+ */
+static void SPI_JobByte(SPI_Handle_t * hspi);
+
+/**
+ * @brief Ends an async zero-copy transfer and starts the queued jobs
+ * @param hspi Handle
+ */
+static void SPI_AsyncDone(SPI_Handle_t * hspi);
+
+/**
+ * @brief Drops a stale received frame and clears OVR and MODF
+ * @param hspi Handle, a mode fault gives its mode back to CR1
+ */
+static void SPI_ClearErrors(SPI_Handle_t * hspi);
+
+/**
+ * @brief Serves the interrupt of one SPI
+ * @param Index Index in SpiHandles
+ */
+static void SPI_IRQDispatch(uint8_t Index);
+
+/**
+ * @brief Sets up one stream of an instance for the data size of the handle
+ * @param Direction SPI_DMA_RX or SPI_DMA_TX
+ * @param isBuffer  The memory side moves, otherwise it is a dummy
+ * @param Mode      DMA_NORMAL or DMA_CIRCULAR
+ * @param CB        Transfer complete callback, may be NULL
+ */
+static SPI_ErrorStatus SPI_ConfigDMA(SPI_Handle_t * hspi, uint8_t Direction, bool isBuffer,
+                                     uint32_t Mode, CallBack_t CB);
+
+/**
+ * @brief Arms both streams of an instance and lets the SPI request them
+ * @param pTxData Frames to send, NULL sends 0xFF
+ * @param pRxData Received frames, NULL drops them
+ * @param pTxChain Pieces sent instead of pTxData when not NULL, Size frames in all
+ */
+static SPI_ErrorStatus SPI_StartDMA(SPI_Handle_t * hspi, uint8_t * pTxData, uint8_t * pRxData,
+                                    uint16_t Size, const DMA_Segment_t * pTxChain, uint16_t Segments,
+                                    CallBack_t CB);
+
+/**
+ * @brief End of the receive stream, every frame was exchanged
+ * @param Index Index in SpiHandles
+ */
+static void SPI_DMADone(uint8_t Index);
+
+/**
+ * @brief Transfer error on one of the streams
+ * @param Index Index in SpiHandles
+ */
+static void SPI_DMAError(uint8_t Index);
+
+static void SPI1_DMADone(void);
+static void SPI2_DMADone(void);
+static void SPI3_DMADone(void);
+static void SPI4_DMADone(void);
+static void SPI1_DMAError(void);
+static void SPI2_DMAError(void);
+static void SPI3_DMAError(void);
+static void SPI4_DMAError(void);
+
+/******************************************************************************/
+
+/**
+ * @brief Done and error callbacks of the streams of each instance
+ */
+static void (*const SpiDMACallBacks[NUMBER_OF_SPI][2])(void) =
+{
+  {SPI1_DMADone, SPI1_DMAError},
+  {SPI2_DMADone, SPI2_DMAError},
+  {SPI3_DMADone, SPI3_DMAError},
+  {SPI4_DMADone, SPI4_DMAError}
+};
 /******************************************************************************/
 
 /******************************************************************************/
 /* PRIVATE FUNCTION DEFINITIONS */
 /******************************************************************************/
+
+static uint8_t SPI_GetIndex(void * Instance)
+{
+  uint8_t RET_Index = NUMBER_OF_SPI;
+  if(Instance == SPI1)
+  {
+    RET_Index = 0;
+  }
+  else if(Instance == SPI2)
+  {
+    RET_Index = 1;
+  }
+  else if(Instance == SPI3)
+  {
+    RET_Index = 2;
+  }
+  else if(Instance == SPI4)
+  {
+    RET_Index = 3;
+  }
+  else
+  {
+    /* No thing */
+  }
+  return RET_Index;
+}
+
+static void SPI_StartJob(SPI_Handle_t * hspi)
+{
+  SPI_t * Instance = ((SPI_t*)hspi->Instance);
+  SPI_Job_t * pJob = hspi->pJobHead;
+  hspi->isJobRunning = true;
+  hspi->idx = 0;
+  /* Drop a byte left by a transmit only transfer and its overrun */
+  (void)Instance->DR;
+  (void)Instance->SR;
+  if(pJob->CSAction & SPI_CS_SELECT)
+  {
+    GPIO_SetPinValue(pJob->CSPort, pJob->CSPin, GPIO_STATE_RESET);
+  }
+  Instance->CR1 |= SPI_CR1_SPE;
+  Instance->CR2 |= SPI_CR2_RXNEIE;
+  Instance->DR = (pJob->pTxData != NULL) ? pJob->pTxData[0] : SPI_DUMMY_BYTE;
+}
+
+static void SPI_JobByte(SPI_Handle_t * hspi)
+{
+  SPI_t * Instance = ((SPI_t*)hspi->Instance);
+  SPI_Job_t * pJob = hspi->pJobHead;
+  uint8_t Byte = (uint8_t)Instance->DR;
+  if(pJob->pRxData != NULL)
+  {
+    pJob->pRxData[hspi->idx] = Byte;
+  }
+  hspi->idx += 1;
+  if(hspi->idx < pJob->Size)
+  {
+    Instance->DR = (pJob->pTxData != NULL) ? pJob->pTxData[hspi->idx] : SPI_DUMMY_BYTE;
+  }
+  else
+  {
+    Instance->CR2 &= ~SPI_CR2_RXNEIE;
+    if(pJob->CSAction & SPI_CS_RELEASE)
+    {
+      GPIO_SetPinValue(pJob->CSPort, pJob->CSPin, GPIO_STATE_SET);
+    }
+    hspi->pJobHead = pJob->pNext;
+    if(hspi->pJobHead == NULL)
+    {
+      hspi->pJobTail = NULL;
+    }
+    pJob->pNext = NULL;
+    hspi->isJobRunning = false;
+    if(pJob->CallBack != NULL)
+    {
+      pJob->CallBack(pJob);
+    }
+    /* The callback may have started the next job with SPI_SubmitJob */
+    if(!hspi->isJobRunning && hspi->pJobHead != NULL)
+    {
+      SPI_StartJob(hspi);
+    }
+  }
+}
+
+static void SPI_AsyncDone(SPI_Handle_t * hspi)
+{
+  hspi->State = SPI_STATE_IDLE;
+  if(hspi->callBack != NULL)
+  {
+    hspi->callBack();
+  }
+  if(hspi->State != SPI_STATE_BUSY && !hspi->isJobRunning && hspi->pJobHead != NULL)
+  {
+    SPI_StartJob(hspi);
+  }
+}
+
+static void SPI_ClearErrors(SPI_Handle_t * hspi)
+{
+  SPI_t * Instance = ((SPI_t*)hspi->Instance);
+  /* Reading DR then SR clears OVR, reading SR then writing CR1 clears MODF */
+  (void)Instance->DR;
+  if(GET_FLAG_STATE(Instance->SR,SPI_SR_MODF))
+  {
+    /* The fault also cleared MSTR and SPE */
+    Instance->CR1 |= hspi->Init.Mode;
+  }
+}
+
+static void SPI_IRQDispatch(uint8_t Index)
+{
+  SPI_Handle_t * hspi = SpiHandles[Index];
+  if(hspi != NULL)
+  {
+    SPI_t * Instance = ((SPI_t*)hspi->Instance);
+    uint32_t SR  = Instance->SR;
+    uint32_t CR2 = Instance->CR2;
+    if(GET_FLAG_STATE(CR2,SPI_CR2_RXNEIE) && GET_FLAG_STATE(SR,SPI_SR_RXNE))
+    {
+      if(hspi->isJobRunning)
+      {
+        SPI_JobByte(hspi);
+      }
+      else
+      {
+        hspi->Data[hspi->idx] = (uint8_t)Instance->DR;
+        hspi->idx += 1;
+        if(hspi->idx < hspi->size)
+        {
+          if(hspi->Init.Mode == SPI_MODE_MASTER)
+          {
+            Instance->DR = SPI_DUMMY_BYTE;
+          }
+        }
+        else
+        {
+          Instance->CR2 &= ~SPI_CR2_RXNEIE;
+          SPI_AsyncDone(hspi);
+        }
+      }
+    }
+    else if(GET_FLAG_STATE(CR2,SPI_CR2_TXEIE) && GET_FLAG_STATE(SR,SPI_SR_TXE))
+    {
+      if(hspi->idx < hspi->size)
+      {
+        Instance->DR = hspi->Data[hspi->idx];
+        hspi->idx += 1;
+      }
+      else
+      {
+        Instance->CR2 &= ~SPI_CR2_TXEIE;
+        /* The last byte is still shifting, the callback may reuse the bus */
+        while (GET_FLAG_STATE(Instance->SR,SPI_SR_BSY) == SPI_IS_BUSY);
+        (void)Instance->DR;
+        (void)Instance->SR;
+        SPI_AsyncDone(hspi);
+      }
+    }
+    else
+    {
+      /* No thing */
+    }
+  }
+}
+
+static SPI_ErrorStatus SPI_ConfigDMA(SPI_Handle_t * hspi, uint8_t Direction, bool isBuffer,
+                                     uint32_t Mode, CallBack_t CB)
+{
+  SPI_ErrorStatus RET_ErrorStatus = SPI_OK;
+  uint8_t Index = SPI_GetIndex(hspi->Instance);
+  DMA_Handle_t * pDMA = &SpiDMA[Index][Direction];
+  bool isHalfWord = (hspi->Init.DataSize == SPI_DATASIZE_16BIT);
+  pDMA->Instance                     = SpiDMAMap[Index][Direction].Instance;
+  pDMA->Stream                       = SpiDMAMap[Index][Direction].Stream;
+  pDMA->Initialization.Channel       = SpiDMAMap[Index][Direction].Channel;
+  pDMA->Initialization.Direction     = (Direction == SPI_DMA_RX) ? DMA_PERIPH_TO_MEMORY : DMA_MEMORY_TO_PERIPH;
+  pDMA->Initialization.FIFOMode      = DMA_FIFOMODE_DISABLE;
+  pDMA->Initialization.FIFOThreshold = DMA_FIFO_THRESHOLD_HALFFULL;
+  pDMA->Initialization.MemAlignment  = isHalfWord ? DMA_MDATAALIGN_HALFWORD : DMA_MDATAALIGN_BYTE;
+  pDMA->Initialization.PerAlignment  = isHalfWord ? DMA_PDATAALIGN_HALFWORD : DMA_PDATAALIGN_BYTE;
+  pDMA->Initialization.MemBurst      = DMA_MBURST_SINGLE;
+  pDMA->Initialization.PeriphBurst   = DMA_PBURST_SINGLE;
+  pDMA->Initialization.MemInc        = isBuffer ? DMA_MEMORY_INCREMENT_ENABLED : DMA_MEMORY_INCREMENT_DISABLED;
+  pDMA->Initialization.PeriphInc     = DMA_PERIPHERAL_INCREMENT_DISABLED;
+  pDMA->Initialization.Mode          = Mode;
+  /* Receive first, a frame left in DR would overrun */
+  pDMA->Initialization.Priority      = (Direction == SPI_DMA_RX) ? DMA_PRIORITY_VERY_HIGH : DMA_PRIORITY_HIGH;
+  pDMA->HalfTransferCallBack         = NULL;
+  pDMA->CompleteTransferCallBack     = CB;
+  pDMA->ErrorTransferCallBack        = SpiDMACallBacks[Index][1];
+  if(DMA_Init(pDMA, SPI_DMA_TIMEOUT) != DMA_OK)
+  {
+    RET_ErrorStatus = SPI_ERROR;
+  }
+  return RET_ErrorStatus;
+}
+
+static SPI_ErrorStatus SPI_StartDMA(SPI_Handle_t * hspi, uint8_t * pTxData, uint8_t * pRxData,
+                                    uint16_t Size, const DMA_Segment_t * pTxChain, uint16_t Segments,
+                                    CallBack_t CB)
+{
+  SPI_ErrorStatus RET_ErrorStatus = SPI_OK;
+  if(!IS_SPI_INSTANCE(hspi->Instance) || Size == 0U)
+  {
+    RET_ErrorStatus = SPI_ERROR;
+  }
+  else if(hspi->State == SPI_STATE_BUSY || hspi->isJobRunning)
+  {
+    RET_ErrorStatus = SPI_BUSY;
+  }
+  else
+  {
+    SPI_t * Instance = ((SPI_t*)hspi->Instance);
+    uint8_t Index = SPI_GetIndex(hspi->Instance);
+    hspi->State    = SPI_STATE_BUSY;
+    hspi->callBack = CB;
+    if(SPI_ConfigDMA(hspi, SPI_DMA_RX, (pRxData != NULL), DMA_NORMAL, SpiDMACallBacks[Index][0]) != SPI_OK ||
+       SPI_ConfigDMA(hspi, SPI_DMA_TX, (pTxData != NULL || pTxChain != NULL), DMA_NORMAL, NULL) != SPI_OK)
+    {
+      hspi->State = SPI_STATE_IDLE;
+      RET_ErrorStatus = SPI_ERROR;
+    }
+    else
+    {
+      /* Drop a frame left by a transmit only transfer and its overrun */
+      (void)Instance->DR;
+      (void)Instance->SR;
+      Instance->CR2 |= SPI_CR2_RXDMAEN;
+      DMA_StartInterrupt(&SpiDMA[Index][SPI_DMA_RX], (void *)&Instance->DR,
+                         (pRxData != NULL) ? (void *)pRxData : (void *)&SpiDMADummyRx, Size);
+      if(pTxChain != NULL)
+      {
+        DMA_StartChain(&SpiDMA[Index][SPI_DMA_TX], (void *)&Instance->DR, pTxChain, Segments);
+      }
+      else
+      {
+        DMA_StartInterrupt(&SpiDMA[Index][SPI_DMA_TX],
+                           (pTxData != NULL) ? (void *)pTxData : (void *)&SpiDMADummyTx,
+                           (void *)&Instance->DR, Size);
+      }
+      Instance->CR1 |= SPI_CR1_SPE;
+      Instance->CR2 |= SPI_CR2_TXDMAEN;
+    }
+  }
+  return RET_ErrorStatus;
+}
+
+static void SPI_DMADone(uint8_t Index)
+{
+  SPI_Handle_t * hspi = SpiHandles[Index];
+  ((SPI_t*)hspi->Instance)->CR2 &= ~(SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+  SPI_AsyncDone(hspi);
+}
+
+static void SPI_DMAError(uint8_t Index)
+{
+  SPI_Handle_t * hspi = SpiHandles[Index];
+  ((SPI_t*)hspi->Instance)->CR2 &= ~(SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+  /* The other stream waits for requests which will not come, DMA_Init of
+     the next transfer would time out on it */
+  (void)DMA_Abort(&SpiDMA[Index][SPI_DMA_RX], SPI_DMA_TIMEOUT);
+  (void)DMA_Abort(&SpiDMA[Index][SPI_DMA_TX], SPI_DMA_TIMEOUT);
+  /* Both streams may report the same failure */
+  if(hspi->State == SPI_STATE_BUSY)
+  {
+    hspi->State = SPI_STATE_IDLE;
+    if(hspi->errorCallBack != NULL)
+    {
+      hspi->errorCallBack();
+    }
+  }
+}
+
+static void SPI1_DMADone(void)
+{
+  SPI_DMADone(0);
+}
+
+static void SPI2_DMADone(void)
+{
+  SPI_DMADone(1);
+}
+
+static void SPI3_DMADone(void)
+{
+  SPI_DMADone(2);
+}
+
+static void SPI4_DMADone(void)
+{
+  SPI_DMADone(3);
+}
+
+static void SPI1_DMAError(void)
+{
+  SPI_DMAError(0);
+}
+
+static void SPI2_DMAError(void)
+{
+  SPI_DMAError(1);
+}
+
+static void SPI3_DMAError(void)
+{
+  SPI_DMAError(2);
+}
+
+static void SPI4_DMAError(void)
+{
+  SPI_DMAError(3);
+}
 /******************************************************************************/
 
 /******************************************************************************/
@@ -337,6 +812,10 @@ SPI_ErrorStatus SPI_Init(SPI_Handle_t *hspi)
             Instance->CR1 |= SPI_CR1_SSI;
           }
           hspi->State = SPI_STATE_INITIALIZED;
+          hspi->pJobHead = NULL;
+          hspi->pJobTail = NULL;
+          hspi->isJobRunning = false;
+          SpiHandles[SPI_GetIndex(hspi->Instance)] = hspi;
        }
     else
     {
@@ -370,6 +849,9 @@ SPI_ErrorStatus SPI_Transmit(SPI_Handle_t *hspi, uint8_t *pData, uint16_t Size,
           Instance->CR1 |= SPI_CR_CRCNEXT;
         }
         while (GET_FLAG_STATE(Instance->SR,SPI_SR_BSY) == SPI_IS_BUSY);
+        /* Nothing read the received bytes, drop the last one and its overrun */
+        (void)Instance->DR;
+        (void)Instance->SR;
     } 
     else
     {
@@ -405,10 +887,93 @@ SPI_ErrorStatus SPI_Receive(SPI_Handle_t *hspi, uint8_t *pData, uint16_t Size, u
     return RET_enuErrorStatus;
 }
 
+SPI_ErrorStatus SPI_TransmitReceive(SPI_Handle_t *hspi, const uint8_t *pTxData, uint8_t *pRxData,
+                                    uint16_t Size, uint32_t Timeout)
+{
+  SPI_ErrorStatus RET_ErrorStatus = SPI_OK;
+  if(!IS_NOT_NULL(hspi) || !IS_SPI_INSTANCE(hspi->Instance) || Size == 0U)
+  {
+    RET_ErrorStatus = SPI_ERROR;
+  }
+  else if(hspi->State == SPI_STATE_BUSY || hspi->isJobRunning)
+  {
+    RET_ErrorStatus = SPI_BUSY;
+  }
+  else
+  {
+    SPI_t * Instance = ((SPI_t*)hspi->Instance);
+    bool isHalfWord = (hspi->Init.DataSize == SPI_DATASIZE_16BIT);
+    uint32_t TxCount = 0;
+    uint32_t RxCount = 0;
+    uint32_t Idle = Timeout;
+    uint32_t SR;
+    uint16_t Frame;
+    SPI_ClearErrors(hspi);
+    Instance->CR1 |= SPI_CR1_SPE;
+    while(RxCount < Size && RET_ErrorStatus == SPI_OK)
+    {
+      SR = Instance->SR;
+      if(GET_FLAG_STATE(SR,SPI_SR_OVR | SPI_SR_MODF))
+      {
+        SPI_ClearErrors(hspi);
+        RET_ErrorStatus = SPI_ERROR;
+      }
+      /* Receive first, a frame left in DR would be overrun by the next one */
+      else if(GET_FLAG_STATE(SR,SPI_SR_RXNE))
+      {
+        Frame = (uint16_t)Instance->DR;
+        if(pRxData != NULL && isHalfWord)
+        {
+          ((uint16_t *)pRxData)[RxCount] = Frame;
+        }
+        else if(pRxData != NULL)
+        {
+          pRxData[RxCount] = (uint8_t)Frame;
+        }
+        else
+        {
+          /* No thing */
+        }
+        RxCount += 1;
+        Idle = Timeout;
+      }
+      /* One frame shifting and the next one waiting keep SCK running */
+      else if(GET_FLAG_STATE(SR,SPI_SR_TXE) && TxCount < Size &&
+              (TxCount - RxCount) < SPI_FRAMES_IN_FLIGHT)
+      {
+        if(pTxData == NULL)
+        {
+          Frame = isHalfWord ? 0xFFFFU : SPI_DUMMY_BYTE;
+        }
+        else if(isHalfWord)
+        {
+          Frame = ((const uint16_t *)pTxData)[TxCount];
+        }
+        else
+        {
+          Frame = pTxData[TxCount];
+        }
+        Instance->DR = Frame;
+        TxCount += 1;
+        Idle = Timeout;
+      }
+      else if(Idle == 0U)
+      {
+        RET_ErrorStatus = SPI_TIMEOUT;
+      }
+      else
+      {
+        Idle -= 1;
+      }
+    }
+  }
+  return RET_ErrorStatus;
+}
+
 SPI_ErrorStatus SPI_TransmitAsyncZeroCopy(SPI_Handle_t *hspi, uint8_t *pData, uint16_t Size,CallBack_t CB)
 {
   SPI_ErrorStatus RET_ErrorStatus = SPI_OK;
-  if(IS_NOT_NULL(hspi) && IS_NOT_NULL(pData) && hspi->State != SPI_STATE_BUSY)
+  if(IS_NOT_NULL(hspi) && IS_NOT_NULL(pData) && hspi->State != SPI_STATE_BUSY && !hspi->isJobRunning)
   {
     hspi->State = SPI_STATE_BUSY;
     hspi->callBack = CB;
@@ -429,7 +994,7 @@ SPI_ErrorStatus SPI_TransmitAsyncZeroCopy(SPI_Handle_t *hspi, uint8_t *pData, ui
 SPI_ErrorStatus SPI_ReceiveAsyncZeroCopy(SPI_Handle_t *hspi, uint8_t *pData, uint16_t Size,CallBack_t CB)
 {
   SPI_ErrorStatus RET_ErrorStatus = SPI_OK;
-  if(IS_NOT_NULL(hspi) && IS_NOT_NULL(pData) && hspi->State != SPI_STATE_BUSY)
+  if(IS_NOT_NULL(hspi) && IS_NOT_NULL(pData) && hspi->State != SPI_STATE_BUSY && !hspi->isJobRunning)
   {
     hspi->State = SPI_STATE_BUSY;
     hspi->callBack = CB;
@@ -451,4 +1016,260 @@ SPI_ErrorStatus SPI_ReceiveAsyncZeroCopy(SPI_Handle_t *hspi, uint8_t *pData, uin
 }
 
 
-/******************************************************************************/
\ No newline at end of file
+/******************************************************************************/
+
+SPI_ErrorStatus SPI_SubmitJob(SPI_Handle_t *hspi, SPI_Job_t *pJob)
+{
+  SPI_ErrorStatus RET_ErrorStatus = SPI_OK;
+  if(IS_NOT_NULL(hspi) && IS_NOT_NULL(pJob) && IS_SPI_INSTANCE(hspi->Instance) &&
+     IS_SPI_JOB_VALID(hspi,pJob))
+  {
+    SPI_t * Instance = ((SPI_t*)hspi->Instance);
+    /* The interrupt of this SPI also walks the queue */
+    uint32_t Enabled = Instance->CR2 & (SPI_CR2_TXEIE | SPI_CR2_RXNEIE);
+    Instance->CR2 &= ~(SPI_CR2_TXEIE | SPI_CR2_RXNEIE);
+    pJob->pNext = NULL;
+    if(hspi->pJobTail != NULL)
+    {
+      hspi->pJobTail->pNext = pJob;
+    }
+    else
+    {
+      hspi->pJobHead = pJob;
+    }
+    hspi->pJobTail = pJob;
+    if(!hspi->isJobRunning && hspi->State != SPI_STATE_BUSY)
+    {
+      SPI_StartJob(hspi);
+    }
+    else
+    {
+      Instance->CR2 |= Enabled;
+    }
+  }
+  else
+  {
+    RET_ErrorStatus = SPI_ERROR;
+  }
+  return RET_ErrorStatus;
+}
+
+SPI_ErrorStatus SPI_UpdateFormat(SPI_Handle_t *hspi)
+{
+  SPI_ErrorStatus RET_ErrorStatus = SPI_OK;
+  if(!IS_NOT_NULL(hspi) || !IS_SPI_INSTANCE(hspi->Instance) ||
+     !IS_SPI_POLARITY(hspi->Init.CLKPolarity) ||
+     !IS_SPI_PHASE(hspi->Init.CLKPhase) ||
+     !IS_SPI_BAUDRATE_PRESCALER(hspi->Init.BaudRatePrescaler) ||
+     !IS_SPI_DATASIZE(hspi->Init.DataSize) ||
+     !IS_SPI_BYTE_ORDER(hspi->Init.ByteOrder))
+  {
+    RET_ErrorStatus = SPI_ERROR;
+  }
+  else if(hspi->State == SPI_STATE_BUSY || hspi->isJobRunning)
+  {
+    RET_ErrorStatus = SPI_BUSY;
+  }
+  else
+  {
+    SPI_t * Instance = ((SPI_t*)hspi->Instance);
+    /* CPOL, CPHA and DFF may only change with the SPI disabled */
+    while (GET_FLAG_STATE(Instance->SR,SPI_SR_BSY) == SPI_IS_BUSY);
+    Instance->CR1 &= ~SPI_CR1_SPE;
+    Instance->CR1 = (Instance->CR1 & ~SPI_CR1_FORMAT_Msk) |
+                    hspi->Init.CLKPolarity | hspi->Init.CLKPhase |
+                    hspi->Init.BaudRatePrescaler | hspi->Init.DataSize | hspi->Init.ByteOrder;
+    /* A master drives SCK at the new idle level before the next chip select */
+    if(hspi->Init.Mode == SPI_MODE_MASTER)
+    {
+      Instance->CR1 |= SPI_CR1_SPE;
+    }
+  }
+  return RET_ErrorStatus;
+}
+
+SPI_ErrorStatus SPI_TransmitDMA(SPI_Handle_t *hspi, uint8_t *pData, uint16_t Size, CallBack_t CB)
+{
+  SPI_ErrorStatus RET_ErrorStatus = SPI_ERROR;
+  if(IS_NOT_NULL(hspi) && IS_NOT_NULL(pData))
+  {
+    RET_ErrorStatus = SPI_StartDMA(hspi, pData, NULL, Size, NULL, 0, CB);
+  }
+  return RET_ErrorStatus;
+}
+
+SPI_ErrorStatus SPI_ReceiveDMA(SPI_Handle_t *hspi, uint8_t *pData, uint16_t Size, CallBack_t CB)
+{
+  SPI_ErrorStatus RET_ErrorStatus = SPI_ERROR;
+  if(IS_NOT_NULL(hspi) && IS_NOT_NULL(pData))
+  {
+    RET_ErrorStatus = SPI_StartDMA(hspi, NULL, pData, Size, NULL, 0, CB);
+  }
+  return RET_ErrorStatus;
+}
+
+SPI_ErrorStatus SPI_TransmitReceiveDMA(SPI_Handle_t *hspi, uint8_t *pTxData, uint8_t *pRxData,
+                                       uint16_t Size, CallBack_t CB)
+{
+  SPI_ErrorStatus RET_ErrorStatus = SPI_ERROR;
+  if(IS_NOT_NULL(hspi) && IS_NOT_NULL(pTxData) && IS_NOT_NULL(pRxData))
+  {
+    RET_ErrorStatus = SPI_StartDMA(hspi, pTxData, pRxData, Size, NULL, 0, CB);
+  }
+  return RET_ErrorStatus;
+}
+
+SPI_ErrorStatus SPI_TransmitChainDMA(SPI_Handle_t *hspi, const DMA_Segment_t *pSegments,
+                                     uint16_t Segments, CallBack_t CB)
+{
+  SPI_ErrorStatus RET_ErrorStatus = SPI_ERROR;
+  uint32_t Size = 0;
+  uint16_t Checked = 0;
+  if(IS_NOT_NULL(hspi) && IS_NOT_NULL(pSegments))
+  {
+    /* The receive stream drops the frames of every piece in one go */
+    while(Checked < Segments && IS_NOT_NULL(pSegments[Checked].pMemory) &&
+          pSegments[Checked].Length != 0U && pSegments[Checked].Length <= 0xFFFFU && Size <= 0xFFFFU)
+    {
+      Size += pSegments[Checked].Length;
+      Checked++;
+    }
+    if(Segments != 0U && Checked == Segments && Size <= 0xFFFFU)
+    {
+      RET_ErrorStatus = SPI_StartDMA(hspi, NULL, NULL, (uint16_t)Size, pSegments, Segments, CB);
+    }
+  }
+  return RET_ErrorStatus;
+}
+
+SPI_ErrorStatus SPI_SlaveStartDMA(SPI_Handle_t *hspi, uint8_t *pRxRing, uint16_t Size)
+{
+  SPI_ErrorStatus RET_ErrorStatus = SPI_OK;
+  if(!IS_NOT_NULL(hspi) || !IS_NOT_NULL(pRxRing) || Size == 0U ||
+     !IS_SPI_INSTANCE(hspi->Instance) || hspi->Init.Mode != SPI_MODE_SLAVE)
+  {
+    RET_ErrorStatus = SPI_ERROR;
+  }
+  else if(hspi->State == SPI_STATE_BUSY || hspi->isJobRunning)
+  {
+    RET_ErrorStatus = SPI_BUSY;
+  }
+  else
+  {
+    SPI_t * Instance = ((SPI_t*)hspi->Instance);
+    uint8_t Index = SPI_GetIndex(hspi->Instance);
+    SpiHandles[Index] = hspi;
+    if(SPI_ConfigDMA(hspi, SPI_DMA_RX, true, DMA_CIRCULAR, NULL) != SPI_OK ||
+       SPI_ConfigDMA(hspi, SPI_DMA_TX, true, DMA_NORMAL, NULL) != SPI_OK)
+    {
+      RET_ErrorStatus = SPI_ERROR;
+    }
+    else
+    {
+      hspi->State = SPI_STATE_BUSY;
+      hspi->Data  = pRxRing;
+      hspi->size  = Size;
+      (void)Instance->DR;
+      (void)Instance->SR;
+      Instance->CR2 |= SPI_CR2_RXDMAEN;
+      DMA_StartInterrupt(&SpiDMA[Index][SPI_DMA_RX], (void *)&Instance->DR, (void *)pRxRing, Size);
+      Instance->CR1 |= SPI_CR1_SPE;
+    }
+  }
+  return RET_ErrorStatus;
+}
+
+SPI_ErrorStatus SPI_SlaveLoadDMA(SPI_Handle_t *hspi, const uint8_t *pTxData, uint16_t Size)
+{
+  SPI_ErrorStatus RET_ErrorStatus = SPI_OK;
+  if(!IS_NOT_NULL(hspi) || !IS_NOT_NULL(pTxData) || Size < 2U ||
+     !IS_SPI_INSTANCE(hspi->Instance) || hspi->State != SPI_STATE_BUSY ||
+     (((SPI_t*)hspi->Instance)->CR2 & SPI_CR2_RXDMAEN) == 0U)
+  {
+    RET_ErrorStatus = SPI_ERROR;
+  }
+  else
+  {
+    SPI_t * Instance = ((SPI_t*)hspi->Instance);
+    uint8_t Index = SPI_GetIndex(hspi->Instance);
+    uint8_t FrameBytes = (hspi->Init.DataSize == SPI_DATASIZE_16BIT) ? 2U : 1U;
+    Instance->CR2 &= ~SPI_CR2_TXDMAEN;
+    if(DMA_Abort(&SpiDMA[Index][SPI_DMA_TX], SPI_DMA_TIMEOUT) != DMA_OK)
+    {
+      RET_ErrorStatus = SPI_ERROR;
+    }
+    else
+    {
+      /* A frame still waiting in DR takes the first slot on the wire */
+      if((Instance->SR & SPI_SR_TXE) == 0U)
+      {
+        pTxData += FrameBytes;
+        Size--;
+      }
+      else
+      {
+        /* No thing */
+      }
+      DMA_StartInterrupt(&SpiDMA[Index][SPI_DMA_TX], (void *)pTxData, (void *)&Instance->DR, Size);
+      Instance->CR2 |= SPI_CR2_TXDMAEN;
+    }
+  }
+  return RET_ErrorStatus;
+}
+
+SPI_ErrorStatus SPI_SlaveGetRxPosition(SPI_Handle_t *hspi, uint16_t *pPosition)
+{
+  SPI_ErrorStatus RET_ErrorStatus = SPI_ERROR;
+  uint32_t Done = 0U;
+  if(IS_NOT_NULL(hspi) && IS_NOT_NULL(pPosition) && IS_SPI_INSTANCE(hspi->Instance) &&
+     hspi->State == SPI_STATE_BUSY && hspi->size != 0U &&
+     DMA_GetProgress(&SpiDMA[SPI_GetIndex(hspi->Instance)][SPI_DMA_RX], &Done) == DMA_OK)
+  {
+    /* NDTR reloads to the ring size, it is never read as 0 */
+    *pPosition = (uint16_t)(Done % hspi->size);
+    RET_ErrorStatus = SPI_OK;
+  }
+  return RET_ErrorStatus;
+}
+
+SPI_ErrorStatus SPI_SlaveStopDMA(SPI_Handle_t *hspi)
+{
+  SPI_ErrorStatus RET_ErrorStatus = SPI_ERROR;
+  if(IS_NOT_NULL(hspi) && IS_SPI_INSTANCE(hspi->Instance) && hspi->Init.Mode == SPI_MODE_SLAVE)
+  {
+    SPI_t * Instance = ((SPI_t*)hspi->Instance);
+    uint8_t Index = SPI_GetIndex(hspi->Instance);
+    Instance->CR2 &= ~(SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+    if(DMA_Abort(&SpiDMA[Index][SPI_DMA_RX], SPI_DMA_TIMEOUT) == DMA_OK &&
+       DMA_Abort(&SpiDMA[Index][SPI_DMA_TX], SPI_DMA_TIMEOUT) == DMA_OK)
+    {
+      Instance->CR1 &= ~SPI_CR1_SPE;
+      hspi->State = SPI_STATE_IDLE;
+      hspi->size  = 0U;
+      RET_ErrorStatus = SPI_OK;
+    }
+  }
+  return RET_ErrorStatus;
+}
+
+void SPI1_IRQHandler(void)
+{
+  SPI_IRQDispatch(0);
+}
+
+void SPI2_IRQHandler(void)
+{
+  SPI_IRQDispatch(1);
+}
+
+void SPI3_IRQHandler(void)
+{
+  SPI_IRQDispatch(2);
+}
+
+void SPI4_IRQHandler(void)
+{
+  SPI_IRQDispatch(3);
+}
+
+/******************************************************************************/
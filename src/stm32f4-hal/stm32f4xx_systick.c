@@ -85,6 +85,16 @@
  */
 #define     __IM     volatile const     
 
+/**
+ * @brief System Control Block Interrupt Control and State Register.
+ */
+#define     SCB_ICSR  *((__IOM uint32_t*)0xE000ED04)
+
+/**
+ * @brief SCB ICSR PENDSTSET Mask, set while the SysTick exception is pending.
+ */
+#define SCB_ICSR_PENDSTSET_Msk             (1UL << 26U)
+
 /**
  * @brief  SysTick CTRL CLKSOURCE Position
  */
@@ -354,6 +364,106 @@ SysTick_ErrorStatus_t SysTick_DelayMicroSeconds(uint32_t Time)
     return SYSTICK_OK;
 }
 
+SysTick_ErrorStatus_t SysTick_SleepTicks(uint32_t Ticks, uint32_t * pSleptTicks)
+{
+    SysTick_ErrorStatus_t RET_ErrorStatus = SYSTICK_OK;
+    uint32_t Period = TimeMS + 1UL;
+    uint32_t Remaining;
+    uint32_t Reload;
+    uint32_t Elapsed;
+
+    if(IS_NULL_PARAM(pSleptTicks))
+    {
+        RET_ErrorStatus = SYSTICK_NULL_PTR_PASSED;
+    }
+    else if(IS_NOT_VALID_TIME(Ticks) || IS_NOT_VALID_TIME(TimeMS) ||
+            ((SYSTICK->CTRL & SysTick_CTRL_ENABLE_Msk) == 0))
+    {
+        RET_ErrorStatus = SYSTICK_NOT_OK;
+    }
+    else
+    {
+        *pSleptTicks = 0;
+        /** The reload register bounds the longest sleep */
+        if(Ticks > (SysTick_LOAD_RELOAD_Msk / Period))
+        {
+            Ticks = SysTick_LOAD_RELOAD_Msk / Period;
+        }
+        else
+        {
+            /* No thing */
+        }
+
+        SYSTICK->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+        Remaining = SYSTICK->VAL;
+        if(Remaining == 0)
+        {
+            Remaining = Period;
+        }
+        else
+        {
+            /* No thing */
+        }
+
+        if((SCB_ICSR & SCB_ICSR_PENDSTSET_Msk) ||
+           ((Ticks == 1UL) && (Remaining < 2UL)))
+        {
+            /** A tick ended before the counter stopped or is about to end */
+            SYSTICK->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        }
+        else
+        {
+            /** Count the rest of this tick and Ticks - 1 more in one period */
+            Reload = Remaining + ((Ticks - 1UL) * Period) - 1UL;
+            SYSTICK->LOAD = Reload;
+            SYSTICK->VAL  = 0UL;
+            SYSTICK->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+            __asm volatile ("dsb" : : : "memory");
+            __asm volatile ("wfi");
+            __asm volatile ("isb");
+
+            SYSTICK->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+            /** Counts since the long period started */
+            Elapsed = Reload - SYSTICK->VAL;
+            if(SCB_ICSR & SCB_ICSR_PENDSTSET_Msk)
+            {
+                /** Slept the whole time, the interrupt pending ends the last tick */
+                *pSleptTicks = Ticks - 1UL;
+                Reload = (Elapsed < Period) ? (Period - Elapsed) : Period;
+            }
+            else
+            {
+                /** Woken early, the time since the last tick decides */
+                Elapsed += Period - Remaining;
+                *pSleptTicks = Elapsed / Period;
+                Reload = Period - (Elapsed % Period);
+            }
+
+            /** A reload of 0 would stop the counter, end the tick a count late */
+            if(Reload < 2UL)
+            {
+                Reload = 2UL;
+            }
+            else
+            {
+                /* No thing */
+            }
+
+            /** Finish the current tick then go back to the normal period */
+            SYSTICK->LOAD = Reload - 1UL;
+            SYSTICK->VAL  = 0UL;
+            SYSTICK->CTRL |= SysTick_CTRL_ENABLE_Msk;
+            while(SYSTICK->VAL == 0UL)
+            {
+                /** Wait for the counter to take the reload before changing it */
+            }
+            SYSTICK->LOAD = TimeMS;
+        }
+    }
+    return RET_ErrorStatus;
+}
+
 void SysTick_Handler(void)
 {
     if(!IS_NULL_PARAM(CallBack))
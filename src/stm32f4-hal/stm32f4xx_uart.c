@@ -23,6 +23,8 @@
 /* INCLUDES */
 /******************************************************************************/
 #include "stm32f4xx_uart.h"
+#include "stm32f4xx_rcc.h"
+#include "stm32f4xx_dma.h"
 /******************************************************************************/
 
 /******************************************************************************/
@@ -42,10 +44,6 @@
 
 #define PARITY_ENABLE 0x00000200U
 
-#ifndef CLK
-#define CLK 16000000
-#endif
-
 #define UART_SR_TXE_Pos (7U)
 #define UART_SR_TXE_Msk (0x1UL << UART_SR_TXE_Pos)
 #define UART_SR_TXE UART_SR_TXE_Msk
@@ -54,6 +52,10 @@
 #define UART_SR_RXNE_Msk (0x1UL << UART_SR_RXNE_Pos)
 #define UART_SR_RXNE UART_SR_RXNE_Msk
 
+#define UART_SR_ORE_Pos (3U)
+#define UART_SR_ORE_Msk (0x1UL << UART_SR_ORE_Pos)
+#define UART_SR_ORE UART_SR_ORE_Msk
+
 #define UART_CR1_TXEIE_Pos (7U)
 #define UART_CR1_TXEIE_Msk (0x1UL << UART_CR1_TXEIE_Pos)
 #define UART_CR1_TXEIE UART_CR1_TXEIE_Msk
@@ -88,7 +90,8 @@
 #define IS_NULL_PTR(_PARAM) (_PARAM == NULL)
 
 #define IS_VALID_OVER_SAMPLING(_PARAM) (_PARAM == UART_OVERSAMPLING_16 || \
-                                        _PARAM == UART_OVERSAMPLING_8)
+                                        _PARAM == UART_OVERSAMPLING_8  || \
+                                        _PARAM == UART_OVERSAMPLING_AUTO)
 
 #define IS_VALID_WORD_LENGTH(_PARAM) (_PARAM == UART_WORDLENGTH_8B || \
                                       _PARAM == UART_WORDLENGTH_9B)
@@ -112,13 +115,19 @@
 
 #define IS_UART_INSTANCE_BUSY(_PARAM)   (_PARAM == true)
 
-#define UART_DIV_SAMPLING8(_PCLK_, _BAUD_)             ((uint32_t)((((uint64_t)(_PCLK_))*25U)/(2U*((uint64_t)(_BAUD_)))))
-#define UART_DIVMANT_SAMPLING8(_PCLK_, _BAUD_)         (UART_DIV_SAMPLING8((_PCLK_), (_BAUD_))/100U)
-#define UART_DIVFRAQ_SAMPLING8(_PCLK_, _BAUD_)         ((((UART_DIV_SAMPLING8((_PCLK_), (_BAUD_)) - (UART_DIVMANT_SAMPLING8((_PCLK_), (_BAUD_)) * 100U)) * 8U) + 50U) / 100U)
+#define IS_VALID_RING_SIZE(_PARAM)      (_PARAM >= 2U)
+
+#define IS_VALID_BLOCK_SIZE(_PARAM)     (_PARAM >= 2U && (_PARAM % 2U) == 0U)
+
+#define GET_UART_REGISTERS(_INSTANCE)   ((USART_t *)((uint32_t)(_INSTANCE) & 0xFFFFFFF0))
+
+#define GET_UART_INDEX(_INSTANCE)       ((uint8_t)((uint32_t)(_INSTANCE) & 0x0000000F))
+
+#define IS_VALID_BAUD_RATE(_PARAM) (_PARAM != 0U)
+
+/** Largest BRR.DIV_Mantissa */
+#define UART_DIV_MANTISSA_MAX      (0xFFFU)
 
-#define UART_BRR_SAMPLING8(_PCLK_, _BAUD_)             ((UART_DIVMANT_SAMPLING8((_PCLK_), (_BAUD_)) << 4U) + \
-                                                        ((UART_DIVFRAQ_SAMPLING8((_PCLK_), (_BAUD_)) & 0xF8U) << 1U) + \
-                                                        (UART_DIVFRAQ_SAMPLING8((_PCLK_), (_BAUD_)) & 0x07U))
 /******************************************************************************/
 /* PRIVATE ENUMS */
 /******************************************************************************/
@@ -143,8 +152,30 @@ typedef struct
   __IOM uint32_t GTPR; /*!< USART Guard time and prescaler */
 } USART_t;
 
+/**
+ * @brief Ring of bytes with a single producer and a single consumer, one of
+ *        them being the interrupt. One byte is left empty to tell full from empty.
+ */
 typedef struct
 {
+  char * pBuffer;
+  uint16_t Size;
+  volatile uint16_t Head;   /*!< Written by the producer only */
+  volatile uint16_t Tail;   /*!< Written by the consumer only */
+} UartRing_t;
+
+typedef struct
+{
+  bool isBuffered;
+  UartRing_t TxRing;
+  UartRing_t RxRing;
+  volatile uint32_t RxDropped;
+  bool isContinuousRX;
+  char * pRxBlockBuffer;
+  uint16_t RxBlockHalfSize;
+  uint8_t RxBlockNextHalf;
+  Uart_RxBlockCallBack RxBlockCallBack;
+  volatile uint32_t RxOverruns;
   bool isTXProcessRequest;
   bool isRXProcessRequest;
   char * pUartTransmitBuffer;
@@ -157,6 +188,16 @@ typedef struct
   uint16_t ReceiverBufferSize;
   uint16_t ReceivePos;
 } UartInstanceProperties;
+
+/**
+ * @brief DMA stream receiving for an instance
+ */
+typedef struct
+{
+  void * Instance;
+  uint32_t Stream;
+  uint32_t Channel;
+} UartRxDMAMap_t;
 /******************************************************************************/
 
 /******************************************************************************/
@@ -169,6 +210,43 @@ typedef struct
 /* PRIVATE VARIABLE DEFINITIONS */
 /******************************************************************************/
 static UartInstanceProperties UartInstancePro[NUMBER_OF_UART] = {0};
+
+/**
+ * @brief Baud rate of each instance, set by UART_Init
+ */
+static UART_BaudInfo_t UartBaudInfo[NUMBER_OF_UART] = {0};
+
+/**
+ * @brief APB bus of each instance, USART2 is on APB1, USART1 and USART6 on APB2
+ */
+static const uint32_t UartBus[NUMBER_OF_UART] =
+{
+  RCC_BUS_APB2,
+  RCC_BUS_APB1,
+  RCC_BUS_APB2
+};
+
+/**
+ * @brief DMA stream of each instance for the continuous reception
+ */
+static const UartRxDMAMap_t UartRxDMAMap[NUMBER_OF_UART] =
+{
+  {DMA2, DMA_STREAM_5, DMA_CHANNEL_4},
+  {DMA1, DMA_STREAM_5, DMA_CHANNEL_4},
+  {DMA2, DMA_STREAM_1, DMA_CHANNEL_5}
+};
+
+static DMA_Handle_t UartRxDMA[NUMBER_OF_UART];
+
+/**
+ * @brief Registers of each instance, indexed by the low nibble of its @ref UART_Instances
+ */
+static USART_t * const UartRegisters[NUMBER_OF_UART] =
+{
+  GET_UART_REGISTERS(USART1),
+  GET_UART_REGISTERS(USART2),
+  GET_UART_REGISTERS(USART6)
+};
 /******************************************************************************/
 
 /******************************************************************************/
@@ -188,6 +266,38 @@ static UartInstanceProperties UartInstancePro[NUMBER_OF_UART] = {0};
 /******************************************************************************/
 __STATIC_INLINE UART_ErrorStatus_t UART_WaitingFlagUntilTimeout(USART_t * Instance,
                                                uint32_t Flag, uint32_t Timeout);
+
+__STATIC_INLINE bool UART_RingPush(UartRing_t * pRing, char Byte);
+
+__STATIC_INLINE bool UART_RingPop(UartRing_t * pRing, char * pByte);
+
+__STATIC_INLINE uint16_t UART_RingCount(const UartRing_t * pRing);
+
+static void UART_IRQDispatch(uint8_t UART_PropertiesIdx);
+
+static void UART_RxBlockEvent(uint8_t UART_PropertiesIdx, uint8_t Half);
+
+static void UART1_RxFirstHalf(void);
+static void UART1_RxSecondHalf(void);
+static void UART2_RxFirstHalf(void);
+static void UART2_RxSecondHalf(void);
+static void UART6_RxFirstHalf(void);
+static void UART6_RxSecondHalf(void);
+
+static bool UART_ComputeBRR(uint32_t Clock, uint32_t BaudRate, uint32_t OverSampling,
+                            uint32_t * pBRR, UART_BaudInfo_t * pInfo);
+/******************************************************************************/
+
+
+/**
+ * @brief DMA callbacks of each instance, they carry no argument
+ */
+static void (* const UartRxHalfCallBacks[NUMBER_OF_UART][2])(void) =
+{
+  {UART1_RxFirstHalf, UART1_RxSecondHalf},
+  {UART2_RxFirstHalf, UART2_RxSecondHalf},
+  {UART6_RxFirstHalf, UART6_RxSecondHalf}
+};
 /******************************************************************************/
 
 /******************************************************************************/
@@ -205,6 +315,257 @@ __STATIC_INLINE UART_ErrorStatus_t UART_WaitingFlagUntilTimeout(USART_t * Instan
   }
   return RET_enuErrorStatus;
 }
+
+__STATIC_INLINE bool UART_RingPush(UartRing_t * pRing, char Byte)
+{
+  bool RET_isPushed = false;
+  uint16_t Next = pRing->Head + 1U;
+  if(Next == pRing->Size)
+  {
+    Next = 0;
+  }
+  else
+  {
+    /* No thing */
+  }
+  if(Next != pRing->Tail)
+  {
+    pRing->pBuffer[pRing->Head] = Byte;
+    pRing->Head = Next;
+    RET_isPushed = true;
+  }
+  else
+  {
+    /* No thing */
+  }
+  return RET_isPushed;
+}
+
+__STATIC_INLINE bool UART_RingPop(UartRing_t * pRing, char * pByte)
+{
+  bool RET_isPopped = false;
+  uint16_t Tail = pRing->Tail;
+  if(Tail != pRing->Head)
+  {
+    *pByte = pRing->pBuffer[Tail];
+    Tail++;
+    if(Tail == pRing->Size)
+    {
+      Tail = 0;
+    }
+    else
+    {
+      /* No thing */
+    }
+    pRing->Tail = Tail;
+    RET_isPopped = true;
+  }
+  else
+  {
+    /* No thing */
+  }
+  return RET_isPopped;
+}
+
+__STATIC_INLINE uint16_t UART_RingCount(const UartRing_t * pRing)
+{
+  uint16_t Head = pRing->Head;
+  uint16_t Tail = pRing->Tail;
+  return (Head >= Tail) ? (Head - Tail) : (pRing->Size - Tail + Head);
+}
+
+/**
+ * @brief Hands a completed half of the continuous reception to its consumer.
+ *
+ * The DMA is now filling the other half, NDTR above the middle at the half
+ * transfer or at most the middle at the transfer complete means it already
+ * wrapped into this half. A half coming out of turn means the flags of both
+ * were pending together. Either way part of the data was overwritten.
+ */
+static void UART_RxBlockEvent(uint8_t UART_PropertiesIdx, uint8_t Half)
+{
+  UartInstanceProperties * pProperties = &UartInstancePro[UART_PropertiesIdx];
+  uint32_t Remaining = 0;
+  bool isOverwritten;
+  DMA_GetCounter(&UartRxDMA[UART_PropertiesIdx], &Remaining);
+  isOverwritten = (Half == 0U) ? (Remaining > pProperties->RxBlockHalfSize) :
+                                 (Remaining <= pProperties->RxBlockHalfSize);
+  if(isOverwritten || Half != pProperties->RxBlockNextHalf)
+  {
+    pProperties->RxOverruns++;
+  }
+  else
+  {
+    /* No thing */
+  }
+  pProperties->RxBlockNextHalf = Half ^ 1U;
+  pProperties->RxBlockCallBack(&pProperties->pRxBlockBuffer[Half * pProperties->RxBlockHalfSize],
+                               pProperties->RxBlockHalfSize);
+}
+
+static void UART1_RxFirstHalf(void)
+{
+  UART_RxBlockEvent(GET_UART_INDEX(USART1), 0U);
+}
+
+static void UART1_RxSecondHalf(void)
+{
+  UART_RxBlockEvent(GET_UART_INDEX(USART1), 1U);
+}
+
+static void UART2_RxFirstHalf(void)
+{
+  UART_RxBlockEvent(GET_UART_INDEX(USART2), 0U);
+}
+
+static void UART2_RxSecondHalf(void)
+{
+  UART_RxBlockEvent(GET_UART_INDEX(USART2), 1U);
+}
+
+static void UART6_RxFirstHalf(void)
+{
+  UART_RxBlockEvent(GET_UART_INDEX(USART6), 0U);
+}
+
+static void UART6_RxSecondHalf(void)
+{
+  UART_RxBlockEvent(GET_UART_INDEX(USART6), 1U);
+}
+
+/**
+ * @brief Finds BRR for one oversampling.
+ *
+ * USARTDIV = Clock / (8 * (2 - OVER8) * BaudRate), BRR keeps it with 4
+ * fraction bits in 16x and 3 in 8x, so the divider is Clock / BaudRate
+ * rounded, in 1/16 or 1/8 steps of USARTDIV, and the achieved baud rate is
+ * Clock / Divider.
+ *
+ * @return false when the divider does not fit in BRR for this oversampling.
+ */
+static bool UART_ComputeBRR(uint32_t Clock, uint32_t BaudRate, uint32_t OverSampling,
+                            uint32_t * pBRR, UART_BaudInfo_t * pInfo)
+{
+  bool RET_isValid = true;
+  uint32_t FractionBits = (OverSampling == UART_OVERSAMPLING_8) ? 3U : 4U;
+  uint32_t Divider = (uint32_t)(((uint64_t)Clock + (BaudRate / 2U)) / BaudRate);
+  uint32_t Mantissa = Divider >> FractionBits;
+  if(Mantissa == 0U || Mantissa > UART_DIV_MANTISSA_MAX)
+  {
+    RET_isValid = false;
+  }
+  else
+  {
+    *pBRR = (Mantissa << 4U) | (Divider & ((1UL << FractionBits) - 1U));
+    pInfo->Clock = Clock;
+    pInfo->Achieved = (Clock + (Divider / 2U)) / Divider;
+    pInfo->ErrorCentiPercent = (int32_t)(((int64_t)pInfo->Achieved - (int64_t)BaudRate) * 10000 /
+                                         (int64_t)BaudRate);
+    pInfo->OverSampling = OverSampling;
+  }
+  return RET_isValid;
+}
+
+/**
+ * @brief Interrupt of one UART instance, shared by every USARTx_IRQHandler.
+ */
+static void UART_IRQDispatch(uint8_t UART_PropertiesIdx)
+{
+  USART_t * UartInstance = UartRegisters[UART_PropertiesIdx];
+  UartInstanceProperties * pProperties = &UartInstancePro[UART_PropertiesIdx];
+  uint32_t Status = UartInstance->SR;
+  char Byte;
+
+  if((Status & (UART_SR_RXNE | UART_SR_ORE)) && (UartInstance->CR1 & UART_CR1_RXNEIE))
+  {
+    /* Reading DR after SR also clears the overrun flag */
+    Byte = (char)UartInstance->DR;
+    if(pProperties->isBuffered == true)
+    {
+      /* On an overrun DR still holds a valid byte, the one lost was in the shift register */
+      if(Status & UART_SR_ORE)
+      {
+        pProperties->RxDropped++;
+      }
+      else
+      {
+        /* No thing */
+      }
+      if(!UART_RingPush(&pProperties->RxRing, Byte))
+      {
+        pProperties->RxDropped++;
+      }
+      else
+      {
+        /* No thing */
+      }
+    }
+    else if(pProperties->isRXProcessRequest == true)
+    {
+      pProperties->pUartReceiverBuffer[pProperties->ReceivePos++] = Byte;
+      if(pProperties->ReceivePos == pProperties->ReceiverBufferSize)
+      {
+        pProperties->isRXProcessRequest = false;
+        UartInstance->CR1 &= ~UART_CR1_RXNEIE;
+        if(pProperties->isTXProcessRequest != true)
+        {
+          UartInstance->CR1 &= ~UART_CR1_UE;
+        }
+        if(IS_NULL_PTR(pProperties->RXCallBack))
+        {
+
+        }
+        else
+        {
+          pProperties->RXCallBack();
+        }
+      }
+    }
+    else
+    {
+      /* No thing */
+    }
+  }
+
+  if((Status & UART_SR_TXE) && (UartInstance->CR1 & UART_CR1_TXEIE))
+  {
+    if(pProperties->isBuffered == true)
+    {
+      if(UART_RingPop(&pProperties->TxRing, &Byte))
+      {
+        UartInstance->DR = Byte;
+      }
+      else
+      {
+        UartInstance->CR1 &= ~UART_CR1_TXEIE;
+      }
+    }
+    else if(pProperties->TransmitPos < pProperties->TransmitBufferSize)
+    {
+      UartInstance->DR = pProperties->pUartTransmitBuffer[pProperties->TransmitPos++];
+    }
+    else
+    {
+      if(pProperties->isTXProcessRequest == true)
+      {
+        pProperties->isTXProcessRequest = false;
+        UartInstance->CR1 &= ~UART_CR1_TXEIE;
+        if(pProperties->isRXProcessRequest != true)
+        {
+         UartInstance->CR1 &= ~UART_CR1_UE;
+        }
+        if(IS_NULL_PTR(pProperties->TXCallBack))
+        {
+
+        }
+        else
+        {
+          pProperties->TXCallBack();
+        }
+      }
+    }
+  }
+}
 /******************************************************************************/
 /* PUBLIC FUNCTION DEFINITIONS */
 /******************************************************************************/
@@ -212,7 +573,15 @@ __STATIC_INLINE UART_ErrorStatus_t UART_WaitingFlagUntilTimeout(USART_t * Instan
 UART_ErrorStatus_t UART_Init(const UART_Handle_t *const uartHandle)
 {
   UART_ErrorStatus_t RET_enuErrorStatus = UART_ERROR_NONE;
-  USART_t *UartInstance = ((USART_t *)((uint32_t)uartHandle->pUartInstance &0xFFFFFFF0));
+  USART_t *UartInstance;
+  uint8_t UART_PropertiesIdx;
+  uint32_t Clock = 0;
+  uint32_t BRR16 = 0;
+  uint32_t BRR8 = 0;
+  UART_BaudInfo_t Info16 = {0};
+  UART_BaudInfo_t Info8 = {0};
+  bool isValid16 = false;
+  bool isValid8 = false;
   if (IS_NULL_PTR(uartHandle))
   {
     RET_enuErrorStatus = UART_NULL_PTR_PASSED;
@@ -223,23 +592,91 @@ UART_ErrorStatus_t UART_Init(const UART_Handle_t *const uartHandle)
            IS_VALID_STOP_BITS(uartHandle->UartConfiguration.StopBits) &&
            IS_VALID_WORD_LENGTH(uartHandle->UartConfiguration.WordLength) &&
            IS_VALID_PARITY(uartHandle->UartConfiguration.Parity) && 
+           IS_VALID_BAUD_RATE(uartHandle->UartConfiguration.BaudRate) &&
            IS_NOT_UART_IN_PROCESS(
-                    UartInstancePro[(uint32_t)uartHandle->pUartInstance &0x0000000F].isTXProcessRequest) &&
+                    UartInstancePro[GET_UART_INDEX(uartHandle->pUartInstance)].isTXProcessRequest) &&
            IS_NOT_UART_IN_PROCESS(
-                    UartInstancePro[(uint32_t)uartHandle->pUartInstance &0x0000000F].isRXProcessRequest))
-  {
-    UartInstance->CR1 = 0;
-    UartInstance->CR2 = 0;
-    UartInstance->CR1 |= uartHandle->UartConfiguration.OverSampling;
-    UartInstance->CR1 |= uartHandle->UartConfiguration.WordLength;
-    UartInstance->CR1 |= uartHandle->UartConfiguration.Parity;
-    UartInstance->CR1 |= uartHandle->UartConfiguration.Mode;
-    UartInstance->CR2 |= uartHandle->UartConfiguration.StopBits;
-    UartInstance->BRR = UART_BRR_SAMPLING8(CLK,uartHandle->UartConfiguration.BaudRate);
-    if(uartHandle->UartConfiguration.Parity != UART_PARITY_NONE)
+                    UartInstancePro[GET_UART_INDEX(uartHandle->pUartInstance)].isRXProcessRequest))
+  {
+    UartInstance = GET_UART_REGISTERS(uartHandle->pUartInstance);
+    UART_PropertiesIdx = GET_UART_INDEX(uartHandle->pUartInstance);
+    if(RCC_enuGetBusClock(UartBus[UART_PropertiesIdx], &Clock) == RCC_FUNC_DONE)
     {
-      UartInstance->CR1 |= PARITY_ENABLE;
+      if(uartHandle->UartConfiguration.OverSampling != UART_OVERSAMPLING_8)
+      {
+        isValid16 = UART_ComputeBRR(Clock, uartHandle->UartConfiguration.BaudRate,
+                                    UART_OVERSAMPLING_16, &BRR16, &Info16);
+      }
+      else
+      {
+        /* No thing */
+      }
+      if(uartHandle->UartConfiguration.OverSampling != UART_OVERSAMPLING_16)
+      {
+        isValid8 = UART_ComputeBRR(Clock, uartHandle->UartConfiguration.BaudRate,
+                                   UART_OVERSAMPLING_8, &BRR8, &Info8);
+      }
+      else
+      {
+        /* No thing */
+      }
+    }
+    /* Same divider and error in both, 16x is kept while it fits, it samples each bit more often */
+    if(isValid16)
+    {
+      isValid8 = false;
+    }
+    else
+    {
+      /* No thing */
+    }
+
+    if(isValid16 || isValid8)
+    {
+      UartInstancePro[UART_PropertiesIdx].isBuffered = false;
+      UartBaudInfo[UART_PropertiesIdx] = isValid16 ? Info16 : Info8;
+      UartInstance->CR1 = 0;
+      UartInstance->CR2 = 0;
+      UartInstance->CR1 |= UartBaudInfo[UART_PropertiesIdx].OverSampling;
+      UartInstance->CR1 |= uartHandle->UartConfiguration.WordLength;
+      UartInstance->CR1 |= uartHandle->UartConfiguration.Parity;
+      UartInstance->CR1 |= uartHandle->UartConfiguration.Mode;
+      UartInstance->CR2 |= uartHandle->UartConfiguration.StopBits;
+      UartInstance->BRR = isValid16 ? BRR16 : BRR8;
+      if(uartHandle->UartConfiguration.Parity != UART_PARITY_NONE)
+      {
+        UartInstance->CR1 |= PARITY_ENABLE;
+      }
+      if(UartInstancePro[UART_PropertiesIdx].isContinuousRX == true)
+      {
+        /* DMAR is still set, the DMA picks up again at the new baud rate */
+        UartInstance->CR1 |= UART_CR1_UE;
+      }
     }
+    else
+    {
+      /* Unknown bus clock or a baud rate out of reach of BRR */
+      RET_enuErrorStatus = UART_PARAM_ERROR;
+    }
+  }
+  else
+  {
+    RET_enuErrorStatus = UART_ERROR;
+  }
+  return RET_enuErrorStatus;
+}
+
+UART_ErrorStatus_t UART_GetBaudInfo(const UART_Handle_t * const uartHandle,
+                                    UART_BaudInfo_t * pInfo)
+{
+  UART_ErrorStatus_t RET_enuErrorStatus = UART_ERROR_NONE;
+  if (IS_NULL_PTR(uartHandle) || IS_NULL_PTR(pInfo))
+  {
+    RET_enuErrorStatus = UART_NULL_PTR_PASSED;
+  }
+  else if(IS_VALID_USART_INSTANCE(uartHandle->pUartInstance))
+  {
+    *pInfo = UartBaudInfo[GET_UART_INDEX(uartHandle->pUartInstance)];
   }
   else
   {
@@ -331,7 +768,8 @@ UART_ErrorStatus_t UART_TransmitAsyncZeroCopy(UART_Handle_t *uartHandle,
   {
     RET_enuErrorStatus = UART_NULL_PTR_PASSED;
   }
-  else if(IS_UART_INSTANCE_BUSY(UartInstancePro[UART_PropertiesIdx].isTXProcessRequest))
+  else if(IS_UART_INSTANCE_BUSY(UartInstancePro[UART_PropertiesIdx].isTXProcessRequest) ||
+          IS_UART_INSTANCE_BUSY(UartInstancePro[UART_PropertiesIdx].isBuffered))
   {
     RET_enuErrorStatus = UART_ERROR;
   }
@@ -365,7 +803,9 @@ UART_ErrorStatus_t UART_TransmitAsyncZeroCopy(UART_Handle_t *uartHandle,
   {
     RET_enuErrorStatus = UART_NULL_PTR_PASSED;
   }
-  else if(IS_UART_INSTANCE_BUSY(UartInstancePro[UART_PropertiesIdx].isRXProcessRequest))
+  else if(IS_UART_INSTANCE_BUSY(UartInstancePro[UART_PropertiesIdx].isRXProcessRequest) ||
+          IS_UART_INSTANCE_BUSY(UartInstancePro[UART_PropertiesIdx].isBuffered) ||
+          IS_UART_INSTANCE_BUSY(UartInstancePro[UART_PropertiesIdx].isContinuousRX))
   {
     RET_enuErrorStatus = UART_ERROR;
   }
@@ -402,58 +842,242 @@ void UART_TransmitWithDMA(UART_Handle_t *uartHandle,Uart_CallBack CB)
   UartInstancePro[UART_PropertiesIdx].TCCallBack = CB;
 }
 
-void USART1_IRQHandler(void)
+UART_ErrorStatus_t UART_ReceiveContinuousDMA(UART_Handle_t *uartHandle,
+                                             char *pBuffer, uint16_t Size,
+                                             Uart_RxBlockCallBack CB)
 {
-  if(((USART_t*)USART1)->SR & UART_SR_RXNE)
+  UART_ErrorStatus_t RET_enuErrorStatus = UART_ERROR_NONE;
+  UartInstanceProperties *pProperties;
+  DMA_Handle_t *pDMA;
+  uint8_t UART_PropertiesIdx;
+  if (IS_NULL_PTR(uartHandle) || IS_NULL_PTR(pBuffer) || IS_NULL_PTR(CB))
+  {
+    RET_enuErrorStatus = UART_NULL_PTR_PASSED;
+  }
+  else if(!IS_VALID_USART_INSTANCE(uartHandle->pUartInstance) || !IS_VALID_BLOCK_SIZE(Size))
+  {
+    RET_enuErrorStatus = UART_PARAM_ERROR;
+  }
+  else
   {
-    UartInstancePro[0].pUartReceiverBuffer[UartInstancePro[0].ReceivePos++] = ((USART_t*)USART1)->DR;
-    if(UartInstancePro[0].ReceivePos == UartInstancePro[0].ReceiverBufferSize)
+    UART_PropertiesIdx = GET_UART_INDEX(uartHandle->pUartInstance);
+    pProperties = &UartInstancePro[UART_PropertiesIdx];
+    pDMA = &UartRxDMA[UART_PropertiesIdx];
+    if(IS_UART_INSTANCE_BUSY(pProperties->isRXProcessRequest) ||
+       IS_UART_INSTANCE_BUSY(pProperties->isBuffered) ||
+       IS_UART_INSTANCE_BUSY(pProperties->isContinuousRX))
     {
-      UartInstancePro[0].isRXProcessRequest = false;
-      ((USART_t*)USART1)->CR1 &= ~UART_CR1_RXNEIE;
-      if(UartInstancePro[0].isTXProcessRequest != true)
-      {
-        ((USART_t*)USART1)->CR1 &= ~UART_CR1_UE;
-      }
-      if(IS_NULL_PTR(UartInstancePro[0].RXCallBack))
-      {
+      RET_enuErrorStatus = UART_ERROR;
+    }
+    else
+    {
+      pProperties->pRxBlockBuffer   = pBuffer;
+      pProperties->RxBlockHalfSize  = Size / 2U;
+      pProperties->RxBlockNextHalf  = 0;
+      pProperties->RxBlockCallBack  = CB;
+      pProperties->RxOverruns       = 0;
+
+      pDMA->Instance                     = UartRxDMAMap[UART_PropertiesIdx].Instance;
+      pDMA->Stream                       = UartRxDMAMap[UART_PropertiesIdx].Stream;
+      pDMA->Initialization.Channel       = UartRxDMAMap[UART_PropertiesIdx].Channel;
+      pDMA->Initialization.Direction     = DMA_PERIPH_TO_MEMORY;
+      pDMA->Initialization.FIFOMode      = DMA_FIFOMODE_DISABLE;
+      pDMA->Initialization.FIFOThreshold = DMA_FIFO_THRESHOLD_HALFFULL;
+      pDMA->Initialization.MemAlignment  = DMA_MDATAALIGN_BYTE;
+      pDMA->Initialization.MemBurst      = DMA_MBURST_SINGLE;
+      pDMA->Initialization.MemInc        = DMA_MEMORY_INCREMENT_ENABLED;
+      pDMA->Initialization.Mode          = DMA_CIRCULAR;
+      pDMA->Initialization.Priority      = DMA_PRIORITY_HIGH;
+      pDMA->Initialization.PerAlignment  = DMA_PDATAALIGN_BYTE;
+      pDMA->Initialization.PeriphInc     = DMA_PERIPHERAL_INCREMENT_DISABLED;
+      pDMA->Initialization.PeriphBurst   = DMA_PBURST_SINGLE;
+      pDMA->HalfTransferCallBack         = UartRxHalfCallBacks[UART_PropertiesIdx][0];
+      pDMA->CompleteTransferCallBack     = UartRxHalfCallBacks[UART_PropertiesIdx][1];
+      pDMA->ErrorTransferCallBack        = NULL;
 
+      if(DMA_Init(pDMA, -1) != DMA_OK ||
+         DMA_StartInterrupt(pDMA, (void *)&GET_UART_REGISTERS(uartHandle->pUartInstance)->DR,
+                            pBuffer, Size) != DMA_OK)
+      {
+        RET_enuErrorStatus = UART_ERROR;
       }
       else
       {
-        UartInstancePro[0].RXCallBack();
+        pProperties->isContinuousRX = true;
+        GET_UART_REGISTERS(uartHandle->pUartInstance)->CR1 &= ~UART_CR1_RXNEIE;
+        UART_ReceiveWithDMA(uartHandle);
       }
     }
   }
+  return RET_enuErrorStatus;
+}
 
-  if(((USART_t*)USART1)->SR & UART_SR_TXE_Msk)
+UART_ErrorStatus_t UART_GetRxOverruns(UART_Handle_t *uartHandle,
+                                      uint32_t *pOverruns)
+{
+  UART_ErrorStatus_t RET_enuErrorStatus = UART_ERROR_NONE;
+  if (IS_NULL_PTR(uartHandle) || IS_NULL_PTR(pOverruns))
+  {
+    RET_enuErrorStatus = UART_NULL_PTR_PASSED;
+  }
+  else if(!IS_VALID_USART_INSTANCE(uartHandle->pUartInstance) ||
+          !UartInstancePro[GET_UART_INDEX(uartHandle->pUartInstance)].isContinuousRX)
   {
-    if(UartInstancePro[0].TransmitPos < UartInstancePro[0].TransmitBufferSize)
+    RET_enuErrorStatus = UART_ERROR;
+  }
+  else
+  {
+    *pOverruns = UartInstancePro[GET_UART_INDEX(uartHandle->pUartInstance)].RxOverruns;
+  }
+  return RET_enuErrorStatus;
+}
+
+UART_ErrorStatus_t UART_StartBuffered(UART_Handle_t *uartHandle,
+                                      char *pTxBuffer, uint16_t TxSize,
+                                      char *pRxBuffer, uint16_t RxSize)
+{
+  UART_ErrorStatus_t RET_enuErrorStatus = UART_ERROR_NONE;
+  USART_t *UartInstance;
+  UartInstanceProperties *pProperties;
+  if (IS_NULL_PTR(uartHandle) || IS_NULL_PTR(pTxBuffer) || IS_NULL_PTR(pRxBuffer))
+  {
+    RET_enuErrorStatus = UART_NULL_PTR_PASSED;
+  }
+  else if(!IS_VALID_USART_INSTANCE(uartHandle->pUartInstance) ||
+          !IS_VALID_RING_SIZE(TxSize) || !IS_VALID_RING_SIZE(RxSize))
+  {
+    RET_enuErrorStatus = UART_PARAM_ERROR;
+  }
+  else
+  {
+    UartInstance = GET_UART_REGISTERS(uartHandle->pUartInstance);
+    pProperties  = &UartInstancePro[GET_UART_INDEX(uartHandle->pUartInstance)];
+    if(IS_UART_INSTANCE_BUSY(pProperties->isTXProcessRequest) ||
+       IS_UART_INSTANCE_BUSY(pProperties->isRXProcessRequest) ||
+       IS_UART_INSTANCE_BUSY(pProperties->isContinuousRX))
     {
-      ((USART_t*)USART1)->DR = UartInstancePro[0].pUartTransmitBuffer[UartInstancePro[0].TransmitPos++];
+      RET_enuErrorStatus = UART_ERROR;
     }
     else
     {
-      if(UartInstancePro[0].isTXProcessRequest == true)
-      {
-        UartInstancePro[0].isTXProcessRequest = false;
-        ((USART_t*)USART1)->CR1 &= ~UART_CR1_TXEIE;
-        if(UartInstancePro[0].isRXProcessRequest != true)
-        {
-         ((USART_t*)USART1)->CR1 &= ~UART_CR1_UE;
-        }
-        if(IS_NULL_PTR(UartInstancePro[0].TXCallBack))
-        {
+      UartInstance->CR1 &= ~(UART_CR1_TXEIE | UART_CR1_RXNEIE);
+      pProperties->TxRing.pBuffer = pTxBuffer;
+      pProperties->TxRing.Size    = TxSize;
+      pProperties->TxRing.Head    = 0;
+      pProperties->TxRing.Tail    = 0;
+      pProperties->RxRing.pBuffer = pRxBuffer;
+      pProperties->RxRing.Size    = RxSize;
+      pProperties->RxRing.Head    = 0;
+      pProperties->RxRing.Tail    = 0;
+      pProperties->RxDropped      = 0;
+      pProperties->isBuffered     = true;
+      UartInstance->CR1 |= UART_CR1_RXNEIE;
+      UartInstance->CR1 |= UART_CR1_UE;
+    }
+  }
+  return RET_enuErrorStatus;
+}
 
-        }
-        else
-        {
-          UartInstancePro[0].TXCallBack();
-        }
-      }
+UART_ErrorStatus_t UART_Write(UART_Handle_t *uartHandle, const char *pData,
+                              uint16_t Size, uint16_t *pWritten)
+{
+  UART_ErrorStatus_t RET_enuErrorStatus = UART_ERROR_NONE;
+  UartInstanceProperties *pProperties;
+  uint16_t Written = 0;
+  if (IS_NULL_PTR(uartHandle) || IS_NULL_PTR(pData) || IS_NULL_PTR(pWritten))
+  {
+    RET_enuErrorStatus = UART_NULL_PTR_PASSED;
+  }
+  else if(!IS_VALID_USART_INSTANCE(uartHandle->pUartInstance) ||
+          !UartInstancePro[GET_UART_INDEX(uartHandle->pUartInstance)].isBuffered)
+  {
+    RET_enuErrorStatus = UART_ERROR;
+  }
+  else
+  {
+    pProperties = &UartInstancePro[GET_UART_INDEX(uartHandle->pUartInstance)];
+    while(Written < Size && UART_RingPush(&pProperties->TxRing, pData[Written]))
+    {
+      Written++;
+    }
+    if(Written != 0)
+    {
+      /* The interrupt only clears TXEIE once the ring is empty, it can not race this */
+      GET_UART_REGISTERS(uartHandle->pUartInstance)->CR1 |= UART_CR1_TXEIE;
+    }
+    else
+    {
+      /* No thing */
     }
+    *pWritten = Written;
   }
+  return RET_enuErrorStatus;
+}
+
+UART_ErrorStatus_t UART_Read(UART_Handle_t *uartHandle, char *pData,
+                             uint16_t Size, uint16_t *pRead)
+{
+  UART_ErrorStatus_t RET_enuErrorStatus = UART_ERROR_NONE;
+  UartInstanceProperties *pProperties;
+  uint16_t Read = 0;
+  if (IS_NULL_PTR(uartHandle) || IS_NULL_PTR(pData) || IS_NULL_PTR(pRead))
+  {
+    RET_enuErrorStatus = UART_NULL_PTR_PASSED;
+  }
+  else if(!IS_VALID_USART_INSTANCE(uartHandle->pUartInstance) ||
+          !UartInstancePro[GET_UART_INDEX(uartHandle->pUartInstance)].isBuffered)
+  {
+    RET_enuErrorStatus = UART_ERROR;
+  }
+  else
+  {
+    pProperties = &UartInstancePro[GET_UART_INDEX(uartHandle->pUartInstance)];
+    while(Read < Size && UART_RingPop(&pProperties->RxRing, &pData[Read]))
+    {
+      Read++;
+    }
+    *pRead = Read;
+  }
+  return RET_enuErrorStatus;
+}
+
+UART_ErrorStatus_t UART_GetBufferedStats(UART_Handle_t *uartHandle,
+                                         UART_BufferedStats_t *pStats)
+{
+  UART_ErrorStatus_t RET_enuErrorStatus = UART_ERROR_NONE;
+  UartInstanceProperties *pProperties;
+  if (IS_NULL_PTR(uartHandle) || IS_NULL_PTR(pStats))
+  {
+    RET_enuErrorStatus = UART_NULL_PTR_PASSED;
+  }
+  else if(!IS_VALID_USART_INSTANCE(uartHandle->pUartInstance) ||
+          !UartInstancePro[GET_UART_INDEX(uartHandle->pUartInstance)].isBuffered)
+  {
+    RET_enuErrorStatus = UART_ERROR;
+  }
+  else
+  {
+    pProperties = &UartInstancePro[GET_UART_INDEX(uartHandle->pUartInstance)];
+    pStats->TxPending = UART_RingCount(&pProperties->TxRing);
+    pStats->RxPending = UART_RingCount(&pProperties->RxRing);
+    pStats->RxDropped = pProperties->RxDropped;
+  }
+  return RET_enuErrorStatus;
+}
+
+void USART1_IRQHandler(void)
+{
+  UART_IRQDispatch(GET_UART_INDEX(USART1));
 }
 
+void USART2_IRQHandler(void)
+{
+  UART_IRQDispatch(GET_UART_INDEX(USART2));
+}
+
+void USART6_IRQHandler(void)
+{
+  UART_IRQDispatch(GET_UART_INDEX(USART6));
+}
 
 /******************************************************************************/
\ No newline at end of file